@@ -7,27 +7,56 @@
 
 #include "bytewords.hpp"
 #include "utils.hpp"
+#include "ur-log.hpp"
 #include <stdexcept>
 
 namespace ur_arduino {
 
 using namespace std;
 
-static const char* bytewords = "ableacidalsoapexaquaarchatomauntawayaxisbackbaldbarnbeltbetabiasbluebodybragbrewbulbbuzzcalmcashcatschefcityclawcodecolacookcostcruxcurlcuspcyandarkdatadaysdelidicedietdoordowndrawdropdrumdulldutyeacheasyechoedgeepicevenexamexiteyesfactfairfernfigsfilmfishfizzflapflewfluxfoxyfreefrogfuelfundgalagamegeargemsgiftgirlglowgoodgraygrimgurugushgyrohalfhanghardhawkheathelphighhillholyhopehornhutsicedideaidleinchinkyintoirisironitemjadejazzjoinjoltjowljudojugsjumpjunkjurykeepkenokeptkeyskickkilnkingkitekiwiknoblamblavalazyleaflegsliarlimplionlistlogoloudloveluaulucklungmainmanymathmazememomenumeowmildmintmissmonknailnavyneednewsnextnoonnotenumbobeyoboeomitonyxopenovalowlspaidpartpeckplaypluspoempoolposepuffpumapurrquadquizraceramprealredorichroadrockroofrubyruinrunsrustsafesagascarsetssilkskewslotsoapsolosongstubsurfswantacotasktaxitenttiedtimetinytoiltombtoystriptunatwinuglyundouniturgeuservastveryvetovialvibeviewvisavoidvowswallwandwarmwaspwavewaxywebswhatwhenwhizwolfworkyankyawnyellyogayurtzapszerozestzinczonezoom";
-
-uint8_t decode_word(const string& word, size_t word_len) {
-    if(word.length() != word_len) {
-        //throw runtime_error("Invalid Bytewords.");
-        Serial.println("Invalid Bytewords.");
-        assert(false);
-    }
-
+// NUL terminated, so a word can be handed out as a C string.
+static const char bytewords[256][5] = {
+    "able", "acid", "also", "apex", "aqua", "arch", "atom", "aunt",
+    "away", "axis", "back", "bald", "barn", "belt", "beta", "bias",
+    "blue", "body", "brag", "brew", "bulb", "buzz", "calm", "cash",
+    "cats", "chef", "city", "claw", "code", "cola", "cook", "cost",
+    "crux", "curl", "cusp", "cyan", "dark", "data", "days", "deli",
+    "dice", "diet", "door", "down", "draw", "drop", "drum", "dull",
+    "duty", "each", "easy", "echo", "edge", "epic", "even", "exam",
+    "exit", "eyes", "fact", "fair", "fern", "figs", "film", "fish",
+    "fizz", "flap", "flew", "flux", "foxy", "free", "frog", "fuel",
+    "fund", "gala", "game", "gear", "gems", "gift", "girl", "glow",
+    "good", "gray", "grim", "guru", "gush", "gyro", "half", "hang",
+    "hard", "hawk", "heat", "help", "high", "hill", "holy", "hope",
+    "horn", "huts", "iced", "idea", "idle", "inch", "inky", "into",
+    "iris", "iron", "item", "jade", "jazz", "join", "jolt", "jowl",
+    "judo", "jugs", "jump", "junk", "jury", "keep", "keno", "kept",
+    "keys", "kick", "kiln", "king", "kite", "kiwi", "knob", "lamb",
+    "lava", "lazy", "leaf", "legs", "liar", "limp", "lion", "list",
+    "logo", "loud", "love", "luau", "luck", "lung", "main", "many",
+    "math", "maze", "memo", "menu", "meow", "mild", "mint", "miss",
+    "monk", "nail", "navy", "need", "news", "next", "noon", "note",
+    "numb", "obey", "oboe", "omit", "onyx", "open", "oval", "owls",
+    "paid", "part", "peck", "play", "plus", "poem", "pool", "pose",
+    "puff", "puma", "purr", "quad", "quiz", "race", "ramp", "real",
+    "redo", "rich", "road", "rock", "roof", "ruby", "ruin", "runs",
+    "rust", "safe", "saga", "scar", "sets", "silk", "skew", "slot",
+    "soap", "solo", "song", "stub", "surf", "swan", "taco", "task",
+    "taxi", "tent", "tied", "time", "tiny", "toil", "tomb", "toys",
+    "trip", "tuna", "twin", "ugly", "undo", "unit", "urge", "user",
+    "vast", "very", "veto", "vial", "vibe", "view", "visa", "void",
+    "vows", "wall", "wand", "warm", "wasp", "wave", "waxy", "webs",
+    "what", "when", "whiz", "wolf", "work", "yank", "yawn", "yell",
+    "yoga", "yurt", "zaps", "zero", "zest", "zinc", "zone", "zoom",
+};
+
+// Since the first and last letters of each Byteword are unique,
+// we can use them as indexes into a two-dimensional lookup table.
+// This table is generated lazily.
+static const int16_t* letters_table() {
     static int16_t* array = NULL;
     const size_t dim = 26;
 
-    // Since the first and last letters of each Byteword are unique,
-    // we can use them as indexes into a two-dimensional lookup table.
-    // This table is generated lazily.
     if(array == NULL) {
         const size_t array_len = dim * dim;
         array = (int16_t*)malloc(array_len * sizeof(int16_t));
@@ -35,13 +64,25 @@ uint8_t decode_word(const string& word, size_t word_len) {
             array[i] = -1;
         }
         for(size_t i = 0; i < 256; i++) {
-            const char* byteword = bytewords + i * 4;
+            const char* byteword = bytewords[i];
             size_t x = byteword[0] - 'a';
             size_t y = byteword[3] - 'a';
             size_t offset = y * dim + x;
             array[offset] = i;
         }
     }
+    return array;
+}
+
+uint8_t decode_word(const string& word, size_t word_len) {
+    if(word.length() != word_len) {
+        //throw runtime_error("Invalid Bytewords.");
+        UR_LOG_ERROR("Invalid Bytewords.\n");
+        assert(false);
+    }
+
+    const int16_t* array = letters_table();
+    const size_t dim = 26;
 
     // If the coordinates generated by the first and last letters are out of bounds,
     // or the lookup table contains -1 at the coordinates, then the word is not valid.
@@ -49,25 +90,25 @@ uint8_t decode_word(const string& word, size_t word_len) {
     int y = tolower(word[word_len == 4 ? 3 : 1]) - 'a';
     if(!(0 <= x && x < dim && 0 <= y && y < dim)) {
         //throw runtime_error("Invalid Bytewords.");
-        Serial.println("Invalid Bytewords.");
+        UR_LOG_ERROR("Invalid Bytewords.\n");
         assert(false);
     }
     size_t offset = y * dim + x;
     int16_t value = array[offset];
     if(value == -1) {
         //throw runtime_error("Invalid Bytewords.");
-        Serial.println("Invalid Bytewords.");
+        UR_LOG_ERROR("Invalid Bytewords.\n");
         assert(false);
     }
 
     // If we're decoding a full four-letter word, verify that the two middle letters are correct.
     if(word_len == 4) {
-        const char* byteword = bytewords + value * 4;
+        const char* byteword = bytewords[value];
         int c1 = tolower(word[1]);
         int c2 = tolower(word[2]);
         if(c1 != byteword[1] || c2 != byteword[2]) {
             //throw runtime_error("Invalid Bytewords.");
-            Serial.println("Invalid Bytewords.");
+            UR_LOG_ERROR("Invalid Bytewords.\n");
             assert(false);
         }
     }
@@ -77,14 +118,14 @@ uint8_t decode_word(const string& word, size_t word_len) {
 }
 
 static const string get_word(uint8_t index) {
-    auto p = &bytewords[index * 4];
+    auto p = bytewords[index];
     return string(p, p + 4);
 }
 
 static const string get_minimal_word(uint8_t index) {
     string word;
     word.reserve(2);
-    auto p = &bytewords[index * 4];
+    auto p = bytewords[index];
     word.push_back(*p);
     word.push_back(*(p + 3));
     return word;
@@ -137,7 +178,7 @@ static const ByteVector _decode(const string& s, char separator, size_t word_len
     }
     if(buf.size() < 5) {
         //throw runtime_error("Invalid Bytewords.");
-        Serial.println("Invalid Bytewords.");
+        UR_LOG_ERROR("Invalid Bytewords.\n");
         assert(false);
     }
     auto p = split(buf, buf.size() - 4);
@@ -146,13 +187,27 @@ static const ByteVector _decode(const string& s, char separator, size_t word_len
     auto checksum = crc32_bytes(body);
     if(checksum != body_checksum) {
         //throw runtime_error("Invalid Bytewords.");
-        Serial.println("Invalid Bytewords.");
+        UR_LOG_ERROR("Invalid Bytewords.\n");
         assert(false);
     }
 
     return body;
 }
 
+int Bytewords::from_letters(char first, char last) {
+    const int dim = 26;
+    int x = tolower(first) - 'a';
+    int y = tolower(last) - 'a';
+    if(!(0 <= x && x < dim && 0 <= y && y < dim)) {
+        return -1;
+    }
+    return letters_table()[y * dim + x];
+}
+
+const char* Bytewords::word(uint8_t index) {
+    return bytewords[index];
+}
+
 string Bytewords::encode(style style, const ByteVector& bytes) {
     switch(style) {
         case standard:
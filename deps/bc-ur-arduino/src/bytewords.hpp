@@ -25,6 +25,14 @@ public:
 
     static std::string encode(style style, const ByteVector& bytes);
     static ByteVector decode(style style, const std::string& string);
+
+    // The index of the Byteword with the given first and last letters,
+    // or -1 if there is none.  Shares the decoder's lookup table.
+    static int from_letters(char first, char last);
+
+    // The Byteword of index, NUL terminated.  The words are in the
+    // order of their values, which is also alphabetical.
+    static const char* word(uint8_t index);
 };
 
 }
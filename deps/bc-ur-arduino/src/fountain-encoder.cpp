@@ -6,6 +6,7 @@
 //
 
 #include "fountain-encoder.hpp"
+#include "ur-log.hpp"
 #include <assert.h>
 #include <cmath>
 //#include <optional>
@@ -27,14 +28,14 @@ namespace ur_arduino {
 
 class CborListen_Part : public CborListener {
   public:
-    void OnInteger(int32_t value){Serial.println("integer"); integers[i] = value; i++; Serial.println(value); };
-    void OnBytes(unsigned char *data, unsigned int size) {Serial.println("bytes");};
-    void OnString(String &str) {Serial.println("string");};
-    void OnArray(unsigned int size) {Serial.println("array");};
-    void OnMap(unsigned int size) {Serial.println("map");};
-    void OnTag(uint32_t tag) {Serial.println("tag");};
-    void OnSpecial(uint32_t code) {Serial.println("tag");};
-    void OnError(const char *error) {Serial.println("error");};
+    void OnInteger(int32_t value){UR_LOG_TRACE("integer %ld\n", (long) value); integers[i] = value; i++; };
+    void OnBytes(unsigned char *data, unsigned int size) {UR_LOG_TRACE("bytes\n");};
+    void OnString(String &str) {UR_LOG_TRACE("string\n");};
+    void OnArray(unsigned int size) {UR_LOG_TRACE("array\n");};
+    void OnMap(unsigned int size) {UR_LOG_TRACE("map\n");};
+    void OnTag(uint32_t tag) {UR_LOG_TRACE("tag\n");};
+    void OnSpecial(uint32_t code) {UR_LOG_TRACE("special\n");};
+    void OnError(const char *error) {UR_LOG_ERROR("Part cbor: %s\n", error);};
     
     // we are gonna collect 4 integers: seqnum, seqlen, msglen and checksum
     size_t i = 0;
@@ -75,7 +76,7 @@ vector<ByteVector> FountainEncoder::partition_message(ByteVector message, size_t
 }
 
 FountainEncoder::Part::Part(const ByteVector& cbor) {
-        Serial.println("*******   Part::Part(const ByteVector& cbor)    ********");
+    UR_LOG_TRACE("Part::Part(const ByteVector& cbor)\n");
 
     uint8_t* cbor_arr = (uint8_t *)&cbor[0];
     CborInput input(cbor_arr, cbor.size());
@@ -89,17 +90,9 @@ FountainEncoder::Part::Part(const ByteVector& cbor) {
     message_len_ = listener.integers[2];
     checksum_ = listener.integers[3];
 
-    Serial.println("seq_num_:");
-    Serial.println(seq_num_);
-
-    Serial.println("seq_len_:");
-    Serial.println(seq_len_);
-
-    Serial.println("message_len_:");
-    Serial.println(message_len_);
-
-    Serial.println("checksum_:");
-    Serial.println(checksum_);
+    UR_LOG_TRACE("seq_num_: %lu, seq_len_: %lu, message_len_: %lu, checksum_: %lu\n",
+                 (unsigned long) seq_num_, (unsigned long) seq_len_,
+                 (unsigned long) message_len_, (unsigned long) checksum_);
 }
 
 ByteVector FountainEncoder::Part::cbor() const {
@@ -0,0 +1,42 @@
+//
+//  ur-log.hpp
+//
+//  Copyright © 2020 by Blockchain Commons, LLC
+//  Licensed under the "BSD-2-Clause Plus Patent License"
+//
+
+#ifndef BC_UR_LOG_HPP
+#define BC_UR_LOG_HPP
+
+// Levelled logging to Serial.  A statement above UR_LOG_LEVEL is an
+// if (false) the compiler drops, its arguments are never evaluated.
+// The library only reports errors unless built with a higher
+// UR_LOG_LEVEL, e.g. -DUR_LOG_LEVEL=UR_LOG_LEVEL_TRACE.
+
+#define UR_LOG_LEVEL_NONE   0
+#define UR_LOG_LEVEL_ERROR  1
+#define UR_LOG_LEVEL_WARN   2
+#define UR_LOG_LEVEL_INFO   3
+#define UR_LOG_LEVEL_DEBUG  4
+#define UR_LOG_LEVEL_TRACE  5
+
+#ifndef UR_LOG_LEVEL
+#define UR_LOG_LEVEL UR_LOG_LEVEL_ERROR
+#endif
+
+namespace ur_arduino {
+
+void log_printf(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+}
+
+#define UR_LOG_AT(level, ...) \
+    do { if ((level) <= UR_LOG_LEVEL) ur_arduino::log_printf(__VA_ARGS__); } while (false)
+
+#define UR_LOG_ERROR(...) UR_LOG_AT(UR_LOG_LEVEL_ERROR, __VA_ARGS__)
+#define UR_LOG_WARN(...)  UR_LOG_AT(UR_LOG_LEVEL_WARN, __VA_ARGS__)
+#define UR_LOG_INFO(...)  UR_LOG_AT(UR_LOG_LEVEL_INFO, __VA_ARGS__)
+#define UR_LOG_DEBUG(...) UR_LOG_AT(UR_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define UR_LOG_TRACE(...) UR_LOG_AT(UR_LOG_LEVEL_TRACE, __VA_ARGS__)
+
+#endif // BC_UR_LOG_HPP
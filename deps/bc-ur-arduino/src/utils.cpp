@@ -6,6 +6,7 @@
 //
 
 #include "utils.hpp"
+#include "ur-log.hpp"
 
 extern "C" {
 
@@ -18,6 +19,7 @@ extern "C" {
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <stdarg.h>
 #include <Arduino.h>
 
 using namespace std;
@@ -205,4 +207,13 @@ string to_string(int32_t val) {
     return tmp;
 }
 
+void log_printf(const char* format, ...) {
+    char buff[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buff, sizeof(buff), format, args);
+    va_end(args);
+    Serial.print(buff);
+}
+
 }
@@ -0,0 +1,479 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+// Generated by gen-bip39-words.sh from the BIP39 english.txt, don't edit.
+
+#ifndef BIP39WORDS_H
+#define BIP39WORDS_H
+
+#include <stdint.h>
+
+// The 2048 BIP39 words, NUL separated.
+static char const bip39_words[] =
+    "abandon\0" "ability\0" "able\0" "about\0" "above\0" "absent\0" "absorb\0" "abstract\0"
+    "absurd\0" "abuse\0" "access\0" "accident\0" "account\0" "accuse\0" "achieve\0" "acid\0"
+    "acoustic\0" "acquire\0" "across\0" "act\0" "action\0" "actor\0" "actress\0" "actual\0"
+    "adapt\0" "add\0" "addict\0" "address\0" "adjust\0" "admit\0" "adult\0" "advance\0"
+    "advice\0" "aerobic\0" "affair\0" "afford\0" "afraid\0" "again\0" "age\0" "agent\0"
+    "agree\0" "ahead\0" "aim\0" "air\0" "airport\0" "aisle\0" "alarm\0" "album\0"
+    "alcohol\0" "alert\0" "alien\0" "all\0" "alley\0" "allow\0" "almost\0" "alone\0"
+    "alpha\0" "already\0" "also\0" "alter\0" "always\0" "amateur\0" "amazing\0" "among\0"
+    "amount\0" "amused\0" "analyst\0" "anchor\0" "ancient\0" "anger\0" "angle\0" "angry\0"
+    "animal\0" "ankle\0" "announce\0" "annual\0" "another\0" "answer\0" "antenna\0" "antique\0"
+    "anxiety\0" "any\0" "apart\0" "apology\0" "appear\0" "apple\0" "approve\0" "april\0"
+    "arch\0" "arctic\0" "area\0" "arena\0" "argue\0" "arm\0" "armed\0" "armor\0"
+    "army\0" "around\0" "arrange\0" "arrest\0" "arrive\0" "arrow\0" "art\0" "artefact\0"
+    "artist\0" "artwork\0" "ask\0" "aspect\0" "assault\0" "asset\0" "assist\0" "assume\0"
+    "asthma\0" "athlete\0" "atom\0" "attack\0" "attend\0" "attitude\0" "attract\0" "auction\0"
+    "audit\0" "august\0" "aunt\0" "author\0" "auto\0" "autumn\0" "average\0" "avocado\0"
+    "avoid\0" "awake\0" "aware\0" "away\0" "awesome\0" "awful\0" "awkward\0" "axis\0"
+    "baby\0" "bachelor\0" "bacon\0" "badge\0" "bag\0" "balance\0" "balcony\0" "ball\0"
+    "bamboo\0" "banana\0" "banner\0" "bar\0" "barely\0" "bargain\0" "barrel\0" "base\0"
+    "basic\0" "basket\0" "battle\0" "beach\0" "bean\0" "beauty\0" "because\0" "become\0"
+    "beef\0" "before\0" "begin\0" "behave\0" "behind\0" "believe\0" "below\0" "belt\0"
+    "bench\0" "benefit\0" "best\0" "betray\0" "better\0" "between\0" "beyond\0" "bicycle\0"
+    "bid\0" "bike\0" "bind\0" "biology\0" "bird\0" "birth\0" "bitter\0" "black\0"
+    "blade\0" "blame\0" "blanket\0" "blast\0" "bleak\0" "bless\0" "blind\0" "blood\0"
+    "blossom\0" "blouse\0" "blue\0" "blur\0" "blush\0" "board\0" "boat\0" "body\0"
+    "boil\0" "bomb\0" "bone\0" "bonus\0" "book\0" "boost\0" "border\0" "boring\0"
+    "borrow\0" "boss\0" "bottom\0" "bounce\0" "box\0" "boy\0" "bracket\0" "brain\0"
+    "brand\0" "brass\0" "brave\0" "bread\0" "breeze\0" "brick\0" "bridge\0" "brief\0"
+    "bright\0" "bring\0" "brisk\0" "broccoli\0" "broken\0" "bronze\0" "broom\0" "brother\0"
+    "brown\0" "brush\0" "bubble\0" "buddy\0" "budget\0" "buffalo\0" "build\0" "bulb\0"
+    "bulk\0" "bullet\0" "bundle\0" "bunker\0" "burden\0" "burger\0" "burst\0" "bus\0"
+    "business\0" "busy\0" "butter\0" "buyer\0" "buzz\0" "cabbage\0" "cabin\0" "cable\0"
+    "cactus\0" "cage\0" "cake\0" "call\0" "calm\0" "camera\0" "camp\0" "can\0"
+    "canal\0" "cancel\0" "candy\0" "cannon\0" "canoe\0" "canvas\0" "canyon\0" "capable\0"
+    "capital\0" "captain\0" "car\0" "carbon\0" "card\0" "cargo\0" "carpet\0" "carry\0"
+    "cart\0" "case\0" "cash\0" "casino\0" "castle\0" "casual\0" "cat\0" "catalog\0"
+    "catch\0" "category\0" "cattle\0" "caught\0" "cause\0" "caution\0" "cave\0" "ceiling\0"
+    "celery\0" "cement\0" "census\0" "century\0" "cereal\0" "certain\0" "chair\0" "chalk\0"
+    "champion\0" "change\0" "chaos\0" "chapter\0" "charge\0" "chase\0" "chat\0" "cheap\0"
+    "check\0" "cheese\0" "chef\0" "cherry\0" "chest\0" "chicken\0" "chief\0" "child\0"
+    "chimney\0" "choice\0" "choose\0" "chronic\0" "chuckle\0" "chunk\0" "churn\0" "cigar\0"
+    "cinnamon\0" "circle\0" "citizen\0" "city\0" "civil\0" "claim\0" "clap\0" "clarify\0"
+    "claw\0" "clay\0" "clean\0" "clerk\0" "clever\0" "click\0" "client\0" "cliff\0"
+    "climb\0" "clinic\0" "clip\0" "clock\0" "clog\0" "close\0" "cloth\0" "cloud\0"
+    "clown\0" "club\0" "clump\0" "cluster\0" "clutch\0" "coach\0" "coast\0" "coconut\0"
+    "code\0" "coffee\0" "coil\0" "coin\0" "collect\0" "color\0" "column\0" "combine\0"
+    "come\0" "comfort\0" "comic\0" "common\0" "company\0" "concert\0" "conduct\0" "confirm\0"
+    "congress\0" "connect\0" "consider\0" "control\0" "convince\0" "cook\0" "cool\0" "copper\0"
+    "copy\0" "coral\0" "core\0" "corn\0" "correct\0" "cost\0" "cotton\0" "couch\0"
+    "country\0" "couple\0" "course\0" "cousin\0" "cover\0" "coyote\0" "crack\0" "cradle\0"
+    "craft\0" "cram\0" "crane\0" "crash\0" "crater\0" "crawl\0" "crazy\0" "cream\0"
+    "credit\0" "creek\0" "crew\0" "cricket\0" "crime\0" "crisp\0" "critic\0" "crop\0"
+    "cross\0" "crouch\0" "crowd\0" "crucial\0" "cruel\0" "cruise\0" "crumble\0" "crunch\0"
+    "crush\0" "cry\0" "crystal\0" "cube\0" "culture\0" "cup\0" "cupboard\0" "curious\0"
+    "current\0" "curtain\0" "curve\0" "cushion\0" "custom\0" "cute\0" "cycle\0" "dad\0"
+    "damage\0" "damp\0" "dance\0" "danger\0" "daring\0" "dash\0" "daughter\0" "dawn\0"
+    "day\0" "deal\0" "debate\0" "debris\0" "decade\0" "december\0" "decide\0" "decline\0"
+    "decorate\0" "decrease\0" "deer\0" "defense\0" "define\0" "defy\0" "degree\0" "delay\0"
+    "deliver\0" "demand\0" "demise\0" "denial\0" "dentist\0" "deny\0" "depart\0" "depend\0"
+    "deposit\0" "depth\0" "deputy\0" "derive\0" "describe\0" "desert\0" "design\0" "desk\0"
+    "despair\0" "destroy\0" "detail\0" "detect\0" "develop\0" "device\0" "devote\0" "diagram\0"
+    "dial\0" "diamond\0" "diary\0" "dice\0" "diesel\0" "diet\0" "differ\0" "digital\0"
+    "dignity\0" "dilemma\0" "dinner\0" "dinosaur\0" "direct\0" "dirt\0" "disagree\0" "discover\0"
+    "disease\0" "dish\0" "dismiss\0" "disorder\0" "display\0" "distance\0" "divert\0" "divide\0"
+    "divorce\0" "dizzy\0" "doctor\0" "document\0" "dog\0" "doll\0" "dolphin\0" "domain\0"
+    "donate\0" "donkey\0" "donor\0" "door\0" "dose\0" "double\0" "dove\0" "draft\0"
+    "dragon\0" "drama\0" "drastic\0" "draw\0" "dream\0" "dress\0" "drift\0" "drill\0"
+    "drink\0" "drip\0" "drive\0" "drop\0" "drum\0" "dry\0" "duck\0" "dumb\0"
+    "dune\0" "during\0" "dust\0" "dutch\0" "duty\0" "dwarf\0" "dynamic\0" "eager\0"
+    "eagle\0" "early\0" "earn\0" "earth\0" "easily\0" "east\0" "easy\0" "echo\0"
+    "ecology\0" "economy\0" "edge\0" "edit\0" "educate\0" "effort\0" "egg\0" "eight\0"
+    "either\0" "elbow\0" "elder\0" "electric\0" "elegant\0" "element\0" "elephant\0" "elevator\0"
+    "elite\0" "else\0" "embark\0" "embody\0" "embrace\0" "emerge\0" "emotion\0" "employ\0"
+    "empower\0" "empty\0" "enable\0" "enact\0" "end\0" "endless\0" "endorse\0" "enemy\0"
+    "energy\0" "enforce\0" "engage\0" "engine\0" "enhance\0" "enjoy\0" "enlist\0" "enough\0"
+    "enrich\0" "enroll\0" "ensure\0" "enter\0" "entire\0" "entry\0" "envelope\0" "episode\0"
+    "equal\0" "equip\0" "era\0" "erase\0" "erode\0" "erosion\0" "error\0" "erupt\0"
+    "escape\0" "essay\0" "essence\0" "estate\0" "eternal\0" "ethics\0" "evidence\0" "evil\0"
+    "evoke\0" "evolve\0" "exact\0" "example\0" "excess\0" "exchange\0" "excite\0" "exclude\0"
+    "excuse\0" "execute\0" "exercise\0" "exhaust\0" "exhibit\0" "exile\0" "exist\0" "exit\0"
+    "exotic\0" "expand\0" "expect\0" "expire\0" "explain\0" "expose\0" "express\0" "extend\0"
+    "extra\0" "eye\0" "eyebrow\0" "fabric\0" "face\0" "faculty\0" "fade\0" "faint\0"
+    "faith\0" "fall\0" "false\0" "fame\0" "family\0" "famous\0" "fan\0" "fancy\0"
+    "fantasy\0" "farm\0" "fashion\0" "fat\0" "fatal\0" "father\0" "fatigue\0" "fault\0"
+    "favorite\0" "feature\0" "february\0" "federal\0" "fee\0" "feed\0" "feel\0" "female\0"
+    "fence\0" "festival\0" "fetch\0" "fever\0" "few\0" "fiber\0" "fiction\0" "field\0"
+    "figure\0" "file\0" "film\0" "filter\0" "final\0" "find\0" "fine\0" "finger\0"
+    "finish\0" "fire\0" "firm\0" "first\0" "fiscal\0" "fish\0" "fit\0" "fitness\0"
+    "fix\0" "flag\0" "flame\0" "flash\0" "flat\0" "flavor\0" "flee\0" "flight\0"
+    "flip\0" "float\0" "flock\0" "floor\0" "flower\0" "fluid\0" "flush\0" "fly\0"
+    "foam\0" "focus\0" "fog\0" "foil\0" "fold\0" "follow\0" "food\0" "foot\0"
+    "force\0" "forest\0" "forget\0" "fork\0" "fortune\0" "forum\0" "forward\0" "fossil\0"
+    "foster\0" "found\0" "fox\0" "fragile\0" "frame\0" "frequent\0" "fresh\0" "friend\0"
+    "fringe\0" "frog\0" "front\0" "frost\0" "frown\0" "frozen\0" "fruit\0" "fuel\0"
+    "fun\0" "funny\0" "furnace\0" "fury\0" "future\0" "gadget\0" "gain\0" "galaxy\0"
+    "gallery\0" "game\0" "gap\0" "garage\0" "garbage\0" "garden\0" "garlic\0" "garment\0"
+    "gas\0" "gasp\0" "gate\0" "gather\0" "gauge\0" "gaze\0" "general\0" "genius\0"
+    "genre\0" "gentle\0" "genuine\0" "gesture\0" "ghost\0" "giant\0" "gift\0" "giggle\0"
+    "ginger\0" "giraffe\0" "girl\0" "give\0" "glad\0" "glance\0" "glare\0" "glass\0"
+    "glide\0" "glimpse\0" "globe\0" "gloom\0" "glory\0" "glove\0" "glow\0" "glue\0"
+    "goat\0" "goddess\0" "gold\0" "good\0" "goose\0" "gorilla\0" "gospel\0" "gossip\0"
+    "govern\0" "gown\0" "grab\0" "grace\0" "grain\0" "grant\0" "grape\0" "grass\0"
+    "gravity\0" "great\0" "green\0" "grid\0" "grief\0" "grit\0" "grocery\0" "group\0"
+    "grow\0" "grunt\0" "guard\0" "guess\0" "guide\0" "guilt\0" "guitar\0" "gun\0"
+    "gym\0" "habit\0" "hair\0" "half\0" "hammer\0" "hamster\0" "hand\0" "happy\0"
+    "harbor\0" "hard\0" "harsh\0" "harvest\0" "hat\0" "have\0" "hawk\0" "hazard\0"
+    "head\0" "health\0" "heart\0" "heavy\0" "hedgehog\0" "height\0" "hello\0" "helmet\0"
+    "help\0" "hen\0" "hero\0" "hidden\0" "high\0" "hill\0" "hint\0" "hip\0"
+    "hire\0" "history\0" "hobby\0" "hockey\0" "hold\0" "hole\0" "holiday\0" "hollow\0"
+    "home\0" "honey\0" "hood\0" "hope\0" "horn\0" "horror\0" "horse\0" "hospital\0"
+    "host\0" "hotel\0" "hour\0" "hover\0" "hub\0" "huge\0" "human\0" "humble\0"
+    "humor\0" "hundred\0" "hungry\0" "hunt\0" "hurdle\0" "hurry\0" "hurt\0" "husband\0"
+    "hybrid\0" "ice\0" "icon\0" "idea\0" "identify\0" "idle\0" "ignore\0" "ill\0"
+    "illegal\0" "illness\0" "image\0" "imitate\0" "immense\0" "immune\0" "impact\0" "impose\0"
+    "improve\0" "impulse\0" "inch\0" "include\0" "income\0" "increase\0" "index\0" "indicate\0"
+    "indoor\0" "industry\0" "infant\0" "inflict\0" "inform\0" "inhale\0" "inherit\0" "initial\0"
+    "inject\0" "injury\0" "inmate\0" "inner\0" "innocent\0" "input\0" "inquiry\0" "insane\0"
+    "insect\0" "inside\0" "inspire\0" "install\0" "intact\0" "interest\0" "into\0" "invest\0"
+    "invite\0" "involve\0" "iron\0" "island\0" "isolate\0" "issue\0" "item\0" "ivory\0"
+    "jacket\0" "jaguar\0" "jar\0" "jazz\0" "jealous\0" "jeans\0" "jelly\0" "jewel\0"
+    "job\0" "join\0" "joke\0" "journey\0" "joy\0" "judge\0" "juice\0" "jump\0"
+    "jungle\0" "junior\0" "junk\0" "just\0" "kangaroo\0" "keen\0" "keep\0" "ketchup\0"
+    "key\0" "kick\0" "kid\0" "kidney\0" "kind\0" "kingdom\0" "kiss\0" "kit\0"
+    "kitchen\0" "kite\0" "kitten\0" "kiwi\0" "knee\0" "knife\0" "knock\0" "know\0"
+    "lab\0" "label\0" "labor\0" "ladder\0" "lady\0" "lake\0" "lamp\0" "language\0"
+    "laptop\0" "large\0" "later\0" "latin\0" "laugh\0" "laundry\0" "lava\0" "law\0"
+    "lawn\0" "lawsuit\0" "layer\0" "lazy\0" "leader\0" "leaf\0" "learn\0" "leave\0"
+    "lecture\0" "left\0" "leg\0" "legal\0" "legend\0" "leisure\0" "lemon\0" "lend\0"
+    "length\0" "lens\0" "leopard\0" "lesson\0" "letter\0" "level\0" "liar\0" "liberty\0"
+    "library\0" "license\0" "life\0" "lift\0" "light\0" "like\0" "limb\0" "limit\0"
+    "link\0" "lion\0" "liquid\0" "list\0" "little\0" "live\0" "lizard\0" "load\0"
+    "loan\0" "lobster\0" "local\0" "lock\0" "logic\0" "lonely\0" "long\0" "loop\0"
+    "lottery\0" "loud\0" "lounge\0" "love\0" "loyal\0" "lucky\0" "luggage\0" "lumber\0"
+    "lunar\0" "lunch\0" "luxury\0" "lyrics\0" "machine\0" "mad\0" "magic\0" "magnet\0"
+    "maid\0" "mail\0" "main\0" "major\0" "make\0" "mammal\0" "man\0" "manage\0"
+    "mandate\0" "mango\0" "mansion\0" "manual\0" "maple\0" "marble\0" "march\0" "margin\0"
+    "marine\0" "market\0" "marriage\0" "mask\0" "mass\0" "master\0" "match\0" "material\0"
+    "math\0" "matrix\0" "matter\0" "maximum\0" "maze\0" "meadow\0" "mean\0" "measure\0"
+    "meat\0" "mechanic\0" "medal\0" "media\0" "melody\0" "melt\0" "member\0" "memory\0"
+    "mention\0" "menu\0" "mercy\0" "merge\0" "merit\0" "merry\0" "mesh\0" "message\0"
+    "metal\0" "method\0" "middle\0" "midnight\0" "milk\0" "million\0" "mimic\0" "mind\0"
+    "minimum\0" "minor\0" "minute\0" "miracle\0" "mirror\0" "misery\0" "miss\0" "mistake\0"
+    "mix\0" "mixed\0" "mixture\0" "mobile\0" "model\0" "modify\0" "mom\0" "moment\0"
+    "monitor\0" "monkey\0" "monster\0" "month\0" "moon\0" "moral\0" "more\0" "morning\0"
+    "mosquito\0" "mother\0" "motion\0" "motor\0" "mountain\0" "mouse\0" "move\0" "movie\0"
+    "much\0" "muffin\0" "mule\0" "multiply\0" "muscle\0" "museum\0" "mushroom\0" "music\0"
+    "must\0" "mutual\0" "myself\0" "mystery\0" "myth\0" "naive\0" "name\0" "napkin\0"
+    "narrow\0" "nasty\0" "nation\0" "nature\0" "near\0" "neck\0" "need\0" "negative\0"
+    "neglect\0" "neither\0" "nephew\0" "nerve\0" "nest\0" "net\0" "network\0" "neutral\0"
+    "never\0" "news\0" "next\0" "nice\0" "night\0" "noble\0" "noise\0" "nominee\0"
+    "noodle\0" "normal\0" "north\0" "nose\0" "notable\0" "note\0" "nothing\0" "notice\0"
+    "novel\0" "now\0" "nuclear\0" "number\0" "nurse\0" "nut\0" "oak\0" "obey\0"
+    "object\0" "oblige\0" "obscure\0" "observe\0" "obtain\0" "obvious\0" "occur\0" "ocean\0"
+    "october\0" "odor\0" "off\0" "offer\0" "office\0" "often\0" "oil\0" "okay\0"
+    "old\0" "olive\0" "olympic\0" "omit\0" "once\0" "one\0" "onion\0" "online\0"
+    "only\0" "open\0" "opera\0" "opinion\0" "oppose\0" "option\0" "orange\0" "orbit\0"
+    "orchard\0" "order\0" "ordinary\0" "organ\0" "orient\0" "original\0" "orphan\0" "ostrich\0"
+    "other\0" "outdoor\0" "outer\0" "output\0" "outside\0" "oval\0" "oven\0" "over\0"
+    "own\0" "owner\0" "oxygen\0" "oyster\0" "ozone\0" "pact\0" "paddle\0" "page\0"
+    "pair\0" "palace\0" "palm\0" "panda\0" "panel\0" "panic\0" "panther\0" "paper\0"
+    "parade\0" "parent\0" "park\0" "parrot\0" "party\0" "pass\0" "patch\0" "path\0"
+    "patient\0" "patrol\0" "pattern\0" "pause\0" "pave\0" "payment\0" "peace\0" "peanut\0"
+    "pear\0" "peasant\0" "pelican\0" "pen\0" "penalty\0" "pencil\0" "people\0" "pepper\0"
+    "perfect\0" "permit\0" "person\0" "pet\0" "phone\0" "photo\0" "phrase\0" "physical\0"
+    "piano\0" "picnic\0" "picture\0" "piece\0" "pig\0" "pigeon\0" "pill\0" "pilot\0"
+    "pink\0" "pioneer\0" "pipe\0" "pistol\0" "pitch\0" "pizza\0" "place\0" "planet\0"
+    "plastic\0" "plate\0" "play\0" "please\0" "pledge\0" "pluck\0" "plug\0" "plunge\0"
+    "poem\0" "poet\0" "point\0" "polar\0" "pole\0" "police\0" "pond\0" "pony\0"
+    "pool\0" "popular\0" "portion\0" "position\0" "possible\0" "post\0" "potato\0" "pottery\0"
+    "poverty\0" "powder\0" "power\0" "practice\0" "praise\0" "predict\0" "prefer\0" "prepare\0"
+    "present\0" "pretty\0" "prevent\0" "price\0" "pride\0" "primary\0" "print\0" "priority\0"
+    "prison\0" "private\0" "prize\0" "problem\0" "process\0" "produce\0" "profit\0" "program\0"
+    "project\0" "promote\0" "proof\0" "property\0" "prosper\0" "protect\0" "proud\0" "provide\0"
+    "public\0" "pudding\0" "pull\0" "pulp\0" "pulse\0" "pumpkin\0" "punch\0" "pupil\0"
+    "puppy\0" "purchase\0" "purity\0" "purpose\0" "purse\0" "push\0" "put\0" "puzzle\0"
+    "pyramid\0" "quality\0" "quantum\0" "quarter\0" "question\0" "quick\0" "quit\0" "quiz\0"
+    "quote\0" "rabbit\0" "raccoon\0" "race\0" "rack\0" "radar\0" "radio\0" "rail\0"
+    "rain\0" "raise\0" "rally\0" "ramp\0" "ranch\0" "random\0" "range\0" "rapid\0"
+    "rare\0" "rate\0" "rather\0" "raven\0" "raw\0" "razor\0" "ready\0" "real\0"
+    "reason\0" "rebel\0" "rebuild\0" "recall\0" "receive\0" "recipe\0" "record\0" "recycle\0"
+    "reduce\0" "reflect\0" "reform\0" "refuse\0" "region\0" "regret\0" "regular\0" "reject\0"
+    "relax\0" "release\0" "relief\0" "rely\0" "remain\0" "remember\0" "remind\0" "remove\0"
+    "render\0" "renew\0" "rent\0" "reopen\0" "repair\0" "repeat\0" "replace\0" "report\0"
+    "require\0" "rescue\0" "resemble\0" "resist\0" "resource\0" "response\0" "result\0" "retire\0"
+    "retreat\0" "return\0" "reunion\0" "reveal\0" "review\0" "reward\0" "rhythm\0" "rib\0"
+    "ribbon\0" "rice\0" "rich\0" "ride\0" "ridge\0" "rifle\0" "right\0" "rigid\0"
+    "ring\0" "riot\0" "ripple\0" "risk\0" "ritual\0" "rival\0" "river\0" "road\0"
+    "roast\0" "robot\0" "robust\0" "rocket\0" "romance\0" "roof\0" "rookie\0" "room\0"
+    "rose\0" "rotate\0" "rough\0" "round\0" "route\0" "royal\0" "rubber\0" "rude\0"
+    "rug\0" "rule\0" "run\0" "runway\0" "rural\0" "sad\0" "saddle\0" "sadness\0"
+    "safe\0" "sail\0" "salad\0" "salmon\0" "salon\0" "salt\0" "salute\0" "same\0"
+    "sample\0" "sand\0" "satisfy\0" "satoshi\0" "sauce\0" "sausage\0" "save\0" "say\0"
+    "scale\0" "scan\0" "scare\0" "scatter\0" "scene\0" "scheme\0" "school\0" "science\0"
+    "scissors\0" "scorpion\0" "scout\0" "scrap\0" "screen\0" "script\0" "scrub\0" "sea\0"
+    "search\0" "season\0" "seat\0" "second\0" "secret\0" "section\0" "security\0" "seed\0"
+    "seek\0" "segment\0" "select\0" "sell\0" "seminar\0" "senior\0" "sense\0" "sentence\0"
+    "series\0" "service\0" "session\0" "settle\0" "setup\0" "seven\0" "shadow\0" "shaft\0"
+    "shallow\0" "share\0" "shed\0" "shell\0" "sheriff\0" "shield\0" "shift\0" "shine\0"
+    "ship\0" "shiver\0" "shock\0" "shoe\0" "shoot\0" "shop\0" "short\0" "shoulder\0"
+    "shove\0" "shrimp\0" "shrug\0" "shuffle\0" "shy\0" "sibling\0" "sick\0" "side\0"
+    "siege\0" "sight\0" "sign\0" "silent\0" "silk\0" "silly\0" "silver\0" "similar\0"
+    "simple\0" "since\0" "sing\0" "siren\0" "sister\0" "situate\0" "six\0" "size\0"
+    "skate\0" "sketch\0" "ski\0" "skill\0" "skin\0" "skirt\0" "skull\0" "slab\0"
+    "slam\0" "sleep\0" "slender\0" "slice\0" "slide\0" "slight\0" "slim\0" "slogan\0"
+    "slot\0" "slow\0" "slush\0" "small\0" "smart\0" "smile\0" "smoke\0" "smooth\0"
+    "snack\0" "snake\0" "snap\0" "sniff\0" "snow\0" "soap\0" "soccer\0" "social\0"
+    "sock\0" "soda\0" "soft\0" "solar\0" "soldier\0" "solid\0" "solution\0" "solve\0"
+    "someone\0" "song\0" "soon\0" "sorry\0" "sort\0" "soul\0" "sound\0" "soup\0"
+    "source\0" "south\0" "space\0" "spare\0" "spatial\0" "spawn\0" "speak\0" "special\0"
+    "speed\0" "spell\0" "spend\0" "sphere\0" "spice\0" "spider\0" "spike\0" "spin\0"
+    "spirit\0" "split\0" "spoil\0" "sponsor\0" "spoon\0" "sport\0" "spot\0" "spray\0"
+    "spread\0" "spring\0" "spy\0" "square\0" "squeeze\0" "squirrel\0" "stable\0" "stadium\0"
+    "staff\0" "stage\0" "stairs\0" "stamp\0" "stand\0" "start\0" "state\0" "stay\0"
+    "steak\0" "steel\0" "stem\0" "step\0" "stereo\0" "stick\0" "still\0" "sting\0"
+    "stock\0" "stomach\0" "stone\0" "stool\0" "story\0" "stove\0" "strategy\0" "street\0"
+    "strike\0" "strong\0" "struggle\0" "student\0" "stuff\0" "stumble\0" "style\0" "subject\0"
+    "submit\0" "subway\0" "success\0" "such\0" "sudden\0" "suffer\0" "sugar\0" "suggest\0"
+    "suit\0" "summer\0" "sun\0" "sunny\0" "sunset\0" "super\0" "supply\0" "supreme\0"
+    "sure\0" "surface\0" "surge\0" "surprise\0" "surround\0" "survey\0" "suspect\0" "sustain\0"
+    "swallow\0" "swamp\0" "swap\0" "swarm\0" "swear\0" "sweet\0" "swift\0" "swim\0"
+    "swing\0" "switch\0" "sword\0" "symbol\0" "symptom\0" "syrup\0" "system\0" "table\0"
+    "tackle\0" "tag\0" "tail\0" "talent\0" "talk\0" "tank\0" "tape\0" "target\0"
+    "task\0" "taste\0" "tattoo\0" "taxi\0" "teach\0" "team\0" "tell\0" "ten\0"
+    "tenant\0" "tennis\0" "tent\0" "term\0" "test\0" "text\0" "thank\0" "that\0"
+    "theme\0" "then\0" "theory\0" "there\0" "they\0" "thing\0" "this\0" "thought\0"
+    "three\0" "thrive\0" "throw\0" "thumb\0" "thunder\0" "ticket\0" "tide\0" "tiger\0"
+    "tilt\0" "timber\0" "time\0" "tiny\0" "tip\0" "tired\0" "tissue\0" "title\0"
+    "toast\0" "tobacco\0" "today\0" "toddler\0" "toe\0" "together\0" "toilet\0" "token\0"
+    "tomato\0" "tomorrow\0" "tone\0" "tongue\0" "tonight\0" "tool\0" "tooth\0" "top\0"
+    "topic\0" "topple\0" "torch\0" "tornado\0" "tortoise\0" "toss\0" "total\0" "tourist\0"
+    "toward\0" "tower\0" "town\0" "toy\0" "track\0" "trade\0" "traffic\0" "tragic\0"
+    "train\0" "transfer\0" "trap\0" "trash\0" "travel\0" "tray\0" "treat\0" "tree\0"
+    "trend\0" "trial\0" "tribe\0" "trick\0" "trigger\0" "trim\0" "trip\0" "trophy\0"
+    "trouble\0" "truck\0" "true\0" "truly\0" "trumpet\0" "trust\0" "truth\0" "try\0"
+    "tube\0" "tuition\0" "tumble\0" "tuna\0" "tunnel\0" "turkey\0" "turn\0" "turtle\0"
+    "twelve\0" "twenty\0" "twice\0" "twin\0" "twist\0" "two\0" "type\0" "typical\0"
+    "ugly\0" "umbrella\0" "unable\0" "unaware\0" "uncle\0" "uncover\0" "under\0" "undo\0"
+    "unfair\0" "unfold\0" "unhappy\0" "uniform\0" "unique\0" "unit\0" "universe\0" "unknown\0"
+    "unlock\0" "until\0" "unusual\0" "unveil\0" "update\0" "upgrade\0" "uphold\0" "upon\0"
+    "upper\0" "upset\0" "urban\0" "urge\0" "usage\0" "use\0" "used\0" "useful\0"
+    "useless\0" "usual\0" "utility\0" "vacant\0" "vacuum\0" "vague\0" "valid\0" "valley\0"
+    "valve\0" "van\0" "vanish\0" "vapor\0" "various\0" "vast\0" "vault\0" "vehicle\0"
+    "velvet\0" "vendor\0" "venture\0" "venue\0" "verb\0" "verify\0" "version\0" "very\0"
+    "vessel\0" "veteran\0" "viable\0" "vibrant\0" "vicious\0" "victory\0" "video\0" "view\0"
+    "village\0" "vintage\0" "violin\0" "virtual\0" "virus\0" "visa\0" "visit\0" "visual\0"
+    "vital\0" "vivid\0" "vocal\0" "voice\0" "void\0" "volcano\0" "volume\0" "vote\0"
+    "voyage\0" "wage\0" "wagon\0" "wait\0" "walk\0" "wall\0" "walnut\0" "want\0"
+    "warfare\0" "warm\0" "warrior\0" "wash\0" "wasp\0" "waste\0" "water\0" "wave\0"
+    "way\0" "wealth\0" "weapon\0" "wear\0" "weasel\0" "weather\0" "web\0" "wedding\0"
+    "weekend\0" "weird\0" "welcome\0" "west\0" "wet\0" "whale\0" "what\0" "wheat\0"
+    "wheel\0" "when\0" "where\0" "whip\0" "whisper\0" "wide\0" "width\0" "wife\0"
+    "wild\0" "will\0" "win\0" "window\0" "wine\0" "wing\0" "wink\0" "winner\0"
+    "winter\0" "wire\0" "wisdom\0" "wise\0" "wish\0" "witness\0" "wolf\0" "woman\0"
+    "wonder\0" "wood\0" "wool\0" "word\0" "work\0" "world\0" "worry\0" "worth\0"
+    "wrap\0" "wreck\0" "wrestle\0" "wrist\0" "write\0" "wrong\0" "yard\0" "year\0"
+    "yellow\0" "you\0" "young\0" "youth\0" "zebra\0" "zero\0" "zone\0" "zoo\0"
+    ;
+
+// Offset of each word in bip39_words.
+static uint16_t const bip39_word_offset[2048] = {
+    0, 8, 16, 21, 27, 33, 40, 47, 56, 63,
+    69, 76, 85, 93, 100, 108, 113, 122, 130, 137,
+    141, 148, 154, 162, 169, 175, 179, 186, 194, 201,
+    207, 213, 221, 228, 236, 243, 250, 257, 263, 267,
+    273, 279, 285, 289, 293, 301, 307, 313, 319, 327,
+    333, 339, 343, 349, 355, 362, 368, 374, 382, 387,
+    393, 400, 408, 416, 422, 429, 436, 444, 451, 459,
+    465, 471, 477, 484, 490, 499, 506, 514, 521, 529,
+    537, 545, 549, 555, 563, 570, 576, 584, 590, 595,
+    602, 607, 613, 619, 623, 629, 635, 640, 647, 655,
+    662, 669, 675, 679, 688, 695, 703, 707, 714, 722,
+    728, 735, 742, 749, 757, 762, 769, 776, 785, 793,
+    801, 807, 814, 819, 826, 831, 838, 846, 854, 860,
+    866, 872, 877, 885, 891, 899, 904, 909, 918, 924,
+    930, 934, 942, 950, 955, 962, 969, 976, 980, 987,
+    995, 1002, 1007, 1013, 1020, 1027, 1033, 1038, 1045, 1053,
+    1060, 1065, 1072, 1078, 1085, 1092, 1100, 1106, 1111, 1117,
+    1125, 1130, 1137, 1144, 1152, 1159, 1167, 1171, 1176, 1181,
+    1189, 1194, 1200, 1207, 1213, 1219, 1225, 1233, 1239, 1245,
+    1251, 1257, 1263, 1271, 1278, 1283, 1288, 1294, 1300, 1305,
+    1310, 1315, 1320, 1325, 1331, 1336, 1342, 1349, 1356, 1363,
+    1368, 1375, 1382, 1386, 1390, 1398, 1404, 1410, 1416, 1422,
+    1428, 1435, 1441, 1448, 1454, 1461, 1467, 1473, 1482, 1489,
+    1496, 1502, 1510, 1516, 1522, 1529, 1535, 1542, 1550, 1556,
+    1561, 1566, 1573, 1580, 1587, 1594, 1601, 1607, 1611, 1620,
+    1625, 1632, 1638, 1643, 1651, 1657, 1663, 1670, 1675, 1680,
+    1685, 1690, 1697, 1702, 1706, 1712, 1719, 1725, 1732, 1738,
+    1745, 1752, 1760, 1768, 1776, 1780, 1787, 1792, 1798, 1805,
+    1811, 1816, 1821, 1826, 1833, 1840, 1847, 1851, 1859, 1865,
+    1874, 1881, 1888, 1894, 1902, 1907, 1915, 1922, 1929, 1936,
+    1944, 1951, 1959, 1965, 1971, 1980, 1987, 1993, 2001, 2008,
+    2014, 2019, 2025, 2031, 2038, 2043, 2050, 2056, 2064, 2070,
+    2076, 2084, 2091, 2098, 2106, 2114, 2120, 2126, 2132, 2141,
+    2148, 2156, 2161, 2167, 2173, 2178, 2186, 2191, 2196, 2202,
+    2208, 2215, 2221, 2228, 2234, 2240, 2247, 2252, 2258, 2263,
+    2269, 2275, 2281, 2287, 2292, 2298, 2306, 2313, 2319, 2325,
+    2333, 2338, 2345, 2350, 2355, 2363, 2369, 2376, 2384, 2389,
+    2397, 2403, 2410, 2418, 2426, 2434, 2442, 2451, 2459, 2468,
+    2476, 2485, 2490, 2495, 2502, 2507, 2513, 2518, 2523, 2531,
+    2536, 2543, 2549, 2557, 2564, 2571, 2578, 2584, 2591, 2597,
+    2604, 2610, 2615, 2621, 2627, 2634, 2640, 2646, 2652, 2659,
+    2665, 2670, 2678, 2684, 2690, 2697, 2702, 2708, 2715, 2721,
+    2729, 2735, 2742, 2750, 2757, 2763, 2767, 2775, 2780, 2788,
+    2792, 2801, 2809, 2817, 2825, 2831, 2839, 2846, 2851, 2857,
+    2861, 2868, 2873, 2879, 2886, 2893, 2898, 2907, 2912, 2916,
+    2921, 2928, 2935, 2942, 2951, 2958, 2966, 2975, 2984, 2989,
+    2997, 3004, 3009, 3016, 3022, 3030, 3037, 3044, 3051, 3059,
+    3064, 3071, 3078, 3086, 3092, 3099, 3106, 3115, 3122, 3129,
+    3134, 3142, 3150, 3157, 3164, 3172, 3179, 3186, 3194, 3199,
+    3207, 3213, 3218, 3225, 3230, 3237, 3245, 3253, 3261, 3268,
+    3277, 3284, 3289, 3298, 3307, 3315, 3320, 3328, 3337, 3345,
+    3354, 3361, 3368, 3376, 3382, 3389, 3398, 3402, 3407, 3415,
+    3422, 3429, 3436, 3442, 3447, 3452, 3459, 3464, 3470, 3477,
+    3483, 3491, 3496, 3502, 3508, 3514, 3520, 3526, 3531, 3537,
+    3542, 3547, 3551, 3556, 3561, 3566, 3573, 3578, 3584, 3589,
+    3595, 3603, 3609, 3615, 3621, 3626, 3632, 3639, 3644, 3649,
+    3654, 3662, 3670, 3675, 3680, 3688, 3695, 3699, 3705, 3712,
+    3718, 3724, 3733, 3741, 3749, 3758, 3767, 3773, 3778, 3785,
+    3792, 3800, 3807, 3815, 3822, 3830, 3836, 3843, 3849, 3853,
+    3861, 3869, 3875, 3882, 3890, 3897, 3904, 3912, 3918, 3925,
+    3932, 3939, 3946, 3953, 3959, 3966, 3972, 3981, 3989, 3995,
+    4001, 4005, 4011, 4017, 4025, 4031, 4037, 4044, 4050, 4058,
+    4065, 4073, 4080, 4089, 4094, 4100, 4107, 4113, 4121, 4128,
+    4137, 4144, 4152, 4159, 4167, 4176, 4184, 4192, 4198, 4204,
+    4209, 4216, 4223, 4230, 4237, 4245, 4252, 4260, 4267, 4273,
+    4277, 4285, 4292, 4297, 4305, 4310, 4316, 4322, 4327, 4333,
+    4338, 4345, 4352, 4356, 4362, 4370, 4375, 4383, 4387, 4393,
+    4400, 4408, 4414, 4423, 4431, 4440, 4448, 4452, 4457, 4462,
+    4469, 4475, 4484, 4490, 4496, 4500, 4506, 4514, 4520, 4527,
+    4532, 4537, 4544, 4550, 4555, 4560, 4567, 4574, 4579, 4584,
+    4590, 4597, 4602, 4606, 4614, 4618, 4623, 4629, 4635, 4640,
+    4647, 4652, 4659, 4664, 4670, 4676, 4682, 4689, 4695, 4701,
+    4705, 4710, 4716, 4720, 4725, 4730, 4737, 4742, 4747, 4753,
+    4760, 4767, 4772, 4780, 4786, 4794, 4801, 4808, 4814, 4818,
+    4826, 4832, 4841, 4847, 4854, 4861, 4866, 4872, 4878, 4884,
+    4891, 4897, 4902, 4906, 4912, 4920, 4925, 4932, 4939, 4944,
+    4951, 4959, 4964, 4968, 4975, 4983, 4990, 4997, 5005, 5009,
+    5014, 5019, 5026, 5032, 5037, 5045, 5052, 5058, 5065, 5073,
+    5081, 5087, 5093, 5098, 5105, 5112, 5120, 5125, 5130, 5135,
+    5142, 5148, 5154, 5160, 5168, 5174, 5180, 5186, 5192, 5197,
+    5202, 5207, 5215, 5220, 5225, 5231, 5239, 5246, 5253, 5260,
+    5265, 5270, 5276, 5282, 5288, 5294, 5300, 5308, 5314, 5320,
+    5325, 5331, 5336, 5344, 5350, 5355, 5361, 5367, 5373, 5379,
+    5385, 5392, 5396, 5400, 5406, 5411, 5416, 5423, 5431, 5436,
+    5442, 5449, 5454, 5460, 5468, 5472, 5477, 5482, 5489, 5494,
+    5501, 5507, 5513, 5522, 5529, 5535, 5542, 5547, 5551, 5556,
+    5563, 5568, 5573, 5578, 5582, 5587, 5595, 5601, 5608, 5613,
+    5618, 5626, 5633, 5638, 5644, 5649, 5654, 5659, 5666, 5672,
+    5681, 5686, 5692, 5697, 5703, 5707, 5712, 5718, 5725, 5731,
+    5739, 5746, 5751, 5758, 5764, 5769, 5777, 5784, 5788, 5793,
+    5798, 5807, 5812, 5819, 5823, 5831, 5839, 5845, 5853, 5861,
+    5868, 5875, 5882, 5890, 5898, 5903, 5911, 5918, 5927, 5933,
+    5942, 5949, 5958, 5965, 5973, 5980, 5987, 5995, 6003, 6010,
+    6017, 6024, 6030, 6039, 6045, 6053, 6060, 6067, 6074, 6082,
+    6090, 6097, 6106, 6111, 6118, 6125, 6133, 6138, 6145, 6153,
+    6159, 6164, 6170, 6177, 6184, 6188, 6193, 6201, 6207, 6213,
+    6219, 6223, 6228, 6233, 6241, 6245, 6251, 6257, 6262, 6269,
+    6276, 6281, 6286, 6295, 6300, 6305, 6313, 6317, 6322, 6326,
+    6333, 6338, 6346, 6351, 6355, 6363, 6368, 6375, 6380, 6385,
+    6391, 6397, 6402, 6406, 6412, 6418, 6425, 6430, 6435, 6440,
+    6449, 6456, 6462, 6468, 6474, 6480, 6488, 6493, 6497, 6502,
+    6510, 6516, 6521, 6528, 6533, 6539, 6545, 6553, 6558, 6562,
+    6568, 6575, 6583, 6589, 6594, 6601, 6606, 6614, 6621, 6628,
+    6634, 6639, 6647, 6655, 6663, 6668, 6673, 6679, 6684, 6689,
+    6695, 6700, 6705, 6712, 6717, 6724, 6729, 6736, 6741, 6746,
+    6754, 6760, 6765, 6771, 6778, 6783, 6788, 6796, 6801, 6808,
+    6813, 6819, 6825, 6833, 6840, 6846, 6852, 6859, 6866, 6874,
+    6878, 6884, 6891, 6896, 6901, 6906, 6912, 6917, 6924, 6928,
+    6935, 6943, 6949, 6957, 6964, 6970, 6977, 6983, 6990, 6997,
+    7004, 7013, 7018, 7023, 7030, 7036, 7045, 7050, 7057, 7064,
+    7072, 7077, 7084, 7089, 7097, 7102, 7111, 7117, 7123, 7130,
+    7135, 7142, 7149, 7157, 7162, 7168, 7174, 7180, 7186, 7191,
+    7199, 7205, 7212, 7219, 7228, 7233, 7241, 7247, 7252, 7260,
+    7266, 7273, 7281, 7288, 7295, 7300, 7308, 7312, 7318, 7326,
+    7333, 7339, 7346, 7350, 7357, 7365, 7372, 7380, 7386, 7391,
+    7397, 7402, 7410, 7419, 7426, 7433, 7439, 7448, 7454, 7459,
+    7465, 7470, 7477, 7482, 7491, 7498, 7505, 7514, 7520, 7525,
+    7532, 7539, 7547, 7552, 7558, 7563, 7570, 7577, 7583, 7590,
+    7597, 7602, 7607, 7612, 7621, 7629, 7637, 7644, 7650, 7655,
+    7659, 7667, 7675, 7681, 7686, 7691, 7696, 7702, 7708, 7714,
+    7722, 7729, 7736, 7742, 7747, 7755, 7760, 7768, 7775, 7781,
+    7785, 7793, 7800, 7806, 7810, 7814, 7819, 7826, 7833, 7841,
+    7849, 7856, 7864, 7870, 7876, 7884, 7889, 7893, 7899, 7906,
+    7912, 7916, 7921, 7925, 7931, 7939, 7944, 7949, 7953, 7959,
+    7966, 7971, 7976, 7982, 7990, 7997, 8004, 8011, 8017, 8025,
+    8031, 8040, 8046, 8053, 8062, 8069, 8077, 8083, 8091, 8097,
+    8104, 8112, 8117, 8122, 8127, 8131, 8137, 8144, 8151, 8157,
+    8162, 8169, 8174, 8179, 8186, 8191, 8197, 8203, 8209, 8217,
+    8223, 8230, 8237, 8242, 8249, 8255, 8260, 8266, 8271, 8279,
+    8286, 8294, 8300, 8305, 8313, 8319, 8326, 8331, 8339, 8347,
+    8351, 8359, 8366, 8373, 8380, 8388, 8395, 8402, 8406, 8412,
+    8418, 8425, 8434, 8440, 8447, 8455, 8461, 8465, 8472, 8477,
+    8483, 8488, 8496, 8501, 8508, 8514, 8520, 8526, 8533, 8541,
+    8547, 8552, 8559, 8566, 8572, 8577, 8584, 8589, 8594, 8600,
+    8606, 8611, 8618, 8623, 8628, 8633, 8641, 8649, 8658, 8667,
+    8672, 8679, 8687, 8695, 8702, 8708, 8717, 8724, 8732, 8739,
+    8747, 8755, 8762, 8770, 8776, 8782, 8790, 8796, 8805, 8812,
+    8820, 8826, 8834, 8842, 8850, 8857, 8865, 8873, 8881, 8887,
+    8896, 8904, 8912, 8918, 8926, 8933, 8941, 8946, 8951, 8957,
+    8965, 8971, 8977, 8983, 8992, 8999, 9007, 9013, 9018, 9022,
+    9029, 9037, 9045, 9053, 9061, 9070, 9076, 9081, 9086, 9092,
+    9099, 9107, 9112, 9117, 9123, 9129, 9134, 9139, 9145, 9151,
+    9156, 9162, 9169, 9175, 9181, 9186, 9191, 9198, 9204, 9208,
+    9214, 9220, 9225, 9232, 9238, 9246, 9253, 9261, 9268, 9275,
+    9283, 9290, 9298, 9305, 9312, 9319, 9326, 9334, 9341, 9347,
+    9355, 9362, 9367, 9374, 9383, 9390, 9397, 9404, 9410, 9415,
+    9422, 9429, 9436, 9444, 9451, 9459, 9466, 9475, 9482, 9491,
+    9500, 9507, 9514, 9522, 9529, 9537, 9544, 9551, 9558, 9565,
+    9569, 9576, 9581, 9586, 9591, 9597, 9603, 9609, 9615, 9620,
+    9625, 9632, 9637, 9644, 9650, 9656, 9661, 9667, 9673, 9680,
+    9687, 9695, 9700, 9707, 9712, 9717, 9724, 9730, 9736, 9742,
+    9748, 9755, 9760, 9764, 9769, 9773, 9780, 9786, 9790, 9797,
+    9805, 9810, 9815, 9821, 9828, 9834, 9839, 9846, 9851, 9858,
+    9863, 9871, 9879, 9885, 9893, 9898, 9902, 9908, 9913, 9919,
+    9927, 9933, 9940, 9947, 9955, 9964, 9973, 9979, 9985, 9992,
+    9999, 10005, 10009, 10016, 10023, 10028, 10035, 10042, 10050, 10059,
+    10064, 10069, 10077, 10084, 10089, 10097, 10104, 10110, 10119, 10126,
+    10134, 10142, 10149, 10155, 10161, 10168, 10174, 10182, 10188, 10193,
+    10199, 10207, 10214, 10220, 10226, 10231, 10238, 10244, 10249, 10255,
+    10260, 10266, 10275, 10281, 10288, 10294, 10302, 10306, 10314, 10319,
+    10324, 10330, 10336, 10341, 10348, 10353, 10359, 10366, 10374, 10381,
+    10387, 10392, 10398, 10405, 10413, 10417, 10422, 10428, 10435, 10439,
+    10445, 10450, 10456, 10462, 10467, 10472, 10478, 10486, 10492, 10498,
+    10505, 10510, 10517, 10522, 10527, 10533, 10539, 10545, 10551, 10557,
+    10564, 10570, 10576, 10581, 10587, 10592, 10597, 10604, 10611, 10616,
+    10621, 10626, 10632, 10640, 10646, 10655, 10661, 10669, 10674, 10679,
+    10685, 10690, 10695, 10701, 10706, 10713, 10719, 10725, 10731, 10739,
+    10745, 10751, 10759, 10765, 10771, 10777, 10784, 10790, 10797, 10803,
+    10808, 10815, 10821, 10827, 10835, 10841, 10847, 10852, 10858, 10865,
+    10872, 10876, 10883, 10891, 10900, 10907, 10915, 10921, 10927, 10934,
+    10940, 10946, 10952, 10958, 10963, 10969, 10975, 10980, 10985, 10992,
+    10998, 11004, 11010, 11016, 11024, 11030, 11036, 11042, 11048, 11057,
+    11064, 11071, 11078, 11087, 11095, 11101, 11109, 11115, 11123, 11130,
+    11137, 11145, 11150, 11157, 11164, 11170, 11178, 11183, 11190, 11194,
+    11200, 11207, 11213, 11220, 11228, 11233, 11241, 11247, 11256, 11265,
+    11272, 11280, 11288, 11296, 11302, 11307, 11313, 11319, 11325, 11331,
+    11336, 11342, 11349, 11355, 11362, 11370, 11376, 11383, 11389, 11396,
+    11400, 11405, 11412, 11417, 11422, 11427, 11434, 11439, 11445, 11452,
+    11457, 11463, 11468, 11473, 11477, 11484, 11491, 11496, 11501, 11506,
+    11511, 11517, 11522, 11528, 11533, 11540, 11546, 11551, 11557, 11562,
+    11570, 11576, 11583, 11589, 11595, 11603, 11610, 11615, 11621, 11626,
+    11633, 11638, 11643, 11647, 11653, 11660, 11666, 11672, 11680, 11686,
+    11694, 11698, 11707, 11714, 11720, 11727, 11736, 11741, 11748, 11756,
+    11761, 11767, 11771, 11777, 11784, 11790, 11798, 11807, 11812, 11818,
+    11826, 11833, 11839, 11844, 11848, 11854, 11860, 11868, 11875, 11881,
+    11890, 11895, 11901, 11908, 11913, 11919, 11924, 11930, 11936, 11942,
+    11948, 11956, 11961, 11966, 11973, 11981, 11987, 11992, 11998, 12006,
+    12012, 12018, 12022, 12027, 12035, 12042, 12047, 12054, 12061, 12066,
+    12073, 12080, 12087, 12093, 12098, 12104, 12108, 12113, 12121, 12126,
+    12135, 12142, 12150, 12156, 12164, 12170, 12175, 12182, 12189, 12197,
+    12205, 12212, 12217, 12226, 12234, 12241, 12247, 12255, 12262, 12269,
+    12277, 12284, 12289, 12295, 12301, 12307, 12312, 12318, 12322, 12327,
+    12334, 12342, 12348, 12356, 12363, 12370, 12376, 12382, 12389, 12395,
+    12399, 12406, 12412, 12420, 12425, 12431, 12439, 12446, 12453, 12461,
+    12467, 12472, 12479, 12487, 12492, 12499, 12507, 12514, 12522, 12530,
+    12538, 12544, 12549, 12557, 12565, 12572, 12580, 12586, 12591, 12597,
+    12604, 12610, 12616, 12622, 12628, 12633, 12641, 12648, 12653, 12660,
+    12665, 12671, 12676, 12681, 12686, 12693, 12698, 12706, 12711, 12719,
+    12724, 12729, 12735, 12741, 12746, 12750, 12757, 12764, 12769, 12776,
+    12784, 12788, 12796, 12804, 12810, 12818, 12823, 12827, 12833, 12838,
+    12844, 12850, 12855, 12861, 12866, 12874, 12879, 12885, 12890, 12895,
+    12900, 12904, 12911, 12916, 12921, 12926, 12933, 12940, 12945, 12952,
+    12957, 12962, 12970, 12975, 12981, 12988, 12993, 12998, 13003, 13008,
+    13014, 13020, 13026, 13031, 13037, 13045, 13051, 13057, 13063, 13068,
+    13073, 13080, 13084, 13090, 13096, 13102, 13107, 13112,
+};
+
+#endif // BIP39WORDS_H
@@ -0,0 +1,24 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#ifndef CEREMONY_H
+#define CEREMONY_H
+
+#include "network.h"
+
+// Are these dice rolls and a threshold and share count SSKR accepts?
+bool ceremony_valid_args(String const & rolls, uint8_t thresh, uint8_t nshares);
+
+/**
+ * One seed -> BIP39 -> BIP32 -> SSKR -> UR pipeline, through the same
+ * code paths as the UI, for acceptance tests and test vectors.  All
+ * state is local to the call: the keys are in a Keystore of its own
+ * and the SSKR randomness comes from a DRBG seeded with the seed, so
+ * the output only depends on the arguments.
+ *
+ * Writes a single NDJSON line (without the newline) to o_line.
+ * Returns false if rolls isn't dice rolls or a step fails.
+ */
+bool ceremony_run(String const & rolls, NetwtorkType network,
+                  uint8_t thresh, uint8_t nshares, String & o_line);
+
+#endif // CEREMONY_H
@@ -0,0 +1,107 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#include "ceremony.h"
+#include "entropy.h"
+#include "keystore.h"
+#include "seed.h"
+#include "ur.h"
+#include "util.h"
+
+namespace ceremony_internal {
+
+void append_hex(String & out, uint8_t const * data, size_t len) {
+    char hex[3];
+    for (size_t ii = 0; ii < len; ++ii) {
+        snprintf(hex, sizeof(hex), "%02x", data[ii]);
+        out += hex;
+    }
+}
+
+// The values are hex, base58, bytewords or URs, none need escaping.
+void append_field(String & out, char const * name, String const & value) {
+    out += out.length() > 1 ? ",\"" : "\"";
+    out += name;
+    out += "\":\"";
+    out += value;
+    out += "\"";
+}
+
+} // namespace ceremony_internal
+
+bool ceremony_valid_args(String const & rolls, uint8_t thresh, uint8_t nshares) {
+    if (rolls.length() == 0 ||
+        thresh < 1 || thresh > nshares || nshares > SSKRShareSeq::MAX_SHARES)
+        return false;
+    for (size_t ii = 0; ii < rolls.length(); ++ii) {
+        if (rolls[ii] < '1' || rolls[ii] > '6')
+            return false;
+    }
+    return true;
+}
+
+bool ceremony_run(String const & rolls, NetwtorkType network,
+                  uint8_t thresh, uint8_t nshares, String & o_line) {
+    using namespace ceremony_internal;
+
+    if (!ceremony_valid_args(rolls, thresh, nshares))
+        return false;
+
+    Seed * seed = Seed::from_rolls(rolls);
+    BIP39Seq * bip39 = new BIP39Seq(seed);	// a couple of seconds
+    Keystore * ks = new Keystore(network);
+
+    bool ok = ks->update_root_key(bip39->mnemonic_seed, BIP39_SEED_LEN_512);
+
+    ext_key key;
+    char * xpub = NULL;
+    ok = ok && ks->get_xpriv(&key) && ks->xpub_to_base58(&key, &xpub, false);
+
+    String ur_seed;
+    String ur_xpub;
+    ok = ok && ur_encode_crypto_seed(seed->data, sizeof(seed->data), ur_seed) &&
+        ur_encode_hd_pubkey_xpub(*ks, ur_xpub, ks->derivation, ks->derivationLen);
+
+    // Shares from a DRBG seeded with the seed, so the same rolls give
+    // the same shares.
+    HmacDrbg drbg;
+    drbg_init(drbg, seed->data, sizeof(seed->data));
+    SSKRShareSeq * sskr = NULL;
+    if (ok)
+        sskr = SSKRShareSeq::from_seed(seed, thresh, nshares, random_buffer, &drbg);
+    ok = ok && sskr;
+
+    if (ok) {
+        String hex;
+        o_line = "{";
+        append_field(o_line, "rolls", rolls);
+        append_hex(hex, seed->data, sizeof(seed->data));
+        append_field(o_line, "seed", hex);
+        wipe_string(hex);
+        append_field(o_line, "ur_seed", ur_seed);
+        append_field(o_line, "bip39", bip39->get_mnemonic_as_string());
+        char fingerprint[9];
+        snprintf(fingerprint, sizeof(fingerprint), "%08x", (unsigned int) ks->fingerprint);
+        append_field(o_line, "fingerprint", fingerprint);
+        append_field(o_line, "path", ks->get_derivation_path());
+        append_field(o_line, "xpub", xpub);
+        append_field(o_line, "ur_xpub", ur_xpub);
+        o_line += ",\"sskr\":[";
+        for (size_t ii = 0; ii < sskr->numshares(); ++ii) {
+            o_line += ii ? ",\"" : "\"";
+            o_line += sskr->get_share_ur(ii);
+            o_line += "\"";
+        }
+        o_line += "]}";
+    }
+
+    wipe_string(ur_seed);
+    if (xpub)
+        wally_free_string(xpub);
+    memzero(&key, sizeof(key));
+    memzero(&drbg, sizeof(drbg));
+    delete sskr;
+    delete ks;
+    delete bip39;
+    delete seed;
+    return ok;
+}
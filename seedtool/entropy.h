@@ -0,0 +1,47 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#ifndef ENTROPY_H
+#define ENTROPY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <bc-crypto-base.h>
+
+// HMAC-DRBG with SHA-256 (NIST SP 800-90A), without prediction
+// resistance or additional input.
+struct HmacDrbg {
+    uint8_t key[SHA256_DIGEST_LENGTH];
+    uint8_t value[SHA256_DIGEST_LENGTH];
+    uint32_t reseed_counter;
+};
+
+void drbg_init(HmacDrbg & drbg, uint8_t const * seed, size_t len);
+void drbg_reseed(HmacDrbg & drbg, uint8_t const * seed, size_t len);
+void drbg_generate(HmacDrbg & drbg, uint8_t * out, size_t len);
+
+/**
+ * The TRNG samples go through the SP 800-90B repetition count and
+ * adaptive proportion tests into a pool, which is filled by a
+ * background task and reseeds the DRBG random requests are served
+ * from.  A failed health test is latched, random requests then halt
+ * rather than return bad randomness.
+ */
+void entropy_setup();
+
+// False once the TRNG failed a health test.
+bool entropy_healthy();
+
+// Runs samples through the health tests from a fresh state, without
+// touching the TRNG's.  False if any sample fails, for testing.
+bool entropy_health_check(uint8_t const * samples, size_t len);
+
+// Serves random requests from a DRBG seeded with seed instead of the
+// TRNG, for reproducible tests.  NULL goes back to the TRNG.
+void entropy_set_deterministic(uint8_t const * seed, size_t len);
+
+extern "C" {
+// Random bytes from the pool's DRBG, or from the HmacDrbg p points to.
+void random_buffer(uint8_t *buf, size_t len, void * p = NULL);
+}
+
+#endif // ENTROPY_H
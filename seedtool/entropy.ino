@@ -0,0 +1,222 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#include "entropy.h"
+#include "hardware.h"
+#include "log.h"
+#include "scheduler.h"
+#include "util.h"
+
+namespace entropy_internal {
+
+// Health test parameters for 8 bit samples, assuming (conservatively
+// for the SAMD51 TRNG) 4 bits of min-entropy per sample and a false
+// alarm rate of 2^-20, see SP 800-90B 4.4.
+size_t const RCT_CUTOFF = 6;		// 1 + ceil(20 / 4)
+size_t const APT_WINDOW = 512;
+size_t const APT_CUTOFF = 62;		// 1 + CRITBINOM(512, 2^-4, 1 - 2^-20)
+size_t const STARTUP_SAMPLES = 1024;
+
+// 64 samples of 4 bits each reseed the DRBG with 256 bits.
+size_t const POOL_SIZE = 64;
+// Reseed from the pool as soon as it's full, wait for it after this
+// many requests.
+uint32_t const RESEED_INTERVAL = 1024;
+
+uint8_t g_pool[POOL_SIZE];
+size_t g_pool_fill = 0;
+int g_fill_task = -1;
+
+bool g_healthy = true;
+bool g_deterministic = false;
+HmacDrbg g_drbg;
+
+struct HealthState {
+    uint8_t rct_sample;
+    size_t rct_count;
+    uint8_t apt_sample;
+    size_t apt_count;
+    size_t apt_seen;
+};
+
+HealthState g_health = { 0, 0, 0, 0, 0 };
+
+// Returns false if sample fails a health test.
+bool health_test(HealthState & hs, uint8_t sample) {
+    bool ok = true;
+
+    // Repetition count test
+    if (hs.rct_count > 0 && sample == hs.rct_sample) {
+        if (++hs.rct_count >= RCT_CUTOFF)
+            ok = false;
+    } else {
+        hs.rct_sample = sample;
+        hs.rct_count = 1;
+    }
+
+    // Adaptive proportion test
+    if (hs.apt_seen == 0) {
+        hs.apt_sample = sample;
+        hs.apt_count = 1;
+    } else if (sample == hs.apt_sample) {
+        if (++hs.apt_count >= APT_CUTOFF)
+            ok = false;
+    }
+    if (++hs.apt_seen == APT_WINDOW)
+        hs.apt_seen = 0;
+    return ok;
+}
+
+// Reads a TRNG word into the pool, if it isn't full.
+void pool_add_word() {
+    uint8_t word[4];
+    hw_random_buffer(word, sizeof(word));
+    for (size_t ii = 0; ii < sizeof(word); ++ii) {
+        if (!health_test(g_health, word[ii]))
+            g_healthy = false;
+        if (g_pool_fill < POOL_SIZE)
+            g_pool[g_pool_fill++] = word[ii];
+    }
+    memzero(word, sizeof(word));
+}
+
+bool pool_fill_step(void *ctx) {
+    (void) ctx;
+    for (size_t ii = 0; ii < 4 && g_pool_fill < POOL_SIZE; ++ii)
+        pool_add_word();
+    return g_pool_fill == POOL_SIZE;
+}
+
+void pool_fill_start() {
+    // The UI cancels background tasks when it changes state.
+    if (g_pool_fill < POOL_SIZE && !sched_active(g_fill_task))
+        g_fill_task = sched_add(pool_fill_step, NULL, SCHED_PRIO_IDLE);
+}
+
+void pool_reseed() {
+    if (g_deterministic)
+        return;
+    while (g_pool_fill < POOL_SIZE)
+        pool_add_word();
+    serial_assert(g_healthy);
+    drbg_reseed(g_drbg, g_pool, POOL_SIZE);
+    memzero(g_pool, sizeof(g_pool));
+    g_pool_fill = 0;
+    pool_fill_start();
+}
+
+// HMAC(K, V || sep || seed), without sep if it's negative.
+void hmac(HmacDrbg const & drbg, int sep, uint8_t const * seed, size_t len,
+          uint8_t * out) {
+    HMAC_SHA256_CTX ctx;
+    hmac_sha256_Init(&ctx, drbg.key, sizeof(drbg.key));
+    hmac_sha256_Update(&ctx, drbg.value, sizeof(drbg.value));
+    if (sep >= 0) {
+        uint8_t byte = sep;
+        hmac_sha256_Update(&ctx, &byte, 1);
+    }
+    if (len)
+        hmac_sha256_Update(&ctx, seed, len);
+    hmac_sha256_Final(&ctx, out);
+    memzero(&ctx, sizeof(ctx));
+}
+
+// HMAC_DRBG_Update
+void drbg_update(HmacDrbg & drbg, uint8_t const * seed, size_t len) {
+    for (int sep = 0x00; sep <= 0x01; ++sep) {
+        hmac(drbg, sep, seed, len, drbg.key);
+        hmac(drbg, -1, NULL, 0, drbg.value);
+        if (len == 0)
+            break;
+    }
+}
+
+} // namespace entropy_internal
+
+void drbg_init(HmacDrbg & drbg, uint8_t const * seed, size_t len) {
+    using namespace entropy_internal;
+    memset(drbg.key, 0x00, sizeof(drbg.key));
+    memset(drbg.value, 0x01, sizeof(drbg.value));
+    drbg_update(drbg, seed, len);
+    drbg.reseed_counter = 1;
+}
+
+void drbg_reseed(HmacDrbg & drbg, uint8_t const * seed, size_t len) {
+    using namespace entropy_internal;
+    drbg_update(drbg, seed, len);
+    drbg.reseed_counter = 1;
+}
+
+void drbg_generate(HmacDrbg & drbg, uint8_t * out, size_t len) {
+    using namespace entropy_internal;
+    while (len > 0) {
+        hmac(drbg, -1, NULL, 0, drbg.value);
+        size_t nn = len < sizeof(drbg.value) ? len : sizeof(drbg.value);
+        memcpy(out, drbg.value, nn);
+        out += nn;
+        len -= nn;
+    }
+    drbg_update(drbg, NULL, 0);
+    ++drbg.reseed_counter;
+}
+
+void entropy_setup() {
+    using namespace entropy_internal;
+    // Startup health test, the samples are discarded.
+    for (size_t ii = 0; ii < STARTUP_SAMPLES / 4; ++ii)
+        pool_add_word();
+    memzero(g_pool, sizeof(g_pool));
+    g_pool_fill = 0;
+
+    while (g_pool_fill < POOL_SIZE)
+        pool_add_word();
+    if (!g_healthy)
+        LOG_ERROR("entropy_setup: TRNG failed startup health test\n");
+    drbg_init(g_drbg, g_pool, POOL_SIZE);
+    memzero(g_pool, sizeof(g_pool));
+    g_pool_fill = 0;
+    pool_fill_start();
+}
+
+bool entropy_healthy() {
+    using namespace entropy_internal;
+    return g_healthy;
+}
+
+bool entropy_health_check(uint8_t const * samples, size_t len) {
+    using namespace entropy_internal;
+    HealthState hs = { 0, 0, 0, 0, 0 };
+    bool ok = true;
+    for (size_t ii = 0; ii < len; ++ii)
+        ok = health_test(hs, samples[ii]) && ok;
+    return ok;
+}
+
+void entropy_set_deterministic(uint8_t const * seed, size_t len) {
+    using namespace entropy_internal;
+    g_deterministic = seed != NULL;
+    if (g_deterministic)
+        drbg_init(g_drbg, seed, len);
+    else
+        pool_reseed();
+}
+
+extern "C" {
+
+void random_buffer(uint8_t *buf, size_t len, void * p) {
+    using namespace entropy_internal;
+    if (p) {
+        drbg_generate(*(HmacDrbg *) p, buf, len);
+        return;
+    }
+    if (!g_deterministic) {
+        // Never hand out randomness from a failing TRNG.
+        serial_assert(g_healthy);
+        if (g_pool_fill == POOL_SIZE || g_drbg.reseed_counter > RESEED_INTERVAL)
+            pool_reseed();
+        else
+            pool_fill_start();
+    }
+    drbg_generate(g_drbg, buf, len);
+}
+
+} // extern "C"
@@ -0,0 +1,56 @@
+#!/bin/bash
+
+# Generates bip39words.h, the BIP39 English wordlist as const tables
+# kept in flash, from english.txt of the BIP39 repository:
+#
+#   ./gen-bip39-words.sh path/to/english.txt > bip39words.h
+#
+# The wordlist is checked against its well known SHA256 first.
+
+set -e
+
+WORDLIST=${1:?usage: $0 english.txt}
+SHA256=2f5eed53a4727b4bf8880d8f3f199efc90e58503646d9ff8eff3a2ed3b24dbda
+
+if [ "$(sha256sum < "$WORDLIST" | cut -d' ' -f1)" != "$SHA256" ]; then
+    echo "$0: $WORDLIST is not the BIP39 English wordlist" >&2
+    exit 1
+fi
+
+cat <<EOF
+// Copyright © 2020 Blockchain Commons, LLC
+
+// Generated by gen-bip39-words.sh from the BIP39 english.txt, don't edit.
+
+#ifndef BIP39WORDS_H
+#define BIP39WORDS_H
+
+#include <stdint.h>
+
+// The 2048 BIP39 words, NUL separated.
+static char const bip39_words[] =
+EOF
+
+awk '
+    { line = line sprintf(" \"%s\\0\"", $1) }
+    NR % 8 == 0 { print "   " line; line = "" }
+    END { if (line != "") print "   " line; print "    ;" }
+' "$WORDLIST"
+
+cat <<EOF
+
+// Offset of each word in bip39_words.
+static uint16_t const bip39_word_offset[2048] = {
+EOF
+
+awk '
+    { line = line sprintf(" %d,", off); off += length($1) + 1 }
+    NR % 10 == 0 { print "   " line; line = "" }
+    END { if (line != "") print "   " line }
+' "$WORDLIST"
+
+cat <<EOF
+};
+
+#endif // BIP39WORDS_H
+EOF
@@ -0,0 +1,71 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#ifndef GF256_H
+#define GF256_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// With GF256_BITSLICED the arithmetic is table free and constant
+// time: vectors of up to 32 bytes are held as 8 bit planes and
+// multiplied a whole vector at a time, and SSKRShareSeqT splits and
+// recovers single group share sets with it instead of bc-shamir (see
+// seed.ino).  Set it to 0 for the log/exp table version, which
+// indexes tables with secret data, and bc-sskr for all SSKR.
+#ifndef GF256_BITSLICED
+#define GF256_BITSLICED 1
+#endif
+
+// Arithmetic in GF(2^8) modulo x^8 + x^4 + x^3 + x + 1, the field
+// bc-shamir splits secrets in.  Addition and subtraction are xor.
+uint8_t gf256_mul(uint8_t aa, uint8_t bb);
+uint8_t gf256_inv(uint8_t aa);	// aa must not be 0
+
+// The value at xx of the polynomial through the npoints points (xs[i],
+// ys[i]), each y a vector of len bytes.  Lagrange form, as bc-shamir's
+// interpolate(): the coefficients only depend on the x coordinates and
+// each y vector is scaled and added a whole vector at a time.  The x
+// coordinates must be distinct.
+void gf256_interpolate(size_t npoints, uint8_t const * xs,
+                       uint8_t const * const * ys, size_t len,
+                       uint8_t xx, uint8_t * o_yy);
+
+/**
+ * Newton form interpolation of byte vectors, byte by byte.  Points
+ * are pushed and popped last-in first-out and pushing a point costs
+ * one row of divided differences.  Interpolating subsets that share a
+ * prefix of points, e.g. walking all subsets depth first, reuses the
+ * work done for the prefix.
+ */
+class GF256Newton {
+public:
+    static size_t const MAX_POINTS = 16;
+    static size_t const MAX_LEN = 32;
+
+    explicit GF256Newton(size_t i_len);
+    ~GF256Newton();	// wipes the points, they are shares of a secret
+
+    size_t numpoints() const { return npoints; }
+
+    // The x coordinates must be distinct.
+    void push(uint8_t xx, uint8_t const * yy);
+    void pop();
+
+    // Value at xx of the polynomial through the points.
+    void eval(uint8_t xx, uint8_t * o_yy) const;
+    // Just byte ndx of the value.
+    uint8_t eval_byte(uint8_t xx, size_t ndx) const;
+
+private:
+    size_t len;
+    size_t npoints;
+    uint8_t xs[MAX_POINTS];
+    // dd[k][j] is f[x_j, .., x_k], dd[k][0] the k-th Newton coefficient.
+#if GF256_BITSLICED
+    uint32_t dd[MAX_POINTS][MAX_POINTS][8];	// bit planes
+#else
+    uint8_t dd[MAX_POINTS][MAX_POINTS][MAX_LEN];
+#endif
+};
+
+#endif // GF256_H
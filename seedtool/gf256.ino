@@ -0,0 +1,324 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#include <bc-crypto-base.h>
+
+#include "gf256.h"
+#include "util.h"
+
+namespace gf256_internal {
+
+#if GF256_BITSLICED
+
+// Plane ii holds bit ii of each byte, byte bb is lane bb.
+void slice(uint32_t * o_planes, uint8_t const * bytes, size_t len) {
+    for (size_t ii = 0; ii < 8; ++ii)
+        o_planes[ii] = 0;
+    for (size_t bb = 0; bb < len; ++bb) {
+        for (size_t ii = 0; ii < 8; ++ii)
+            o_planes[ii] |= (uint32_t) ((bytes[bb] >> ii) & 1) << bb;
+    }
+}
+
+// Byte bb of the planes.
+uint8_t lane(uint32_t const * planes, size_t bb) {
+    uint8_t byte = 0;
+    for (size_t ii = 0; ii < 8; ++ii)
+        byte |= ((planes[ii] >> bb) & 1) << ii;
+    return byte;
+}
+
+void unslice(uint8_t * o_bytes, uint32_t const * planes, size_t len) {
+    for (size_t bb = 0; bb < len; ++bb)
+        o_bytes[bb] = lane(planes, bb);
+}
+
+// The same byte in every lane.
+void broadcast(uint32_t * o_planes, uint8_t byte) {
+    for (size_t ii = 0; ii < 8; ++ii)
+        o_planes[ii] = -(uint32_t) ((byte >> ii) & 1);
+}
+
+// o_rr may alias aa or bb.
+void mul(uint32_t * o_rr, uint32_t const * aa, uint32_t const * bb) {
+    uint32_t tt[15] = { 0 };
+    for (size_t ii = 0; ii < 8; ++ii) {
+        for (size_t jj = 0; jj < 8; ++jj)
+            tt[ii + jj] ^= aa[ii] & bb[jj];
+    }
+    // x^8 = x^4 + x^3 + x + 1
+    for (size_t kk = 14; kk >= 8; --kk) {
+        tt[kk - 4] ^= tt[kk];
+        tt[kk - 5] ^= tt[kk];
+        tt[kk - 7] ^= tt[kk];
+        tt[kk - 8] ^= tt[kk];
+    }
+    for (size_t ii = 0; ii < 8; ++ii)
+        o_rr[ii] = tt[ii];
+}
+
+#else
+
+// Powers and logarithms of the generator 3, built on first use.
+uint8_t g_exp[255 * 2];
+uint8_t g_log[256];
+bool g_tables_ready = false;
+
+void build_tables() {
+    uint8_t vv = 1;
+    for (size_t ii = 0; ii < 255; ++ii) {
+        g_exp[ii] = g_exp[ii + 255] = vv;
+        g_log[vv] = ii;
+        // vv *= 3
+        vv ^= (vv << 1) ^ ((vv & 0x80) ? 0x1b : 0);
+    }
+    g_tables_ready = true;
+}
+
+#endif // GF256_BITSLICED
+
+} // namespace gf256_internal
+
+#if GF256_BITSLICED
+
+// Shift and add, without branching on the operands.
+uint8_t gf256_mul(uint8_t aa, uint8_t bb) {
+    uint8_t rr = 0;
+    for (size_t ii = 0; ii < 8; ++ii) {
+        rr ^= -(bb & 1) & aa;
+        bb >>= 1;
+        aa = (aa << 1) ^ (-(aa >> 7) & 0x1b);
+    }
+    return rr;
+}
+
+// aa^254
+uint8_t gf256_inv(uint8_t aa) {
+    serial_assert(aa != 0);
+    uint8_t pp = gf256_mul(aa, aa);	// aa^(2^ii)
+    uint8_t rr = pp;
+    for (size_t ii = 2; ii < 8; ++ii) {
+        pp = gf256_mul(pp, pp);
+        rr = gf256_mul(rr, pp);
+    }
+    return rr;
+}
+
+#else
+
+uint8_t gf256_mul(uint8_t aa, uint8_t bb) {
+    using namespace gf256_internal;
+    if (!g_tables_ready)
+        build_tables();
+    if (aa == 0 || bb == 0)
+        return 0;
+    return g_exp[g_log[aa] + g_log[bb]];
+}
+
+uint8_t gf256_inv(uint8_t aa) {
+    using namespace gf256_internal;
+    serial_assert(aa != 0);
+    if (!g_tables_ready)
+        build_tables();
+    return g_exp[255 - g_log[aa]];
+}
+
+#endif // GF256_BITSLICED
+
+#if GF256_BITSLICED
+
+namespace gf256_internal {
+
+// aa^254, in every lane.  A lane that is 0 stays 0.
+void inv(uint32_t * o_rr, uint32_t const * aa) {
+    uint32_t pp[8];	// aa^(2^ii)
+    mul(pp, aa, aa);
+    for (size_t ii = 0; ii < 8; ++ii)
+        o_rr[ii] = pp[ii];
+    for (size_t ii = 2; ii < 8; ++ii) {
+        mul(pp, pp, pp);
+        mul(o_rr, o_rr, pp);
+    }
+}
+
+// Multiplies lane mm by 1 and the others by factor.
+void mul_except(uint32_t * io_rr, uint32_t * factor, size_t mm) {
+    for (size_t ii = 0; ii < 8; ++ii)
+        factor[ii] &= ~((uint32_t) 1 << mm);
+    factor[0] |= (uint32_t) 1 << mm;
+    mul(io_rr, io_rr, factor);
+}
+
+// Lane jj of o_coefs is the Lagrange basis polynomial of point jj at
+// xx, all the points at once.
+void lagrange_coefs(uint32_t * o_coefs, size_t npoints, uint8_t const * xs, uint8_t xx) {
+    uint32_t lanes[8] = { 0 };
+    for (size_t jj = 0; jj < npoints; ++jj) {
+        for (size_t ii = 0; ii < 8; ++ii)
+            lanes[ii] |= (uint32_t) ((xs[jj] >> ii) & 1) << jj;
+    }
+    uint32_t num[8], den[8];
+    broadcast(num, 1);
+    broadcast(den, 1);
+    for (size_t mm = 0; mm < npoints; ++mm) {
+        uint32_t factor[8];
+        broadcast(factor, xx ^ xs[mm]);
+        mul_except(num, factor, mm);
+        broadcast(factor, xs[mm]);
+        for (size_t ii = 0; ii < 8; ++ii)
+            factor[ii] ^= lanes[ii];
+        mul_except(den, factor, mm);
+    }
+    inv(den, den);
+    mul(o_coefs, num, den);
+}
+
+} // namespace gf256_internal
+
+void gf256_interpolate(size_t npoints, uint8_t const * xs,
+                       uint8_t const * const * ys, size_t len,
+                       uint8_t xx, uint8_t * o_yy) {
+    using namespace gf256_internal;
+    serial_assert(npoints <= GF256Newton::MAX_POINTS);
+    serial_assert(len <= GF256Newton::MAX_LEN);
+    uint32_t coefs[8];
+    lagrange_coefs(coefs, npoints, xs, xx);
+    uint32_t sum[8] = { 0 };
+    uint32_t term[8];
+    for (size_t jj = 0; jj < npoints; ++jj) {
+        uint32_t coef[8];
+        broadcast(coef, lane(coefs, jj));
+        slice(term, ys[jj], len);
+        mul(term, term, coef);
+        for (size_t ii = 0; ii < 8; ++ii)
+            sum[ii] ^= term[ii];
+    }
+    unslice(o_yy, sum, len);
+    memzero(sum, sizeof(sum));
+    memzero(term, sizeof(term));
+}
+
+#else
+
+namespace gf256_internal {
+
+// The Lagrange basis polynomial of point jj at xx.
+uint8_t lagrange_coef(size_t npoints, uint8_t const * xs, size_t jj, uint8_t xx) {
+    uint8_t num = 1;
+    uint8_t den = 1;
+    for (size_t mm = 0; mm < npoints; ++mm) {
+        if (mm == jj)
+            continue;
+        num = gf256_mul(num, xx ^ xs[mm]);
+        den = gf256_mul(den, xs[jj] ^ xs[mm]);
+    }
+    return gf256_mul(num, gf256_inv(den));
+}
+
+} // namespace gf256_internal
+
+void gf256_interpolate(size_t npoints, uint8_t const * xs,
+                       uint8_t const * const * ys, size_t len,
+                       uint8_t xx, uint8_t * o_yy) {
+    using namespace gf256_internal;
+    memset(o_yy, 0, len);
+    for (size_t jj = 0; jj < npoints; ++jj) {
+        uint8_t coef = lagrange_coef(npoints, xs, jj, xx);
+        for (size_t bb = 0; bb < len; ++bb)
+            o_yy[bb] ^= gf256_mul(ys[jj][bb], coef);
+    }
+}
+
+#endif // GF256_BITSLICED
+
+GF256Newton::GF256Newton(size_t i_len)
+    : len(i_len)
+    , npoints(0)
+{
+    serial_assert(len <= MAX_LEN);
+}
+
+GF256Newton::~GF256Newton() {
+    memzero(dd, sizeof(dd));
+}
+
+void GF256Newton::pop() {
+    serial_assert(npoints > 0);
+    --npoints;
+}
+
+#if GF256_BITSLICED
+
+void GF256Newton::push(uint8_t xx, uint8_t const * yy) {
+    using namespace gf256_internal;
+    serial_assert(npoints < MAX_POINTS);
+    size_t kk = npoints;
+    xs[kk] = xx;
+    slice(dd[kk][kk], yy, len);
+    for (size_t jj = kk; jj-- > 0; ) {
+        uint32_t dx[8];
+        broadcast(dx, gf256_inv(xx ^ xs[jj]));
+        for (size_t ii = 0; ii < 8; ++ii)
+            dd[kk][jj][ii] = dd[kk][jj+1][ii] ^ dd[kk-1][jj][ii];
+        mul(dd[kk][jj], dd[kk][jj], dx);
+    }
+    ++npoints;
+}
+
+void GF256Newton::eval(uint8_t xx, uint8_t * o_yy) const {
+    using namespace gf256_internal;
+    serial_assert(npoints > 0);
+    // Horner's rule on c_0 + (x - x_0)(c_1 + (x - x_1)(c_2 + ...)),
+    // all the bytes at once.
+    uint32_t yy[8];
+    for (size_t ii = 0; ii < 8; ++ii)
+        yy[ii] = dd[npoints-1][0][ii];
+    for (size_t kk = npoints-1; kk > 0; --kk) {
+        uint32_t dx[8];
+        broadcast(dx, xx ^ xs[kk-1]);
+        mul(yy, yy, dx);
+        for (size_t ii = 0; ii < 8; ++ii)
+            yy[ii] ^= dd[kk-1][0][ii];
+    }
+    unslice(o_yy, yy, len);
+}
+
+uint8_t GF256Newton::eval_byte(uint8_t xx, size_t ndx) const {
+    using namespace gf256_internal;
+    serial_assert(npoints > 0);
+    // Just the one lane, with scalar arithmetic.
+    uint8_t yy = lane(dd[npoints-1][0], ndx);
+    for (size_t kk = npoints-1; kk > 0; --kk)
+        yy = gf256_mul(yy, xx ^ xs[kk-1]) ^ lane(dd[kk-1][0], ndx);
+    return yy;
+}
+
+#else
+
+void GF256Newton::push(uint8_t xx, uint8_t const * yy) {
+    serial_assert(npoints < MAX_POINTS);
+    size_t kk = npoints;
+    xs[kk] = xx;
+    memcpy(dd[kk][kk], yy, len);
+    for (size_t jj = kk; jj-- > 0; ) {
+        uint8_t inv = gf256_inv(xx ^ xs[jj]);
+        for (size_t bb = 0; bb < len; ++bb)
+            dd[kk][jj][bb] = gf256_mul(dd[kk][jj+1][bb] ^ dd[kk-1][jj][bb], inv);
+    }
+    ++npoints;
+}
+
+uint8_t GF256Newton::eval_byte(uint8_t xx, size_t ndx) const {
+    serial_assert(npoints > 0);
+    // Horner's rule on c_0 + (x - x_0)(c_1 + (x - x_1)(c_2 + ...))
+    uint8_t yy = dd[npoints-1][0][ndx];
+    for (size_t kk = npoints-1; kk > 0; --kk)
+        yy = gf256_mul(yy, xx ^ xs[kk-1]) ^ dd[kk-1][0][ndx];
+    return yy;
+}
+
+void GF256Newton::eval(uint8_t xx, uint8_t * o_yy) const {
+    for (size_t bb = 0; bb < len; ++bb)
+        o_yy[bb] = eval_byte(xx, bb);
+}
+
+#endif // GF256_BITSLICED
@@ -0,0 +1,79 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#ifndef GLYPH_H
+#define GLYPH_H
+
+#include <Adafruit_GFX.h>
+
+// Up to eight pixels of a glyph row, leftmost in the leading bit.  GFX
+// fonts store the glyph bits back to back in flash, so a row starts at
+// any bit; the bits are taken a byte at a time instead of one by one.
+inline uint8_t glyph_bits(uint8_t const *bitmap, uint32_t bit, uint8_t nbits) {
+    uint8_t const *ptr = bitmap + (bit >> 3);
+    uint8_t shift = bit & 7;
+    unsigned bits = (unsigned) ptr[0] << shift;
+    if (shift + nbits > 8)
+        bits |= ptr[1] >> (8 - shift);
+    return bits & (0xff << (8 - nbits));
+}
+
+/**
+ * Adds a fast text renderer to a GFX display class.  Glyphs of GFX
+ * fonts are read from their flash bitmaps eight pixels at a time, zero
+ * bytes are skipped and the set bits go straight to GFX::drawPixel,
+ * without the virtual writePixel/drawPixel dispatch of drawChar.
+ *
+ * The pinned GxEPD2 keeps its frame buffer private, so pixels are
+ * still stored one by one through the (non-virtual) drawPixel of the
+ * display class rather than masked into the buffer a row at a time.
+ * The "Glyphs" self test logs both renderers' times.
+ *
+ * Anything else (the classic font, scaled text, control characters)
+ * is left to the GFX renderer.
+ */
+template <class GFX>
+class GlyphText : public GFX {
+public:
+    using GFX::GFX;
+    using Print::write;
+
+    size_t write(uint8_t c) override {
+        const GFXfont *font = this->gfxFont;
+        if (!font || this->textsize_x != 1 || this->textsize_y != 1)
+            return GFX::write(c);
+        uint8_t first = font->first;
+        if (c < first || c > font->last)
+            return GFX::write(c);
+        GFXglyph const *glyph = font->glyph + (c - first);
+        uint8_t ww = glyph->width;
+        uint8_t hh = glyph->height;
+        if (ww > 0 && hh > 0) {
+            int16_t xo = glyph->xOffset;
+            if (this->wrap && (this->cursor_x + xo + ww) > this->_width) {
+                this->cursor_x = 0;
+                this->cursor_y += font->yAdvance;
+            }
+            int16_t x0 = this->cursor_x + xo;
+            int16_t y0 = this->cursor_y + glyph->yOffset;
+            uint16_t color = this->textcolor;
+            uint8_t const *bitmap = font->bitmap + glyph->bitmapOffset;
+            uint32_t row = 0;		// bit offset of the row
+            for (uint8_t yy = 0; yy < hh; ++yy, row += ww) {
+                for (uint8_t bb = 0; bb < ww; bb += 8) {
+                    uint8_t nbits = ww - bb < 8 ? ww - bb : 8;
+                    unsigned bits = glyph_bits(bitmap, row + bb, nbits);
+                    while (bits) {
+                        // Leading bit is the leftmost pixel.
+                        int lead = __builtin_clz(bits) - (sizeof(bits) * 8 - 8);
+                        GFX::drawPixel(x0 + bb + lead, y0 + yy, color);
+                        bits &= ~(0x80u >> lead);
+                    }
+                }
+            }
+        }
+        this->cursor_x += glyph->xAdvance;
+        return 1;
+    }
+};
+
+#endif // GLYPH_H
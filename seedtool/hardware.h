@@ -4,17 +4,34 @@
 #define HARDWARE_H
 
 #include <GxEPD2_GFX.h>
-#include <Keypad.h>
+#include <Keypad.h>	// NO_KEY
 
 // This is hard to hide/encapsulate.
 extern GxEPD2_GFX *g_display;
 
+// Which e-paper controller was detected at boot.
+enum DisplayVariant {
+    DISPLAY_LEGACY,	// GxEPD2_154
+    DISPLAY_MODERN,	// GxEPD2_154_D67, "Rev2.1" modules
+};
+
 void hw_setup();
+DisplayVariant hw_display_variant();
+
+// Returns the next queued key press, or NO_KEY.
+char hw_getkey();
+// Are there queued key presses?
+bool hw_key_pending();
+// Drops queued key presses, they were typed for a previous screen.
+void hw_key_flush();
+// Queues key as if it was pressed, for the self tests.
+void hw_key_inject(char key);
+
 void hw_green_led(int value);
 
+// Raw TRNG output, use random_buffer (entropy.h) for random numbers.
 extern "C" {
 void hw_random_buffer(uint8_t *buf, size_t len);
-void random_buffer(uint8_t *buf, size_t len, void * p = NULL);
 }
 
 #endif // HARDWARE_H
@@ -8,6 +8,8 @@
 #include <GxEPD2_BW.h>
 
 #include "hardware.h"
+#include "glyph.h"
+#include "log.h"
 #include "util.h"
 
 #if defined(SAMD51)
@@ -68,6 +70,7 @@ extern "C" {
 #endif
 
 GxEPD2_GFX *g_display;
+DisplayVariant g_display_variant;
 
 // Display
 #if defined(ESP32)
@@ -84,15 +87,17 @@ g_display(EPD_DRIVER(/*CS=*/   21,
 // of the display.  This new version requires a different driver
 // module from GxEPD2 (GxEPD2_154_D67).
 //
-// We declare and initialize both modules and then probe the
-// controller at runtime to see which is connected.
+// We declare both modules and probe the controller at runtime to see
+// which is connected, the result is cached for the next boot.
 //
-GxEPD2_BW<GxEPD2_154, GxEPD2_154::HEIGHT>
+// Both render text with the glyph renderer (glyph.h).
+//
+GlyphText<GxEPD2_BW<GxEPD2_154, GxEPD2_154::HEIGHT> >
 display_legacy(GxEPD2_154(/*CS=*/   PIN_A4,
                           /*DC=*/   PIN_A3,
                           /*RST=*/  PIN_A2,
                           /*BUSY=*/ PIN_A1));
-GxEPD2_BW<GxEPD2_154_D67, GxEPD2_154_D67::HEIGHT>
+GlyphText<GxEPD2_BW<GxEPD2_154_D67, GxEPD2_154_D67::HEIGHT> >
 display_modern(GxEPD2_154_D67(/*CS=*/   PIN_A4,
                               /*DC=*/   PIN_A3,
                               /*RST=*/  PIN_A2,
@@ -118,7 +123,159 @@ byte rowPins_[rows_] = {13, 12, 11, 10};
 byte colPins_[cols_] = {9, 6, 5, 21};
 #endif
 
-Keypad g_keypad = Keypad(makeKeymap(keys_), rowPins_, colPins_, rows_, cols_);
+/*
+ *  The keypad matrix is scanned from a timer interrupt so keys pressed
+ *  while the main loop is busy (e.g. waiting for the panel to refresh)
+ *  are not lost.  Debounced key presses are pushed into a single
+ *  producer (the interrupt), single consumer (hw_getkey) ring buffer.
+ */
+uint32_t const KEYPAD_SCAN_MS = 5;	// scan period
+uint8_t const KEYPAD_DEBOUNCE = 4;	// stable scans for a state change
+
+size_t const KEYQ_SIZE = 32;		// must be a power of 2
+
+struct {
+    char keys[KEYQ_SIZE];
+    volatile uint32_t head;		// written by the producer only
+    volatile uint32_t tail;		// written by the consumer only
+} g_keyq;
+
+uint16_t g_key_state;			// debounced state, bit per key
+uint8_t g_key_count[rows_ * cols_];	// consecutive scans in the other state
+
+void keyq_push(char key) {
+    uint32_t head = g_keyq.head;
+    if (head - g_keyq.tail == KEYQ_SIZE)
+        return;		// full, drop the key
+    g_keyq.keys[head % KEYQ_SIZE] = key;
+    __sync_synchronize();	// publish the key before the index
+    g_keyq.head = head + 1;
+}
+
+// Called every KEYPAD_SCAN_MS.
+void keypad_scan() {
+    for (byte cc = 0; cc < cols_; ++cc) {
+        pinMode(colPins_[cc], OUTPUT);
+        digitalWrite(colPins_[cc], LOW);
+        for (byte rr = 0; rr < rows_; ++rr) {
+            int kk = rr * cols_ + cc;
+            bool down = digitalRead(rowPins_[rr]) == LOW;
+            bool was_down = g_key_state & (1 << kk);
+            if (down == was_down) {
+                g_key_count[kk] = 0;
+                continue;
+            }
+            if (++g_key_count[kk] < KEYPAD_DEBOUNCE)
+                continue;
+            g_key_count[kk] = 0;
+            g_key_state ^= (1 << kk);
+            if (down)
+                keyq_push(keys_[rr][cc]);
+        }
+        digitalWrite(colPins_[cc], HIGH);
+        pinMode(colPins_[cc], INPUT);
+    }
+}
+
+#if defined(SAMD51)
+void keypad_timer_start() {
+    // TC3 clocked from GCLK1 (48 MHz) / 64, match frequency mode.
+    GCLK->PCHCTRL[TC3_GCLK_ID].reg =
+        GCLK_PCHCTRL_GEN_GCLK1 | GCLK_PCHCTRL_CHEN;
+    while (!(GCLK->PCHCTRL[TC3_GCLK_ID].reg & GCLK_PCHCTRL_CHEN));
+
+    TC3->COUNT16.CTRLA.bit.ENABLE = 0;
+    while (TC3->COUNT16.SYNCBUSY.bit.ENABLE);
+    TC3->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 | TC_CTRLA_PRESCALER_DIV64;
+    TC3->COUNT16.WAVE.reg = TC_WAVE_WAVEGEN_MFRQ;
+    TC3->COUNT16.CC[0].reg = (48000000 / 64 / 1000) * KEYPAD_SCAN_MS - 1;
+    while (TC3->COUNT16.SYNCBUSY.bit.CC0);
+    TC3->COUNT16.INTENSET.reg = TC_INTENSET_MC0;
+
+    NVIC_SetPriority(TC3_IRQn, 3);
+    NVIC_EnableIRQ(TC3_IRQn);
+
+    TC3->COUNT16.CTRLA.bit.ENABLE = 1;
+    while (TC3->COUNT16.SYNCBUSY.bit.ENABLE);
+}
+
+extern "C" void TC3_Handler(void) {
+    if (TC3->COUNT16.INTFLAG.bit.MC0) {
+        TC3->COUNT16.INTFLAG.reg = TC_INTFLAG_MC0;
+        keypad_scan();
+    }
+}
+#endif
+
+// The detected display variant is kept in the NVM user page, after its
+// 32 bytes of fuses, so later boots initialize only that driver.  The
+// user page survives firmware uploads.
+#if defined(SAMD51)
+size_t const USER_PAGE_WORDS = 512 / sizeof(uint32_t);
+size_t const USER_VARIANT_WORD = 8;		// first word after the fuses
+uint32_t const USER_VARIANT_MAGIC = 0x5eed0000;
+
+bool nvm_read_variant(DisplayVariant & o_variant) {
+    uint32_t word = ((uint32_t const volatile *) NVMCTRL_USER)[USER_VARIANT_WORD];
+    if ((word & 0xffff0000) != USER_VARIANT_MAGIC)
+        return false;	// erased, never written
+    switch (word & 0xffff) {
+    case DISPLAY_LEGACY:
+        o_variant = DISPLAY_LEGACY;
+        return true;
+    case DISPLAY_MODERN:
+        o_variant = DISPLAY_MODERN;
+        return true;
+    default:
+        return false;
+    }
+}
+
+void nvm_command(uint32_t cmd) {
+    NVMCTRL->INTFLAG.reg = NVMCTRL_INTFLAG_DONE;
+    NVMCTRL->CTRLB.reg = NVMCTRL_CTRLB_CMDEX_KEY | cmd;
+    while (!NVMCTRL->INTFLAG.bit.DONE);
+}
+
+// The user page can only be erased as a whole, the fuses are written
+// back as they were read.
+void nvm_write_variant(DisplayVariant variant) {
+    uint32_t volatile * user = (uint32_t volatile *) NVMCTRL_USER;
+    uint32_t page[USER_PAGE_WORDS];
+    for (size_t ii = 0; ii < USER_PAGE_WORDS; ++ii)
+        page[ii] = user[ii];
+    page[USER_VARIANT_WORD] = USER_VARIANT_MAGIC | variant;
+
+    while (!NVMCTRL->STATUS.bit.READY);
+    NVMCTRL->CTRLA.bit.WMODE = NVMCTRL_CTRLA_WMODE_MAN_Val;
+    NVMCTRL->ADDR.reg = NVMCTRL_USER;
+    nvm_command(NVMCTRL_CTRLB_CMD_EP);
+    nvm_command(NVMCTRL_CTRLB_CMD_PBC);
+    // Quad words through the page buffer.
+    for (size_t ii = 0; ii < USER_PAGE_WORDS; ii += 4) {
+        for (size_t jj = 0; jj < 4; ++jj)
+            user[ii + jj] = page[ii + jj];
+        NVMCTRL->ADDR.reg = (uint32_t) (uintptr_t) (user + ii);
+        nvm_command(NVMCTRL_CTRLB_CMD_WQW);
+    }
+}
+#else
+bool nvm_read_variant(DisplayVariant & o_variant) {
+    return false;
+}
+
+void nvm_write_variant(DisplayVariant variant) {
+}
+#endif
+
+// Initializes one driver over SW SPI and reads a byte back, only the
+// legacy controller answers with a non-zero byte.
+template <typename Display>
+uint8_t display_init_probe(Display & display) {
+    display.epd2.init(SW_SCK, SW_MOSI, 115200, true, false);
+    display.init(115200);
+    return display.epd2._readData();
+}
 
 void hw_setup() {
     pinMode(BLUE_LED, OUTPUT);	// Blue LED
@@ -127,29 +284,70 @@ void hw_setup() {
     pinMode(GREEN_LED, OUTPUT);	// Green LED
     digitalWrite(GREEN_LED, LOW);
 
+    uint32_t t0 = micros();
     Serial.begin(115200);
+    uint32_t t_serial = micros();
 
-    // Initialize both versions of the display instance.
-    display_modern.epd2.init(SW_SCK, SW_MOSI, 115200, true, false);
-    display_modern.init(115200);
-    display_legacy.epd2.init(SW_SCK, SW_MOSI, 115200, true, false);
-    display_legacy.init(115200);
+    // Initialize only the cached variant's driver and check that the
+    // controller still agrees.
+    DisplayVariant cached;
+    bool have_cached = nvm_read_variant(cached);
+    bool verified = false;
+    if (have_cached) {
+        uint8_t read_legacy = cached == DISPLAY_LEGACY
+            ? display_init_probe(display_legacy)
+            : display_init_probe(display_modern);
+        LOG_DEBUG("read_legacy: cached %d, readData=0x%02x\n", cached, read_legacy);
+        verified = (read_legacy != 0) == (cached == DISPLAY_LEGACY);
+    }
 
-    // Read a byte from the display instance to pick a version.
-    uint8_t read_legacy = display_legacy.epd2._readData();
-    serial_printf("read_legacy: readData=0x%02x\n", read_legacy);
-    g_display = read_legacy
+    if (verified) {
+        g_display_variant = cached;
+    }
+    else {
+        // Initialize both versions of the display instance and read a
+        // byte from the legacy one to pick a version.
+        display_modern.epd2.init(SW_SCK, SW_MOSI, 115200, true, false);
+        display_modern.init(115200);
+        uint8_t read_legacy = display_init_probe(display_legacy);
+        LOG_DEBUG("read_legacy: readData=0x%02x\n", read_legacy);
+        g_display_variant = read_legacy ? DISPLAY_LEGACY : DISPLAY_MODERN;
+        if (!have_cached || cached != g_display_variant)
+            nvm_write_variant(g_display_variant);
+    }
+    g_display = g_display_variant == DISPLAY_LEGACY
         ? static_cast<GxEPD2_GFX *>(&display_legacy)
         : static_cast<GxEPD2_GFX *>(&display_modern);
+    uint32_t t_display = micros();
 
     // Switch back to HW SPI for performance.
     g_display->epd2.init(-1, -1, 115200, true, false);
 
     g_display->setRotation(1);
+    uint32_t t_spi = micros();
 
 #if defined(SAMD51)
     trngInit();
 #endif
+    uint32_t t_trng = micros();
+
+    for (byte rr = 0; rr < rows_; ++rr)
+        pinMode(rowPins_[rr], INPUT_PULLUP);
+    for (byte cc = 0; cc < cols_; ++cc)
+        pinMode(colPins_[cc], INPUT);
+#if defined(SAMD51)
+    keypad_timer_start();
+#endif
+    uint32_t t_keypad = micros();
+
+    LOG_TRACE("hw_setup: serial %lu us, display %lu us (%s), spi %lu us, "
+              "trng %lu us, keypad %lu us\n",
+              (unsigned long) (t_serial - t0),
+              (unsigned long) (t_display - t_serial),
+              verified ? "cached" : "probed",
+              (unsigned long) (t_spi - t_display),
+              (unsigned long) (t_trng - t_spi),
+              (unsigned long) (t_keypad - t_trng));
 
     // Only wait on the ESP32, the SAMD51 gets hung w/o serial here
 #if defined(ESP32)
@@ -157,6 +355,44 @@ void hw_setup() {
 #endif
 }
 
+DisplayVariant hw_display_variant() {
+    return g_display_variant;
+}
+
+char hw_getkey() {
+#if !defined(SAMD51)
+    // No scan timer, scan when polled.
+    static uint32_t last_scan = 0;
+    if (millis() - last_scan >= KEYPAD_SCAN_MS) {
+        last_scan = millis();
+        keypad_scan();
+    }
+#endif
+    uint32_t tail = g_keyq.tail;
+    if (tail == g_keyq.head)
+        return NO_KEY;
+    __sync_synchronize();	// read the key after the index
+    char key = g_keyq.keys[tail % KEYQ_SIZE];
+    g_keyq.tail = tail + 1;
+    return key;
+}
+
+bool hw_key_pending() {
+    return g_keyq.tail != g_keyq.head;
+}
+
+void hw_key_flush() {
+    // Only the consumer writes tail.
+    g_keyq.tail = g_keyq.head;
+}
+
+void hw_key_inject(char key) {
+    // The scan interrupt is the producer otherwise.
+    noInterrupts();
+    keyq_push(key);
+    interrupts();
+}
+
 void hw_green_led(int value) {
     digitalWrite(GREEN_LED, value);  // turn off the green LED
 }
@@ -164,7 +400,6 @@ void hw_green_led(int value) {
 extern "C" {
 
 void hw_random_buffer(uint8_t *buf, size_t len) {
-    serial_printf("random_buffer %d\n", len);
     uint32_t r = 0;
     for (size_t i = 0; i < len; i++) {
         if (i % 4 == 0) {
@@ -178,18 +413,4 @@ void hw_random_buffer(uint8_t *buf, size_t len) {
     }
 }
 
-
-// TODO
-void random_buffer(uint8_t *buf, size_t len, void * p) {
-    if (p == NULL) {
-        hw_random_buffer(buf, len);
-    }
-    else {
-      // deterministic random
-      // TODO
-    }
-  
-}
-
-
 } // extern "C"
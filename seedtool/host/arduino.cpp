@@ -0,0 +1,384 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+// The Arduino core for the host build, see shims/Arduino.h.
+
+#include <Arduino.h>
+
+#include <time.h>
+#include <mutex>
+#include <deque>
+
+namespace {
+
+uint64_t now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint64_t const g_start_us = now_us();
+
+} // namespace
+
+unsigned long millis(void) {
+    return (unsigned long) ((now_us() - g_start_us) / 1000);
+}
+
+unsigned long micros(void) {
+    return (unsigned long) (now_us() - g_start_us);
+}
+
+void delay(unsigned long ms) {
+    struct timespec ts = { (time_t) (ms / 1000), (long) (ms % 1000) * 1000000 };
+    nanosleep(&ts, NULL);
+}
+
+void delayMicroseconds(unsigned int us) {
+    struct timespec ts = { (time_t) (us / 1000000), (long) (us % 1000000) * 1000 };
+    nanosleep(&ts, NULL);
+}
+
+// String
+
+char String::empty_[1] = { 0 };
+
+String::String(const char *cstr) : buf_(empty_), cap_(0), len_(0) {
+    if (cstr)
+        assign(cstr, strlen(cstr));
+}
+
+String::String(const String &str) : buf_(empty_), cap_(0), len_(0) {
+    assign(str.buf_, str.len_);
+}
+
+String::String(const __FlashStringHelper *str) : String((const char *) str) {}
+
+String::String(char c) : buf_(empty_), cap_(0), len_(0) {
+    assign(&c, 1);
+}
+
+String::String(unsigned char value, unsigned char base)
+    : String((unsigned long) value, base) {}
+
+String::String(int value, unsigned char base) : String((long) value, base) {}
+
+String::String(unsigned int value, unsigned char base)
+    : String((unsigned long) value, base) {}
+
+String::String(long value, unsigned char base) : buf_(empty_), cap_(0), len_(0) {
+    if (base == 10 && value < 0) {
+        *this = String(0UL - (unsigned long) value, base);
+        String minus("-");
+        minus.concat(*this);
+        *this = minus;
+    } else {
+        *this = String((unsigned long) value, base);
+    }
+}
+
+String::String(unsigned long value, unsigned char base)
+    : buf_(empty_), cap_(0), len_(0) {
+    char tmp[8 * sizeof(value) + 1];
+    char *ptr = tmp + sizeof(tmp) - 1;
+    *ptr = '\0';
+    do {
+        unsigned digit = value % base;
+        *--ptr = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    } while (value);
+    assign(ptr, strlen(ptr));
+}
+
+String::String(double value, unsigned char decimals)
+    : buf_(empty_), cap_(0), len_(0) {
+    char tmp[64];
+    snprintf(tmp, sizeof(tmp), "%.*f", decimals, value);
+    assign(tmp, strlen(tmp));
+}
+
+String::~String() {
+    if (cap_)
+        free(buf_);
+}
+
+String & String::operator=(const String &rhs) {
+    if (this != &rhs)
+        assign(rhs.buf_, rhs.len_);
+    return *this;
+}
+
+String & String::operator=(const char *cstr) {
+    assign(cstr ? cstr : "", cstr ? strlen(cstr) : 0);
+    return *this;
+}
+
+bool String::reserve(unsigned int size) {
+    if (size <= cap_)
+        return true;
+    char *buf = (char *) realloc(cap_ ? buf_ : NULL, size + 1);
+    if (!buf)
+        return false;
+    if (!cap_)
+        buf[0] = '\0';
+    buf_ = buf;
+    cap_ = size;
+    return true;
+}
+
+void String::assign(const char *cstr, unsigned int length) {
+    if (!reserve(length))
+        abort();
+    memmove(buf_, cstr, length);
+    len_ = length;
+    if (cap_)
+        buf_[len_] = '\0';
+}
+
+bool String::concat(const char *cstr, unsigned int length) {
+    if (length == 0)
+        return true;
+    if (len_ + length > cap_ && !reserve(std::max(len_ + length, cap_ * 2)))
+        return false;
+    memmove(buf_ + len_, cstr, length);
+    len_ += length;
+    buf_[len_] = '\0';
+    return true;
+}
+
+bool String::startsWith(const String &prefix) const {
+    return prefix.len_ <= len_ && memcmp(buf_, prefix.buf_, prefix.len_) == 0;
+}
+
+bool String::endsWith(const String &suffix) const {
+    return suffix.len_ <= len_ &&
+        memcmp(buf_ + len_ - suffix.len_, suffix.buf_, suffix.len_) == 0;
+}
+
+void String::setCharAt(unsigned int index, char c) {
+    if (index < len_)
+        buf_[index] = c;
+}
+
+char String::operator[](unsigned int index) const {
+    return index < len_ ? buf_[index] : 0;
+}
+
+char & String::operator[](unsigned int index) {
+    static thread_local char dummy;
+    if (index >= len_) {
+        dummy = 0;
+        return dummy;
+    }
+    return buf_[index];
+}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize,
+                      unsigned int index) const {
+    if (!bufsize || !buf)
+        return;
+    if (index >= len_) {
+        buf[0] = 0;
+        return;
+    }
+    unsigned int nn = std::min(bufsize - 1, len_ - index);
+    memcpy(buf, buf_ + index, nn);
+    buf[nn] = 0;
+}
+
+int String::indexOf(char ch, unsigned int from) const {
+    if (from >= len_)
+        return -1;
+    const char *ptr = (const char *) memchr(buf_ + from, ch, len_ - from);
+    return ptr ? ptr - buf_ : -1;
+}
+
+int String::indexOf(const String &str, unsigned int from) const {
+    if (from > len_)
+        return -1;
+    const char *ptr = strstr(buf_ + from, str.buf_);
+    return ptr ? ptr - buf_ : -1;
+}
+
+int String::lastIndexOf(char ch) const {
+    const char *ptr = strrchr(buf_, ch);
+    return ptr && ch ? ptr - buf_ : -1;
+}
+
+String String::substring(unsigned int begin, unsigned int end) const {
+    if (begin > end)
+        std::swap(begin, end);
+    String out;
+    if (begin >= len_)
+        return out;
+    end = std::min(end, len_);
+    out.assign(buf_ + begin, end - begin);
+    return out;
+}
+
+void String::replace(char find, char replace) {
+    for (unsigned int ii = 0; ii < len_; ++ii)
+        if (buf_[ii] == find)
+            buf_[ii] = replace;
+}
+
+void String::replace(const String &find, const String &replace) {
+    if (find.len_ == 0)
+        return;
+    String out;
+    unsigned int pos = 0;
+    int hit;
+    while ((hit = indexOf(find, pos)) >= 0) {
+        out.concat(buf_ + pos, hit - pos);
+        out.concat(replace);
+        pos = hit + find.len_;
+    }
+    out.concat(buf_ + pos, len_ - pos);
+    *this = out;
+}
+
+void String::remove(unsigned int index) {
+    remove(index, (unsigned int) -1);
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index >= len_)
+        return;
+    count = std::min(count, len_ - index);
+    memmove(buf_ + index, buf_ + index + count, len_ - index - count);
+    len_ -= count;
+    buf_[len_] = '\0';
+}
+
+void String::toLowerCase(void) {
+    for (unsigned int ii = 0; ii < len_; ++ii)
+        buf_[ii] = tolower((unsigned char) buf_[ii]);
+}
+
+void String::toUpperCase(void) {
+    for (unsigned int ii = 0; ii < len_; ++ii)
+        buf_[ii] = toupper((unsigned char) buf_[ii]);
+}
+
+void String::trim(void) {
+    unsigned int begin = 0, end = len_;
+    while (begin < end && isspace((unsigned char) buf_[begin]))
+        ++begin;
+    while (end > begin && isspace((unsigned char) buf_[end - 1]))
+        --end;
+    String out = substring(begin, end);
+    *this = out;
+}
+
+String operator+(const String &lhs, const String &rhs) {
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+String operator+(const String &lhs, const char *rhs) {
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+String operator+(const char *lhs, const String &rhs) {
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+String operator+(const String &lhs, char rhs) {
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+// Print
+
+size_t Print::write(const uint8_t *buf, size_t size) {
+    size_t nn = 0;
+    while (size--)
+        nn += write(*buf++);
+    return nn;
+}
+
+size_t Print::print(long value, int base) {
+    if (base == 10 && value < 0)
+        return print('-') + print(0UL - (unsigned long) value, base);
+    return print((unsigned long) value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+    // Unlike String, Print writes upper case digits.
+    String digits(value, (unsigned char) base);
+    digits.toUpperCase();
+    return print(digits);
+}
+
+size_t Print::print(double value, int decimals) {
+    return print(String(value, (unsigned char) decimals));
+}
+
+// Stream
+
+size_t Stream::readBytes(char *buf, size_t len) {
+    size_t nn = 0;
+    while (nn < len) {
+        unsigned long start = millis();
+        int c;
+        while ((c = read()) < 0 && millis() - start < timeout_)
+            delay(1);
+        if (c < 0)
+            break;
+        buf[nn++] = (char) c;
+    }
+    return nn;
+}
+
+// Serial
+
+HostSerial Serial;
+
+namespace {
+
+std::mutex g_serial_mutex;
+std::deque<uint8_t> g_serial_rx;
+
+} // namespace
+
+size_t HostSerial::write(uint8_t c) {
+    return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HostSerial::write(const uint8_t *buf, size_t size) {
+    // One stdio call per write keeps concurrent writers' lines whole.
+    return fwrite(buf, 1, size, stdout);
+}
+
+int HostSerial::available() {
+    std::lock_guard<std::mutex> lock(g_serial_mutex);
+    return (int) g_serial_rx.size();
+}
+
+int HostSerial::read() {
+    std::lock_guard<std::mutex> lock(g_serial_mutex);
+    if (g_serial_rx.empty())
+        return -1;
+    int c = g_serial_rx.front();
+    g_serial_rx.pop_front();
+    return c;
+}
+
+int HostSerial::peek() {
+    std::lock_guard<std::mutex> lock(g_serial_mutex);
+    return g_serial_rx.empty() ? -1 : g_serial_rx.front();
+}
+
+void HostSerial::flush() {
+    fflush(stdout);
+}
+
+void serial_host_feed(const uint8_t *buf, size_t len) {
+    std::lock_guard<std::mutex> lock(g_serial_mutex);
+    g_serial_rx.insert(g_serial_rx.end(), buf, buf + len);
+}
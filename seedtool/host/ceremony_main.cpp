@@ -0,0 +1,285 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+// Runs ceremony_run() for each line of dice rolls on a work stealing
+// thread pool and writes the NDJSON lines in input order, see
+// ../doc/host_build.md.
+
+#include <Arduino.h>
+
+#include <errno.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ceremony.h"
+#include "util.h"
+
+namespace ceremony_main_internal {
+
+struct Item {
+    size_t ndx;
+    std::string rolls;
+};
+
+// Each worker takes from the front of its own queue and, when that is
+// empty, steals from the back of the others'.
+struct Queue {
+    std::mutex mutex;
+    std::deque<Item> items;
+};
+
+class Pool {
+public:
+    explicit Pool(size_t nworkers) : queues_(nworkers), queued_(0), done_(false) {
+        for (std::unique_ptr<Queue> & queue : queues_)
+            queue.reset(new Queue);
+    }
+
+    size_t size() const { return queues_.size(); }
+
+    void push(Item && item) {
+        Queue & queue = *queues_[item.ndx % queues_.size()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.items.push_back(std::move(item));
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++queued_;
+        cv_.notify_one();
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+        cv_.notify_all();
+    }
+
+    // Blocks until there is an item for worker self, false once the
+    // pool is closed and empty.
+    bool take(size_t self, Item & o_item) {
+        for (;;) {
+            if (take_from(self, true, o_item))
+                return true;
+            for (size_t ii = 1; ii < queues_.size(); ++ii)
+                if (take_from((self + ii) % queues_.size(), false, o_item))
+                    return true;
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return queued_ > 0 || done_; });
+            if (queued_ == 0)
+                return false;
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t queued_;
+    bool done_;
+
+    bool take_from(size_t ndx, bool front, Item & o_item) {
+        Queue & queue = *queues_[ndx];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.items.empty())
+                return false;
+            if (front) {
+                o_item = std::move(queue.items.front());
+                queue.items.pop_front();
+            } else {
+                o_item = std::move(queue.items.back());
+                queue.items.pop_back();
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        --queued_;
+        return true;
+    }
+};
+
+// Writes line ndx once all the lines before it are written.
+class OrderedWriter {
+public:
+    explicit OrderedWriter(FILE * out) : out_(out), next_(0) {}
+
+    void put(size_t ndx, std::string && line) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_[ndx] = std::move(line);
+        bool wrote = false;
+        for (auto it = pending_.find(next_); it != pending_.end();
+             it = pending_.find(next_)) {
+            fputs(it->second.c_str(), out_);
+            fputc('\n', out_);
+            pending_.erase(it);
+            ++next_;
+            wrote = true;
+        }
+        if (wrote) {
+            fflush(out_);
+            cv_.notify_all();
+        }
+    }
+
+    // Blocks until fewer than window lines before ndx are unwritten,
+    // which bounds the memory a slow line holds up.
+    void wait_for(size_t ndx, size_t window) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return next_ + window > ndx; });
+    }
+
+private:
+    FILE * out_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<size_t, std::string> pending_;
+    size_t next_;
+};
+
+std::string json_string(std::string const & text) {
+    std::string out = "\"";
+    for (unsigned char cc : text) {
+        if (cc == '"' || cc == '\\') {
+            out += '\\';
+            out += cc;
+        } else if (cc < 0x20) {
+            char esc[7];
+            snprintf(esc, sizeof(esc), "\\u%04x", cc);
+            out += esc;
+        } else {
+            out += cc;
+        }
+    }
+    return out + "\"";
+}
+
+void usage(char const * argv0) {
+    fprintf(stderr,
+            "usage: %s [-n mainnet|testnet|regtest] [-t threshold] [-s shares]"
+            " [-j jobs] [rolls.txt]\n"
+            "  -n  network (default mainnet)\n"
+            "  -t  SSKR threshold (default 2)\n"
+            "  -s  SSKR shares (default 3)\n"
+            "  -j  threads (default: one per core)\n"
+            "One ceremony per line of dice rolls, from stdin without a file.\n",
+            argv0);
+    exit(2);
+}
+
+} // namespace ceremony_main_internal
+
+int main(int argc, char **argv) {
+    using namespace ceremony_main_internal;
+
+    NetwtorkType network = MAINNET;
+    unsigned long thresh = 2, nshares = 3;
+    size_t njobs = std::thread::hardware_concurrency();
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:s:j:")) != -1) {
+        switch (opt) {
+        case 'n':
+            if (strcmp(optarg, "mainnet") == 0)
+                network = MAINNET;
+            else if (strcmp(optarg, "testnet") == 0)
+                network = TESTNET;
+            else if (strcmp(optarg, "regtest") == 0)
+                network = REGTEST;
+            else
+                usage(argv[0]);
+            break;
+        case 't': thresh = strtoul(optarg, NULL, 10); break;
+        case 's': nshares = strtoul(optarg, NULL, 10); break;
+        case 'j': njobs = strtoul(optarg, NULL, 10); break;
+        default: usage(argv[0]);
+        }
+    }
+    if (argc - optind > 1 || njobs == 0 || thresh > nshares || nshares > 255 ||
+        !ceremony_valid_args("1", thresh, nshares))
+        usage(argv[0]);
+
+    std::ifstream file;
+    if (optind < argc && strcmp(argv[optind], "-") != 0) {
+        file.open(argv[optind]);
+        if (!file) {
+            fprintf(stderr, "%s: %s\n", argv[optind], strerror(errno));
+            return 2;
+        }
+    }
+    std::istream & in = file.is_open() ? file : std::cin;
+
+    // The NDJSON keeps the real stdout; Serial, and so the log, writes
+    // to stdout too and is moved to stderr.
+    FILE * out = fdopen(dup(1), "w");
+    if (!out || dup2(2, 1) < 0) {
+        perror("stdout");
+        return 2;
+    }
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    // libwally creates its secp256k1 context on first use, and the
+    // sketch's lookup tables are built the same way.  One ceremony
+    // before the threads start builds them all.
+    String warmup;
+    ceremony_run("1", network, thresh, nshares, warmup);
+    wipe_string(warmup);
+
+    auto start = std::chrono::steady_clock::now();
+    Pool pool(njobs);
+    OrderedWriter writer(out);
+    size_t nfailed = 0;
+    std::mutex failed_mutex;
+    auto worker = [&](size_t self) {
+        Item item;
+        while (pool.take(self, item)) {
+            String line;
+            if (ceremony_run(item.rolls.c_str(), network, thresh, nshares, line)) {
+                writer.put(item.ndx, line.c_str());
+            } else {
+                // Every line gets an output line, or the ones after it
+                // would never be written.
+                char const * error =
+                    ceremony_valid_args(item.rolls.c_str(), thresh, nshares)
+                    ? "ceremony failed" : "not dice rolls";
+                fprintf(stderr, "line %zu: %s\n", item.ndx + 1, error);
+                writer.put(item.ndx, "{\"rolls\":" + json_string(item.rolls) +
+                           ",\"error\":\"" + error + "\"}");
+                std::lock_guard<std::mutex> lock(failed_mutex);
+                ++nfailed;
+            }
+            wipe_string(line);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t ii = 0; ii < pool.size(); ++ii)
+        threads.emplace_back(worker, ii);
+
+    size_t nlines = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos)
+            continue;
+        line = line.substr(begin, line.find_last_not_of(" \t\r") + 1 - begin);
+        writer.wait_for(nlines, 64 * pool.size());
+        pool.push({ nlines++, line });
+    }
+    pool.close();
+    for (std::thread & thread : threads)
+        thread.join();
+    fclose(out);
+
+    uint32_t wall = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%zu ceremonies, %zu failed, %u ms on %zu threads\n",
+            nlines, nfailed, (unsigned) wall, pool.size());
+    return nfailed ? 1 : 0;
+}
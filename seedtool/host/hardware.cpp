@@ -0,0 +1,81 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+// hardware.h for the host build: no display or keypad, keys only come
+// from hw_key_inject and random bytes from the kernel.
+
+#include <Arduino.h>
+#include <sys/random.h>
+
+#include "hardware.h"
+#include "userinterface.h"
+
+GxEPD2_GFX *g_display = NULL;
+
+namespace hardware_internal {
+
+size_t const KEYQ_SIZE = 32;
+
+// One queue per thread, a test and the keys it injects share a thread.
+thread_local struct {
+    char keys[KEYQ_SIZE];
+    uint32_t head;
+    uint32_t tail;
+} g_keyq;
+
+} // namespace hardware_internal
+
+void hw_setup() {
+}
+
+DisplayVariant hw_display_variant() {
+    return DISPLAY_MODERN;
+}
+
+char hw_getkey() {
+    using namespace hardware_internal;
+    if (g_keyq.tail == g_keyq.head)
+        return NO_KEY;
+    return g_keyq.keys[g_keyq.tail++ % KEYQ_SIZE];
+}
+
+bool hw_key_pending() {
+    using namespace hardware_internal;
+    return g_keyq.tail != g_keyq.head;
+}
+
+void hw_key_flush() {
+    using namespace hardware_internal;
+    g_keyq.tail = g_keyq.head;
+}
+
+void hw_key_inject(char key) {
+    using namespace hardware_internal;
+    if (g_keyq.head - g_keyq.tail < KEYQ_SIZE)
+        g_keyq.keys[g_keyq.head++ % KEYQ_SIZE] = key;
+}
+
+void hw_green_led(int value) {
+    (void) value;
+}
+
+// Nobody is at a keypad, so rather than wait forever this returns
+// NO_KEY once the injected keys are used up.
+char wait_for_key() {
+    return hw_getkey();
+}
+
+extern "C" {
+
+void hw_random_buffer(uint8_t *buf, size_t len) {
+    while (len > 0) {
+        ssize_t nn = getrandom(buf, len, 0);
+        if (nn < 0) {
+            perror("getrandom");
+            abort();
+        }
+        buf += nn;
+        len -= nn;
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,612 @@
+#!/usr/bin/env python3
+# Copyright © 2020 Blockchain Commons, LLC
+
+"""Reference outputs for the host differential corpora.
+
+BIP39, BIP32, CBOR, bytewords, UR and SSKR are implemented here from
+their specifications on the Python standard library alone, so they
+share no code with the firmware's libraries.  `selfcheck` tests them
+against published vectors and the selftest.ino vectors; `corpus`
+writes randomized records the host runner feeds through the firmware
+(see ../doc/host_build.md for the record format).
+
+    reference.py selfcheck
+    reference.py corpus [--count N] [--seed S] > corpus.tsv
+    seedtool-ceremony rolls.txt | reference.py check-ceremony
+"""
+
+import argparse
+import hashlib
+import hmac
+import json
+import multiprocessing
+import os
+import random
+import sys
+import zlib
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# -- word lists ----------------------------------------------------------
+
+BIP39_ENGLISH_SHA256 = \
+    "2f5eed53a4727b4bf8880d8f3f199efc90e58503646d9ff8eff3a2ed3b24dbda"
+
+
+def load_bip39_words():
+    """The English list, taken from bip39words.h and checked against the
+    SHA256 of the BIP's english.txt, like gen-bip39-words.sh does."""
+    text = open(os.path.join(HERE, "..", "bip39words.h")).read()
+    body = text[text.index("bip39_words[] ="):text.index(";")]
+    words = [w for w in body.split('"')[1::2]]
+    words = [w[:-2] for w in words]		# the "\0" separators
+    english = "".join(w + "\n" for w in words).encode()
+    if hashlib.sha256(english).hexdigest() != BIP39_ENGLISH_SHA256:
+        sys.exit("reference.py: bip39words.h is not the BIP39 English list")
+    return words
+
+
+BIP39_WORDS = load_bip39_words()
+
+# https://github.com/BlockchainCommons/Research/blob/master/papers/bcr-2020-012-bytewords.md
+BYTEWORDS = """
+able acid also apex aqua arch atom aunt away axis back bald barn belt beta
+bias blue body brag brew bulb buzz calm cash cats chef city claw code cola
+cook cost crux curl cusp cyan dark data days deli dice diet door down draw
+drop drum dull duty each easy echo edge epic even exam exit eyes fact fair
+fern figs film fish fizz flap flew flux foxy free frog fuel fund gala game
+gear gems gift girl glow good gray grim guru gush gyro half hang hard hawk
+heat help high hill holy hope horn huts iced idea idle inch inky into iris
+iron item jade jazz join jolt jowl judo jugs jump junk jury keep keno kept
+keys kick kiln king kite kiwi knob lamb lava lazy leaf legs liar limp lion
+list logo loud love luau luck lung main many math maze memo menu meow mild
+mint miss monk nail navy need news next noon note numb obey oboe omit onyx
+open oval owls paid part peck play plus poem pool pose puff puma purr quad
+quiz race ramp real redo rich road rock roof ruby ruin runs rust safe saga
+scar sets silk skew slot soap solo song stub surf swan taco task taxi tent
+tied time tiny toil tomb toys trip tuna twin ugly undo unit urge user vast
+very veto vial vibe view visa void vows wall wand warm wasp wave waxy webs
+what when whiz wolf work yank yawn yell yoga yurt zaps zero zest zinc zone
+zoom
+""".split()
+
+# -- BIP39 ---------------------------------------------------------------
+
+
+def bip39_mnemonic(entropy):
+    nbits = len(entropy) * 8
+    bits = int.from_bytes(entropy, "big") << (nbits // 32)
+    bits |= hashlib.sha256(entropy).digest()[0] >> (8 - nbits // 32)
+    nwords = (nbits + nbits // 32) // 11
+    return " ".join(BIP39_WORDS[(bits >> (11 * (nwords - 1 - ii))) & 0x7ff]
+                    for ii in range(nwords))
+
+
+def bip39_seed(mnemonic, passphrase=""):
+    return hashlib.pbkdf2_hmac("sha512", mnemonic.encode(),
+                               ("mnemonic" + passphrase).encode(), 2048)
+
+# -- BIP32 ---------------------------------------------------------------
+
+
+EC_P = 2**256 - 2**32 - 977
+EC_N = 0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141
+EC_G = (0x79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798,
+        0x483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8)
+
+BIP32_VERSIONS = {
+    "main": (0x0488ade4, 0x0488b21e),	# xprv, xpub
+    "test": (0x04358394, 0x043587cf),	# tprv, tpub
+}
+
+
+def ec_double(pt):
+    x, y, z = pt
+    if y == 0:
+        return (0, 0, 0)
+    ysq = y * y % EC_P
+    s = 4 * x * ysq % EC_P
+    m = 3 * x * x % EC_P
+    nx = (m * m - 2 * s) % EC_P
+    ny = (m * (s - nx) - 8 * ysq * ysq) % EC_P
+    return (nx, ny, 2 * y * z % EC_P)
+
+
+def ec_add(p1, p2):
+    if p1[2] == 0:
+        return p2
+    if p2[2] == 0:
+        return p1
+    x1, y1, z1 = p1
+    x2, y2, z2 = p2
+    z1sq, z2sq = z1 * z1 % EC_P, z2 * z2 % EC_P
+    u1, u2 = x1 * z2sq % EC_P, x2 * z1sq % EC_P
+    s1, s2 = y1 * z2sq * z2 % EC_P, y2 * z1sq * z1 % EC_P
+    if u1 == u2:
+        return ec_double(p1) if s1 == s2 else (0, 0, 0)
+    h, r = (u2 - u1) % EC_P, (s2 - s1) % EC_P
+    hsq = h * h % EC_P
+    hcu = hsq * h % EC_P
+    nx = (r * r - hcu - 2 * u1 * hsq) % EC_P
+    ny = (r * (u1 * hsq - nx) - s1 * hcu) % EC_P
+    return (nx, ny, h * z1 * z2 % EC_P)
+
+
+def ec_pubkey(k):
+    """Compressed public key of private key k."""
+    acc, pt = (0, 0, 0), (EC_G[0], EC_G[1], 1)
+    while k:
+        if k & 1:
+            acc = ec_add(acc, pt)
+        pt = ec_double(pt)
+        k >>= 1
+    zinv = pow(acc[2], EC_P - 2, EC_P)
+    x = acc[0] * zinv * zinv % EC_P
+    y = acc[1] * zinv * zinv * zinv % EC_P
+    return bytes([2 + (y & 1)]) + x.to_bytes(32, "big")
+
+
+def hash160(data):
+    return hashlib.new("ripemd160", hashlib.sha256(data).digest()).digest()
+
+
+B58 = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz"
+
+
+def base58check(payload):
+    data = payload + hashlib.sha256(hashlib.sha256(payload).digest()).digest()[:4]
+    num = int.from_bytes(data, "big")
+    out = ""
+    while num:
+        num, rem = divmod(num, 58)
+        out = B58[rem] + out
+    return "1" * (len(data) - len(data.lstrip(b"\0"))) + out
+
+
+def base58check_decode(text):
+    num = 0
+    for c in text:
+        num = num * 58 + B58.index(c)
+    data = num.to_bytes((num.bit_length() + 7) // 8, "big")
+    data = b"\0" * (len(text) - len(text.lstrip("1"))) + data
+    payload, check = data[:-4], data[-4:]
+    assert hashlib.sha256(hashlib.sha256(payload).digest()).digest()[:4] == check
+    return payload
+
+
+def parse_path(path):
+    out = []
+    for part in path.split("/")[1:]:
+        hard = part[-1] in "h'"
+        out.append(int(part[:-1] if hard else part) + (0x80000000 if hard else 0))
+    return out
+
+
+class HDKey:
+    def __init__(self, seed):
+        ii = hmac.new(b"Bitcoin seed", seed, hashlib.sha512).digest()
+        self.key, self.chain = int.from_bytes(ii[:32], "big"), ii[32:]
+        self.depth, self.parent_fp, self.child = 0, b"\0" * 4, 0
+        self.pub = ec_pubkey(self.key)
+
+    def derive(self, index):
+        if index & 0x80000000:
+            data = b"\0" + self.key.to_bytes(32, "big")
+        else:
+            data = self.pub
+        ii = hmac.new(self.chain, data + index.to_bytes(4, "big"),
+                      hashlib.sha512).digest()
+        tweak = int.from_bytes(ii[:32], "big")
+        child = HDKey.__new__(HDKey)
+        child.key = (tweak + self.key) % EC_N
+        assert tweak < EC_N and child.key != 0	# probability below 2^-127
+        child.chain = ii[32:]
+        child.depth, child.child = self.depth + 1, index
+        child.parent_fp = hash160(self.pub)[:4]
+        child.pub = ec_pubkey(child.key)
+        return child
+
+    def fingerprint(self):
+        return hash160(self.pub)[:4]
+
+    def serialize(self, version, private):
+        key = b"\0" + self.key.to_bytes(32, "big") if private else self.pub
+        return base58check(version.to_bytes(4, "big") + bytes([self.depth]) +
+                           self.parent_fp + self.child.to_bytes(4, "big") +
+                           self.chain + key)
+
+
+def bip32_xpub(seed, network, path):
+    """(root fingerprint, xpub at path) for a BIP39 seed."""
+    root = key = HDKey(seed)
+    for index in parse_path(path):
+        key = key.derive(index)
+    return root.fingerprint(), key.serialize(BIP32_VERSIONS[network][1], False)
+
+# -- CBOR, bytewords, UR -------------------------------------------------
+
+
+def cbor_head(major, value):
+    if value < 24:
+        return bytes([major << 5 | value])
+    for info, size in ((24, 1), (25, 2), (26, 4), (27, 8)):
+        if value < 1 << (8 * size):
+            return bytes([major << 5 | info]) + value.to_bytes(size, "big")
+    raise ValueError(value)
+
+
+def cbor_uint(value):
+    return cbor_head(0, value)
+
+
+def cbor_bytes(data):
+    return cbor_head(2, len(data)) + data
+
+
+def cbor_map(pairs):
+    return cbor_head(5, len(pairs)) + b"".join(k + v for k, v in pairs)
+
+
+def cbor_tag(tag, item):
+    return cbor_head(6, tag) + item
+
+
+def with_crc(data):
+    return data + zlib.crc32(data).to_bytes(4, "big")
+
+
+def bytewords_standard(data):
+    return " ".join(BYTEWORDS[b] for b in with_crc(data))
+
+
+def bytewords_minimal(data):
+    return "".join(BYTEWORDS[b][0] + BYTEWORDS[b][3] for b in with_crc(data))
+
+
+def bytewords_decode(text):
+    data = bytes(BYTEWORDS.index(w) for w in text.split())
+    if zlib.crc32(data[:-4]).to_bytes(4, "big") != data[-4:]:
+        raise ValueError("bytewords checksum")
+    return data[:-4]
+
+
+def ur_crypto_seed(seed, birthday=None):
+    pairs = [(cbor_uint(1), cbor_bytes(seed))]
+    if birthday is not None:
+        pairs.append((cbor_uint(2), cbor_tag(100, cbor_uint(birthday))))
+    return "ur:crypto-seed/" + bytewords_minimal(cbor_map(pairs))
+
+# -- SSKR ----------------------------------------------------------------
+
+# GF(256) with the AES polynomial, as Shamir's scheme in SSKR uses.
+GF_EXP = [0] * 510
+GF_LOG = [0] * 256
+_x = 1
+for _ii in range(255):
+    GF_EXP[_ii] = GF_EXP[_ii + 255] = _x
+    GF_LOG[_x] = _ii
+    _x ^= (_x << 1) ^ (0x11b if _x & 0x80 else 0)	# times 3
+    _x &= 0xff
+
+
+def gf_mul(a, b):
+    return 0 if a == 0 or b == 0 else GF_EXP[GF_LOG[a] + GF_LOG[b]]
+
+
+def gf_div(a, b):
+    return 0 if a == 0 else GF_EXP[GF_LOG[a] + 255 - GF_LOG[b]]
+
+
+def interpolate(points, x):
+    """Value at x of the polynomial through points [(xi, bytes)]."""
+    out = bytearray(len(points[0][1]))
+    for ii, (xi, yi) in enumerate(points):
+        num = den = 1
+        for jj, (xj, _) in enumerate(points):
+            if jj != ii:
+                num = gf_mul(num, x ^ xj)
+                den = gf_mul(den, xi ^ xj)
+        coef = gf_div(num, den)
+        for kk, byte in enumerate(yi):
+            out[kk] ^= gf_mul(coef, byte)
+    return bytes(out)
+
+
+SECRET_INDEX = 255
+DIGEST_INDEX = 254
+
+
+def shamir_digest(random_part, secret):
+    return hmac.new(random_part, secret, hashlib.sha256).digest()[:4]
+
+
+def shamir_split(threshold, count, secret, rng):
+    """count shares, any threshold of them recover secret.  The secret
+    sits at x = 255 and a digest of it at x = 254."""
+    if threshold == 1:
+        return [secret] * count
+    random_part = rng.randbytes(len(secret) - 4)
+    points = [(ii, rng.randbytes(len(secret))) for ii in range(threshold - 2)]
+    points.append((DIGEST_INDEX, shamir_digest(random_part, secret) + random_part))
+    points.append((SECRET_INDEX, secret))
+    shares = [yy for _, yy in points[:threshold - 2]]
+    shares += [interpolate(points, ii) for ii in range(threshold - 2, count)]
+    return shares
+
+
+def shamir_recover(threshold, indexed_shares):
+    if threshold == 1:
+        return indexed_shares[0][1]
+    points = indexed_shares[:threshold]
+    secret = interpolate(points, SECRET_INDEX)
+    digest = interpolate(points, DIGEST_INDEX)
+    if shamir_digest(digest[4:], secret) != digest[:4]:
+        raise ValueError("shamir digest")
+    return secret
+
+
+def sskr_split(threshold, count, secret, rng):
+    """A single group of count shares, the share bytes with metadata.
+    https://github.com/BlockchainCommons/Research/blob/master/papers/bcr-2020-011-sskr.md"""
+    ident = rng.randbytes(2)
+    meta = ident + bytes([0, threshold - 1])	# group threshold and count 1
+    return [meta + bytes([ii]) + value for ii, value in
+            enumerate(shamir_split(threshold, count, secret, rng))]
+
+
+def sskr_combine(shares):
+    """Single group shares back to the secret."""
+    ident, gtgc, gimt = shares[0][:2], shares[0][2], shares[0][3]
+    if gtgc != 0 or gimt >> 4:
+        raise ValueError("sskr: multiple groups")
+    for share in shares:
+        if share[:4] != shares[0][:4]:
+            raise ValueError("sskr: mixed shares")
+    threshold = (gimt & 0xf) + 1
+    if len(shares) < threshold:
+        raise ValueError("sskr: too few shares")
+    return shamir_recover(threshold, [(ss[4] & 0xf, ss[5:]) for ss in shares])
+
+
+def sskr_share_cbor(share):
+    return cbor_tag(309, cbor_bytes(share))
+
+
+def sskr_share_ur(share):
+    return "ur:crypto-sskr/" + bytewords_minimal(sskr_share_cbor(share))
+
+
+def sskr_share_from_ur(ur):
+    prefix = "ur:crypto-sskr/"
+    assert ur.startswith(prefix)
+    text = ur[len(prefix):]
+    minimal = {w[0] + w[3]: ii for ii, w in enumerate(BYTEWORDS)}
+    data = bytes(minimal[text[ii:ii + 2]] for ii in range(0, len(text), 2))
+    if zlib.crc32(data[:-4]).to_bytes(4, "big") != data[-4:]:
+        raise ValueError("bytewords checksum")
+    cbor = data[:-4]
+    head = sskr_share_cbor(b"")[:3]
+    if cbor[:3] != head:
+        raise ValueError("sskr: not tag 309")
+    length = cbor[3] & 0x1f
+    start = 4
+    if length == 24:
+        length, start = cbor[4], 5
+    return cbor[start:start + length]
+
+# -- selfcheck -----------------------------------------------------------
+
+
+def selfcheck():
+    def expect(name, got, want):
+        if got != want:
+            sys.exit("reference.py selfcheck: %s\n  got  %s\n  want %s" %
+                     (name, got, want))
+
+    # https://github.com/trezor/python-mnemonic/blob/master/vectors.json
+    abandon = bip39_mnemonic(bytes(16))
+    expect("bip39 zero", abandon, "abandon " * 11 + "about")
+    expect("bip39 seed", bip39_seed(abandon, "TREZOR").hex(),
+           "c55257c360c07c72029aebc1b53c05ed0362ada38ead3e3e9efa3708e5349553"
+           "1f09a6987599d18264c1e1c92f2cf141630c7a3c4ab7c81b2f001698e7463b04")
+    expect("bip39 24 words", bip39_mnemonic(bytes.fromhex(
+        "8080808080808080808080808080808080808080808080808080808080808080")),
+        "letter advice cage absurd amount doctor acoustic avoid letter "
+        "advice cage absurd amount doctor acoustic avoid letter advice "
+        "cage absurd amount doctor acoustic bless")
+    # selftest.ino: selftest_seed and ref_secret, the SHA256 of "123456".
+    expect("bip39 selftest", bip39_mnemonic(bytes.fromhex(
+        "f13ad5414aee7ca944e79669db8e4cb3")),
+        "van stove expect noise treat feed bean version hawk symbol nasty grocery")
+    expect("bip39 rolls", bip39_mnemonic(hashlib.sha256(b"123456").digest()[:16]),
+           "mirror reject rookie talk pudding throw happy era myth already "
+           "payment owner")
+
+    # https://github.com/bitcoin/bips/blob/master/bip-0032.mediawiki#test-vector-1
+    seed = bytes(range(16))
+    root = HDKey(seed)
+    expect("bip32 root", root.serialize(BIP32_VERSIONS["main"][0], True),
+           "xprv9s21ZrQH143K3QTDL4LXw2F7HEK3wJUD2nW2nRk4stbPy6cq3jPPqjiChkVvvNK"
+           "mPGJxWUtg6LnF5kejMRNNU3TGtRBeJgk33yuGBxrMPHi")
+    expect("bip32 path", bip32_xpub(seed, "main", "m/0h/1/2h/2/1000000000")[1],
+           "xpub6H1LXWLaKsWFhvm6RVpEL9P4KfRZSW7abD2ttkWP3SSQvnyA8FSVqNTEcYFgJS2"
+           "UaFcxupHiYkro49S8yGasTvXEYBVPamhGW6cFJodrTHy")
+    # https://github.com/bitcoin/bips/blob/master/bip-0084.mediawiki#test-vectors
+    fingerprint, xpub = bip32_xpub(bip39_seed(abandon), "main", "m/84h/0h/0h")
+    expect("bip84 fingerprint", fingerprint.hex(), "73c5da0a")
+    zpub = base58check_decode(
+        "zpub6rFR7y4Q2AijBEqTUquhVz398htDFrtymD9xYYfG1m4wAcvPhXNfE3EfH1r1ADq"
+        "tfSdVCToUG868RvUUkgDKf31mGDtKsAYz2oz2AGutZYs")
+    expect("bip84 account", xpub,
+           base58check(BIP32_VERSIONS["main"][1].to_bytes(4, "big") + zpub[4:]))
+
+    # bcr-2020-012 and bcr-2020-006, as in test_ur.
+    crypto_seed = bytes.fromhex("c7098580125e2ab0981253468b2dbc52")
+    expect("bytewords", bytewords_minimal(cbor_tag(300, cbor_map([
+        (cbor_uint(1), cbor_bytes(crypto_seed)),
+        (cbor_uint(2), cbor_tag(100, cbor_uint(18394)))]))),
+        "taaddwoeadgdstaslplabghydrpfmkbggufgludprfgmaotpiecffltntddwgmrp")
+    expect("ur crypto-seed", ur_crypto_seed(crypto_seed, 18394),
+           "ur:crypto-seed/oeadgdstaslplabghydrpfmkbggufgludprfgmaotpiecffltnlpqdenos")
+
+    # selftest.ino: selftest_sskr, 2 of 3 shares of selftest_seed.
+    shares = [bytewords_decode(text) for text in (
+        "tuna acid epic gyro gray monk able acid able lava visa flux zero jolt "
+        "runs miss vial need wand race drum kept yank safe taxi part into body away",
+        "tuna acid epic gyro gray monk able acid acid play jolt grim toys quad "
+        "eyes figs kiln exam inky fern fair soap atom task cats jowl cola void waxy",
+        "tuna acid epic gyro gray monk able acid also tomb wave huts omit task "
+        "paid trip song trip wall roof aqua brag away unit help keep vibe skew luau")]
+    shares = [share[4:] for share in shares]	# tag 309, byte string of 21
+    for pair in ((0, 1), (2, 0), (1, 2)):
+        expect("sskr combine %s" % (pair,),
+               sskr_combine([shares[ii] for ii in pair]).hex(),
+               "f13ad5414aee7ca944e79669db8e4cb3")
+    try:
+        sskr_combine([shares[0], shares[1][:5] + bytes([shares[1][5] ^ 1]) + shares[1][6:]])
+        sys.exit("reference.py selfcheck: sskr accepted a bad share")
+    except ValueError:
+        pass
+
+    rng = random.Random(1)
+    for threshold in range(1, 17):
+        secret = rng.randbytes(rng.choice((16, 32)))
+        split = sskr_split(threshold, 16, secret, rng)
+        rng.shuffle(split)
+        expect("sskr %d of 16" % threshold,
+               sskr_combine(split[:threshold]), secret)
+        expect("sskr ur %d" % threshold,
+               sskr_share_from_ur(sskr_share_ur(split[0])), split[0])
+    print("reference.py selfcheck: ok", file=sys.stderr)
+
+# -- corpus --------------------------------------------------------------
+
+
+def corpus_records(args):
+    """The records of one chunk, from its own RNG so the corpus doesn't
+    depend on how it was split across processes."""
+    seed, chunk, count = args
+    rng = random.Random("%s/%d" % (seed, chunk))
+    out = []
+    for _ in range(count):
+        nbytes = rng.choice((16, 32))
+        entropy = rng.randbytes(nbytes)
+        mnemonic = bip39_mnemonic(entropy)
+        mseed = bip39_seed(mnemonic)
+        out.append("\t".join(("bip39", entropy.hex(), mnemonic, mseed.hex())))
+
+        rolls = "".join(rng.choice("123456") for _ in range(rng.randint(1, 120)))
+        out.append("\t".join(("rolls", rolls,
+                              hashlib.sha256(rolls.encode()).digest()[:nbytes].hex())))
+
+        network = rng.choice(("main", "test"))
+        path = "m/" + "/".join(
+            "%d%s" % (rng.randrange(0x80000000), rng.choice(("h", "")))
+            for _ in range(rng.randint(1, 5)))
+        fingerprint, xpub = bip32_xpub(mseed, network, path)
+        out.append("\t".join(("bip32", mseed.hex(), network, path,
+                              fingerprint.hex(), xpub)))
+
+        out.append("\t".join(("ur-seed", entropy.hex(), ur_crypto_seed(entropy))))
+
+        count = rng.randint(1, 16)
+        threshold = rng.randint(1, count)
+        shares = sskr_split(threshold, count, entropy, rng)
+        rng.shuffle(shares)
+        out.append("\t".join(["sskr", entropy.hex()] +
+                             [bytewords_standard(sskr_share_cbor(ss))
+                              for ss in shares[:rng.randint(threshold, count)]]))
+    return out
+
+
+def corpus(count, seed, jobs):
+    chunk = 50
+    work = [(seed, ii, min(chunk, count - ii * chunk))
+            for ii in range((count + chunk - 1) // chunk)]
+    with multiprocessing.Pool(jobs) as pool:
+        for records in pool.imap(corpus_records, work):
+            for record in records:
+                print(record)
+
+
+# -- ceremony ------------------------------------------------------------
+
+
+def ceremony_differs(line):
+    """What is wrong with a seedtool-ceremony NDJSON line by the
+    reference, None if nothing is.  ur_xpub isn't checked."""
+    rec = json.loads(line)
+    if "error" in rec:
+        return "failed: " + rec["error"]
+    seed = bytes.fromhex(rec["seed"])
+    if seed != hashlib.sha256(rec["rolls"].encode()).digest()[:len(seed)]:
+        return "seed differs"
+    if rec["ur_seed"] != ur_crypto_seed(seed):
+        return "ur_seed differs"
+    mnemonic = bip39_mnemonic(seed)
+    if rec["bip39"] != mnemonic:
+        return "bip39 differs"
+    network = "main" if rec["xpub"].startswith("xpub") else "test"
+    if rec["path"] != "m/84h/%dh/0h" % (network != "main"):
+        return "path differs"
+    fingerprint, xpub = bip32_xpub(bip39_seed(mnemonic), network, rec["path"])
+    if rec["fingerprint"] != fingerprint.hex():
+        return "fingerprint differs"
+    if rec["xpub"] != xpub:
+        return "xpub differs"
+    try:
+        shares = [sskr_share_from_ur(ur) for ur in rec["sskr"]]
+        threshold = (shares[0][3] & 0xf) + 1
+        # Every run of threshold shares, wrapping around.
+        for ii in range(len(shares)):
+            subset = (shares + shares)[ii:ii + threshold]
+            if sskr_combine(subset) != seed:
+                return "sskr differs"
+    except (ValueError, KeyError, IndexError):
+        return "sskr differs"
+    return None
+
+
+def check_ceremony(infile, jobs):
+    lines = [line for line in infile if line.strip()]
+    with multiprocessing.Pool(jobs) as pool:
+        diffs = pool.map(ceremony_differs, lines, chunksize=16)
+    failed = 0
+    for lineno, diff in enumerate(diffs, 1):
+        if diff:
+            print("line %d: %s" % (lineno, diff), file=sys.stderr)
+            failed += 1
+    print("reference.py check-ceremony: %d lines, %d differ" %
+          (len(lines), failed), file=sys.stderr)
+    return 1 if failed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+    sub.add_parser("selfcheck")
+    cp = sub.add_parser("corpus")
+    cp.add_argument("--count", type=int, default=1000,
+                    help="records of each kind (default 1000)")
+    cp.add_argument("--seed", default="seedtool",
+                    help="RNG seed, the same seed gives the same corpus")
+    cp.add_argument("-j", "--jobs", type=int, default=os.cpu_count())
+    cc = sub.add_parser("check-ceremony")
+    cc.add_argument("input", nargs="?", default="-",
+                    help="seedtool-ceremony output (default stdin)")
+    cc.add_argument("-j", "--jobs", type=int, default=os.cpu_count())
+    args = parser.parse_args()
+
+    if args.command == "selfcheck":
+        selfcheck()
+    elif args.command == "corpus":
+        selfcheck()
+        corpus(args.count, args.seed, args.jobs)
+    elif args.command == "check-ceremony":
+        selfcheck()
+        infile = sys.stdin if args.input == "-" else open(args.input)
+        sys.exit(check_ceremony(infile, args.jobs))
+
+
+if __name__ == "__main__":
+    main()
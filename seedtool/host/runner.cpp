@@ -0,0 +1,385 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+// Runs the self tests and the differential corpora of the host build
+// in parallel, see ../doc/host_build.md.
+
+#include <Arduino.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "entropy.h"
+#include "keystore.h"
+#include "seed.h"
+#include "selftest.h"
+#include "ur.h"
+#include "util.h"
+
+extern char **environ;
+
+namespace runner_internal {
+
+// -- the child side: one test, or a range of corpus records ----------
+
+bool parse_hex(std::string const & hex, std::vector<uint8_t> & o_bytes) {
+    if (hex.size() % 2)
+        return false;
+    o_bytes.clear();
+    for (size_t ii = 0; ii < hex.size(); ii += 2) {
+        char *end;
+        std::string byte = hex.substr(ii, 2);
+        o_bytes.push_back((uint8_t) strtoul(byte.c_str(), &end, 16));
+        if (*end)
+            return false;
+    }
+    return true;
+}
+
+std::vector<std::string> split_fields(std::string const & line) {
+    std::vector<std::string> out;
+    size_t start = 0, tab;
+    while ((tab = line.find('\t', start)) != std::string::npos) {
+        out.push_back(line.substr(start, tab - start));
+        start = tab + 1;
+    }
+    out.push_back(line.substr(start));
+    return out;
+}
+
+// Each check returns NULL if the firmware agrees with the reference,
+// otherwise what differs.
+
+// bip39 <entropy> <mnemonic> <BIP39 seed>
+template <size_t N>
+char const * check_bip39(std::vector<uint8_t> const & entropy,
+                         std::string const & mnemonic,
+                         std::vector<uint8_t> const & mseed) {
+    SeedT<N> seed(entropy.data());
+    BIP39SeqT<N> bip39(&seed);
+    if (bip39.get_mnemonic_as_string() != mnemonic.c_str())
+        return "mnemonic";
+    if (mseed.size() != BIP39_SEED_LEN_512 ||
+        memcmp(bip39.mnemonic_seed, mseed.data(), BIP39_SEED_LEN_512) != 0)
+        return "BIP39 seed";
+    uint16_t words[BIP39SeqT<N>::WORD_COUNT];
+    for (size_t ii = 0; ii < BIP39SeqT<N>::WORD_COUNT; ++ii)
+        words[ii] = bip39.get_word(ii);
+    BIP39SeqT<N> * restored = BIP39SeqT<N>::from_words(words);
+    SeedT<N> * back = restored->restore_seed();
+    bool ok = back && *back == seed;
+    delete back;
+    delete restored;
+    return ok ? NULL : "restore from words";
+}
+
+// rolls <dice rolls> <seed>
+template <size_t N>
+char const * check_rolls(std::string const & rolls,
+                         std::vector<uint8_t> const & expected) {
+    SeedT<N> * seed = SeedT<N>::from_rolls(String(rolls.c_str()));
+    bool ok = memcmp(seed->data, expected.data(), N) == 0;
+    delete seed;
+    return ok ? NULL : "seed";
+}
+
+// bip32 <BIP39 seed> <main|test> <path> <fingerprint> <xpub>
+char const * check_bip32(std::vector<std::string> const & ff) {
+    std::vector<uint8_t> mseed;
+    if (ff.size() != 6 || !parse_hex(ff[1], mseed))
+        return "malformed record";
+    Keystore ks(ff[2] == "main" ? MAINNET : TESTNET);
+    if (!ks.update_root_key(mseed.data(), mseed.size()))
+        return "root key";
+    char fingerprint[9];
+    snprintf(fingerprint, sizeof(fingerprint), "%08x", (unsigned int) ks.fingerprint);
+    if (ff[4] != fingerprint)
+        return "fingerprint";
+    if (!ks.check_derivation_path(ff[3].c_str(), true))
+        return "derivation path";
+    ext_key key;
+    char * xpub = NULL;
+    if (!ks.get_xpriv(&key) || !ks.xpub_to_base58(&key, &xpub, false))
+        return "derivation";
+    bool ok = ff[5] == xpub;
+    wally_free_string(xpub);
+    memzero(&key, sizeof(key));
+    return ok ? NULL : "xpub";
+}
+
+// ur-seed <seed> <ur>
+char const * check_ur_seed(std::vector<uint8_t> & seed, std::string const & ur) {
+    String out;
+    if (!ur_encode_crypto_seed(seed.data(), seed.size(), out))
+        return "encode";
+    return ur == out.c_str() ? NULL : "ur";
+}
+
+// sskr <seed> <share bytewords>...
+template <size_t N>
+char const * check_sskr(std::vector<std::string> const & ff,
+                        std::vector<uint8_t> const & expected) {
+    SSKRShareSeqT<N> sskr;
+    for (size_t ii = 2; ii < ff.size(); ++ii) {
+        if (!sskr.get_share_from_ur(String(ff[ii].c_str()), ii - 2))
+            return "share decode";
+        if (sskr.get_share_strings(ii - 2) != ff[ii].c_str())
+            return "share encode";
+    }
+    SeedT<N> * seed = sskr.restore_seed();
+    bool ok = seed && memcmp(seed->data, expected.data(), N) == 0;
+    delete seed;
+    return ok ? NULL : "restore";
+}
+
+char const * check_record(std::vector<std::string> const & ff) {
+    std::vector<uint8_t> bytes;
+    if (ff[0] == "bip32")
+        return check_bip32(ff);
+    if (ff.size() < 3)
+        return "malformed record";
+    if (ff[0] == "rolls") {
+        if (!parse_hex(ff[2], bytes))
+            return "malformed record";
+        return bytes.size() == 16 ? check_rolls<16>(ff[1], bytes) :
+            bytes.size() == 32 ? check_rolls<32>(ff[1], bytes) : "seed size";
+    }
+    if (!parse_hex(ff[1], bytes) || (bytes.size() != 16 && bytes.size() != 32))
+        return "malformed record";
+    bool const small = bytes.size() == 16;
+    if (ff[0] == "bip39") {
+        std::vector<uint8_t> mseed;
+        if (ff.size() != 4 || !parse_hex(ff[3], mseed))
+            return "malformed record";
+        return small ? check_bip39<16>(bytes, ff[2], mseed) :
+            check_bip39<32>(bytes, ff[2], mseed);
+    }
+    if (ff[0] == "ur-seed")
+        return check_ur_seed(bytes, ff[2]);
+    if (ff[0] == "sskr")
+        return small ? check_sskr<16>(ff, bytes) : check_sskr<32>(ff, bytes);
+    return "unknown record";
+}
+
+int run_corpus(char const * path, size_t first, size_t last) {
+    std::ifstream in(path);
+    if (!in) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return 2;
+    }
+    std::string line;
+    size_t lineno = 0, nfailed = 0;
+    while (lineno < last && std::getline(in, line)) {
+        if (lineno++ < first || line.empty())
+            continue;
+        std::vector<std::string> ff = split_fields(line);
+        char const * diff = check_record(ff);
+        if (diff) {
+            printf("%s:%zu: %s: %s differs\n", path, lineno, ff[0].c_str(), diff);
+            ++nfailed;
+        }
+    }
+    return nfailed ? 1 : 0;
+}
+
+int run_test(size_t ndx) {
+    entropy_setup();
+    return selftest_testrun(ndx) ? 0 : 1;
+}
+
+// -- the parent side: a thread pool, each job in a child process ------
+
+struct Job {
+    std::string name;
+    std::vector<std::string> args;
+    int status;
+    uint32_t ms;
+    std::string output;
+};
+
+// Runs argv to completion, collecting its stdout and stderr.
+int spawn(std::vector<std::string> const & args, std::string & o_output) {
+    // Close on exec, or the children other threads spawn meanwhile
+    // would hold the write end open.
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0)
+        return -1;
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], 1);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], 2);
+
+    std::vector<char *> argv;
+    for (std::string const & arg : args)
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    argv.push_back(NULL);
+    pid_t pid;
+    int rv = posix_spawn(&pid, "/proc/self/exe", &actions, NULL, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+    if (rv != 0) {
+        close(fds[0]);
+        return -1;
+    }
+
+    char buf[4096];
+    ssize_t nn;
+    while ((nn = read(fds[0], buf, sizeof(buf))) > 0 || (nn < 0 && errno == EINTR))
+        if (nn > 0)
+            o_output.append(buf, nn);
+    close(fds[0]);
+    int status;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+        ;
+    return status;
+}
+
+// What went wrong beyond failing, if anything, for the result line.
+std::string describe(int status) {
+    if (status < 0)
+        return "  (could not start)";
+    if (WIFSIGNALED(status))
+        return std::string("  (killed by ") + strsignal(WTERMSIG(status)) + ")";
+    return "";
+}
+
+void usage(char const * argv0) {
+    fprintf(stderr,
+            "usage: %s [-j jobs] [-t fast|full] [-k name] [-c corpus.tsv]"
+            " [-s lines] [-v] [-l]\n"
+            "  -j  parallel jobs (default: one per core)\n"
+            "  -t  only this tier of self tests (default: both)\n"
+            "  -k  only self tests whose name contains this\n"
+            "  -c  also check a reference.py corpus\n"
+            "  -s  corpus records per job (default 100)\n"
+            "  -v  show the log of passing jobs too\n"
+            "  -l  list the self tests\n", argv0);
+    exit(2);
+}
+
+} // namespace runner_internal
+
+int main(int argc, char **argv) {
+    using namespace runner_internal;
+
+    // The child side.  Unbuffered, so a crash doesn't lose the log.
+    if (argc > 1 && strncmp(argv[1], "--", 2) == 0)
+        setvbuf(stdout, NULL, _IONBF, 0);
+    if (argc == 3 && strcmp(argv[1], "--test") == 0)
+        return run_test(strtoul(argv[2], NULL, 10));
+    if (argc == 5 && strcmp(argv[1], "--corpus") == 0)
+        return run_corpus(argv[2], strtoul(argv[3], NULL, 10),
+                          strtoul(argv[4], NULL, 10));
+
+    size_t njobs = std::thread::hardware_concurrency();
+    int tier = -1;
+    char const * filter = NULL;
+    char const * corpus = NULL;
+    size_t shard = 100;
+    bool verbose = false, list = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "j:t:k:c:s:vl")) != -1) {
+        switch (opt) {
+        case 'j': njobs = strtoul(optarg, NULL, 10); break;
+        case 't':
+            if (strcmp(optarg, "fast") == 0)
+                tier = SELFTEST_FAST;
+            else if (strcmp(optarg, "full") == 0)
+                tier = SELFTEST_FULL;
+            else
+                usage(argv[0]);
+            break;
+        case 'k': filter = optarg; break;
+        case 'c': corpus = optarg; break;
+        case 's': shard = strtoul(optarg, NULL, 10); break;
+        case 'v': verbose = true; break;
+        case 'l': list = true; break;
+        default: usage(argv[0]);
+        }
+    }
+    if (optind != argc || njobs == 0 || shard == 0)
+        usage(argv[0]);
+
+    std::vector<Job> jobs;
+    for (size_t ndx = 0; ndx < selftest_numtests(); ++ndx) {
+        String name = selftest_testname(ndx);
+        if ((tier >= 0 && selftest_testtier(ndx) != tier) ||
+            (filter && !strstr(name.c_str(), filter)))
+            continue;
+        if (list) {
+            printf("%s\n", name.c_str());
+            continue;
+        }
+        jobs.push_back({ name.c_str(), { argv[0], "--test", std::to_string(ndx) } });
+    }
+    if (list)
+        return 0;
+    if (corpus) {
+        std::ifstream in(corpus);
+        if (!in) {
+            fprintf(stderr, "%s: %s\n", corpus, strerror(errno));
+            return 2;
+        }
+        size_t nlines = 0;
+        std::string line;
+        while (std::getline(in, line))
+            ++nlines;
+        for (size_t first = 0; first < nlines; first += shard) {
+            size_t last = std::min(first + shard, nlines);
+            jobs.push_back({ std::string(corpus) + ":" + std::to_string(first + 1) +
+                             "-" + std::to_string(last),
+                             { argv[0], "--corpus", corpus,
+                               std::to_string(first), std::to_string(last) } });
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> next(0);
+    std::mutex print_mutex;
+    size_t nfailed = 0;
+    auto worker = [&]() {
+        size_t ndx;
+        while ((ndx = next++) < jobs.size()) {
+            Job & job = jobs[ndx];
+            auto t0 = std::chrono::steady_clock::now();
+            job.status = spawn(job.args, job.output);
+            job.ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - t0).count();
+
+            bool passed = job.status == 0;
+            std::lock_guard<std::mutex> lock(print_mutex);
+            printf("%-8s %6u ms  %s%s\n", passed ? "passed" : "FAILED",
+                   (unsigned) job.ms, job.name.c_str(),
+                   describe(job.status).c_str());
+            if (!passed || verbose)
+                fputs(job.output.c_str(), stdout);
+            nfailed += !passed;
+            fflush(stdout);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t ii = 0; ii < std::min(njobs, jobs.size()); ++ii)
+        pool.emplace_back(worker);
+    for (std::thread & thread : pool)
+        thread.join();
+
+    uint32_t busy = 0;
+    for (Job const & job : jobs)
+        busy += job.ms;
+    uint32_t wall = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    printf("%zu jobs, %zu failed, %u ms (%u ms of jobs on %zu threads)\n",
+           jobs.size(), nfailed, (unsigned) wall, (unsigned) busy,
+           std::min(njobs, jobs.size()));
+    return nfailed ? 1 : 0;
+}
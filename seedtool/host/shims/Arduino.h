@@ -0,0 +1,227 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/**
+ * The part of the Arduino core the sketch's non-hardware modules and
+ * bc-ur-arduino use, for the Linux host build (see doc/host_build.md).
+ * String and Print follow the Arduino API; Serial writes to stdout and
+ * reads what serial_host_feed() queued.  Only what the sketch calls is
+ * here, a missing piece is a compile error rather than a silent stub.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <math.h>
+
+#ifdef __cplusplus
+#include <algorithm>
+using std::min;
+using std::max;
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define pgm_read_pointer(p) (*(p))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// There are no interrupts on the host, the key queue is only touched
+// from the thread running the sketch.
+static inline void noInterrupts(void) {}
+static inline void interrupts(void) {}
+
+#ifdef __cplusplus
+}
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+inline bool isDigit(int c) { return isdigit(c) != 0; }
+inline bool isAlpha(int c) { return isalpha(c) != 0; }
+inline bool isSpace(int c) { return isspace(c) != 0; }
+
+class String {
+public:
+    String(const char *cstr = "");
+    String(const String &str);
+    String(const __FlashStringHelper *str);
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(double value, unsigned char decimals = 2);
+    ~String();
+
+    String & operator=(const String &rhs);
+    String & operator=(const char *cstr);
+
+    bool reserve(unsigned int size);
+    unsigned int length(void) const { return len_; }
+    const char * c_str() const { return buf_; }
+
+    bool concat(const char *cstr, unsigned int length);
+    bool concat(const String &str) { return concat(str.buf_, str.len_); }
+    bool concat(const char *cstr) { return concat(cstr, strlen(cstr)); }
+    bool concat(char c) { return concat(&c, 1); }
+    bool concat(int value) { return concat(String(value)); }
+    bool concat(unsigned int value) { return concat(String(value)); }
+    bool concat(long value) { return concat(String(value)); }
+    bool concat(unsigned long value) { return concat(String(value)); }
+
+    template <class T> String & operator+=(T const &rhs) {
+        concat(rhs);
+        return *this;
+    }
+
+    int compareTo(const String &s) const { return strcmp(buf_, s.buf_); }
+    bool equals(const String &s) const {
+        return len_ == s.len_ && memcmp(buf_, s.buf_, len_) == 0;
+    }
+    bool equals(const char *cstr) const { return strcmp(buf_, cstr) == 0; }
+    bool operator==(const String &rhs) const { return equals(rhs); }
+    bool operator==(const char *cstr) const { return equals(cstr); }
+    bool operator!=(const String &rhs) const { return !equals(rhs); }
+    bool operator!=(const char *cstr) const { return !equals(cstr); }
+    bool operator<(const String &rhs) const { return compareTo(rhs) < 0; }
+    bool startsWith(const String &prefix) const;
+    bool endsWith(const String &suffix) const;
+
+    char charAt(unsigned int index) const { return (*this)[index]; }
+    void setCharAt(unsigned int index, char c);
+    char operator[](unsigned int index) const;
+    char & operator[](unsigned int index);
+    void getBytes(unsigned char *buf, unsigned int bufsize,
+                  unsigned int index = 0) const;
+    void toCharArray(char *buf, unsigned int bufsize,
+                     unsigned int index = 0) const {
+        getBytes((unsigned char *) buf, bufsize, index);
+    }
+
+    int indexOf(char ch, unsigned int from = 0) const;
+    int indexOf(const String &str, unsigned int from = 0) const;
+    int lastIndexOf(char ch) const;
+    String substring(unsigned int begin) const { return substring(begin, len_); }
+    String substring(unsigned int begin, unsigned int end) const;
+
+    void replace(char find, char replace);
+    void replace(const String &find, const String &replace);
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void toLowerCase(void);
+    void toUpperCase(void);
+    void trim(void);
+    long toInt(void) const { return atol(buf_); }
+
+private:
+    char *buf_;
+    unsigned int cap_;
+    unsigned int len_;
+    static char empty_[1];
+    void assign(const char *cstr, unsigned int length);
+};
+
+String operator+(const String &lhs, const String &rhs);
+String operator+(const String &lhs, const char *rhs);
+String operator+(const char *lhs, const String &rhs);
+String operator+(const String &lhs, char rhs);
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t size);
+    size_t write(const char *str) {
+        return str ? write((const uint8_t *) str, strlen(str)) : 0;
+    }
+    size_t write(const char *buf, size_t size) {
+        return write((const uint8_t *) buf, size);
+    }
+
+    size_t print(const __FlashStringHelper *str) { return write((const char *) str); }
+    size_t print(const String &str) { return write(str.c_str(), str.length()); }
+    size_t print(const char *str) { return write(str); }
+    size_t print(char c) { return write((uint8_t) c); }
+    size_t print(unsigned char value, int base = DEC) { return print((unsigned long) value, base); }
+    size_t print(int value, int base = DEC) { return print((long) value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long) value, base); }
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int decimals = 2);
+
+    template <class T> size_t println(T const &value) {
+        size_t nn = print(value);
+        return nn + println();
+    }
+    template <class T> size_t println(T const &value, int format) {
+        size_t nn = print(value, format);
+        return nn + println();
+    }
+    size_t println(void) { return write("\r\n"); }
+};
+
+class Stream : public Print {
+public:
+    Stream() : timeout_(1000) {}
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    void setTimeout(unsigned long ms) { timeout_ = ms; }
+    // Waits up to the timeout for each byte, like the Arduino core.
+    size_t readBytes(char *buf, size_t len);
+    size_t readBytes(uint8_t *buf, size_t len) {
+        return readBytes((char *) buf, len);
+    }
+
+private:
+    unsigned long timeout_;
+};
+
+class HostSerial : public Stream {
+public:
+    void begin(unsigned long) {}
+    operator bool() { return true; }
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+    void flush();
+};
+
+extern HostSerial Serial;
+
+// Queues bytes for Serial.read(), as if the host had sent them.
+void serial_host_feed(const uint8_t *buf, size_t len);
+
+#endif // __cplusplus
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,13 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#ifndef HOST_ARDUINOSTL_H
+#define HOST_ARDUINOSTL_H
+
+// The host has the real standard library, ArduinoSTL is its subset.
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <set>
+
+#endif // HOST_ARDUINOSTL_H
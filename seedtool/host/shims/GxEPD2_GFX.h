@@ -0,0 +1,9 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#ifndef HOST_GXEPD2_GFX_H
+#define HOST_GXEPD2_GFX_H
+
+// There is no display on the host, hardware.h only names the class.
+class GxEPD2_GFX;
+
+#endif // HOST_GXEPD2_GFX_H
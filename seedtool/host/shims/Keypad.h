@@ -0,0 +1,9 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#ifndef HOST_KEYPAD_H
+#define HOST_KEYPAD_H
+
+// hardware.h only needs NO_KEY, the host keys come from hw_key_inject.
+#define NO_KEY '\0'
+
+#endif // HOST_KEYPAD_H
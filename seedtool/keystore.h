@@ -20,16 +20,33 @@ enum stdDerivation {
  * @brief  * This class initializes/updates bip32 root key
  *         * It is also a database that stores xpub configuration set by user.
  *           @FIXME: DB part should be moved into UI code
+ *         * Each instance is a separate context with its own network, the
+ *           UI uses the global keystore.
 */
 class Keystore
 {
   public:
-    Keystore(void);
+    Keystore(NetwtorkType i_network=MAINNET);
 
     /**
      * @brief  Whenever seed changes, call this to update bip32 root key
      */
-    bool update_root_key(uint8_t *seed, size_t len, NetwtorkType network=network.get_network());
+    bool update_root_key(uint8_t *seed, size_t len);
+
+    /**
+     * @brief  switch to another network and update bip32 root key
+     */
+    bool update_root_key(uint8_t *seed, size_t len, NetwtorkType i_network);
+
+    /**
+     * @brief  use a root key derived elsewhere, e.g. kept by a SeedContext
+     */
+    void set_root_key(ext_key const *key);
+
+    /**
+     * @brief  forget the root key, there is no current seed
+     */
+    void clear_root_key(void);
 
     /**
      * @brief  read the last derivation path set/saved by user or default one
@@ -89,6 +106,7 @@ class Keystore
     String derivation_path;
     uint32_t fingerprint;
     ext_key root;
+    Network network;
 
   private:
     int res;
@@ -98,4 +116,112 @@ class Keystore
 
 extern Keystore keystore;
 
+/**
+ * @brief  Keys derived from one seed, kept for as long as the seed so
+ *         moving between key screens does no crypto.  Root keys are
+ *         derived once per network, account keys and their encodings
+ *         are recomputed only when the network, path or format change.
+*/
+class SeedContext
+{
+  public:
+    static size_t const SEED_LEN = 64; // BIP39_SEED_LEN_512
+
+    SeedContext(uint8_t const *mnemonic_seed);
+    ~SeedContext();
+
+    /**
+     * @brief  root key of a network, derived on first use
+     */
+    ext_key const *root(NetwtorkType network);
+
+    /**
+     * @brief  set ks's root key to the root key of its network
+     */
+    bool select(Keystore &ks);
+
+    /**
+     * @brief  key at path below the root key of network, the last few
+     *         derived are kept
+     */
+    ext_key const *derive(NetwtorkType network, uint32_t const *path, uint32_t path_len);
+
+    struct Account {
+        ext_key key;
+        String xpub;        // base58
+        String xpriv;
+        String ur_xpub;
+        String ur_xpriv;
+    };
+
+    /**
+     * @brief  account key at ks's derivation path and its encodings,
+     *         NULL on failure
+     * @pre    select(ks)
+     */
+    Account const *account(Keystore &ks, bool slip132);
+
+  private:
+    static size_t const NUM_NETWORKS = 3;
+    static size_t const NUM_DERIVED = 4;
+
+    struct Derived {
+        bool valid;
+        NetwtorkType network;
+        uint32_t path[MAX_DERIVATION_PATH_LEN];
+        uint32_t path_len;
+        ext_key key;
+    };
+
+    uint8_t seed[SEED_LEN];
+    bool have_root[NUM_NETWORKS];
+    ext_key roots[NUM_NETWORKS];
+    Derived derived[NUM_DERIVED];
+    size_t next_derived;
+
+    // what acct was computed for
+    bool have_account;
+    NetwtorkType account_network;
+    uint32_t account_path[MAX_DERIVATION_PATH_LEN];
+    uint32_t account_path_len;
+    bool account_slip132;
+    bool account_standard;
+    Account acct;
+};
+
+/**
+ * @brief  wsh(sortedmulti(k,...)) descriptor of the MULTISIG_NATIVE_SEGWIT
+ *         cosigner keys of n seeds, taken from their contexts' cached keys
+ * @param[in]  contexts: contexts of the seeds
+ * @param[in]  n: number of seeds
+ * @param[in]  network: network of the keys
+ * @param[in]  k: signatures required, 1..n
+ * @param[out] o_desc: descriptor
+ * @return     true on success
+ */
+bool multisig_descriptor(SeedContext * const *contexts, size_t n, NetwtorkType network,
+                         uint8_t k, String &o_desc);
+
+/**
+ * @brief  account key of one of the standard script types
+ */
+struct AccountKey {
+    stdDerivation script;
+    uint32_t account;
+    uint32_t path[4];
+    uint32_t path_len;
+    ext_key key;
+};
+
+size_t const NUM_STD_DERIVATIONS = 3;
+
+/**
+ * @brief  keys of accounts 0..naccounts-1 for every standard script type,
+ *         m/84h/coinh, m/49h/coinh and m/48h/coinh are derived only once
+ * @param[out] o_keys: NUM_STD_DERIVATIONS * naccounts keys
+ * @return     true on success
+ */
+bool derive_account_keys(SeedContext &ctx, NetwtorkType network, uint32_t naccounts,
+                         AccountKey *o_keys);
+
 #endif
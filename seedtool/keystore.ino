@@ -1,8 +1,31 @@
+#include <bc-crypto-base.h>
+
 #include "keystore.h"
+#include "log.h"
+#include "ur.h"
+#include "util.h"
+
+namespace keystore_internal {
+
+uint32_t bip32_version(NetwtorkType network) {
+    switch(network) {
+        case REGTEST:
+        case TESTNET:
+            return BIP32_VER_TEST_PRIVATE;
+        case MAINNET:
+            return BIP32_VER_MAIN_PRIVATE;
+        default:
+            return BIP32_VER_TEST_PRIVATE;
+    }
+}
+
+} // namespace keystore_internal
 
 Keystore keystore = Keystore();
 
-Keystore::Keystore(void) {
+Keystore::Keystore(NetwtorkType i_network)
+    : network(i_network)
+{
     // set default path for single native segwit key
     stdDerivation stdDer = SINGLE_NATIVE_SEGWIT;
     save_standard_derivation_path(&stdDer, network.get_network());
@@ -12,32 +35,42 @@ String Keystore::get_derivation_path(void) {
     return derivation_path;
 }
 
-bool Keystore::update_root_key(uint8_t *seed, size_t len, NetwtorkType network)
+bool Keystore::update_root_key(uint8_t *seed, size_t len, NetwtorkType i_network)
 {
-    uint32_t version_code = BIP32_VER_TEST_PRIVATE;
-    switch(network) {
-        case REGTEST:
-        case TESTNET:
-            version_code = BIP32_VER_TEST_PRIVATE;
-            break;
-        case MAINNET:
-            version_code = BIP32_VER_MAIN_PRIVATE;
-            break;
-        default:
-            version_code = BIP32_VER_TEST_PRIVATE;
-    }
+    network.set_network(i_network);
+    return update_root_key(seed, len);
+}
+
+bool Keystore::update_root_key(uint8_t *seed, size_t len)
+{
+    using namespace keystore_internal;
 
-    res = bip32_key_from_seed(seed, len, version_code, 0, &root);
+    ext_key key;
+    res = bip32_key_from_seed(seed, len, bip32_version(network.get_network()), 0, &key);
     if (res != WALLY_OK) {
         return false;
     }
 
+    set_root_key(&key);
+    memzero(&key, sizeof(key));
+
+    return true;
+}
+
+void Keystore::set_root_key(ext_key const *key)
+{
+    root = *key;
+
     ((uint8_t *)&fingerprint)[0] = root.hash160[3];
     ((uint8_t *)&fingerprint)[1] = root.hash160[2];
     ((uint8_t *)&fingerprint)[2] = root.hash160[1];
     ((uint8_t *)&fingerprint)[3] = root.hash160[0];
+}
 
-    return true;
+void Keystore::clear_root_key(void)
+{
+    memzero(&root, sizeof(root));
+    fingerprint = 0;
 }
 
 bool Keystore::calc_derivation_path(const char *path, uint32_t *derivation, uint32_t &derivation_len) {
@@ -112,12 +145,12 @@ bool Keystore::check_derivation_path(const char *path, bool save) {
       uint32_t derivation_tmp[MAX_DERIVATION_PATH_LEN];
 
       if (calc_derivation_path(path, derivation_tmp, derivationLen_tmp) == false) {
-        Serial.println("calc_deriv fail 1");
+        LOG_DEBUG("calc_deriv fail 1\n");
         return false;
       }
 
       if (derivationLen_tmp > MAX_DERIVATION_PATH_LEN) {
-          Serial.println("calc_deriv fail 2");
+          LOG_DEBUG("calc_deriv fail 2\n");
           return false;
       }
 
@@ -286,3 +319,197 @@ bool Keystore::xpriv_to_base58(ext_key *key, char **output, bool slip132) {
     else
         return false;
 }
+
+SeedContext::SeedContext(uint8_t const *mnemonic_seed)
+    : next_derived(0)
+    , have_account(false)
+{
+    memcpy(seed, mnemonic_seed, SEED_LEN);
+    for (size_t i=0; i<NUM_NETWORKS; i++)
+        have_root[i] = false;
+    for (size_t i=0; i<NUM_DERIVED; i++)
+        derived[i].valid = false;
+}
+
+SeedContext::~SeedContext() {
+    memzero(seed, sizeof(seed));
+    memzero(roots, sizeof(roots));
+    memzero(derived, sizeof(derived));
+    memzero(&acct.key, sizeof(acct.key));
+    wipe_string(acct.xpriv);
+    wipe_string(acct.ur_xpriv);
+}
+
+ext_key const *SeedContext::root(NetwtorkType network) {
+    using namespace keystore_internal;
+
+    if (!have_root[network]) {
+        if (bip32_key_from_seed(seed, SEED_LEN, bip32_version(network), 0, &roots[network]) != WALLY_OK)
+            return NULL;
+        have_root[network] = true;
+    }
+    return &roots[network];
+}
+
+bool SeedContext::select(Keystore &ks) {
+    ext_key const *key = root(ks.network.get_network());
+    if (key == NULL)
+        return false;
+    ks.set_root_key(key);
+    return true;
+}
+
+ext_key const *SeedContext::derive(NetwtorkType network, uint32_t const *path, uint32_t path_len) {
+    for (size_t i=0; i<NUM_DERIVED; i++) {
+        Derived &d = derived[i];
+        if (d.valid && d.network == network && d.path_len == path_len &&
+            memcmp(d.path, path, path_len*sizeof(uint32_t)) == 0)
+            return &d.key;
+    }
+
+    ext_key const *parent = root(network);
+    if (parent == NULL || path_len > MAX_DERIVATION_PATH_LEN)
+        return NULL;
+
+    // replace the oldest
+    Derived &d = derived[next_derived];
+    next_derived = (next_derived + 1) % NUM_DERIVED;
+    d.valid = false;
+    if (bip32_key_from_parent_path(parent, path, path_len, BIP32_FLAG_KEY_PRIVATE, &d.key) != WALLY_OK)
+        return NULL;
+    d.network = network;
+    memcpy(d.path, path, path_len*sizeof(uint32_t));
+    d.path_len = path_len;
+    d.valid = true;
+    return &d.key;
+}
+
+SeedContext::Account const *SeedContext::account(Keystore &ks, bool slip132) {
+    NetwtorkType network = ks.network.get_network();
+    bool standard = ks.is_standard_derivation_path();
+
+    if (have_account && account_network == network &&
+        account_path_len == ks.derivationLen &&
+        memcmp(account_path, ks.derivation, ks.derivationLen*sizeof(uint32_t)) == 0 &&
+        account_slip132 == slip132 && account_standard == standard)
+        return &acct;
+
+    have_account = false;
+    // The old private encodings aren't left behind in freed memory.
+    wipe_string(acct.xpriv);
+    wipe_string(acct.ur_xpriv);
+    ext_key const *key = derive(network, ks.derivation, ks.derivationLen);
+    if (key == NULL)
+        return NULL;
+    acct.key = *key;
+
+    char *xpub = NULL;
+    char *xpriv = NULL;
+    bool ok = ks.xpub_to_base58(&acct.key, &xpub, slip132) &&
+              ks.xpriv_to_base58(&acct.key, &xpriv, slip132) &&
+              ur_encode_hd_pubkey_xpub(ks, acct.ur_xpub, ks.derivation, ks.derivationLen) &&
+              ur_encode_hd_pubkey_xpriv(ks, acct.ur_xpriv, ks.derivation, ks.derivationLen);
+    if (ok) {
+        acct.xpub = xpub;
+        acct.xpriv = xpriv;
+    }
+    if (xpub)
+        wally_free_string(xpub);
+    if (xpriv)
+        wally_free_string(xpriv);
+    if (!ok)
+        return NULL;
+
+    account_network = network;
+    memcpy(account_path, ks.derivation, ks.derivationLen*sizeof(uint32_t));
+    account_path_len = ks.derivationLen;
+    account_slip132 = slip132;
+    account_standard = standard;
+    have_account = true;
+    return &acct;
+}
+
+bool multisig_descriptor(SeedContext * const *contexts, size_t n, NetwtorkType network,
+                         uint8_t k, String &o_desc) {
+    if (n == 0 || k < 1 || k > n)
+        return false;
+
+    unsigned int coin = network == MAINNET ? 0 : 1;
+    uint32_t path[] = {
+        48 | BIP32_INITIAL_HARDENED_CHILD,
+        coin | BIP32_INITIAL_HARDENED_CHILD,
+        0 | BIP32_INITIAL_HARDENED_CHILD,
+        2 | BIP32_INITIAL_HARDENED_CHILD,
+    };
+    size_t const path_len = sizeof(path) / sizeof(*path);
+
+    o_desc = "wsh(sortedmulti(" + String(k);
+    for (size_t i=0; i<n; i++) {
+        ext_key const *root = contexts[i]->root(network);
+        ext_key const *key = contexts[i]->derive(network, path, path_len);
+        if (root == NULL || key == NULL)
+            return false;
+
+        char *xpub = NULL;
+        if (bip32_key_to_base58(key, BIP32_FLAG_KEY_PUBLIC, &xpub) != WALLY_OK)
+            return false;
+
+        // root fingerprint is the first 4 bytes of its hash160
+        char origin[32];
+        snprintf(origin, sizeof(origin), ",[%02x%02x%02x%02x/48h/%uh/0h/2h]",
+                 root->hash160[0], root->hash160[1], root->hash160[2], root->hash160[3], coin);
+        o_desc += origin;
+        o_desc += xpub;
+        wally_free_string(xpub);
+    }
+    o_desc += "))";
+    return true;
+}
+
+bool derive_account_keys(SeedContext &ctx, NetwtorkType network, uint32_t naccounts,
+                         AccountKey *o_keys) {
+    static stdDerivation const scripts[NUM_STD_DERIVATIONS] =
+        { SINGLE_NATIVE_SEGWIT, SINGLE_NESTED_SEGWIT, MULTISIG_NATIVE_SEGWIT };
+    static uint32_t const purposes[NUM_STD_DERIVATIONS] = { 84, 49, 48 };
+    uint32_t const coin = network == MAINNET ? 0 : 1;
+
+    AccountKey *out = o_keys;
+    for (size_t i=0; i<NUM_STD_DERIVATIONS; i++) {
+        uint32_t prefix[] = {
+            purposes[i] | BIP32_INITIAL_HARDENED_CHILD,
+            coin | BIP32_INITIAL_HARDENED_CHILD,
+        };
+        // copy, the context may reuse its slot on the next derive
+        ext_key const *derived = ctx.derive(network, prefix, 2);
+        if (derived == NULL)
+            return false;
+        ext_key parent = *derived;
+
+        for (uint32_t account=0; account<naccounts; account++, out++) {
+            out->script = scripts[i];
+            out->account = account;
+            out->path[0] = prefix[0];
+            out->path[1] = prefix[1];
+            out->path[2] = account | BIP32_INITIAL_HARDENED_CHILD;
+            out->path_len = 3;
+            if (bip32_key_from_parent(&parent, out->path[2], BIP32_FLAG_KEY_PRIVATE, &out->key) != WALLY_OK) {
+                memzero(&parent, sizeof(parent));
+                return false;
+            }
+            if (scripts[i] == MULTISIG_NATIVE_SEGWIT) {
+                // m/48h/coinh/accounth/2h
+                ext_key account_key = out->key;
+                out->path[3] = 2 | BIP32_INITIAL_HARDENED_CHILD;
+                out->path_len = 4;
+                int res = bip32_key_from_parent(&account_key, out->path[3], BIP32_FLAG_KEY_PRIVATE, &out->key);
+                memzero(&account_key, sizeof(account_key));
+                if (res != WALLY_OK) {
+                    memzero(&parent, sizeof(parent));
+                    return false;
+                }
+            }
+        }
+        memzero(&parent, sizeof(parent));
+    }
+    return true;
+}
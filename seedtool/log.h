@@ -0,0 +1,51 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#ifndef LOG_H
+#define LOG_H
+
+#include "util.h"
+
+/**
+ * Levelled logging to the serial port.  A statement above LOG_LEVEL is
+ * an if (false) the compiler drops, its format arguments are checked
+ * but never evaluated, so trace logging costs nothing when disabled.
+ *
+ * Seeds, shares and words are only ever logged at LOG_LEVEL_TRACE.
+ * Build with -DLOG_LEVEL=LOG_LEVEL_TRACE to see everything.
+ *
+ * Logging is for diagnostics.  What the user asked for, exported keys,
+ * URs and signatures, is written to Serial at any log level.
+ */
+
+#define LOG_LEVEL_NONE	0
+#define LOG_LEVEL_ERROR	1
+#define LOG_LEVEL_WARN	2
+#define LOG_LEVEL_INFO	3		// progress, results of self tests
+#define LOG_LEVEL_DEBUG	4		// key presses, timings
+#define LOG_LEVEL_TRACE	5		// secrets, per item detail
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_ENABLED(_level) ((_level) <= LOG_LEVEL)
+
+#define LOG_AT(_level, ...)                                             \
+    do {                                                                \
+        if (LOG_ENABLED(_level))                                        \
+            serial_printf(__VA_ARGS__);                                 \
+    } while (false)
+
+#define LOG_HEX(_level, _data, _len)                                    \
+    do {                                                                \
+        if (LOG_ENABLED(_level))                                        \
+            print_hex(_data, _len);                                     \
+    } while (false)
+
+#define LOG_ERROR(...)	LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(...)	LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(...)	LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...)	LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_TRACE(...)	LOG_AT(LOG_LEVEL_TRACE, __VA_ARGS__)
+
+#endif // LOG_H
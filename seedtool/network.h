@@ -19,6 +19,4 @@ class Network
     NetwtorkType _type;
 };
 
-extern Network network;
-
 #endif
@@ -1,7 +1,5 @@
 #include "network.h"
 
-Network network = Network();
-
 Network::Network(NetwtorkType network) {
    _type = network;
 }
@@ -0,0 +1,148 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#ifndef PSBT_H
+#define PSBT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <bc-crypto-base.h>
+
+#include "keystore.h"
+#include "network.h"
+
+/**
+ * Signs PSBTs (BIP174, version 0) streamed in over USB serial.  The
+ * PSBT is parsed as it arrives and never held in RAM: the unsigned
+ * transaction is hashed into the BIP143 midstates on the way in and
+ * only each input's outpoint and sequence are kept, then every input
+ * map is signed as soon as it ends.
+ *
+ * Inputs spending P2WPKH or P2SH-P2WPKH outputs with a BIP32
+ * derivation from this seed's root fingerprint are signed with
+ * SIGHASH_ALL, all others are skipped.
+ *
+ * The user confirms twice: the outputs once the unsigned transaction
+ * is read, and the fee once every input map is.  The signatures are
+ * held until then, nothing is signed blindly.
+ */
+
+// Upper bound for the per input state, which holds the input's
+// signature until the fee is confirmed: about 110 bytes each.
+size_t const PSBT_MAX_INPUTS = 400;
+
+// The first outputs are kept for the user to check, the rest only
+// count towards the total.
+size_t const PSBT_SHOWN_OUTPUTS = 4;
+size_t const PSBT_MAX_SCRIPT_LEN = 64;
+
+struct PsbtOutput {
+    uint64_t amount;
+    uint8_t script[PSBT_MAX_SCRIPT_LEN];
+    size_t script_len;		// 0 if the script is longer
+};
+
+// What the unsigned transaction pays, for the user to confirm.
+struct PsbtTxSummary {
+    uint32_t ninputs;
+    uint32_t noutputs;
+    uint64_t out_total;
+    size_t nshown;		// outputs kept, at most PSBT_SHOWN_OUTPUTS
+    PsbtOutput outputs[PSBT_SHOWN_OUTPUTS];
+};
+
+// The address an output pays to on network, or its script in hex if
+// it isn't a standard one.
+String psbt_output_address(PsbtOutput const & out, NetwtorkType network);
+
+// Where the PSBT bytes come from, pulled as the parser needs them.
+class PsbtSource {
+  public:
+    virtual bool read(uint8_t * buf, size_t len) = 0;
+};
+
+// Bytes in memory.
+class PsbtBufferSource : public PsbtSource {
+  public:
+    PsbtBufferSource(uint8_t const * data, size_t len) : data(data), len(len) {}
+    bool read(uint8_t * buf, size_t n);
+
+  private:
+    uint8_t const * data;
+    size_t len;
+};
+
+// Raw bytes or one line of base64 text from a stream, told apart by
+// the first character ('p' of the magic or 'c' of its base64).
+class PsbtStreamSource : public PsbtSource {
+  public:
+    PsbtStreamSource(Stream & in) : in(in), base64(false), started(false), peeked(-1), ndecoded(0), pos(0) {}
+    bool read(uint8_t * buf, size_t n);
+
+    // Skip what's left of the line after a base64 PSBT.
+    void finish();
+
+  private:
+    bool read_char(char & c);
+    bool decode_quad();
+
+    Stream & in;
+    bool base64;
+    bool started;
+    int peeked;			// first character, -1 once consumed
+    uint8_t decoded[3];
+    size_t ndecoded;
+    size_t pos;
+};
+
+// BIP143 signature hash of one transaction.  The version, prevouts
+// and sequences hash are absorbed once, every input starts from a
+// copy of that midstate.
+class Bip143Hasher {
+  public:
+    void init(uint32_t version, uint8_t const * hash_prevouts,
+              uint8_t const * hash_sequence, uint8_t const * hash_outputs,
+              uint32_t locktime);
+
+    // scriptCode of a P2WPKH (or P2SH-P2WPKH) input is built from pkh.
+    void sighash_p2wpkh(uint8_t const * outpoint, uint8_t const * pkh,
+                        uint64_t amount, uint32_t sequence, uint32_t hashtype,
+                        uint8_t * o_hash) const;
+
+  private:
+    SHA256_CTX midstate;
+    uint8_t hash_outputs[SHA256_DIGEST_LENGTH];
+    uint32_t locktime;
+};
+
+struct PsbtCallbacks {
+    // The unsigned transaction was read; return false to sign nothing.
+    bool (*confirm)(PsbtTxSummary const & tx, void * arg);
+    // Every input map was read and nsigned inputs were signed, none of
+    // the signatures is passed on yet; return false to drop them.  The
+    // fee is only known if every input has a witness UTXO.
+    bool (*confirm_fee)(uint32_t nsigned, uint32_t ninputs, bool fee_known,
+                        uint64_t fee, void * arg);
+    // A signature of input, DER with the sighash type appended.
+    void (*signature)(uint32_t input, uint8_t const * pubkey,
+                      uint8_t const * sig, size_t sig_len, void * arg);
+    void * arg;
+};
+
+struct PsbtSignStats {
+    uint32_t ninputs;
+    uint32_t nsigned;		// signatures passed on
+    uint32_t sign_ms;		// time spent on the input maps
+};
+
+/**
+ * Reads a PSBT from src and signs the inputs belonging to ctx's seed
+ * on network.  Returns false if the PSBT is malformed, unsupported,
+ * not confirmed or src fails, no signature is passed on then.
+ */
+bool psbt_sign(PsbtSource & src, SeedContext & ctx, NetwtorkType network,
+               PsbtCallbacks const & cb, PsbtSignStats & o_stats);
+
+// Reads the unsigned transaction into hasher, for tests.
+bool psbt_read_unsigned_tx(PsbtSource & src, size_t len, Bip143Hasher & hasher);
+
+#endif // PSBT_H
@@ -0,0 +1,721 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#include <bc-crypto-base.h>
+
+#include "psbt.h"
+#include "keystore.h"
+#include "log.h"
+#include "util.h"
+#include "wally_address.h"
+#include "wally_core.h"
+#include "wally_crypto.h"
+#include "wally_bip32.h"
+
+namespace psbt_internal {
+
+uint8_t const MAGIC[] = { 'p', 's', 'b', 't', 0xff };
+
+// Key types, BIP174
+uint8_t const PSBT_GLOBAL_UNSIGNED_TX = 0x00;
+uint8_t const PSBT_GLOBAL_VERSION = 0xfb;
+uint8_t const PSBT_IN_WITNESS_UTXO = 0x01;
+uint8_t const PSBT_IN_SIGHASH_TYPE = 0x03;
+uint8_t const PSBT_IN_REDEEM_SCRIPT = 0x04;
+uint8_t const PSBT_IN_BIP32_DERIVATION = 0x06;
+
+uint32_t const SIGHASH_ALL = 1;
+
+// 21 million BTC in satoshis, no amount or sum of amounts exceeds it.
+uint64_t const MAX_MONEY = 2100000000000000ULL;
+
+size_t const PUBKEY_LEN = 33;
+size_t const MAX_PATH_LEN = 10;
+size_t const MAX_KEY_LEN = 1 + PUBKEY_LEN;
+size_t const MAX_SCRIPT_LEN = PSBT_MAX_SCRIPT_LEN;
+
+struct TxIn {
+    union {
+        uint8_t outpoint[36];		// txid, vout, until signed
+        uint8_t pubkey[PUBKEY_LEN];	// the key that signed
+    };
+    uint32_t sequence;
+    bool have_sig;
+    uint8_t sig[EC_SIGNATURE_LEN];	// compact, held until the fee is confirmed
+};
+
+// What an input map says, the rest of it is skipped.
+struct InputState {
+    bool have_utxo;
+    uint64_t amount;
+    uint8_t script[MAX_SCRIPT_LEN];
+    size_t script_len;
+    bool have_redeem;
+    uint8_t redeem[MAX_SCRIPT_LEN];
+    size_t redeem_len;
+    uint32_t hashtype;
+    bool have_key;		// a key of this seed
+    uint8_t pubkey[PUBKEY_LEN];
+    uint32_t path[MAX_PATH_LEN];
+    uint32_t path_len;
+};
+
+// Keeps sub-parsers within the value they parse.
+class LimitedSource : public PsbtSource {
+  public:
+    LimitedSource(PsbtSource & src, uint64_t left) : left(left), src(src) {}
+    bool read(uint8_t * buf, size_t n) {
+        if (n > left)
+            return false;
+        left -= n;
+        return src.read(buf, n);
+    }
+
+    uint64_t left;
+
+  private:
+    PsbtSource & src;
+};
+
+uint32_t get_le32(uint8_t const * p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+uint64_t get_le64(uint8_t const * p) {
+    return get_le32(p) | ((uint64_t) get_le32(p + 4) << 32);
+}
+
+void put_le32(uint32_t val, uint8_t * o_p) {
+    for (size_t ii = 0; ii < 4; ++ii)
+        o_p[ii] = val >> (8 * ii);
+}
+
+void put_le64(uint64_t val, uint8_t * o_p) {
+    put_le32(val, o_p);
+    put_le32(val >> 32, o_p + 4);
+}
+
+bool read_varint(PsbtSource & src, uint64_t & o_val) {
+    uint8_t buf[8];
+    if (!src.read(buf, 1))
+        return false;
+    size_t nn = buf[0] < 0xfd ? 0 : buf[0] == 0xfd ? 2 : buf[0] == 0xfe ? 4 : 8;
+    if (nn == 0) {
+        o_val = buf[0];
+        return true;
+    }
+    if (!src.read(buf, nn))
+        return false;
+    o_val = 0;
+    for (size_t ii = nn; ii-- > 0; )
+        o_val = (o_val << 8) | buf[ii];
+    return true;
+}
+
+size_t put_varint(uint64_t val, uint8_t * o_buf) {
+    if (val < 0xfd) {
+        o_buf[0] = val;
+        return 1;
+    }
+    if (val <= 0xffff) {
+        o_buf[0] = 0xfd;
+        o_buf[1] = val;
+        o_buf[2] = val >> 8;
+        return 3;
+    }
+    if (val <= 0xffffffff) {
+        o_buf[0] = 0xfe;
+        put_le32(val, o_buf + 1);
+        return 5;
+    }
+    o_buf[0] = 0xff;
+    put_le64(val, o_buf + 1);
+    return 9;
+}
+
+bool skip(PsbtSource & src, uint64_t nn) {
+    uint8_t buf[32];
+    while (nn) {
+        size_t chunk = nn < sizeof(buf) ? nn : sizeof(buf);
+        if (!src.read(buf, chunk))
+            return false;
+        nn -= chunk;
+    }
+    return true;
+}
+
+// Streams nn bytes of src into ctx.
+bool hash_bytes(PsbtSource & src, uint64_t nn, SHA256_CTX * ctx) {
+    uint8_t buf[32];
+    while (nn) {
+        size_t chunk = nn < sizeof(buf) ? nn : sizeof(buf);
+        if (!src.read(buf, chunk))
+            return false;
+        sha256_Update(ctx, buf, chunk);
+        nn -= chunk;
+    }
+    return true;
+}
+
+// Reads a len byte value into buf if it fits, skips it otherwise.
+bool read_value(PsbtSource & src, uint64_t len, uint8_t * buf, size_t cap, bool & o_fits) {
+    o_fits = len <= cap;
+    return o_fits ? src.read(buf, len) : skip(src, len);
+}
+
+void sha256d_final(SHA256_CTX * ctx, uint8_t * o_hash) {
+    uint8_t hash[SHA256_DIGEST_LENGTH];
+    sha256_Final(ctx, hash);
+    sha256_Raw(hash, sizeof(hash), o_hash);
+    memzero(hash, sizeof(hash));
+}
+
+// The unsigned transaction is only hashed, of the inputs the outpoints
+// and sequences are kept for their signature hashes and of the outputs
+// the first few for the user to check.
+bool read_unsigned_tx(PsbtSource & src, uint64_t len, Bip143Hasher & hasher,
+                      TxIn * & o_txins, PsbtTxSummary & o_tx) {
+    LimitedSource tx(src, len);
+    uint8_t buf[36];
+    SHA256_CTX prevouts, sequences, outputs;
+    sha256_Init(&prevouts);
+    sha256_Init(&sequences);
+    sha256_Init(&outputs);
+
+    if (!tx.read(buf, 4))
+        return false;
+    uint32_t version = get_le32(buf);
+
+    // No segwit marker, unsigned transactions have no witnesses.
+    uint64_t nin;
+    if (!read_varint(tx, nin) || nin == 0 || nin > PSBT_MAX_INPUTS)
+        return false;
+    // Up to about 43 KB, more than the heap may have free.
+    o_txins = (TxIn *) malloc(nin * sizeof(TxIn));
+    if (o_txins == NULL) {
+        LOG_ERROR("psbt: no memory for %lu inputs\n", (unsigned long) nin);
+        return false;
+    }
+    o_tx.ninputs = nin;
+    for (uint32_t ii = 0; ii < nin; ++ii) {
+        o_txins[ii].have_sig = false;
+        uint64_t script_len;
+        if (!tx.read(o_txins[ii].outpoint, sizeof(o_txins[ii].outpoint)) ||
+            !read_varint(tx, script_len) || script_len != 0 || !tx.read(buf, 4))
+            return false;
+        o_txins[ii].sequence = get_le32(buf);
+        sha256_Update(&prevouts, o_txins[ii].outpoint, sizeof(o_txins[ii].outpoint));
+        sha256_Update(&sequences, buf, 4);
+    }
+
+    uint64_t nout;
+    if (!read_varint(tx, nout))
+        return false;
+    o_tx.noutputs = nout;
+    o_tx.out_total = 0;
+    o_tx.nshown = 0;
+    for (uint64_t ii = 0; ii < nout; ++ii) {
+        uint64_t script_len;
+        if (!tx.read(buf, 8) || !read_varint(tx, script_len))
+            return false;
+        uint64_t amount = get_le64(buf);
+        if (amount > MAX_MONEY - o_tx.out_total)
+            return false;
+        o_tx.out_total += amount;
+        size_t nn = 8 + put_varint(script_len, buf + 8);
+        sha256_Update(&outputs, buf, nn);
+
+        if (o_tx.nshown < PSBT_SHOWN_OUTPUTS) {
+            PsbtOutput & out = o_tx.outputs[o_tx.nshown++];
+            out.amount = amount;
+            out.script_len = 0;
+            if (script_len <= sizeof(out.script)) {
+                if (!tx.read(out.script, script_len))
+                    return false;
+                sha256_Update(&outputs, out.script, script_len);
+                out.script_len = script_len;
+                continue;
+            }
+        }
+        if (!hash_bytes(tx, script_len, &outputs))
+            return false;
+    }
+
+    if (!tx.read(buf, 4) || tx.left != 0)
+        return false;
+    uint32_t locktime = get_le32(buf);
+
+    uint8_t hash_prevouts[SHA256_DIGEST_LENGTH];
+    uint8_t hash_sequence[SHA256_DIGEST_LENGTH];
+    uint8_t hash_outputs[SHA256_DIGEST_LENGTH];
+    sha256d_final(&prevouts, hash_prevouts);
+    sha256d_final(&sequences, hash_sequence);
+    sha256d_final(&outputs, hash_outputs);
+    hasher.init(version, hash_prevouts, hash_sequence, hash_outputs, locktime);
+    return true;
+}
+
+// Reads a key, its type is the first byte.  Longer keys than we use
+// are skipped and reported with o_len 0.  False at the end of the map.
+bool read_key(PsbtSource & src, bool & o_ok, uint8_t * o_key, size_t & o_len) {
+    uint64_t len;
+    bool fits;
+    o_ok = read_varint(src, len);
+    if (!o_ok || len == 0)
+        return false;
+    o_ok = read_value(src, len, o_key, MAX_KEY_LEN, fits);
+    o_len = fits ? len : 0;
+    return o_ok;
+}
+
+bool read_global_map(PsbtSource & src, Bip143Hasher & hasher, TxIn * & o_txins,
+                     PsbtTxSummary & o_tx) {
+    bool ok;
+    bool have_tx = false;
+    uint8_t key[MAX_KEY_LEN];
+    size_t key_len;
+    while (read_key(src, ok, key, key_len)) {
+        uint64_t len;
+        if (!read_varint(src, len))
+            return false;
+        if (key_len == 1 && key[0] == PSBT_GLOBAL_UNSIGNED_TX) {
+            if (have_tx || !read_unsigned_tx(src, len, hasher, o_txins, o_tx))
+                return false;
+            have_tx = true;
+        }
+        else if (key_len == 1 && key[0] == PSBT_GLOBAL_VERSION) {
+            // Only version 0, later versions have no unsigned transaction.
+            uint8_t value[4];
+            bool fits;
+            if (!read_value(src, len, value, sizeof(value), fits) ||
+                !fits || len != 4 || get_le32(value) != 0)
+                return false;
+        }
+        else if (!skip(src, len)) {
+            return false;
+        }
+    }
+    return ok && have_tx;
+}
+
+bool read_input_map(PsbtSource & src, uint8_t const * fingerprint, InputState & o_st) {
+    o_st.have_utxo = false;
+    o_st.have_redeem = false;
+    o_st.have_key = false;
+    o_st.hashtype = SIGHASH_ALL;
+
+    bool ok;
+    uint8_t key[MAX_KEY_LEN];
+    size_t key_len;
+    while (read_key(src, ok, key, key_len)) {
+        uint64_t len;
+        bool fits;
+        if (!read_varint(src, len))
+            return false;
+
+        if (key_len == 1 && key[0] == PSBT_IN_WITNESS_UTXO) {
+            // amount, script length and script
+            uint8_t value[8 + 1 + MAX_SCRIPT_LEN];
+            if (!read_value(src, len, value, sizeof(value), fits))
+                return false;
+            if (fits && len > 9 && value[8] == len - 9) {
+                o_st.amount = get_le64(value);
+                o_st.script_len = value[8];
+                memcpy(o_st.script, value + 9, o_st.script_len);
+                o_st.have_utxo = true;
+            }
+        }
+        else if (key_len == 1 && key[0] == PSBT_IN_SIGHASH_TYPE) {
+            uint8_t value[4];
+            if (!read_value(src, len, value, sizeof(value), fits) || !fits || len != 4)
+                return false;
+            o_st.hashtype = get_le32(value);
+        }
+        else if (key_len == 1 && key[0] == PSBT_IN_REDEEM_SCRIPT) {
+            if (!read_value(src, len, o_st.redeem, sizeof(o_st.redeem), fits))
+                return false;
+            o_st.have_redeem = fits;
+            o_st.redeem_len = len;
+        }
+        else if (key_len == MAX_KEY_LEN && key[0] == PSBT_IN_BIP32_DERIVATION) {
+            // root fingerprint and path, the first of our keys is used
+            uint8_t value[4 + 4 * MAX_PATH_LEN];
+            if (!read_value(src, len, value, sizeof(value), fits))
+                return false;
+            if (!o_st.have_key && fits && len >= 4 && len % 4 == 0 &&
+                memcmp(value, fingerprint, 4) == 0) {
+                memcpy(o_st.pubkey, key + 1, PUBKEY_LEN);
+                o_st.path_len = len / 4 - 1;
+                for (size_t ii = 0; ii < o_st.path_len; ++ii)
+                    o_st.path[ii] = get_le32(value + 4 + 4 * ii);
+                o_st.have_key = true;
+            }
+        }
+        else if (!skip(src, len)) {
+            return false;
+        }
+    }
+    return ok;
+}
+
+bool skip_map(PsbtSource & src) {
+    bool ok;
+    uint8_t key[MAX_KEY_LEN];
+    size_t key_len;
+    while (read_key(src, ok, key, key_len)) {
+        uint64_t len;
+        if (!read_varint(src, len) || !skip(src, len))
+            return false;
+    }
+    return ok;
+}
+
+// Inputs usually share their account, keep it in ctx and derive only
+// the last two steps (change, index).
+bool derive_key(SeedContext & ctx, NetwtorkType network, uint32_t const * path,
+                uint32_t path_len, ext_key * o_key) {
+    uint32_t prefix_len = path_len < 2 ? path_len : path_len - 2;
+    ext_key const * prefix = prefix_len ? ctx.derive(network, path, prefix_len) : ctx.root(network);
+    if (prefix == NULL)
+        return false;
+    *o_key = *prefix;
+    for (uint32_t ii = prefix_len; ii < path_len; ++ii) {
+        ext_key parent = *o_key;
+        int res = bip32_key_from_parent(&parent, path[ii], BIP32_FLAG_KEY_PRIVATE, o_key);
+        memzero(&parent, sizeof(parent));
+        if (res != WALLY_OK)
+            return false;
+    }
+    return true;
+}
+
+// The witness program (0x00 0x14 pkh) an input spends, directly or
+// through a P2SH redeem script.
+uint8_t const * p2wpkh_program(InputState const & st) {
+    if (st.script_len == 22 && st.script[0] == 0x00 && st.script[1] == 0x14)
+        return st.script;
+
+    if (st.script_len == 23 && st.script[0] == 0xa9 && st.script[1] == 0x14 &&
+        st.script[22] == 0x87 && st.have_redeem && st.redeem_len == 22 &&
+        st.redeem[0] == 0x00 && st.redeem[1] == 0x14) {
+        uint8_t hash[20];
+        if (wally_hash160(st.redeem, st.redeem_len, hash, sizeof(hash)) == WALLY_OK &&
+            memcmp(hash, st.script + 2, sizeof(hash)) == 0)
+            return st.redeem;
+    }
+    return NULL;
+}
+
+// Signs into txin, the signature is passed on once the fee is confirmed.
+bool sign_input(SeedContext & ctx, NetwtorkType network, Bip143Hasher const & hasher,
+                TxIn & txin, InputState const & st) {
+    if (!st.have_utxo || !st.have_key || st.hashtype != SIGHASH_ALL)
+        return false;
+    uint8_t const * program = p2wpkh_program(st);
+    if (program == NULL)
+        return false;
+
+    // The key must be the one the PSBT names and the output pays to.
+    ext_key key;
+    if (!derive_key(ctx, network, st.path, st.path_len, &key) ||
+        memcmp(key.pub_key, st.pubkey, PUBKEY_LEN) != 0 ||
+        memcmp(key.hash160, program + 2, 20) != 0) {
+        memzero(&key, sizeof(key));
+        return false;
+    }
+
+    uint8_t hash[SHA256_DIGEST_LENGTH];
+    hasher.sighash_p2wpkh(txin.outpoint, program + 2, st.amount, txin.sequence,
+                          st.hashtype, hash);
+
+    bool ok = wally_ec_sig_from_bytes(key.priv_key + 1, EC_PRIVATE_KEY_LEN, hash, sizeof(hash),
+                                      EC_FLAG_ECDSA | EC_FLAG_GRIND_R,
+                                      txin.sig, sizeof(txin.sig)) == WALLY_OK;
+    memzero(&key, sizeof(key));
+    if (!ok)
+        return false;
+
+    // The outpoint isn't needed anymore.
+    memcpy(txin.pubkey, st.pubkey, PUBKEY_LEN);
+    txin.have_sig = true;
+    return true;
+}
+
+// Passes on the held signatures, all SIGHASH_ALL.
+bool emit_signatures(TxIn const * txins, uint32_t ninputs, PsbtCallbacks const & cb) {
+    for (uint32_t ii = 0; ii < ninputs; ++ii) {
+        if (!txins[ii].have_sig)
+            continue;
+        uint8_t der[EC_SIGNATURE_DER_MAX_LEN + 1];
+        size_t der_len = 0;
+        if (wally_ec_sig_to_der(txins[ii].sig, sizeof(txins[ii].sig),
+                                der, sizeof(der) - 1, &der_len) != WALLY_OK)
+            return false;
+        der[der_len++] = SIGHASH_ALL;
+        cb.signature(ii, txins[ii].pubkey, der, der_len, cb.arg);
+    }
+    return true;
+}
+
+int base64_value(char c) {
+    if (c >= 'A' && c <= 'Z')
+        return c - 'A';
+    if (c >= 'a' && c <= 'z')
+        return c - 'a' + 26;
+    if (c >= '0' && c <= '9')
+        return c - '0' + 52;
+    if (c == '+')
+        return 62;
+    if (c == '/')
+        return 63;
+    return -1;
+}
+
+} // namespace psbt_internal
+
+bool PsbtBufferSource::read(uint8_t * buf, size_t n) {
+    if (n > len)
+        return false;
+    memcpy(buf, data, n);
+    data += n;
+    len -= n;
+    return true;
+}
+
+bool PsbtStreamSource::read_char(char & c) {
+    if (peeked >= 0) {
+        c = peeked;
+        peeked = -1;
+        return true;
+    }
+    uint8_t b;
+    if (in.readBytes(&b, 1) != 1)
+        return false;		// timed out
+    c = b;
+    return true;
+}
+
+bool PsbtStreamSource::decode_quad() {
+    using namespace psbt_internal;
+
+    uint32_t bits = 0;
+    size_t nchars = 0;
+    size_t npad = 0;
+    while (nchars < 4) {
+        char c;
+        if (!read_char(c) || c == '\n')
+            return false;
+        if (c == '\r' || c == ' ')
+            continue;
+        int val = 0;
+        if (c == '=')
+            npad++;
+        else if ((val = base64_value(c)) < 0 || npad)
+            return false;
+        bits = (bits << 6) | val;
+        nchars++;
+    }
+    if (npad > 2)
+        return false;
+    decoded[0] = bits >> 16;
+    decoded[1] = bits >> 8;
+    decoded[2] = bits;
+    ndecoded = 3 - npad;
+    pos = 0;
+    return true;
+}
+
+bool PsbtStreamSource::read(uint8_t * buf, size_t n) {
+    if (!started) {
+        char c;
+        do {
+            if (!read_char(c))
+                return false;
+        } while (c == '\r' || c == '\n' || c == ' ');
+        base64 = c != 'p';
+        peeked = c;
+        started = true;
+    }
+
+    if (!base64) {
+        size_t nn = 0;
+        if (peeked >= 0 && n > 0) {
+            buf[nn++] = peeked;
+            peeked = -1;
+        }
+        return in.readBytes(buf + nn, n - nn) == n - nn;
+    }
+
+    for (size_t ii = 0; ii < n; ++ii) {
+        if (pos == ndecoded && !decode_quad())
+            return false;
+        buf[ii] = decoded[pos++];
+    }
+    return true;
+}
+
+void PsbtStreamSource::finish() {
+    char c;
+    while (base64 && read_char(c) && c != '\n')
+        ;
+}
+
+void Bip143Hasher::init(uint32_t version, uint8_t const * hash_prevouts,
+                        uint8_t const * hash_sequence, uint8_t const * i_hash_outputs,
+                        uint32_t i_locktime) {
+    using namespace psbt_internal;
+
+    uint8_t buf[4];
+    put_le32(version, buf);
+    sha256_Init(&midstate);
+    sha256_Update(&midstate, buf, sizeof(buf));
+    sha256_Update(&midstate, hash_prevouts, SHA256_DIGEST_LENGTH);
+    sha256_Update(&midstate, hash_sequence, SHA256_DIGEST_LENGTH);
+    memcpy(hash_outputs, i_hash_outputs, sizeof(hash_outputs));
+    locktime = i_locktime;
+}
+
+void Bip143Hasher::sighash_p2wpkh(uint8_t const * outpoint, uint8_t const * pkh,
+                                  uint64_t amount, uint32_t sequence, uint32_t hashtype,
+                                  uint8_t * o_hash) const {
+    using namespace psbt_internal;
+
+    SHA256_CTX ctx = midstate;
+    sha256_Update(&ctx, outpoint, 36);
+
+    // scriptCode: OP_DUP OP_HASH160 <pkh> OP_EQUALVERIFY OP_CHECKSIG
+    uint8_t script_code[26] = { 0x19, 0x76, 0xa9, 0x14 };
+    memcpy(script_code + 4, pkh, 20);
+    script_code[24] = 0x88;
+    script_code[25] = 0xac;
+    sha256_Update(&ctx, script_code, sizeof(script_code));
+
+    uint8_t buf[8];
+    put_le64(amount, buf);
+    sha256_Update(&ctx, buf, 8);
+    put_le32(sequence, buf);
+    sha256_Update(&ctx, buf, 4);
+    sha256_Update(&ctx, hash_outputs, sizeof(hash_outputs));
+    put_le32(locktime, buf);
+    sha256_Update(&ctx, buf, 4);
+    put_le32(hashtype, buf);
+    sha256_Update(&ctx, buf, 4);
+    sha256d_final(&ctx, o_hash);
+}
+
+String psbt_output_address(PsbtOutput const & out, NetwtorkType network) {
+    using namespace psbt_internal;
+
+    uint8_t const * script = out.script;
+    size_t len = out.script_len;
+    if (len == 0)
+        return "long script";
+
+    char * addr = NULL;
+    if ((len == 22 || len == 34) && script[0] == 0x00 && script[1] == len - 2) {
+        // P2WPKH, P2WSH
+        char const * family = network == MAINNET ? "bc" : network == TESTNET ? "tb" : "bcrt";
+        (void) wally_addr_segwit_from_bytes(script, len, family, 0, &addr);
+    }
+    else if ((len == 25 && script[0] == 0x76 && script[1] == 0xa9 && script[2] == 0x14 &&
+              script[23] == 0x88 && script[24] == 0xac) ||
+             (len == 23 && script[0] == 0xa9 && script[1] == 0x14 && script[22] == 0x87)) {
+        // P2PKH, P2SH: version byte and hash
+        bool p2pkh = len == 25;
+        uint8_t bytes[21];
+        bytes[0] = network == MAINNET ? (p2pkh ? 0x00 : 0x05) : (p2pkh ? 0x6f : 0xc4);
+        memcpy(bytes + 1, script + (p2pkh ? 3 : 2), 20);
+        (void) wally_base58_from_bytes(bytes, sizeof(bytes), BASE58_FLAG_CHECKSUM, &addr);
+    }
+
+    String result;
+    if (addr) {
+        result = addr;
+        wally_free_string(addr);
+        return result;
+    }
+    char hex[3];
+    result = "script ";
+    for (size_t ii = 0; ii < len; ++ii) {
+        snprintf(hex, sizeof(hex), "%02x", script[ii]);
+        result += hex;
+    }
+    return result;
+}
+
+bool psbt_read_unsigned_tx(PsbtSource & src, size_t len, Bip143Hasher & hasher) {
+    using namespace psbt_internal;
+
+    TxIn * txins = NULL;
+    PsbtTxSummary tx;
+    bool ok = read_unsigned_tx(src, len, hasher, txins, tx);
+    free(txins);
+    return ok;
+}
+
+bool psbt_sign(PsbtSource & src, SeedContext & ctx, NetwtorkType network,
+               PsbtCallbacks const & cb, PsbtSignStats & o_stats) {
+    using namespace psbt_internal;
+
+    o_stats.ninputs = 0;
+    o_stats.nsigned = 0;
+    o_stats.sign_ms = 0;
+
+    ext_key const * root = ctx.root(network);
+    if (root == NULL)
+        return false;
+    // root fingerprint, as PSBT key origins give it
+    uint8_t fingerprint[4];
+    memcpy(fingerprint, root->hash160, sizeof(fingerprint));
+
+    uint8_t magic[sizeof(MAGIC)];
+    if (!src.read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        return false;
+
+    Bip143Hasher hasher;
+    TxIn * txins = NULL;
+    PsbtTxSummary tx;
+    tx.ninputs = 0;
+    tx.noutputs = 0;
+    bool ok = read_global_map(src, hasher, txins, tx) && cb.confirm(tx, cb.arg);
+
+    // The fee is known if every input has its amount.
+    uint64_t in_total = 0;
+    bool fee_known = true;
+    uint32_t nsigned = 0;
+    uint32_t t0 = millis();
+    InputState st;
+    for (uint32_t ii = 0; ok && ii < tx.ninputs; ++ii) {
+        ok = read_input_map(src, fingerprint, st);
+        if (!ok)
+            break;
+        if (!st.have_utxo)
+            fee_known = false;
+        else if (st.amount > MAX_MONEY - in_total)
+            ok = false;
+        else
+            in_total += st.amount;
+        if (ok && sign_input(ctx, network, hasher, txins[ii], st))
+            nsigned++;
+    }
+    o_stats.sign_ms = millis() - t0;
+    o_stats.ninputs = tx.ninputs;
+
+    for (uint32_t ii = 0; ok && ii < tx.noutputs; ++ii)
+        ok = skip_map(src);
+
+    // Nothing goes out before the whole PSBT was read and the user
+    // agreed to the fee.
+    if (ok && fee_known && in_total < tx.out_total)
+        ok = false;
+    if (ok && nsigned > 0)
+        ok = cb.confirm_fee(nsigned, tx.ninputs, fee_known,
+                            fee_known ? in_total - tx.out_total : 0, cb.arg) &&
+            emit_signatures(txins, tx.ninputs, cb);
+    if (ok)
+        o_stats.nsigned = nsigned;
+
+    if (txins)
+        memzero(txins, tx.ninputs * sizeof(TxIn));
+    free(txins);
+    return ok;
+}
@@ -0,0 +1,61 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+/**
+ * A small cooperative scheduler for background work.  Tasks are run
+ * one step at a time while the user interface waits for a key, so a
+ * step should take at most a few tens of milliseconds.  Long
+ * computations keep their progress in ctx and are resumed on the
+ * next step.
+ */
+
+// Does the next step of a task, returns true when the task is done.
+typedef bool (*sched_step_fn)(void *ctx);
+
+enum SchedPriority {
+    SCHED_PRIO_IDLE,		// speculative work, e.g. precomputing a screen
+    SCHED_PRIO_NORMAL,
+    SCHED_PRIO_URGENT,
+};
+
+// Adds a task, returns its id or -1 if there are no free slots.
+// deadline_ms is relative to now, tasks of the same priority run in
+// deadline order, tasks without a deadline (0) run last.
+int sched_add(sched_step_fn step, void *ctx,
+              SchedPriority prio, uint32_t deadline_ms = 0);
+
+// Cancels a task, ignores ids of finished or cancelled tasks.
+void sched_cancel(int id);
+void sched_cancel_all();
+
+// Is the task still waiting to be run or resumed?
+bool sched_active(int id);
+
+// Runs one step of the most urgent task, returns false if there was
+// nothing to run.
+bool sched_run_one();
+
+struct SchedState;
+
+/**
+ * Sets aside the tasks added so far and puts them back when it goes out
+ * of scope, the tasks added in between are cancelled.  The self test
+ * uses it, it may run while a screen has work scheduled.
+ */
+class SchedScope {
+  public:
+    SchedScope();
+    ~SchedScope();
+
+  private:
+    SchedScope(SchedScope const &);
+    SchedScope & operator=(SchedScope const &);
+
+    SchedState * saved_;
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,131 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#include "scheduler.h"
+#include "log.h"
+#include "util.h"
+
+namespace sched_internal {
+
+size_t const MAX_TASKS = 8;
+
+struct Task {
+    sched_step_fn step;		// NULL if the slot is free
+    void *ctx;
+    SchedPriority prio;
+    bool has_deadline;
+    uint32_t deadline;		// millis()
+    uint32_t seq;		// order of addition
+    uint16_t gen;		// makes ids of reused slots unique
+};
+
+Task g_tasks[MAX_TASKS];
+uint32_t g_seq = 0;
+
+int task_id(size_t slot) {
+    return (g_tasks[slot].gen << 4) | slot;
+}
+
+Task * lookup(int id) {
+    if (id < 0)
+        return NULL;
+    size_t slot = id & 0xf;
+    if (slot >= MAX_TASKS)
+        return NULL;
+    Task * task = &g_tasks[slot];
+    if (!task->step || task_id(slot) != id)
+        return NULL;
+    return task;
+}
+
+// Should task aa run before task bb?
+bool before(Task const & aa, Task const & bb, uint32_t now) {
+    if (aa.prio != bb.prio)
+        return aa.prio > bb.prio;
+    if (aa.has_deadline != bb.has_deadline)
+        return aa.has_deadline;
+    if (aa.has_deadline) {
+        // Compare the time left so millis() wrapping is harmless.
+        int32_t left_aa = aa.deadline - now;
+        int32_t left_bb = bb.deadline - now;
+        if (left_aa != left_bb)
+            return left_aa < left_bb;
+    }
+    return (int32_t) (aa.seq - bb.seq) < 0;
+}
+
+} // namespace sched_internal
+
+int sched_add(sched_step_fn step, void *ctx,
+              SchedPriority prio, uint32_t deadline_ms) {
+    using namespace sched_internal;
+    serial_assert(step);
+    for (size_t slot = 0; slot < MAX_TASKS; ++slot) {
+        Task & task = g_tasks[slot];
+        if (task.step)
+            continue;
+        task.step = step;
+        task.ctx = ctx;
+        task.prio = prio;
+        task.has_deadline = deadline_ms != 0;
+        task.deadline = millis() + deadline_ms;
+        task.seq = g_seq++;
+        task.gen = (task.gen + 1) & 0x7ff;
+        return task_id(slot);
+    }
+    LOG_WARN("sched_add: no free task slots\n");
+    return -1;
+}
+
+void sched_cancel(int id) {
+    using namespace sched_internal;
+    Task * task = lookup(id);
+    if (task)
+        task->step = NULL;
+}
+
+void sched_cancel_all() {
+    using namespace sched_internal;
+    for (size_t slot = 0; slot < MAX_TASKS; ++slot)
+        g_tasks[slot].step = NULL;
+}
+
+bool sched_active(int id) {
+    using namespace sched_internal;
+    return lookup(id) != NULL;
+}
+
+bool sched_run_one() {
+    using namespace sched_internal;
+    uint32_t now = millis();
+    Task * next = NULL;
+    for (size_t slot = 0; slot < MAX_TASKS; ++slot) {
+        Task & task = g_tasks[slot];
+        if (task.step && (!next || before(task, *next, now)))
+            next = &task;
+    }
+    if (!next)
+        return false;
+
+    // The step may add or cancel tasks, including itself.
+    int id = task_id(next - g_tasks);
+    bool done = next->step(next->ctx);
+    if (done && lookup(id) == next)
+        next->step = NULL;
+    return true;
+}
+
+struct SchedState {
+    sched_internal::Task tasks[sched_internal::MAX_TASKS];
+};
+
+SchedScope::SchedScope() : saved_(new SchedState) {
+    using namespace sched_internal;
+    memcpy(saved_->tasks, g_tasks, sizeof(g_tasks));
+    sched_cancel_all();
+}
+
+SchedScope::~SchedScope() {
+    using namespace sched_internal;
+    memcpy(g_tasks, saved_->tasks, sizeof(g_tasks));
+    delete saved_;
+}
@@ -6,25 +6,39 @@
 #include <stdint.h>
 
 #include <bc-bip39.h>
+#include <bc-crypto-base.h>
 #include "util.h"
 #include "bc-bytewords.h"
 #include "CborEncoder.h"
 
 #define BIP39_SEED_LEN_512 64
 
-class Seed {
+// Seed size of this build in bytes: 16 gives 128 bit seeds, 12 word
+// mnemonics and 29 word SSKR shares, 32 gives 256 bit seeds, 24 word
+// mnemonics and 46 word SSKR shares.  Seed, BIP39Seq and SSKRShareSeq
+// are the classes for this size; both sizes are instantiated, so the
+// selftests can check the vectors of either.
+#ifndef SEED_BYTES
+#define SEED_BYTES 16
+#endif
+
+template <size_t N>
+class SeedT {
 public:
-    static size_t const SIZE = 16;
+    static size_t const SIZE = N;
 
-    static Seed * from_rolls(String const & rolls, uint8_t *trng_entropy = NULL, uint8_t trng_entropy_size = 0);
+    static SeedT * from_rolls(String const & rolls, uint8_t *trng_entropy = NULL, uint8_t trng_entropy_size = 0);
 
-    Seed(uint8_t const * data, size_t len);
+    // Copies SIZE bytes.
+    explicit SeedT(uint8_t const * data);
 
-    bool operator==(Seed const & other) const {
+    ~SeedT() { memzero(data, SIZE); }
+
+    bool operator==(SeedT const & other) const {
         return memcmp(data, other.data, SIZE) == 0;
     }
 
-    bool operator!=(Seed const & other) const {
+    bool operator!=(SeedT const & other) const {
         return memcmp(data, other.data, SIZE) != 0;
     }
 
@@ -33,19 +47,53 @@ public:
     uint8_t data[SIZE];
 };
 
-class BIP39Seq {
+// Builds a seed from dice rolls as they are entered.  The rolls are
+// hashed as they come and only their count is kept; finalize gives
+// the same seed as Seed::from_rolls on the same rolls.
+template <size_t N>
+class SeedBuilderT {
 public:
-    static size_t const WORD_COUNT = 12;
+    SeedBuilderT();
+    ~SeedBuilderT();
+
+    void add_roll(char roll);
+    size_t numrolls() const { return nrolls; }
+
+    // Forget the rolls entered so far.
+    void reset();
+
+    // Appends the optional TRNG entropy, returns the seed and resets.
+    SeedT<N> * finalize(uint8_t const * trng_entropy = NULL, size_t trng_entropy_size = 0);
+
+private:
+    SHA256_CTX ctx;
+    size_t nrolls;
+};
+
+template <size_t N>
+class BIP39SeqT {
+public:
+    // 11 bits per word, N * 8 bits of entropy and N / 4 checksum bits.
+    static size_t const WORD_COUNT = N * 3 / 4;
+
+    // The last word holds the checksum (WORD_COUNT / 3 bits) and the
+    // rest of the entropy, only the entropy bits are free.
+    static size_t const LAST_WORD_CHOICES = 1 << (11 - WORD_COUNT / 3);
+
+    static BIP39SeqT * from_words(uint16_t * words);
 
-    static BIP39Seq * from_words(uint16_t * words);
+    // Computes the last words giving a valid checksum with the first
+    // WORD_COUNT - 1 words, in ascending order.  o_words must hold
+    // LAST_WORD_CHOICES words.
+    static void valid_last_words(uint16_t const * words, uint16_t * o_words);
 
     uint8_t mnemonic_seed[BIP39_SEED_LEN_512];
 
-    BIP39Seq();
+    BIP39SeqT();
 
-    BIP39Seq(Seed const * seed);
+    BIP39SeqT(SeedT<N> const * seed);
 
-    ~BIP39Seq();
+    ~BIP39SeqT();
 
     void set_word(size_t ndx, uint16_t word);
 
@@ -59,7 +107,7 @@ public:
     String get_string(size_t ndx);
 
     // Returns NULL if restore fails (bad BIP39 checksum).
-    Seed * restore_seed() const;
+    SeedT<N> * restore_seed() const;
 
     // fix_bip39_checksum is only intended for when user wants
     // to generate seed from bip39 words
@@ -76,20 +124,48 @@ private:
     bool calc_mnemonic_seed();
 };
 
-class SSKRShareSeq {
+// SSKR share metadata, the first bytes of each share.
+// https://github.com/BlockchainCommons/Research/blob/master/papers/bcr-2020-011-sskr.md
+struct SSKRShareMetadata {
+    uint16_t identifier;
+    uint8_t group_threshold;
+    uint8_t group_count;
+    uint8_t group_index;
+    uint8_t member_threshold;
+    uint8_t member_index;
+};
+
+// Result of checking an entered share against the others.
+enum SSKRShareCheck {
+    SSKR_SHARE_OK,
+    SSKR_SHARE_BAD_METADATA,	// malformed or unsupported metadata
+    SSKR_SHARE_MISMATCH,	// identifier or threshold differs
+    SSKR_SHARE_DUPLICATE,	// same member as another share
+};
+
+template <size_t N>
+class SSKRShareSeqT {
 public:
     static size_t const MAX_SHARES = 16;
 
-    // we currently support only 16 byte seed, therefore WORDS_PER_SHARE and BYTES_PER_SHARE are a constant
-    static size_t const WORDS_PER_SHARE = 29;
-    static size_t const BYTES_PER_SHARE = 21;
+    static size_t const METADATA_LENGTH_BYTES = 5;
+    static size_t const BYTES_PER_SHARE = METADATA_LENGTH_BYTES + N;
+
+    // The bytewords of a share encode the CBOR tag 309 (3 bytes), the
+    // byte string header (1 byte up to 23 bytes, 2 above), the share
+    // and a CRC32.  The header words are the same for every share.
+    static size_t const HEADER_WORDS = 3 + (BYTES_PER_SHARE < 24 ? 1 : 2);
+    static size_t const WORDS_PER_SHARE = HEADER_WORDS + BYTES_PER_SHARE + 4;
 
-    const size_t METADATA_LENGTH_BYTES = 5;
+    SSKRShareSeqT();
+    ~SSKRShareSeqT();
 
-    static SSKRShareSeq * from_seed(Seed const * seed,
+    // randctx is passed on to randgen.
+    static SSKRShareSeqT * from_seed(SeedT<N> const * seed,
                                       uint8_t thresh,
                                       uint8_t nshares,
-                                      void(*randgen)(uint8_t *, size_t, void *));
+                                      void(*randgen)(uint8_t *, size_t, void *),
+                                      void * randctx = NULL);
 
     // Read-only, don't free returned value.
     uint8_t const * get_share(size_t ndx) const;
@@ -101,34 +177,67 @@ public:
     void set_share(size_t ndx, uint8_t const * share, size_t len);
 
     // Returns NULL if restore fails, use last_error for diagnostic.
-    Seed * restore_seed() const;
+    SeedT<N> * restore_seed() const;
+
+    // For when restore_seed fails with more than threshold shares.
+    // Recombines threshold sized subsets until one yields a secret
+    // with a valid digest, and returns the indices of the shares that
+    // don't agree with it in o_outliers (MAX_SHARES entries).
+    // Returns NULL if no subset recombines.
+    SeedT<N> * restore_seed_majority(size_t * o_outliers, size_t & o_noutliers) const;
 
     // Delete the specified share, compact gaps.
     void del_share(size_t ndx);
 
     // get share from ur message ur:crypto-sskr
+    // Returns false if the bytewords checksum or the CBOR is bad.
     bool get_share_from_ur(String bytewords, size_t sskr_shard_indx);
 
-    // Read only, don't free returned value.
-    String get_share_word(int sharendx, int wndx);
+    // Decodes the metadata of a share, returns false if malformed.
+    static bool decode_metadata(uint8_t const * share, size_t len,
+                                SSKRShareMetadata & o_meta);
+
+    // Checks share ndx against the other shares, so a bad share is
+    // caught when entered rather than by restore_seed.
+    SSKRShareCheck check_share(size_t ndx) const;
+
+    // The text forms are rendered on demand, one share at a time.
+    String get_share_word(int sharendx, int wndx) const;
 
-    String get_share_strings(size_t ndx) const;
+    // The bytewords indices of a share, WORDS_PER_SHARE of them.
+    void get_share_words(size_t ndx, uint8_t * o_words) const;
+
+    String get_share_strings(size_t ndx) const;	// bytewords
+    String get_share_ur(size_t ndx) const;
 
     size_t numshares() const { return nshares; }
 
     int last_restore_error() { return last_rv; }
 
-    uint8_t *shares[MAX_SHARES]; // shares in bytes format
-    String shares_ur[MAX_SHARES]; // shares in ur format   @TODO: getter
-    String shares_bytewords[MAX_SHARES]; // shares in bytewords format @TODO: getter
+    uint8_t shares[MAX_SHARES][BYTES_PER_SHARE]; // shares in bytes format
     size_t shares_len; // threshold
     size_t bytes_in_each_share;
 
 private:
     size_t nshares;
     mutable int last_rv;
+
+    // The shares last rendered as text, two of them so precomputing
+    // the next share's QR code doesn't evict the share on display.
+    // render() returns the slot holding share ndx.
+    static size_t const RENDER_SLOTS = 2;
+    size_t render(size_t ndx) const;
+    void unrender(size_t ndx);
+    mutable int rendered_ndx[RENDER_SLOTS];	// -1 if empty
+    mutable size_t rendered_lru;		// slot to evict next
+    mutable char rendered_words[RENDER_SLOTS][WORDS_PER_SHARE * 5];
+    mutable String rendered_ur[RENDER_SLOTS];
 };
 
+typedef SeedT<SEED_BYTES> Seed;
+typedef SeedBuilderT<SEED_BYTES> SeedBuilder;
+typedef BIP39SeqT<SEED_BYTES> BIP39Seq;
+typedef SSKRShareSeqT<SEED_BYTES> SSKRShareSeq;
 
 /**
  *  This function is taken from libwally. We cannot import libwally_bip39 because it is clashing with
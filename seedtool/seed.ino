@@ -5,6 +5,9 @@
 #include <bc-crypto-base.h>
 
 #include "util.h"
+#include "log.h"
+#include "gf256.h"
+#include "wordlist.h"
 #include "seed.h"
 #include "wally_crypto.h"
 #include "ur.h"
@@ -13,181 +16,530 @@
 
 namespace seed_internal {
 
-} // namespace seed_internal
+// bc-shamir evaluates the member share polynomial at these points.
+uint8_t const SHAMIR_SECRET_INDEX = 255;
+uint8_t const SHAMIR_DIGEST_INDEX = 254;
+size_t const SHAMIR_DIGEST_LENGTH = 4;
+
+// Depth first walk of the threshold sized subsets of the shares, see
+// SSKRShareSeqT::restore_seed_majority.
+template <size_t N>
+struct SubsetSearch {
+    static size_t const MAX_SHARES = SSKRShareSeqT<N>::MAX_SHARES;
+
+    GF256Newton newton;
+    size_t thresh;
+    size_t nshares;
+    uint8_t xx[MAX_SHARES];		// member index
+    uint8_t const * value[MAX_SHARES];
+    bool in_subset[MAX_SHARES];
+    bool agree[MAX_SHARES];
+    bool verify_all;		// check the digest of every subset
+    uint8_t secret[N];
+
+    SubsetSearch() : newton(N) {}
+};
 
-Seed * Seed::from_rolls(String const & rolls, uint8_t *trng_entropy, uint8_t trng_entropy_size) {
-    using namespace seed_internal;
-    uint8_t *entropy = NULL;
-    uint8_t digest[SHA256_DIGEST_LENGTH];
+// The first bytes of the digest share are an HMAC of the secret,
+// keyed with the rest of the digest share.
+template <size_t N>
+bool digest_matches(uint8_t const * secret, uint8_t const * digest) {
+    uint8_t hmac[SHA256_DIGEST_LENGTH];
+    hmac_sha256(digest + SHAMIR_DIGEST_LENGTH, N - SHAMIR_DIGEST_LENGTH,
+                secret, N, hmac);
+    return memcmp(hmac, digest, SHAMIR_DIGEST_LENGTH) == 0;
+}
+
+template <size_t N>
+bool check_subset(SubsetSearch<N> & ss) {
+    uint8_t yy[N];
+    size_t nagree = 0;
+    for (size_t ii = 0; ii < ss.nshares; ++ii) {
+        if (ss.in_subset[ii]) {
+            ss.agree[ii] = true;
+            continue;
+        }
+        // A subset with a bad share gives a random polynomial, which
+        // rarely gets even the first byte of another share right.
+        ss.agree[ii] = ss.newton.eval_byte(ss.xx[ii], 0) == ss.value[ii][0];
+        if (ss.agree[ii]) {
+            ss.newton.eval(ss.xx[ii], yy);
+            ss.agree[ii] = memcmp(yy, ss.value[ii], N) == 0;
+        }
+        nagree += ss.agree[ii];
+    }
+
+    // The HMAC is the expensive part, first look for a subset that
+    // other shares agree with.
+    if (nagree == 0 && !ss.verify_all)
+        return false;
+
+    // Shares of a threshold 1 split are copies of the secret.
+    if (ss.thresh == 1) {
+        memcpy(ss.secret, ss.value[0], N);
+        for (size_t ii = 0; ii < ss.nshares; ++ii) {
+            if (ss.in_subset[ii])
+                memcpy(ss.secret, ss.value[ii], N);
+        }
+        return true;
+    }
+
+    ss.newton.eval(SHAMIR_SECRET_INDEX, ss.secret);
+    ss.newton.eval(SHAMIR_DIGEST_INDEX, yy);
+    return digest_matches<N>(ss.secret, yy);
+}
 
-    if (trng_entropy) {
-        /* mix trng entropy into dice rolling. Trng entropy is appended. */
-        entropy = (uint8_t *)malloc(trng_entropy_size + rolls.length());
-        memcpy(entropy, (const uint8_t*)rolls.c_str(), rolls.length());
-        memcpy(entropy + rolls.length(), trng_entropy, trng_entropy_size);
-        sha256_Raw(entropy, trng_entropy_size + rolls.length(), digest);
+// Tries the subsets extending the current one with shares from first on.
+template <size_t N>
+bool search_subsets(SubsetSearch<N> & ss, size_t first) {
+    if (ss.newton.numpoints() == ss.thresh)
+        return check_subset(ss);
+    size_t need = ss.thresh - ss.newton.numpoints();
+    for (size_t ii = first; ii + need <= ss.nshares; ++ii) {
+        ss.newton.push(ss.xx[ii], ss.value[ii]);
+        ss.in_subset[ii] = true;
+        bool found = search_subsets(ss, ii + 1);
+        ss.in_subset[ii] = false;
+        ss.newton.pop();
+        if (found)
+            return true;
     }
-    else {
-        /* entropy from dice rolling alone */
-        sha256_Raw((const uint8_t*)rolls.c_str(), rolls.length(), digest);
+    return false;
+}
+
+#if GF256_BITSLICED
+
+// A single group of SSKR shares, as sskr_generate makes them, with
+// gf256_interpolate's bitsliced arithmetic.  The member polynomial
+// goes through thresh - 2 random shares, the digest at 254 and the
+// secret at 255, and the other shares are its values at their index.
+template <size_t N>
+void split_shares(uint8_t const * secret, uint8_t thresh, uint8_t nshares,
+                  uint8_t (*o_shares)[SSKRShareSeqT<N>::BYTES_PER_SHARE],
+                  void (*randgen)(uint8_t *, size_t, void *), void * randctx) {
+    size_t const META = SSKRShareSeqT<N>::METADATA_LENGTH_BYTES;
+
+    uint8_t identifier[2];
+    randgen(identifier, sizeof(identifier), randctx);
+    for (size_t ii = 0; ii < nshares; ++ii) {
+        o_shares[ii][0] = identifier[0];
+        o_shares[ii][1] = identifier[1];
+        o_shares[ii][2] = 0;		// group threshold and count 1
+        o_shares[ii][3] = thresh - 1;	// group 0
+        o_shares[ii][4] = ii;
     }
 
-    if (entropy != NULL) {
-        free(entropy);
+    if (thresh == 1) {
+        for (size_t ii = 0; ii < nshares; ++ii)
+            memcpy(o_shares[ii] + META, secret, N);
+        return;
     }
 
-    return new Seed(digest, SIZE);
+    uint8_t xs[SSKRShareSeqT<N>::MAX_SHARES];
+    uint8_t const * ys[SSKRShareSeqT<N>::MAX_SHARES];
+    size_t npoints = 0;
+    for (; npoints < thresh - 2u; ++npoints) {
+        randgen(o_shares[npoints] + META, N, randctx);
+        xs[npoints] = npoints;
+        ys[npoints] = o_shares[npoints] + META;
+    }
+    uint8_t digest[N];
+    uint8_t hmac[SHA256_DIGEST_LENGTH];
+    randgen(digest + SHAMIR_DIGEST_LENGTH, N - SHAMIR_DIGEST_LENGTH, randctx);
+    hmac_sha256(digest + SHAMIR_DIGEST_LENGTH, N - SHAMIR_DIGEST_LENGTH,
+                secret, N, hmac);
+    memcpy(digest, hmac, SHAMIR_DIGEST_LENGTH);
+    xs[npoints] = SHAMIR_DIGEST_INDEX;
+    ys[npoints++] = digest;
+    xs[npoints] = SHAMIR_SECRET_INDEX;
+    ys[npoints++] = secret;
+    for (size_t ii = thresh - 2; ii < nshares; ++ii)
+        gf256_interpolate(npoints, xs, ys, N, ii, o_shares[ii] + META);
+    memzero(digest, sizeof(digest));
+    memzero(hmac, sizeof(hmac));
+}
 
-//    // Convert supplied entropy into master secret.
-//    Sha256Class sha256;
-//    sha256.init();
-//    for(uint8_t ii=0; ii < rolls.length(); ii++) {
-//        sha256.write(rolls[ii]);
-//    }
-//    return new Seed(sha256.result(), SIZE);
+// The secret of a single group share set, from its first threshold
+// shares.  False if the shares aren't one such set, or too few, or the
+// digest doesn't match.
+template <size_t N>
+bool combine_shares(uint8_t const (*shares)[SSKRShareSeqT<N>::BYTES_PER_SHARE],
+                    size_t nshares, uint8_t * o_secret) {
+    size_t const META = SSKRShareSeqT<N>::METADATA_LENGTH_BYTES;
+    size_t const BYTES = SSKRShareSeqT<N>::BYTES_PER_SHARE;
+
+    SSKRShareMetadata first;
+    if (nshares == 0 || !SSKRShareSeqT<N>::decode_metadata(shares[0], BYTES, first))
+        return false;
+    bool member_seen[SSKRShareSeqT<N>::MAX_SHARES] = { false };
+    for (size_t ii = 0; ii < nshares; ++ii) {
+        SSKRShareMetadata meta;
+        if (!SSKRShareSeqT<N>::decode_metadata(shares[ii], BYTES, meta) ||
+            meta.identifier != first.identifier ||
+            meta.member_threshold != first.member_threshold ||
+            member_seen[meta.member_index])
+            return false;
+        member_seen[meta.member_index] = true;
+    }
+    if (nshares < first.member_threshold)
+        return false;
+
+    if (first.member_threshold == 1) {
+        memcpy(o_secret, shares[0] + META, N);
+        return true;
+    }
+
+    uint8_t xs[SSKRShareSeqT<N>::MAX_SHARES];
+    uint8_t const * ys[SSKRShareSeqT<N>::MAX_SHARES];
+    for (size_t ii = 0; ii < first.member_threshold; ++ii) {
+        xs[ii] = shares[ii][4] & 0xf;	// member index
+        ys[ii] = shares[ii] + META;
+    }
+    uint8_t digest[N];
+    gf256_interpolate(first.member_threshold, xs, ys, N, SHAMIR_SECRET_INDEX, o_secret);
+    gf256_interpolate(first.member_threshold, xs, ys, N, SHAMIR_DIGEST_INDEX, digest);
+    bool ok = digest_matches<N>(o_secret, digest);
+    memzero(digest, sizeof(digest));
+    if (!ok)
+        memzero(o_secret, N);
+    return ok;
 }
 
-Seed::Seed(uint8_t const * i_data, size_t len) {
-    using namespace seed_internal;
+#endif // GF256_BITSLICED
+
+} // namespace seed_internal
 
-    serial_assert(len == sizeof(data));
-    memcpy(data, i_data, len);
+template <size_t N>
+SeedT<N> * SeedT<N>::from_rolls(String const & rolls, uint8_t *trng_entropy, uint8_t trng_entropy_size) {
+    /* mix trng entropy into dice rolling. Trng entropy is appended. */
+    SeedBuilderT<N> builder;
+    for (size_t ii = 0; ii < rolls.length(); ++ii)
+        builder.add_roll(rolls[ii]);
+    return builder.finalize(trng_entropy, trng_entropy_size);
 }
 
-void Seed::log() const {
-    serial_printf("seed: ");
+template <size_t N>
+SeedBuilderT<N>::SeedBuilderT() {
+    reset();
+}
+
+template <size_t N>
+SeedBuilderT<N>::~SeedBuilderT() {
+    memzero(&ctx, sizeof(ctx));
+}
+
+template <size_t N>
+void SeedBuilderT<N>::add_roll(char roll) {
+    sha256_Update(&ctx, (uint8_t const *) &roll, 1);
+    ++nrolls;
+}
+
+template <size_t N>
+void SeedBuilderT<N>::reset() {
+    sha256_Init(&ctx);
+    nrolls = 0;
+}
+
+template <size_t N>
+SeedT<N> * SeedBuilderT<N>::finalize(uint8_t const * trng_entropy, size_t trng_entropy_size) {
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    if (trng_entropy)
+        sha256_Update(&ctx, trng_entropy, trng_entropy_size);
+    sha256_Final(&ctx, digest);
+    SeedT<N> * seed = new SeedT<N>(digest);
+    memzero(digest, sizeof(digest));
+    reset();
+    return seed;
+}
+
+template <size_t N>
+SeedT<N>::SeedT(uint8_t const * i_data) {
+    memcpy(data, i_data, SIZE);
+}
+
+template <size_t N>
+void SeedT<N>::log() const {
+    LOG_TRACE("seed: ");
     for (size_t ii = 0; ii < sizeof(data); ++ii)
-        serial_printf("%02x", data[ii]);
-    serial_printf("\n");
+        LOG_TRACE("%02x", data[ii]);
+    LOG_TRACE("\n");
+}
+
+template <size_t N>
+SSKRShareSeqT<N>::SSKRShareSeqT()
+    : shares_len(0)
+    , bytes_in_each_share(BYTES_PER_SHARE)
+    , nshares(0)
+    , last_rv(0)
+    , rendered_lru(0)
+{
+    for (size_t ss = 0; ss < RENDER_SLOTS; ++ss)
+        rendered_ndx[ss] = -1;
+}
+
+template <size_t N>
+SSKRShareSeqT<N>::~SSKRShareSeqT() {
+    memzero(shares, sizeof(shares));
+    memzero(rendered_words, sizeof(rendered_words));
+    for (size_t ss = 0; ss < RENDER_SLOTS; ++ss)
+        wipe_string(rendered_ur[ss]);
 }
 
-SSKRShareSeq * SSKRShareSeq::from_seed(Seed const * seed,
-                                           uint8_t thresh,
-                                           uint8_t nshares,
-                                           void(*randgen)(uint8_t *, size_t, void *)) {
+template <size_t N>
+SSKRShareSeqT<N> * SSKRShareSeqT<N>::from_seed(SeedT<N> const * seed,
+                                               uint8_t thresh,
+                                               uint8_t nshares,
+                                               void(*randgen)(uint8_t *, size_t, void *),
+                                               void * randctx) {
+    SSKRShareSeqT * sskr = new SSKRShareSeqT();
+
+    // The shares are generated straight into the arena, the text
+    // forms are only rendered when a share is displayed.
+#if GF256_BITSLICED
+    serial_assert(thresh >= 1 && thresh <= nshares && nshares <= MAX_SHARES);
+    seed_internal::split_shares<N>(seed->data, thresh, nshares, sskr->shares,
+                                   randgen, randctx);
+    sskr->bytes_in_each_share = BYTES_PER_SHARE;
+    sskr->nshares = nshares;
+    sskr->shares_len = nshares;
+#else
     uint8_t group_threshold = 1;
     uint8_t group_len = 1;
     sskr_group_descriptor group = { thresh, nshares };
     sskr_group_descriptor groups[] = { group };
 
-    size_t buff_size = 1024;
-    uint8_t buff[buff_size];
-
-    size_t bytes_in_each_share;
-
-    size_t share_len = Seed::SIZE + METADATA_LENGTH_BYTES;
-    int share_count = sskr_count_shards(group_threshold, groups, group_len);
-
-    buff_size = share_len * share_count;
-
     int gen_share_count = sskr_generate(group_threshold,
                              groups,
                              group_len,
                              seed->data,
-                             Seed::SIZE,
-                             &bytes_in_each_share,
-                             buff,
-                             buff_size,
-                             NULL,
+                             N,
+                             &sskr->bytes_in_each_share,
+                             sskr->shares[0],
+                             sizeof(sskr->shares),
+                             randctx,
                              randgen);
 
-    // currently we support only 29 words per share
-    serial_assert(bytes_in_each_share == BYTES_PER_SHARE);
-    serial_assert(gen_share_count == (int)share_count);
-    serial_assert(bytes_in_each_share == share_len);
+    serial_assert(sskr->bytes_in_each_share == BYTES_PER_SHARE);
+    serial_assert(gen_share_count == (int)sskr_count_shards(group_threshold, groups, group_len));
 
+    sskr->nshares = gen_share_count;
+    sskr->shares_len = gen_share_count;
+#endif
+    return sskr;
+}
 
-    String strings[MAX_SHARES];
-    String ur_strings[MAX_SHARES];
-    uint8_t shards_byte[MAX_SHARES][buff_size];
-    for (int i = 0; i < share_count; i++) {
-        uint8_t* bytes = buff + (i * bytes_in_each_share);
-        memcpy(shards_byte[i], bytes, bytes_in_each_share);
-
-        CborDynamicOutput output;
-        CborWriter writer(output);
-
-        writer.writeTag(309);
-        writer.writeBytes(shards_byte[i], bytes_in_each_share);
+template <size_t N>
+size_t SSKRShareSeqT<N>::add_share(uint8_t const * share) {
+    serial_assert(nshares < MAX_SHARES);
+    memcpy(shares[nshares], share, BYTES_PER_SHARE);
+    return nshares++;
+}
 
-        // Encode cbor payload as bytewords
-        char *payload_bytewords = bytewords_encode(bw_standard, output.getData(), output.getSize());
-        if(payload_bytewords == NULL) {
-            Serial.println("ur_encode bytewords failed");
-            return NULL;
-        }
-        else {
-            Serial.println(payload_bytewords);
-            strings[i] = String(payload_bytewords);
+template <size_t N>
+size_t SSKRShareSeqT<N>::render(size_t ndx) const {
+    serial_assert(ndx < nshares);
+    for (size_t ss = 0; ss < RENDER_SLOTS; ++ss) {
+        if (rendered_ndx[ss] == (int)ndx) {
+            rendered_lru = (ss + 1) % RENDER_SLOTS;
+            return ss;
         }
-
-        // and encode also as UR
-        String ur;
-        (void)ur_encode("crypto-sskr", output.getData(), output.getSize(), ur);
-        ur_strings[i] = ur;
     }
+    size_t slot = rendered_lru;
+    rendered_lru = (slot + 1) % RENDER_SLOTS;
+
+    CborDynamicOutput output;
+    CborWriter writer(output);
+    writer.writeTag(309);
+    writer.writeBytes(shares[ndx], BYTES_PER_SHARE);
+
+    char *payload_bytewords = bytewords_encode(bw_standard, output.getData(), output.getSize());
+    serial_assert(payload_bytewords);
+    serial_assert(strlen(payload_bytewords) < sizeof(rendered_words[slot]));
+    strcpy(rendered_words[slot], payload_bytewords);
+    memzero(payload_bytewords, strlen(payload_bytewords));
+    free(payload_bytewords);
+
+    wipe_string(rendered_ur[slot]);
+    (void)ur_encode("crypto-sskr", output.getData(), output.getSize(), rendered_ur[slot]);
+    rendered_ndx[slot] = ndx;
+    return slot;
+}
 
-    SSKRShareSeq * sskr = new SSKRShareSeq();
-    sskr->nshares = nshares;
-    sskr->shares_len = thresh;
-    sskr->bytes_in_each_share = bytes_in_each_share;
-    sskr->shares_len = share_count;
-    for (int i=0; i<share_count; i++) {
-        sskr->shares_bytewords[i] = strings[i];  // bytewords format
-        sskr->shares_ur[i] = ur_strings[i];      // ur format
-        sskr->set_share(i, shards_byte[i], bytes_in_each_share); // byte format
+template <size_t N>
+void SSKRShareSeqT<N>::unrender(size_t ndx) {
+    for (size_t ss = 0; ss < RENDER_SLOTS; ++ss) {
+        if (rendered_ndx[ss] == (int)ndx)
+            rendered_ndx[ss] = -1;
     }
-
-    return sskr;
 }
 
-size_t SSKRShareSeq::add_share(uint8_t const * share) {
-    serial_assert(nshares < MAX_SHARES);
-    size_t sharesz = sizeof(uint8_t) * BYTES_PER_SHARE;
-    shares[nshares] = (uint8_t *) malloc(sharesz);
-    memcpy(shares[nshares], share, sharesz);
-    return nshares++;
+template <size_t N>
+String SSKRShareSeqT<N>::get_share_word(int sharendx, int wndx) const {
+    serial_assert(wndx >= 0 && wndx < (int)WORDS_PER_SHARE);
+    size_t slot = render(sharendx);
+    // Words are 4 letters, separated by a space.
+    char word[5];
+    memcpy(word, rendered_words[slot] + wndx * 5, 4);
+    word[4] = '\0';
+    return String(word);
 }
 
-String SSKRShareSeq::get_share_word(int sharendx, int wndx) {
-    return get_word_from_sentence(shares_bytewords[sharendx], ' ', wndx);
+template <size_t N>
+void SSKRShareSeqT<N>::get_share_words(size_t ndx, uint8_t * o_words) const {
+    size_t slot = render(ndx);
+    // A byteword is known by its first and last letters.
+    for (size_t ii = 0; ii < WORDS_PER_SHARE; ++ii) {
+        char const * word = rendered_words[slot] + ii * 5;
+        int value = wordlist_byteword_from_letters(word[0], word[3]);
+        serial_assert(value >= 0);
+        o_words[ii] = value;
+    }
 }
 
-uint8_t const * SSKRShareSeq::get_share(size_t ndx) const {
+template <size_t N>
+uint8_t const * SSKRShareSeqT<N>::get_share(size_t ndx) const {
     serial_assert(ndx < nshares);
     return shares[ndx];
 }
 
-void SSKRShareSeq::set_share(size_t ndx, uint8_t const * share, size_t len) {
+template <size_t N>
+void SSKRShareSeqT<N>::set_share(size_t ndx, uint8_t const * share, size_t len) {
     serial_assert(ndx < nshares);
-    if (shares[ndx])
-        free(shares[ndx]);
-    size_t sharesz = sizeof(uint8_t) * len;
-    shares[ndx] = (uint8_t *) malloc(sharesz);
-    memcpy(shares[ndx], share, sharesz);
+    serial_assert(len == BYTES_PER_SHARE);
+    memcpy(shares[ndx], share, len);
+    unrender(ndx);
 }
 
-String SSKRShareSeq::get_share_strings(size_t ndx) const {
-    serial_assert(ndx < nshares);
-    return shares_bytewords[ndx];
+template <size_t N>
+String SSKRShareSeqT<N>::get_share_strings(size_t ndx) const {
+    return String(rendered_words[render(ndx)]);
 }
 
-Seed * SSKRShareSeq::restore_seed() const {
-    uint8_t seed_data[Seed::SIZE];
+template <size_t N>
+String SSKRShareSeqT<N>::get_share_ur(size_t ndx) const {
+    return rendered_ur[render(ndx)];
+}
+
+template <size_t N>
+SeedT<N> * SSKRShareSeqT<N>::restore_seed() const {
+    uint8_t seed_data[N];
+
+#if GF256_BITSLICED
+    // Single group sets, all a seedtool makes, are recovered here.
+    // bc-sskr gets any other set, and tells why a set is refused.
+    if (seed_internal::combine_shares<N>(shares, nshares, seed_data)) {
+        last_rv = N;
+        SeedT<N> * seed = new SeedT<N>(seed_data);
+        memzero(seed_data, sizeof(seed_data));
+        return seed;
+    }
+#endif
+
+    uint8_t const * share_ptrs[MAX_SHARES];
+    for (size_t ii = 0; ii < nshares; ++ii)
+        share_ptrs[ii] = shares[ii];
 
-    last_rv = sskr_combine(const_cast<const uint8_t **>(shares),
+    last_rv = sskr_combine(share_ptrs,
                              bytes_in_each_share,
                              nshares,
                              seed_data,
                              sizeof(seed_data));
-    Serial.println(last_rv);
-    return last_rv < 0 ? NULL : new Seed(seed_data, sizeof(seed_data));
+    LOG_DEBUG("sskr_combine: %d\n", last_rv);
+    return last_rv < 0 ? NULL : new SeedT<N>(seed_data);
+}
+
+template <size_t N>
+SeedT<N> * SSKRShareSeqT<N>::restore_seed_majority(size_t * o_outliers,
+                                                   size_t & o_noutliers) const {
+    using namespace seed_internal;
+
+    // Shares belong with those most others share an identifier and
+    // threshold with.
+    SSKRShareMetadata meta[MAX_SHARES];
+    bool ok[MAX_SHARES];
+    size_t best = nshares;
+    size_t best_count = 0;
+    for (size_t ii = 0; ii < nshares; ++ii)
+        ok[ii] = decode_metadata(shares[ii], BYTES_PER_SHARE, meta[ii]);
+    for (size_t ii = 0; ii < nshares; ++ii) {
+        if (!ok[ii])
+            continue;
+        size_t count = 0;
+        for (size_t jj = 0; jj < nshares; ++jj) {
+            count += ok[jj] &&
+                meta[jj].identifier == meta[ii].identifier &&
+                meta[jj].member_threshold == meta[ii].member_threshold;
+        }
+        if (count > best_count) {
+            best = ii;
+            best_count = count;
+        }
+    }
+
+    SubsetSearch<N> * ss = new SubsetSearch<N>();
+    size_t share_ndx[MAX_SHARES];	// share index of each search entry
+    bool member_seen[MAX_SHARES] = { false };
+    ss->nshares = 0;
+    if (best < nshares) {
+        ss->thresh = meta[best].member_threshold;
+        for (size_t ii = 0; ii < nshares; ++ii) {
+            if (!ok[ii] ||
+                meta[ii].identifier != meta[best].identifier ||
+                meta[ii].member_threshold != meta[best].member_threshold ||
+                member_seen[meta[ii].member_index])
+                continue;
+            member_seen[meta[ii].member_index] = true;
+            share_ndx[ss->nshares] = ii;
+            ss->xx[ss->nshares] = meta[ii].member_index;
+            ss->value[ss->nshares] = shares[ii] + METADATA_LENGTH_BYTES;
+            ss->in_subset[ss->nshares] = false;
+            ++ss->nshares;
+        }
+    }
+
+    bool found = false;
+    if (best < nshares && ss->nshares >= ss->thresh) {
+        ss->verify_all = false;
+        found = search_subsets(*ss, 0);
+        if (!found) {
+            // Maybe every share outside the good subsets is bad.
+            ss->verify_all = true;
+            found = search_subsets(*ss, 0);
+        }
+    }
+
+    SeedT<N> * seed = NULL;
+    o_noutliers = 0;
+    if (found) {
+        bool agree[MAX_SHARES] = { false };
+        for (size_t ii = 0; ii < ss->nshares; ++ii)
+            agree[share_ndx[ii]] = ss->agree[ii];
+        for (size_t ii = 0; ii < nshares; ++ii) {
+            if (!agree[ii])
+                o_outliers[o_noutliers++] = ii;
+        }
+        seed = new SeedT<N>(ss->secret);
+    }
+    memzero(ss->secret, sizeof(ss->secret));
+    delete ss;
+    return seed;
 }
 
 class CborListen : public CborListener {
   public:
+    CborListen() : tag_(0), len(0) {}
+    ~CborListen() { memzero(bytes, sizeof(bytes)); }
+
     void OnInteger(int32_t value){ };
-    void OnBytes(unsigned char *data, unsigned int size) { memcpy(bytes, data, size); len = size; };
+    void OnBytes(unsigned char *data, unsigned int size) {
+        // Oversized byte strings are not shares, drop them.
+        if (size > sizeof(bytes)) {
+            len = 0;
+            return;
+        }
+        memcpy(bytes, data, size);
+        len = size;
+    };
     void OnString(String &str) {};
     void OnArray(unsigned int size) {};
     void OnMap(unsigned int size) {};
@@ -201,7 +553,8 @@ class CborListen : public CborListener {
     size_t len;
 };
 
-bool SSKRShareSeq::get_share_from_ur(String bytewords, size_t sskr_shard_indx) {
+template <size_t N>
+bool SSKRShareSeqT<N>::get_share_from_ur(String bytewords, size_t sskr_shard_indx) {
     uint8_t* decoded = NULL;
     size_t decoded_len;
 
@@ -218,15 +571,15 @@ bool SSKRShareSeq::get_share_from_ur(String bytewords, size_t sskr_shard_indx) {
     reader.SetListener(listener);
     reader.Run();
 
+    free(decoded);
+
     // https://github.com/BlockchainCommons/Research/blob/master/papers/bcr-2020-011-sskr.md
-    if (listener.tag_ != 309)
+    if (listener.tag_ != 309 || listener.len != BYTES_PER_SHARE)
         return false;
 
-    free(decoded);
-
     if (sskr_shard_indx >= nshares) {
         // init a new share
-        uint8_t empty_share[SSKRShareSeq::BYTES_PER_SHARE] = {0};
+        uint8_t empty_share[BYTES_PER_SHARE] = {0};
         add_share(empty_share);
     }
 
@@ -236,18 +589,67 @@ bool SSKRShareSeq::get_share_from_ur(String bytewords, size_t sskr_shard_indx) {
     return true;
 }
 
-void SSKRShareSeq::del_share(size_t ndx) {
+template <size_t N>
+bool SSKRShareSeqT<N>::decode_metadata(uint8_t const * share, size_t len,
+                                       SSKRShareMetadata & o_meta) {
+    if (len != BYTES_PER_SHARE)
+        return false;
+    o_meta.identifier = (share[0] << 8) | share[1];
+    o_meta.group_threshold = (share[2] >> 4) + 1;
+    o_meta.group_count = (share[2] & 0xf) + 1;
+    o_meta.group_index = share[3] >> 4;
+    o_meta.member_threshold = (share[3] & 0xf) + 1;
+    o_meta.member_index = share[4] & 0xf;
+    // The high nibble of the last metadata byte is reserved.
+    if (share[4] >> 4)
+        return false;
+    if (o_meta.group_threshold > o_meta.group_count ||
+        o_meta.group_index >= o_meta.group_count)
+        return false;
+    // We only generate and restore a single group.
+    if (o_meta.group_count != 1)
+        return false;
+    return true;
+}
+
+template <size_t N>
+SSKRShareCheck SSKRShareSeqT<N>::check_share(size_t ndx) const {
+    serial_assert(ndx < nshares);
+    SSKRShareMetadata meta;
+    if (!decode_metadata(shares[ndx], BYTES_PER_SHARE, meta))
+        return SSKR_SHARE_BAD_METADATA;
+    uint8_t const empty_share[BYTES_PER_SHARE] = {0};
+    for (size_t ii = 0; ii < nshares; ++ii) {
+        // Shares being added start out zeroed, skip them.
+        if (ii == ndx || memcmp(shares[ii], empty_share, BYTES_PER_SHARE) == 0)
+            continue;
+        SSKRShareMetadata other;
+        if (!decode_metadata(shares[ii], BYTES_PER_SHARE, other))
+            continue;
+        if (other.identifier != meta.identifier ||
+            other.member_threshold != meta.member_threshold)
+            return SSKR_SHARE_MISMATCH;
+        if (other.member_index == meta.member_index)
+            return SSKR_SHARE_DUPLICATE;
+    }
+    return SSKR_SHARE_OK;
+}
+
+template <size_t N>
+void SSKRShareSeqT<N>::del_share(size_t ndx) {
     serial_assert(ndx < nshares);
-    if (shares[ndx])
-        free(shares[ndx]);
     // Compact any created gap.
-    for (size_t ii = ndx; ii < nshares-1; ++ii)
-        shares[ii] = shares[ii+1];
+    memmove(shares[ndx], shares[ndx+1], (nshares - 1 - ndx) * BYTES_PER_SHARE);
+    memzero(shares[nshares-1], BYTES_PER_SHARE);
     nshares -= 1;
+    // Shares after ndx moved down, forget them all.
+    for (size_t ss = 0; ss < RENDER_SLOTS; ++ss)
+        rendered_ndx[ss] = -1;
 }
 
-BIP39Seq * BIP39Seq::from_words(uint16_t * words) {
-    BIP39Seq * retval = new BIP39Seq();
+template <size_t N>
+BIP39SeqT<N> * BIP39SeqT<N>::from_words(uint16_t * words) {
+    BIP39SeqT * retval = new BIP39SeqT();
     for (size_t ii = 0; ii < WORD_COUNT; ++ii)
         retval->set_word(ii, words[ii]);
 
@@ -257,48 +659,94 @@ BIP39Seq * BIP39Seq::from_words(uint16_t * words) {
     return retval;
 }
 
-BIP39Seq::BIP39Seq() {
+template <size_t N>
+void BIP39SeqT<N>::valid_last_words(uint16_t const * words, uint16_t * o_words) {
+    size_t const ENT_BITS = WORD_COUNT * 11 * 32 / 33;
+    size_t const CS_BITS = ENT_BITS / 32;
+    size_t const FREE_BITS = 11 - CS_BITS;
+    uint8_t entropy[ENT_BITS / 8];
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+
+    // Pack the known words, most significant bit first.
+    memset(entropy, 0, sizeof(entropy));
+    size_t bit = 0;
+    for (size_t ii = 0; ii < WORD_COUNT - 1; ++ii) {
+        for (int bb = 10; bb >= 0; --bb, ++bit) {
+            if ((words[ii] >> bb) & 1)
+                entropy[bit / 8] |= 0x80 >> (bit % 8);
+        }
+    }
+
+    // One hash per choice of the free entropy bits, the checksum then
+    // fixes the rest of the last word.
+    for (uint16_t free = 0; free < LAST_WORD_CHOICES; ++free) {
+        for (size_t bb = 0; bb < FREE_BITS; ++bb) {
+            size_t pos = bit + bb;
+            uint8_t mask = 0x80 >> (pos % 8);
+            if ((free >> (FREE_BITS - 1 - bb)) & 1)
+                entropy[pos / 8] |= mask;
+            else
+                entropy[pos / 8] &= ~mask;
+        }
+        sha256_Raw(entropy, sizeof(entropy), digest);
+        o_words[free] = (free << CS_BITS) | (digest[0] >> (8 - CS_BITS));
+    }
+
+    memset(entropy, 0, sizeof(entropy));
+    memset(digest, 0, sizeof(digest));
+}
+
+template <size_t N>
+BIP39SeqT<N>::BIP39SeqT() {
     ctx = bip39_new_context();
-    bip39_set_byte_count(ctx, Seed::SIZE);
+    bip39_set_byte_count(ctx, N);
 }
 
-BIP39Seq::BIP39Seq(Seed const * seed) {
+template <size_t N>
+BIP39SeqT<N>::BIP39SeqT(SeedT<N> const * seed) {
     using namespace seed_internal;
 
     ctx = bip39_new_context();
-    bip39_set_byte_count(ctx, Seed::SIZE);
-    bip39_set_payload(ctx, Seed::SIZE, seed->data);
+    bip39_set_byte_count(ctx, N);
+    bip39_set_payload(ctx, N, seed->data);
 
     // this function takes a couple of seconds!
     calc_mnemonic_seed();
 }
 
-BIP39Seq::~BIP39Seq() {
+template <size_t N>
+BIP39SeqT<N>::~BIP39SeqT() {
     bip39_dispose_context(ctx);
+    memzero(mnemonic_seed, sizeof(mnemonic_seed));
 }
 
-void BIP39Seq::set_word(size_t ndx, uint16_t word) {
+template <size_t N>
+void BIP39SeqT<N>::set_word(size_t ndx, uint16_t word) {
     bip39_set_word(ctx, ndx, word);
 }
 
-String BIP39Seq::get_dict_string(size_t ndx) {
+template <size_t N>
+String BIP39SeqT<N>::get_dict_string(size_t ndx) {
     char mnemonic[20];
     bip39_mnemonic_from_word(ndx, mnemonic);
     return String(mnemonic);
 }
 
-uint16_t BIP39Seq::get_word(size_t ndx) const {
+template <size_t N>
+uint16_t BIP39SeqT<N>::get_word(size_t ndx) const {
     return bip39_get_word(ctx, ndx);
 }
 
-String BIP39Seq::get_string(size_t ndx) {
+template <size_t N>
+String BIP39SeqT<N>::get_string(size_t ndx) {
     uint16_t word = bip39_get_word(ctx, ndx);
     char mnemonic[20];
     bip39_mnemonic_from_word(word, mnemonic);
     return String(mnemonic);
 }
 
-String BIP39Seq::get_mnemonic_as_string() {
+template <size_t N>
+String BIP39SeqT<N>::get_mnemonic_as_string() {
     String mnemonic;
     for (size_t i=0; i< WORD_COUNT; i++) {
         mnemonic += get_string(i);
@@ -308,7 +756,8 @@ String BIP39Seq::get_mnemonic_as_string() {
     return mnemonic;
 }
 
-bool BIP39Seq::calc_mnemonic_seed() {
+template <size_t N>
+bool BIP39SeqT<N>::calc_mnemonic_seed() {
 
     String mnemonic_str = get_mnemonic_as_string();
     size_t written;
@@ -320,12 +769,22 @@ bool BIP39Seq::calc_mnemonic_seed() {
     return true;
 }
 
-Seed * BIP39Seq::restore_seed() const {
+template <size_t N>
+SeedT<N> * BIP39SeqT<N>::restore_seed() const {
     return bip39_verify_checksum(ctx)
-        ? new Seed(bip39_get_bytes(ctx), Seed::SIZE)
+        ? new SeedT<N>(bip39_get_bytes(ctx))
         : NULL;
 }
 
+template class SeedT<16>;
+template class SeedT<32>;
+template class SeedBuilderT<16>;
+template class SeedBuilderT<32>;
+template class BIP39SeqT<16>;
+template class BIP39SeqT<32>;
+template class SSKRShareSeqT<16>;
+template class SSKRShareSeqT<32>;
+
 int bip39_mnemonic_to_seed(const char *mnemonic, const char *passphrase,
                             unsigned char *bytes_out, size_t len,
                             size_t *written)
@@ -1,6 +1,8 @@
 // Copyright © 2020 Blockchain Commons, LLC
 
 #include "hardware.h"
+#include "entropy.h"
+#include "log.h"
 #include "selftest.h"
 #include "seed.h"
 #include "userinterface.h"
@@ -9,8 +11,16 @@
 #include "gitrevision.h"
 
 void setup() {
+    uint32_t t0 = micros();
 
     hw_setup();
+    uint32_t t_hw = micros();
+
+    entropy_setup();
+    uint32_t t_entropy = micros();
+
+    ui_setup();
+    uint32_t t_ui = micros();
 
     // To see the serial debugging output from the power-on-self-test
     // uncomment this delay to give you a chance to get the serial
@@ -20,7 +30,10 @@ void setup() {
 
     ui_reset_into_state(SELF_TEST);
 
-    Serial.println("seedtool starting");
+    LOG_TRACE("setup: hw %lu us, entropy %lu us, ui %lu us\n",
+              (unsigned long) (t_hw - t0), (unsigned long) (t_entropy - t_hw),
+              (unsigned long) (t_ui - t_entropy));
+    LOG_INFO("seedtool starting\n");
 }
 
 void loop() {
@@ -5,10 +5,20 @@
 
 void selftest();
 
+// The fast tier holds cheap known answer tests and runs at every
+// boot, the full tier holds the rest and runs on demand.
+enum SelftestTier {
+    SELFTEST_FAST,
+    SELFTEST_FULL,
+};
+
 // Used to run selftests from the UI.
 size_t selftest_numtests();
 String selftest_testname(size_t ndx);
+SelftestTier selftest_testtier(size_t ndx);
 bool selftest_testrun(size_t ndx);
+// How long the last run of a test took, in ms.
+uint32_t selftest_duration(size_t ndx);
 
 // Used to populate dummy data in UI testing.
 const uint8_t * selftest_dummy_sskr(size_t ndx);
@@ -4,34 +4,69 @@
 
 #include "seed.h"
 #include "util.h"
+#include "log.h"
 
 #include "selftest.h"
 #include <bc-crypto-base.h>
 #include <bc-bip39.h>
+#include <bc-sskr.h>
 #include "prefix1.h"
 
 #include "secp256k1.h"
 #include "wally_core.h"
+#include "wally_crypto.h"
 #include "wally_bip32.h"
 #include "ur.h"
 #include "test_bc_ur.hpp"
+#ifndef SEEDTOOL_HOST
+#include "glyph.h"
+#endif
+#include "scheduler.h"
+#include "wordlist.h"
+#include "entropy.h"
+#include "ceremony.h"
+#include "psbt.h"
+#include "serialcmd.h"
+#include "hardware.h"
+#include "userinterface.h"
+#include "gitrevision.h"
+#include "bc-bytewords.h"
+
+#ifndef SEEDTOOL_HOST
+// Defined by the font headers included in userinterface.ino.
+extern const GFXfont FreeMonoBold9pt7b;
+extern const GFXfont FreeSansBold9pt7b;
+#endif
 
 namespace selftest_internal {
 
+// The reference vectors are for 128 bit seeds, whatever SEED_BYTES is.
+typedef SeedT<16> Seed128;
+typedef SeedBuilderT<16> SeedBuilder128;
+typedef BIP39SeqT<16> BIP39Seq128;
+typedef SSKRShareSeqT<16> SSKRShareSeq128;
+
 uint8_t ref_secret[16] =
 {
  0x8d, 0x96, 0x9e, 0xef, 0x6e, 0xca, 0xd3, 0xc2,
  0x9a, 0x3a, 0x62, 0x92, 0x80, 0xe6, 0x86, 0xcf
 };
 
-uint16_t ref_bip39_words_correct[BIP39Seq::WORD_COUNT] =
+// The rest of the SHA256 of "123456", for 256 bit seeds.
+uint8_t ref_secret256_tail[16] =
+{
+ 0x0c, 0x3f, 0x5d, 0x5a, 0x86, 0xaf, 0xf3, 0xca,
+ 0x12, 0x02, 0x0c, 0x92, 0x3a, 0xdc, 0x6c, 0x92
+};
+
+uint16_t ref_bip39_words_correct[BIP39Seq128::WORD_COUNT] =
 {
  0x046c, 0x05a7, 0x05de, 0x06ec,
  0x0569, 0x070a, 0x0347, 0x0262,
  0x0494, 0x0039, 0x050d, 0x04f1
 };
 
-uint16_t ref_bip39_words_bad_checksum[BIP39Seq::WORD_COUNT] =
+uint16_t ref_bip39_words_bad_checksum[BIP39Seq128::WORD_COUNT] =
 {
  // third word is altered
  0x046c, 0x05a7, 0x0569, 0x06ec,
@@ -39,7 +74,7 @@ uint16_t ref_bip39_words_bad_checksum[BIP39Seq::WORD_COUNT] =
  0x0494, 0x0039, 0x050d, 0x04f1
 };
 
-const char* ref_bip39_mnemonics[BIP39Seq::WORD_COUNT] =
+const char* ref_bip39_mnemonics[BIP39Seq128::WORD_COUNT] =
 {
  "mirror", "reject", "rookie", "talk",
  "pudding", "throw", "happy", "era",
@@ -86,69 +121,119 @@ bool test_failed(const char *format, ...) {
   vsnprintf(buff, sizeof(buff), format, args);
   va_end(args);
   buff[sizeof(buff)/sizeof(buff[0])-1]='\0';
-  Serial.print(buff);
+  LOG_ERROR("%s", buff);
   return false;
 }
 
 bool test_sha256() {
-    serial_printf("test_sha256 starting\n");
+    LOG_DEBUG("test_sha256 starting\n");
     uint8_t digest[SHA256_DIGEST_LENGTH];
     sha256_Raw((const uint8_t*)ref_sha_input, strlen(ref_sha_input), digest);
     if (memcmp(digest, ref_sha256_output, SHA256_DIGEST_LENGTH) != 0) {
         return test_failed("test_sha256 failed\n");
     }
-    serial_printf("test_sha256 finished\n");
+    LOG_DEBUG("test_sha256 finished\n");
+    return true;
+}
+
+// Known answers for the primitives under BIP39 and BIP32, with the
+// PBKDF2 iterations cut down so this can run at every boot.
+bool test_kdf(void) {
+    LOG_DEBUG("test_kdf starting\n");
+    // RFC 4231 test case 2.
+    char const * key = "Jefe";
+    char const * data = "what do ya want for nothing?";
+    uint8_t mac256[SHA256_DIGEST_LENGTH];
+    hmac_sha256((uint8_t const *) key, strlen(key),
+                (uint8_t const *) data, strlen(data), mac256);
+    if (!compare_bytes_with_hex(mac256, sizeof(mac256),
+            "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"))
+        return test_failed("test_kdf failed: HMAC-SHA256\n");
+    uint8_t mac512[SHA512_DIGEST_LENGTH];
+    hmac_sha512((uint8_t const *) key, strlen(key),
+                (uint8_t const *) data, strlen(data), mac512);
+    if (!compare_bytes_with_hex(mac512, sizeof(mac512),
+            "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea250554"
+            "9758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737"))
+        return test_failed("test_kdf failed: HMAC-SHA512\n");
+
+    // PBKDF2-HMAC-SHA512 "password", "salt", 2 iterations.
+    uint8_t salt[] = { 's', 'a', 'l', 't' };
+    uint8_t dk[BIP39_SEED_LEN_512];
+    if (wally_pbkdf2_hmac_sha512((unsigned char *) "password", 8,
+                                 salt, sizeof(salt), 0, 2,
+                                 dk, sizeof(dk)) != WALLY_OK ||
+        !compare_bytes_with_hex(dk, sizeof(dk),
+            "e1d9c16aa681708a45f5c7c4e215ceb66e011a2e9f0040713f18aefdb866d53c"
+            "f76cab2868a39b9f7840edce4fef5a82be67335c77a6068e04112754f27ccf4e"))
+        return test_failed("test_kdf failed: PBKDF2-HMAC-SHA512\n");
+    LOG_DEBUG("test_kdf finished\n");
     return true;
 }
 
 bool test_seed_generate() {
-    serial_printf("test_seed_generate starting\n");
-    Seed * seed = Seed::from_rolls("123456");
-    Seed * seed0 = new Seed(ref_secret, sizeof(ref_secret));
+    LOG_DEBUG("test_seed_generate starting\n");
+    Seed128 * seed = Seed128::from_rolls("123456");
+    Seed128 * seed0 = new Seed128(ref_secret);
     if (*seed != *seed0)
         return test_failed("test_seed_generate failed: seed mismatch\n");
 
-    Seed * seed_mixed = Seed::from_rolls("123", (uint8_t *)"456", 3);
+    Seed128 * seed_mixed = Seed128::from_rolls("123", (uint8_t *)"456", 3);
     if (*seed_mixed != *seed0)
         return test_failed("test_seed_generate failed: seed mismatch when mixing entropy\n");
 
-    seed_mixed = Seed::from_rolls("123", (uint8_t *)"4567", 4);
+    delete seed_mixed;
+    seed_mixed = Seed128::from_rolls("123", (uint8_t *)"4567", 4);
     if (*seed_mixed == *seed0)
         return test_failed("test_seed_generate failed: seed mismatch when mixing entropy\n");
 
+    // The builder forgets rolls on reset and starts over on finalize.
+    SeedBuilder128 builder;
+    builder.add_roll('6');
+    builder.reset();
+    for (int round = 0; round < 2; ++round) {
+        for (char const * roll = "123456"; *roll; ++roll)
+            builder.add_roll(*roll);
+        Seed128 * built = builder.finalize();
+        bool ok = *built == *seed0 && builder.numrolls() == 0;
+        delete built;
+        if (!ok)
+            return test_failed("test_seed_generate failed: builder\n");
+    }
+
     delete seed0;
     delete seed;
     delete seed_mixed;
-    serial_printf("test_seed_generate finished\n");
+    LOG_DEBUG("test_seed_generate finished\n");
     return true;
 }
 
 bool test_bip39_mnemonics() {
-    serial_printf("test_bip39_mnemonics starting\n");
+    LOG_DEBUG("test_bip39_mnemonics starting\n");
     void* ctx = bip39_new_context();
-    for(size_t i = 0; i < BIP39Seq::WORD_COUNT; i++) {
+    for(size_t i = 0; i < BIP39Seq128::WORD_COUNT; i++) {
         uint16_t word = ref_bip39_words_correct[i];
         const char* mnemonic1 = ref_bip39_mnemonics[i];
         const char* mnemonic2 = bip39_get_mnemonic(ctx, word);
-        //serial_printf("word: 0x%0hx, mnemonic1: \"%s\", mnemonic2: \"%s\"\n", word, mnemonic1, mnemonic2);
+        LOG_TRACE("word: 0x%0hx, mnemonic1: \"%s\", mnemonic2: \"%s\"\n", word, mnemonic1, mnemonic2);
         if(strcmp(mnemonic1, mnemonic2) != 0) {
             return test_failed("test_bip39_mnemonics failed: mismatch\n");
         }
     }
     bip39_dispose_context(ctx);
-    serial_printf("test_bip39_mnemonics finished\n");
+    LOG_DEBUG("test_bip39_mnemonics finished\n");
     return true;
 }
 
 bool test_bip39_generate() {
-    serial_printf("test_bip39_generate starting\n");
-    Seed * seed = Seed::from_rolls("123456");
-    BIP39Seq * bip39 = new BIP39Seq(seed);
-    for (size_t ii = 0; ii < BIP39Seq::WORD_COUNT; ++ii) {
+    LOG_DEBUG("test_bip39_generate starting\n");
+    Seed128 * seed = Seed128::from_rolls("123456");
+    BIP39Seq128 * bip39 = new BIP39Seq128(seed);
+    for (size_t ii = 0; ii < BIP39Seq128::WORD_COUNT; ++ii) {
         uint16_t word = bip39->get_word(ii);
         if (word != ref_bip39_words_correct[ii])
             return test_failed("test_bip39_generate failed: word mismatch\n");
-        if (strcmp(BIP39Seq::get_dict_string(word).c_str(),
+        if (strcmp(BIP39Seq128::get_dict_string(word).c_str(),
                    ref_bip39_mnemonics[ii]) != 0)
             return test_failed("test_bip39_generate failed: "
                                "dict_string mismatch\n");
@@ -158,84 +243,84 @@ bool test_bip39_generate() {
     }
     delete bip39;
     delete seed;
-    serial_printf("test_bip39_generate finished\n");
+    LOG_DEBUG("test_bip39_generate finished\n");
     return true;
 }
 
 bool test_bip39_restore() {
-    serial_printf("test_bip39_restore starting\n");
-    BIP39Seq * bip39 = BIP39Seq::from_words(ref_bip39_words_correct);
-    Seed * seed = bip39->restore_seed();
+    LOG_DEBUG("test_bip39_restore starting\n");
+    BIP39Seq128 * bip39 = BIP39Seq128::from_words(ref_bip39_words_correct);
+    Seed128 * seed = bip39->restore_seed();
     if (!seed)
         return test_failed("test_bip39_restore failed: restore failed\n");
-    Seed * seed0 = Seed::from_rolls("123456");
+    Seed128 * seed0 = Seed128::from_rolls("123456");
     if (*seed != *seed0)
         return test_failed("test_bip39_restore failed: seed mismatch\n");
     delete seed0;
     delete seed;
     delete bip39;
-    serial_printf("test_bip39_restore finished\n");
+    LOG_DEBUG("test_bip39_restore finished\n");
     return true;
 }
 
 bool test_bip39_bad_checksum() {
-    serial_printf("test_bip39_bad_checksum starting\n");
-    BIP39Seq * bip39 = BIP39Seq::from_words(ref_bip39_words_bad_checksum);
-    Seed * seed = bip39->restore_seed();
+    LOG_DEBUG("test_bip39_bad_checksum starting\n");
+    BIP39Seq128 * bip39 = BIP39Seq128::from_words(ref_bip39_words_bad_checksum);
+    Seed128 * seed = bip39->restore_seed();
     if (seed)
         return test_failed(
             "test_bip39_bad_checksum failed: restore verify passed\n");
     delete seed;
     delete bip39;
-    serial_printf("test_bip39_bad_checksum finished\n");
+    LOG_DEBUG("test_bip39_bad_checksum finished\n");
     return true;
 }
 
 bool test_sskr(void) {
 
-    Seed seed = Seed(selftest_seed_arr, sizeof(selftest_seed_arr));
-    SSKRShareSeq * sskr = SSKRShareSeq::from_seed(&seed, 2, 3, random_buffer);
+    Seed128 seed = Seed128(selftest_seed_arr);
+    SSKRShareSeq128 * sskr = SSKRShareSeq128::from_seed(&seed, 2, 3, random_buffer);
 
-    Serial.println("sskr print");
+    LOG_TRACE("sskr print\n");
     for (int i=0; i < sskr->shares_len; i++) {
-         Serial.println(sskr->shares_bytewords[i]);
+         LOG_TRACE("%s\n", sskr->get_share_strings(i).c_str());
     }
 
     // restore with all shards
-    Seed *seed_restored = sskr->restore_seed();
+    Seed128 *seed_restored = sskr->restore_seed();
     if (seed_restored == NULL || seed != *seed_restored) {
         seed.log();
         seed_restored->log();
-        Serial.println("sskr failed");
+        LOG_ERROR("sskr failed\n");
         return false;
     }
     delete seed_restored;
     delete sskr;
 
     // restore from the first and third shard:
-    SSKRShareSeq sskr2 = SSKRShareSeq();
+    SSKRShareSeq128 sskr2;
     bool ret = sskr2.get_share_from_ur(selftest_sskr[0], 0);
     if (ret == false) {
-        Serial.println("get_share_from_ur failed");
+        LOG_ERROR("get_share_from_ur failed\n");
         return false;
     }
 
     ret = sskr2.get_share_from_ur(selftest_sskr[2], 1);
     if (ret == false) {
-        Serial.println("get_share_from_ur failed");
+        LOG_ERROR("get_share_from_ur failed\n");
         return false;
     }
 
     seed_restored = sskr2.restore_seed();
     if (seed_restored == NULL || seed != *seed_restored) {
-        Serial.println("sskr failed");
+        LOG_ERROR("sskr failed\n");
         return false;
     }
 
     // is it round-trip compatible with bip39?
-    BIP39Seq * bip39 = new BIP39Seq(seed_restored);
+    BIP39Seq128 * bip39 = new BIP39Seq128(seed_restored);
     if (bip39->get_mnemonic_as_string() != selftest_bip39) {
-          Serial.println("bip39-sskr: round-trip incompatible");
+          LOG_ERROR("bip39-sskr: round-trip incompatible\n");
           return false;
     }
 
@@ -248,10 +333,378 @@ bool test_sskr(void) {
     // must fail due to incorrect bytewords checksum
     ret = sskr2.get_share_from_ur(shard_changed, 1);
     if (ret == true) {
-        Serial.println("get_share_from_ur failed");
+        LOG_ERROR("get_share_from_ur failed\n");
+        return false;
+    }
+
+    // each share is checked against the others as it is entered
+    SSKRShareMetadata meta;
+    if (!SSKRShareSeq128::decode_metadata(sskr2.get_share(0), SSKRShareSeq128::BYTES_PER_SHARE, meta) ||
+        meta.member_threshold != selftest_sskr_thresh || meta.member_index != 0) {
+        LOG_ERROR("sskr metadata failed\n");
+        return false;
+    }
+    sskr2.get_share_from_ur(selftest_sskr[2], 1);
+    if (sskr2.check_share(1) != SSKR_SHARE_OK) {
+        LOG_ERROR("sskr check_share failed\n");
+        return false;
+    }
+    sskr2.get_share_from_ur(selftest_sskr[0], 1);
+    if (sskr2.check_share(1) != SSKR_SHARE_DUPLICATE) {
+        LOG_ERROR("sskr check_share duplicate failed\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool test_entropy(void) {
+    LOG_DEBUG("test_entropy starting\n");
+    if (!entropy_healthy())
+        return test_failed("test_entropy failed: TRNG health test\n");
+
+    // NIST CAVP HMAC_DRBG SHA-256, no prediction resistance, count 0:
+    // EntropyInput || Nonce, the second 1024 bits generated.
+    uint8_t seed[48] = {
+        0xca, 0x85, 0x19, 0x11, 0x34, 0x93, 0x84, 0xbf,
+        0xfe, 0x89, 0xde, 0x1c, 0xbd, 0xc4, 0x6e, 0x68,
+        0x31, 0xe4, 0x4d, 0x34, 0xa4, 0xfb, 0x93, 0x5e,
+        0xe2, 0x85, 0xdd, 0x14, 0xb7, 0x1a, 0x74, 0x88,
+        0x65, 0x9b, 0xa9, 0x6c, 0x60, 0x1d, 0xc6, 0x9f,
+        0xc9, 0x02, 0x94, 0x08, 0x05, 0xec, 0x0c, 0xa8
+    };
+    HmacDrbg drbg;
+    uint8_t out[128];
+    drbg_init(drbg, seed, sizeof(seed));
+    drbg_generate(drbg, out, sizeof(out));
+    drbg_generate(drbg, out, sizeof(out));
+    if (!compare_bytes_with_hex(out, sizeof(out),
+            "e528e9abf2dece54d47c7e75e5fe302149f817ea9fb4bee6f4199697d04d5b89"
+            "d54fbb978a15b5c443c9ec21036d2460b6f73ebad0dc2aba6e624abf07745bc1"
+            "07694bb7547bb0995f70de25d6b29e2d3011bb19d27676c07162c8b5ccde0668"
+            "961df86803482cb37ed6d5c0bb8d50cf1f50d476aa0458bdaba806f48be9dcb8"))
+        return test_failed("test_entropy failed: HMAC_DRBG vector\n");
+
+    // Deterministic mode repeats itself.
+    uint8_t first[16], second[16];
+    entropy_set_deterministic(seed, sizeof(seed));
+    random_buffer(first, sizeof(first));
+    entropy_set_deterministic(seed, sizeof(seed));
+    random_buffer(second, sizeof(second));
+    entropy_set_deterministic(NULL, 0);
+    if (memcmp(first, second, sizeof(first)) != 0)
+        return test_failed("test_entropy failed: deterministic\n");
+    random_buffer(second, sizeof(second));
+    if (memcmp(first, second, sizeof(first)) == 0)
+        return test_failed("test_entropy failed: still deterministic\n");
+
+    // The adaptive proportion test trips when the first sample of a
+    // 512 sample window turns up 62 times, one above what 4 bits of
+    // min-entropy allow at a 2^-20 false alarm rate.
+    for (size_t repeats = 61; repeats <= 62; ++repeats) {
+        uint8_t samples[512];
+        uint8_t filler = 0;
+        for (size_t ii = 0; ii < sizeof(samples); ++ii) {
+            if (ii % 8 == 0 && ii / 8 < repeats) {
+                samples[ii] = 0xa5;
+            } else {
+                if (++filler == 0xa5)
+                    ++filler;
+                samples[ii] = filler;
+            }
+        }
+        if (entropy_health_check(samples, sizeof(samples)) != (repeats < 62))
+            return test_failed("test_entropy failed: APT at %d repeats\n",
+                               (int) repeats);
+    }
+    // The repetition count test trips on 6 equal samples in a row.
+    uint8_t run[6] = { 7, 7, 7, 7, 7, 7 };
+    if (!entropy_health_check(run, 5) || entropy_health_check(run, 6))
+        return test_failed("test_entropy failed: RCT\n");
+    LOG_DEBUG("test_entropy finished\n");
+    return true;
+}
+
+// 256 bit seeds: 24 word mnemonics and 46 word SSKR shares.
+bool test_seed256(void) {
+    LOG_DEBUG("test_seed256 starting\n");
+    // Dice rolls give the whole SHA256 of the rolls.
+    SeedT<32> * seed = SeedT<32>::from_rolls("123456");
+    bool ok = memcmp(seed->data, ref_secret, sizeof(ref_secret)) == 0 &&
+        memcmp(seed->data + sizeof(ref_secret), ref_secret256_tail,
+               sizeof(ref_secret256_tail)) == 0;
+    delete seed;
+    if (!ok)
+        return test_failed("test_seed256 failed: from_rolls\n");
+
+    // All zero entropy is "abandon" 23 times and "art".
+    uint8_t zeros[32] = {0};
+    SeedT<32> seed0(zeros);
+    BIP39SeqT<32> * bip39 = new BIP39SeqT<32>(&seed0);
+    for (size_t ii = 0; ii < BIP39SeqT<32>::WORD_COUNT; ++ii) {
+        if (bip39->get_string(ii) != (ii < 23 ? "abandon" : "art"))
+            return test_failed("test_seed256 failed: bip39 word %d\n", ii);
+    }
+    SeedT<32> * restored = bip39->restore_seed();
+    ok = restored && *restored == seed0;
+    delete restored;
+    if (!ok)
+        return test_failed("test_seed256 failed: bip39 restore\n");
+
+    uint16_t words[BIP39SeqT<32>::WORD_COUNT];
+    for (size_t ii = 0; ii < BIP39SeqT<32>::WORD_COUNT; ++ii)
+        words[ii] = bip39->get_word(ii);
+    delete bip39;
+    uint16_t choices[BIP39SeqT<32>::LAST_WORD_CHOICES];
+    BIP39SeqT<32>::valid_last_words(words, choices);
+    ok = false;
+    for (size_t ii = 0; ii < BIP39SeqT<32>::LAST_WORD_CHOICES; ++ii)
+        ok = ok || choices[ii] == words[BIP39SeqT<32>::WORD_COUNT - 1];
+    if (!ok)
+        return test_failed("test_seed256 failed: bip39 last word\n");
+
+    // Round trip through the share bytewords.
+    SeedT<32> seed1(ref_sha256_output);
+    SSKRShareSeqT<32> * sskr =
+        SSKRShareSeqT<32>::from_seed(&seed1, 2, 3, random_buffer);
+    SSKRShareSeqT<32> sskr2;
+    for (size_t ii = 0; ii < 2; ++ii) {
+        String text = sskr->get_share_strings(ii + 1);
+        uint8_t share_words[SSKRShareSeqT<32>::WORDS_PER_SHARE];
+        sskr->get_share_words(ii + 1, share_words);
+        if (text.length() != SSKRShareSeqT<32>::WORDS_PER_SHARE * 5 - 1 ||
+            share_words[3] != 0x58 || share_words[4] != 37 ||
+            !sskr2.get_share_from_ur(text, ii))
+            return test_failed("test_seed256 failed: sskr share %d\n", ii);
+    }
+    delete sskr;
+    restored = sskr2.restore_seed();
+    ok = restored && *restored == seed1;
+    delete restored;
+    if (!ok)
+        return test_failed("test_seed256 failed: sskr restore\n");
+
+    LOG_DEBUG("test_seed256 finished\n");
+    return true;
+}
+
+// Randomized differential tests over a reproducible corpus, the
+// random requests are served from a DRBG with a fixed seed.
+template <size_t N>
+bool sskr_random_trials(size_t ntrials) {
+    for (size_t trial = 0; trial < ntrials; ++trial) {
+        uint8_t data[N];
+        uint8_t rnd[3];
+        random_buffer(data, sizeof(data));
+        random_buffer(rnd, sizeof(rnd));
+        SeedT<N> seed(data);
+        uint8_t nshares = 1 + rnd[0] % 8;
+        uint8_t thresh = 1 + rnd[1] % nshares;
+        SSKRShareSeqT<N> * sskr =
+            SSKRShareSeqT<N>::from_seed(&seed, thresh, nshares, random_buffer);
+
+        // A threshold sized subset of the shares, through their bytewords.
+        SSKRShareSeqT<N> subset;
+        bool ok = true;
+        for (size_t ii = 0; ii < thresh; ++ii) {
+            size_t ndx = (rnd[2] + ii) % nshares;
+            ok = ok && subset.get_share_from_ur(sskr->get_share_strings(ndx), ii);
+        }
+        delete sskr;
+
+        // bc-shamir and the GF256Newton recombination must agree.
+        SeedT<N> * combined = subset.restore_seed();
+        size_t outliers[SSKRShareSeqT<N>::MAX_SHARES];
+        size_t noutliers;
+        SeedT<N> * recovered = subset.restore_seed_majority(outliers, noutliers);
+        ok = ok && combined && *combined == seed &&
+            recovered && *recovered == seed && noutliers == 0;
+        delete combined;
+        delete recovered;
+        if (!ok)
+            return test_failed("test_random failed: %d byte SSKR trial %d\n",
+                               (int) N, (int) trial);
+    }
+    return true;
+}
+
+// bc-bip39's checksum against BIP39SeqT::valid_last_words.
+template <size_t N>
+bool bip39_random_trials(size_t ntrials) {
+    size_t const nwords = BIP39SeqT<N>::WORD_COUNT;
+    void * ctx = bip39_new_context();
+    void * ctx2 = bip39_new_context();
+    bip39_set_byte_count(ctx, N);
+    bip39_set_byte_count(ctx2, N);
+    bool ok = true;
+    for (size_t trial = 0; trial < ntrials && ok; ++trial) {
+        uint8_t data[N];
+        random_buffer(data, sizeof(data));
+        bip39_set_payload(ctx, N, data);
+        uint16_t words[nwords];
+        for (size_t ii = 0; ii < nwords; ++ii) {
+            words[ii] = bip39_get_word(ctx, ii);
+            bip39_set_word(ctx2, ii, words[ii]);
+        }
+        ok = bip39_verify_checksum(ctx2) &&
+            memcmp(bip39_get_bytes(ctx2), data, N) == 0;
+
+        uint16_t choices[BIP39SeqT<N>::LAST_WORD_CHOICES];
+        BIP39SeqT<N>::valid_last_words(words, choices);
+        size_t nfound = 0;
+        for (size_t ii = 0; ii < BIP39SeqT<N>::LAST_WORD_CHOICES; ++ii)
+            nfound += choices[ii] == words[nwords - 1];
+        ok = ok && nfound == 1;
+        if (!ok)
+            test_failed("test_random failed: %d byte BIP39 trial %d\n",
+                        (int) N, (int) trial);
+    }
+    bip39_dispose_context(ctx);
+    bip39_dispose_context(ctx2);
+    return ok;
+}
+
+bool test_random(void) {
+    LOG_DEBUG("test_random starting\n");
+    uint8_t corpus_seed[32];
+    memcpy(corpus_seed, ref_sha256_output, sizeof(corpus_seed));
+    entropy_set_deterministic(corpus_seed, sizeof(corpus_seed));
+    bool ok = sskr_random_trials<16>(32) &&
+        sskr_random_trials<32>(32) &&
+        bip39_random_trials<16>(128) &&
+        bip39_random_trials<32>(128);
+    entropy_set_deterministic(NULL, 0);
+    if (!ok)
         return false;
+    LOG_DEBUG("test_random finished\n");
+    return true;
+}
+
+// Also a benchmark, the corrupted shares come first so most subsets
+// contain one.
+bool test_sskr_outliers(void) {
+    LOG_DEBUG("test_sskr_outliers starting\n");
+    Seed128 seed = Seed128(selftest_seed_arr);
+    for (uint8_t thresh = 8; thresh <= 10; ++thresh) {
+        SSKRShareSeq128 * sskr = SSKRShareSeq128::from_seed(&seed, thresh, 16, random_buffer);
+        uint8_t share[SSKRShareSeq128::BYTES_PER_SHARE];
+        for (size_t ii = 0; ii < 2; ++ii) {
+            memcpy(share, sskr->get_share(ii), sizeof(share));
+            share[sizeof(share) - 1 - ii] ^= 0x5a;
+            sskr->set_share(ii, share, sizeof(share));
+        }
+
+        size_t outliers[SSKRShareSeq128::MAX_SHARES];
+        size_t noutliers;
+        uint32_t start = millis();
+        Seed128 * restored = sskr->restore_seed_majority(outliers, noutliers);
+        LOG_DEBUG("test_sskr_outliers: 16 shares thresh %d %d ms\n",
+                  thresh, (int) (millis() - start));
+        delete sskr;
+        bool ok = restored && seed == *restored &&
+            noutliers == 2 && outliers[0] == 0 && outliers[1] == 1;
+        delete restored;
+        if (!ok)
+            return test_failed("test_sskr_outliers failed: thresh %d\n", thresh);
+    }
+    LOG_DEBUG("test_sskr_outliers finished\n");
+    return true;
+}
+
+// Shares both ways between SSKRShareSeqT and bc-sskr, for every
+// threshold of 16 shares.  With GF256_BITSLICED, SSKRShareSeqT's are
+// the bitsliced ones in seed.ino.
+template <size_t N>
+bool sskr_16_trials(void) {
+    size_t const BYTES = SSKRShareSeqT<N>::BYTES_PER_SHARE;
+    uint8_t data[N];
+    uint8_t secret[N];
+    uint8_t shares[16][BYTES];
+    uint8_t const * share_ptrs[16];
+    bool ok = true;
+    for (uint8_t thresh = 1; thresh <= 16 && ok; ++thresh) {
+        random_buffer(data, sizeof(data));
+        SeedT<N> seed(data);
+
+        // Ours into bc-sskr, the last threshold shares.
+        SSKRShareSeqT<N> * sskr = SSKRShareSeqT<N>::from_seed(&seed, thresh, 16, random_buffer);
+        for (size_t ii = 0; ii < thresh; ++ii)
+            share_ptrs[ii] = sskr->get_share(16 - thresh + ii);
+        int rv = sskr_combine(share_ptrs, BYTES, thresh, secret, sizeof(secret));
+        ok = rv == (int) N && memcmp(secret, data, N) == 0;
+        delete sskr;
+
+        // bc-sskr's into ours, the first threshold shares backwards.
+        sskr_group_descriptor groups[] = { { thresh, 16 } };
+        size_t share_len = 0;
+        rv = sskr_generate(1, groups, 1, data, N, &share_len,
+                           shares[0], sizeof(shares), NULL, random_buffer);
+        SSKRShareSeqT<N> restore;
+        for (size_t ii = thresh; ii-- > 0; )
+            restore.add_share(shares[ii]);
+        SeedT<N> * restored = restore.restore_seed();
+        ok = ok && rv == 16 && share_len == BYTES &&
+            restored && *restored == seed;
+        delete restored;
+        if (!ok)
+            test_failed("test_sskr_16 failed: %d bytes, threshold %d\n",
+                        (int) N, thresh);
+    }
+    memzero(data, sizeof(data));
+    memzero(secret, sizeof(secret));
+    memzero(shares, sizeof(shares));
+    return ok;
+}
+
+// Logs the time of a 16 of 16 split and recovery by SSKRShareSeqT and
+// by bc-sskr.
+template <size_t N>
+void sskr_16_benchmark(void) {
+    size_t const BYTES = SSKRShareSeqT<N>::BYTES_PER_SHARE;
+    int const rounds = 8;
+    uint8_t data[N];
+    uint8_t shares[16][BYTES];
+    uint8_t const * share_ptrs[16];
+    uint32_t dt[4] = { 0 };	// split and recovery, ours then bc-sskr's
+    random_buffer(data, sizeof(data));
+    SeedT<N> seed(data);
+    for (int rr = 0; rr < rounds; ++rr) {
+        uint32_t start = micros();
+        SSKRShareSeqT<N> * sskr = SSKRShareSeqT<N>::from_seed(&seed, 16, 16, random_buffer);
+        dt[0] += micros() - start;
+        start = micros();
+        delete sskr->restore_seed();
+        dt[1] += micros() - start;
+        delete sskr;
+
+        sskr_group_descriptor groups[] = { { 16, 16 } };
+        size_t share_len;
+        start = micros();
+        sskr_generate(1, groups, 1, data, N, &share_len,
+                      shares[0], sizeof(shares), NULL, random_buffer);
+        dt[2] += micros() - start;
+        for (size_t ii = 0; ii < 16; ++ii)
+            share_ptrs[ii] = shares[ii];
+        start = micros();
+        sskr_combine(share_ptrs, BYTES, 16, data, sizeof(data));
+        dt[3] += micros() - start;
     }
+    LOG_DEBUG("test_sskr_16: %d bytes, split %d us, recovery %d us; "
+              "bc-sskr %d us, %d us\n", (int) N, (int) (dt[0] / rounds),
+              (int) (dt[1] / rounds), (int) (dt[2] / rounds),
+              (int) (dt[3] / rounds));
+    memzero(data, sizeof(data));
+    memzero(shares, sizeof(shares));
+}
 
+// Also a benchmark.
+bool test_sskr_16(void) {
+    LOG_DEBUG("test_sskr_16 starting\n");
+    if (!sskr_16_trials<16>() || !sskr_16_trials<32>())
+        return false;
+    sskr_16_benchmark<16>();
+    sskr_16_benchmark<32>();
+    LOG_DEBUG("test_sskr_16 finished\n");
     return true;
 }
 
@@ -264,24 +717,24 @@ bool test_bip32(void) {
 
     res = wally_init(0);
     if (res != WALLY_OK) {
-        serial_printf("test_bip32 libwally init failed\n");
+        LOG_ERROR("test_bip32 libwally init failed\n");
         return false;
     }
 
     res = bip32_key_from_seed(seed, sizeof(seed), BIP32_VER_MAIN_PRIVATE, 0, &root);
     if (res != WALLY_OK) {
-        serial_printf("test_bip32 bip32 failed\n");
+        LOG_ERROR("test_bip32 bip32 failed\n");
         return false;
     }
 
     char *xprv = NULL;
     res = bip32_key_to_base58(&root, BIP32_FLAG_KEY_PRIVATE, &xprv);
     if (res != WALLY_OK) {
-        serial_printf("test_bip32 base58 failed\n");
+        LOG_ERROR("test_bip32 base58 failed\n");
         return false;
     }
     if (strcmp(xprv, expected_xprv.c_str()) != 0) {
-        serial_printf("test_bip32 xprv derivation failed\n");
+        LOG_ERROR("test_bip32 xprv derivation failed\n");
         return false;
     }
     wally_free_string(xprv);
@@ -298,7 +751,7 @@ bool test_bip32(void) {
     // STUB derivation path
     bool retval = keystore.check_derivation_path(derivation_path.c_str(), true);
     if (retval == false) {
-        Serial.println(F("save derivation path failed"));
+        LOG_ERROR("save derivation path failed\n");
         return false;
     }
 
@@ -306,7 +759,7 @@ bool test_bip32(void) {
     bip32_key_to_base58(&key, BIP32_FLAG_KEY_PUBLIC, &xpub);
 
     if (strcmp(xpub, expected_xpub.c_str()) != 0) {
-        serial_printf("test_bip32 xpub derivation failed\n");
+        LOG_ERROR("test_bip32 xpub derivation failed\n");
         return false;
     }
 
@@ -315,39 +768,686 @@ bool test_bip32(void) {
     return true;
 }
 
+// Keys from a SeedContext must match keys derived from scratch, and
+// asking again must not derive again.
+bool test_seed_context(void) {
+    uint8_t seed[SeedContext::SEED_LEN];
+    for (size_t ii = 0; ii < sizeof(seed); ++ii)
+        seed[ii] = ii * 7;
+
+    SeedContext ctx(seed);
+    NetwtorkType const networks[] = { MAINNET, TESTNET, MAINNET };
+    char const * const paths[] = { "m/84h/0h/0h", "m/84h/1h/0h", "m/0h/1/2h" };
+
+    for (size_t ii = 0; ii < 3; ++ii) {
+        Keystore cached(networks[ii]);
+        Keystore fresh(networks[ii]);
+        serial_assert(cached.check_derivation_path(paths[ii], true));
+        serial_assert(fresh.check_derivation_path(paths[ii], true));
+
+        serial_assert(ctx.select(cached));
+        SeedContext::Account const * account = ctx.account(cached, false);
+        serial_assert(account);
+        serial_assert(ctx.account(cached, false) == account);
+
+        ext_key key;
+        char * xpub = NULL;
+        serial_assert(fresh.update_root_key(seed, sizeof(seed)));
+        serial_assert(cached.fingerprint == fresh.fingerprint);
+        serial_assert(fresh.get_xpriv(&key));
+        serial_assert(fresh.xpub_to_base58(&key, &xpub, false));
+        serial_assert(account->xpub == xpub);
+        wally_free_string(xpub);
+
+        String ur_xpub;
+        serial_assert(ur_encode_hd_pubkey_xpub(fresh, ur_xpub, fresh.derivation, fresh.derivationLen));
+        serial_assert(account->ur_xpub == ur_xpub);
+
+        // The derived key is kept.
+        ext_key const * derived = ctx.derive(networks[ii], fresh.derivation, fresh.derivationLen);
+        serial_assert(derived);
+        serial_assert(ctx.derive(networks[ii], fresh.derivation, fresh.derivationLen) == derived);
+        serial_assert(memcmp(derived->chain_code, key.chain_code, sizeof(key.chain_code)) == 0);
+        memzero(&key, sizeof(key));
+    }
+
+    // Two cosigners, the second from another seed.
+    uint8_t seed2[SeedContext::SEED_LEN];
+    for (size_t ii = 0; ii < sizeof(seed2); ++ii)
+        seed2[ii] = ii * 11;
+    SeedContext ctx2(seed2);
+    SeedContext * contexts[] = { &ctx, &ctx2 };
+    String descriptor;
+    serial_assert(!multisig_descriptor(contexts, 2, MAINNET, 3, descriptor));
+    serial_assert(multisig_descriptor(contexts, 2, MAINNET, 2, descriptor));
+    serial_assert(descriptor.startsWith("wsh(sortedmulti(2,["));
+
+    uint8_t const * seeds[] = { seed, seed2 };
+    stdDerivation multisig = MULTISIG_NATIVE_SEGWIT;
+    for (size_t ii = 0; ii < 2; ++ii) {
+        Keystore fresh(MAINNET);
+        serial_assert(fresh.update_root_key((uint8_t *) seeds[ii], SeedContext::SEED_LEN));
+        serial_assert(fresh.save_standard_derivation_path(&multisig, MAINNET));
+        ext_key key;
+        char * xpub = NULL;
+        serial_assert(fresh.get_xpriv(&key));
+        serial_assert(bip32_key_to_base58(&key, BIP32_FLAG_KEY_PUBLIC, &xpub) == WALLY_OK);
+        char origin[32];
+        snprintf(origin, sizeof(origin), "[%08x/48h/0h/0h/2h]", (unsigned int) fresh.fingerprint);
+        serial_assert(descriptor.indexOf(String(origin) + xpub) > 0);
+        wally_free_string(xpub);
+        memzero(&key, sizeof(key));
+    }
+
+    // Batch account export, against single derivations.
+    AccountKey accounts[NUM_STD_DERIVATIONS * 2];
+    serial_assert(derive_account_keys(ctx, MAINNET, 2, accounts));
+    char const * const account_paths[] = {
+        "m/84h/0h/0h", "m/84h/0h/1h", "m/49h/0h/0h", "m/49h/0h/1h", "m/48h/0h/0h/2h", "m/48h/0h/1h/2h" };
+    Keystore fresh(MAINNET);
+    serial_assert(fresh.update_root_key(seed, sizeof(seed)));
+    for (size_t ii = 0; ii < NUM_STD_DERIVATIONS * 2; ++ii) {
+        ext_key key;
+        serial_assert(fresh.check_derivation_path(account_paths[ii], true));
+        serial_assert(fresh.get_xpriv(&key));
+        serial_assert(accounts[ii].path_len == fresh.derivationLen);
+        serial_assert(memcmp(accounts[ii].key.pub_key, key.pub_key, sizeof(key.pub_key)) == 0);
+        memzero(&key, sizeof(key));
+    }
+
+    // map(2) 1: fingerprint 2: [ crypto-output(wpkh(crypto-hdkey)), ...
+    uint8_t * cbor = NULL;
+    size_t cbor_size = cbor_encode_crypto_account(fresh, accounts, NUM_STD_DERIVATIONS * 2, &cbor);
+    uint8_t const expected_output[] = { 0x02, 0x86, 0xd9, 0x01, 0x34, 0xd9, 0x01, 0x94, 0xd9, 0x01, 0x2f };
+    serial_assert(cbor_size > 7 + sizeof(expected_output));
+    serial_assert(cbor[0] == 0xa2 && cbor[1] == 0x01);
+    // the fingerprint is an uint of 1 to 5 bytes
+    size_t offset = 2 + (cbor[2] == 0x1a ? 5 : cbor[2] == 0x19 ? 3 : cbor[2] == 0x18 ? 2 : 1);
+    serial_assert(memcmp(cbor + offset, expected_output, sizeof(expected_output)) == 0);
+    free(cbor);
+    memzero(accounts, sizeof(accounts));
+    return true;
+}
+
+// The host build (host/Makefile) has no GFX library to render with.
+#ifndef SEEDTOOL_HOST
+// Render text with drawChar and with the glyph renderer, the
+// pixels must match.
+bool test_glyph_font(const GFXfont *font, const char *txt) {
+    int16_t const ww = 200, hh = 64;
+    size_t const nbytes = ((ww + 7) / 8) * hh;
+    GFXcanvas1 ref(ww, hh);
+    GlyphText<GFXcanvas1> fast(ww, hh);
+
+    uint32_t dt[2];
+    Adafruit_GFX * canvas[2] = { &ref, &fast };
+    for (size_t ii = 0; ii < 2; ++ii) {
+        canvas[ii]->fillScreen(0);
+        canvas[ii]->setFont(font);
+        canvas[ii]->setTextColor(1);
+        canvas[ii]->setCursor(3, 14);
+        dt[ii] = micros();
+        canvas[ii]->print(txt);
+        dt[ii] = micros() - dt[ii];
+    }
+    LOG_DEBUG("test_glyph: drawChar %lu us, glyph %lu us\n",
+              (unsigned long) dt[0], (unsigned long) dt[1]);
+    if (ref.getCursorX() != fast.getCursorX() ||
+        ref.getCursorY() != fast.getCursorY())
+        return test_failed("test_glyph failed: cursor mismatch\n");
+    if (memcmp(ref.getBuffer(), fast.getBuffer(), nbytes) != 0)
+        return test_failed("test_glyph failed: pixel mismatch\n");
+    return true;
+}
+
+bool test_glyph(void) {
+    LOG_DEBUG("test_glyph starting\n");
+    // Long enough to wrap, with a newline.
+    char const * txt =
+        "ur:crypto-hdkey/onaxhdclaojlvoechgferkdpqdiabdrflawshlhdmdcemt\n"
+        "xpub6H1LXWLaKsWFhvm6RVpEL9P4Kf ~{|}";
+    if (!test_glyph_font(&FreeMonoBold9pt7b, txt))
+        return false;
+    if (!test_glyph_font(&FreeSansBold9pt7b, txt))
+        return false;
+    LOG_DEBUG("test_glyph finished\n");
+    return true;
+}
+#endif
+
+bool test_bip39_last_words(void) {
+    LOG_DEBUG("test_bip39_last_words starting\n");
+    uint16_t choices[BIP39Seq128::LAST_WORD_CHOICES];
+    BIP39Seq128::valid_last_words(ref_bip39_words_correct, choices);
+
+    bool found = false;
+    void* ctx = bip39_new_context();
+    bip39_set_byte_count(ctx, Seed128::SIZE);
+    for (size_t ii = 0; ii < BIP39Seq128::WORD_COUNT - 1; ++ii)
+        bip39_set_word(ctx, ii, ref_bip39_words_correct[ii]);
+    for (size_t ii = 0; ii < BIP39Seq128::LAST_WORD_CHOICES; ++ii) {
+        if (ii > 0 && choices[ii] <= choices[ii - 1])
+            return test_failed("test_bip39_last_words failed: not ascending\n");
+        bip39_set_word(ctx, BIP39Seq128::WORD_COUNT - 1, choices[ii]);
+        if (!bip39_verify_checksum(ctx))
+            return test_failed("test_bip39_last_words failed: bad checksum\n");
+        if (choices[ii] == ref_bip39_words_correct[BIP39Seq128::WORD_COUNT - 1])
+            found = true;
+    }
+    bip39_dispose_context(ctx);
+    if (!found)
+        return test_failed("test_bip39_last_words failed: missing last word\n");
+    LOG_DEBUG("test_bip39_last_words finished\n");
+    return true;
+}
+
+bool test_wordlist(void) {
+    LOG_DEBUG("test_wordlist starting\n");
+    char word[10];
+    for (uint16_t ndx = 0; ndx < wordlist_size(WORDLIST_BIP39); ++ndx) {
+        bip39_mnemonic_from_word(ndx, word);
+        if (strcmp(word, wordlist_word(WORDLIST_BIP39, ndx)) != 0)
+            return test_failed("test_wordlist failed: bip39 word %d\n", ndx);
+    }
+    for (uint16_t ndx = 0; ndx < wordlist_size(WORDLIST_BYTEWORDS); ++ndx) {
+        bytewords_get_word(ndx, word);
+        if (strcmp(word, wordlist_word(WORDLIST_BYTEWORDS, ndx)) != 0)
+            return test_failed("test_wordlist failed: byteword %d\n", ndx);
+    }
+
+    uint16_t lo, hi;
+    // "abandon" .. "abuse"
+    wordlist_prefix_range(WORDLIST_BIP39, "ab", 2, lo, hi);
+    if (lo != 0 || hi != 10)
+        return test_failed("test_wordlist failed: bip39 range %d %d\n", lo, hi);
+    // "able" .. "axis"
+    wordlist_prefix_range(WORDLIST_BYTEWORDS, "a", 1, lo, hi);
+    if (lo != 0 || hi != 10)
+        return test_failed("test_wordlist failed: bytewords range %d %d\n", lo, hi);
+
+    // "able" -> "acid" -> "also", wrapping back to "able" from "axis".
+    if (wordlist_next_distinct(WORDLIST_BYTEWORDS, 0, 1) != 1 ||
+        wordlist_next_distinct(WORDLIST_BYTEWORDS, 1, 1) != 2 ||
+        wordlist_next_distinct(WORDLIST_BYTEWORDS, 9, 1) != 0 ||
+        wordlist_prev_distinct(WORDLIST_BYTEWORDS, 0, 1) != 9)
+        return test_failed("test_wordlist failed: distinct\n");
+    // "zoom" is the only word starting with "zoo".
+    if (!wordlist_unique_prefix(WORDLIST_BYTEWORDS, 255, 3) ||
+        wordlist_unique_prefix(WORDLIST_BYTEWORDS, 255, 2))
+        return test_failed("test_wordlist failed: unique\n");
+
+    // First and last letters pick a byteword, no byteword starts with 'x'.
+    for (uint16_t ndx = 0; ndx < wordlist_size(WORDLIST_BYTEWORDS); ++ndx) {
+        const char * ww = wordlist_word(WORDLIST_BYTEWORDS, ndx);
+        if (wordlist_byteword_from_letters(ww[0], ww[3]) != ndx)
+            return test_failed("test_wordlist failed: letters %d\n", ndx);
+    }
+    if (wordlist_byteword_from_letters('x', 'a') != -1)
+        return test_failed("test_wordlist failed: letters x\n");
+    LOG_DEBUG("test_wordlist finished\n");
+    return true;
+}
+
+// Records the order in which the scheduler steps tasks.
+struct SchedTraceTask {
+    char name;
+    int nsteps;			// steps left
+};
+
+char g_sched_trace[8];
+size_t g_sched_ntrace;
+
+bool sched_trace_step(void *ctx) {
+    SchedTraceTask * task = (SchedTraceTask *) ctx;
+    if (g_sched_ntrace < sizeof(g_sched_trace))
+        g_sched_trace[g_sched_ntrace++] = task->name;
+    return --task->nsteps == 0;
+}
+
+// Runs tasks in its own scope, the caller's are left alone.
+bool sched_test_order(void) {
+    SchedScope scope;
+    g_sched_ntrace = 0;
+    SchedTraceTask tasks[] = {
+        {'i', 1}, {'n', 1}, {'l', 1}, {'e', 2}, {'c', 1}, {'u', 1}
+    };
+    sched_add(sched_trace_step, &tasks[0], SCHED_PRIO_IDLE);
+    sched_add(sched_trace_step, &tasks[1], SCHED_PRIO_NORMAL);
+    sched_add(sched_trace_step, &tasks[2], SCHED_PRIO_NORMAL, 2000);
+    sched_add(sched_trace_step, &tasks[3], SCHED_PRIO_NORMAL, 1000);
+    int cancelled = sched_add(sched_trace_step, &tasks[4], SCHED_PRIO_URGENT);
+    sched_add(sched_trace_step, &tasks[5], SCHED_PRIO_URGENT, 5000);
+    sched_cancel(cancelled);
+    if (sched_active(cancelled))
+        return test_failed("test_scheduler failed: task not cancelled\n");
+    while (sched_run_one())
+        ;
+    // Priority first, then deadline, then order of addition; the
+    // two step task is resumed until it's done.
+    if (g_sched_ntrace != 6 || memcmp(g_sched_trace, "ueelni", 6) != 0)
+        return test_failed("test_scheduler failed: order %.*s\n",
+                           (int) g_sched_ntrace, g_sched_trace);
+    return true;
+}
+
+bool test_scheduler(void) {
+    LOG_DEBUG("test_scheduler starting\n");
+    // The screen's tasks are back when the test is done.
+    SchedScope scope;
+    // Stands for a screen's task, it survives the test's.
+    SchedTraceTask live = { 'x', 1 };
+    int id = sched_add(sched_trace_step, &live, SCHED_PRIO_IDLE);
+    if (!sched_test_order())
+        return false;
+    if (!sched_active(id) || !sched_run_one() || live.nsteps != 0)
+        return test_failed("test_scheduler failed: task not kept\n");
+    LOG_DEBUG("test_scheduler finished\n");
+    return true;
+}
+
+// The native P2WPKH example of BIP143, and a PSBT around it with one
+// input belonging to a test seed.
+uint8_t const g_bip143_tx[] = {
+        0x01, 0x00, 0x00, 0x00, 0x02, 0xff, 0xf7, 0xf7, 0x88, 0x1a, 0x80, 0x99,
+        0xaf, 0xa6, 0x94, 0x0d, 0x42, 0xd1, 0xe7, 0xf6, 0x36, 0x2b, 0xec, 0x38,
+        0x17, 0x1e, 0xa3, 0xed, 0xf4, 0x33, 0x54, 0x1d, 0xb4, 0xe4, 0xad, 0x96,
+        0x9f, 0x00, 0x00, 0x00, 0x00, 0x00, 0xee, 0xff, 0xff, 0xff, 0xef, 0x51,
+        0xe1, 0xb8, 0x04, 0xcc, 0x89, 0xd1, 0x82, 0xd2, 0x79, 0x65, 0x5c, 0x3a,
+        0xa8, 0x9e, 0x81, 0x5b, 0x1b, 0x30, 0x9f, 0xe2, 0x87, 0xd9, 0xb2, 0xb5,
+        0x5d, 0x57, 0xb9, 0x0e, 0xc6, 0x8a, 0x01, 0x00, 0x00, 0x00, 0x00, 0xff,
+        0xff, 0xff, 0xff, 0x02, 0x20, 0x2c, 0xb2, 0x06, 0x00, 0x00, 0x00, 0x00,
+        0x19, 0x76, 0xa9, 0x14, 0x82, 0x80, 0xb3, 0x7d, 0xf3, 0x78, 0xdb, 0x99,
+        0xf6, 0x6f, 0x85, 0xc9, 0x5a, 0x78, 0x3a, 0x76, 0xac, 0x7a, 0x6d, 0x59,
+        0x88, 0xac, 0x90, 0x93, 0x51, 0x0d, 0x00, 0x00, 0x00, 0x00, 0x19, 0x76,
+        0xa9, 0x14, 0x3b, 0xde, 0x42, 0xdb, 0xee, 0x7e, 0x4d, 0xbe, 0x6a, 0x21,
+        0xb2, 0xd5, 0x0c, 0xe2, 0xf0, 0x16, 0x7f, 0xaa, 0x81, 0x59, 0x88, 0xac,
+        0x11, 0x00, 0x00, 0x00,
+};
+
+struct PsbtTestSig {
+    PsbtTxSummary tx;
+    bool send;			// the answer to the fee
+    bool fee_asked;
+    uint32_t count;
+    uint32_t input;
+    uint8_t pubkey[33];
+    uint8_t sig[EC_SIGNATURE_DER_MAX_LEN + 1];
+    size_t sig_len;
+};
+
+bool psbt_test_confirm(PsbtTxSummary const & tx, void * arg) {
+    PsbtTestSig * out = (PsbtTestSig *) arg;
+    out->tx = tx;
+    return tx.ninputs == 2 && tx.noutputs == 2 && tx.out_total == 335790000 &&
+        tx.nshown == 2;
+}
+
+// Input 0 has no witness UTXO, the fee can't be known.
+bool psbt_test_confirm_fee(uint32_t nsigned, uint32_t ninputs, bool fee_known,
+                           uint64_t fee, void * arg) {
+    (void) fee;
+    PsbtTestSig * out = (PsbtTestSig *) arg;
+    out->fee_asked = true;
+    // No signature may be out before the fee is confirmed.
+    return out->send && out->count == 0 && nsigned == 1 && ninputs == 2 && !fee_known;
+}
+
+// A PSBT arriving over a Stream.
+class PsbtTestStream : public Stream {
+  public:
+    PsbtTestStream(uint8_t const * data, size_t len) : data(data), len(len), pos(0) {}
+    int available() { return len - pos; }
+    int read() { return pos < len ? data[pos++] : -1; }
+    int peek() { return pos < len ? data[pos] : -1; }
+    size_t write(uint8_t) { return 0; }
+    using Print::write;
+
+  private:
+    uint8_t const * data;
+    size_t len;
+    size_t pos;
+};
+
+// As the user interface does: each confirmation waits for a key, the
+// test presses it.
+bool psbt_test_confirm_key(PsbtTxSummary const & tx, void * arg) {
+    hw_key_inject('#');
+    return wait_for_key() == '#' && psbt_test_confirm(tx, arg);
+}
+
+bool psbt_test_confirm_fee_key(uint32_t nsigned, uint32_t ninputs, bool fee_known,
+                               uint64_t fee, void * arg) {
+    hw_key_inject('#');
+    return wait_for_key() == '#' &&
+        psbt_test_confirm_fee(nsigned, ninputs, fee_known, fee, arg);
+}
+
+void psbt_test_signature(uint32_t input, uint8_t const * pubkey,
+                         uint8_t const * sig, size_t sig_len, void * arg) {
+    PsbtTestSig * out = (PsbtTestSig *) arg;
+    out->count++;
+    out->input = input;
+    memcpy(out->pubkey, pubkey, sizeof(out->pubkey));
+    out->sig_len = sig_len < sizeof(out->sig) ? sig_len : sizeof(out->sig);
+    memcpy(out->sig, sig, out->sig_len);
+}
+
+bool test_psbt(void) {
+    LOG_DEBUG("test_psbt starting\n");
+
+    // Midstates from the streamed transaction give the BIP143 sighash.
+    Bip143Hasher hasher;
+    PsbtBufferSource tx_src(g_bip143_tx, sizeof(g_bip143_tx));
+    if (!psbt_read_unsigned_tx(tx_src, sizeof(g_bip143_tx), hasher))
+        return test_failed("test_psbt failed: unsigned tx\n");
+    uint8_t const * outpoint1 = g_bip143_tx + 5 + 41;
+    uint8_t const pkh1[] = {
+        0x1d, 0x0f, 0x17, 0x2a, 0x0e, 0xcb, 0x48, 0xae, 0xe1, 0xbe,
+        0x1f, 0x26, 0x87, 0xd2, 0x96, 0x3a, 0xe3, 0x3f, 0x71, 0xa1 };
+    uint8_t hash[SHA256_DIGEST_LENGTH];
+    hasher.sighash_p2wpkh(outpoint1, pkh1, 600000000, 0xffffffff, 1, hash);
+    if (!compare_bytes_with_hex(hash, sizeof(hash),
+            "c37af31116d1b27caf68aae9e3ac82f1477929014d5b917657d0eb49478cb670"))
+        return test_failed("test_psbt failed: BIP143 sighash\n");
+
+    // Input 1 spends a P2WPKH output of m/84h/0h/0h/0/3 of a test seed.
+    uint8_t seed[SeedContext::SEED_LEN];
+    for (size_t ii = 0; ii < sizeof(seed); ++ii)
+        seed[ii] = ii * 3;
+    SeedContext ctx(seed);
+    uint32_t const path[] = {
+        84 | BIP32_INITIAL_HARDENED_CHILD, 0 | BIP32_INITIAL_HARDENED_CHILD,
+        0 | BIP32_INITIAL_HARDENED_CHILD, 0, 3 };
+    ext_key const * key = ctx.derive(MAINNET, path, 5);
+    serial_assert(key);
+    ext_key const * root = ctx.root(MAINNET);
+    serial_assert(root);
+
+    uint8_t psbt[400];
+    size_t len = 0;
+    uint8_t const head[] = { 'p', 's', 'b', 't', 0xff, 0x01, 0x00, sizeof(g_bip143_tx) };
+    memcpy(psbt + len, head, sizeof(head)); len += sizeof(head);
+    memcpy(psbt + len, g_bip143_tx, sizeof(g_bip143_tx)); len += sizeof(g_bip143_tx);
+    psbt[len++] = 0x00;		// end of globals
+    psbt[len++] = 0x00;		// input 0, not ours
+    // input 1: witness utxo 6 BTC to 0014<pkh>
+    uint8_t const utxo[] = { 0x01, 0x01, 0x1f, 0x00, 0x46, 0xc3, 0x23, 0x00, 0x00, 0x00, 0x00,
+                             0x16, 0x00, 0x14 };
+    memcpy(psbt + len, utxo, sizeof(utxo)); len += sizeof(utxo);
+    memcpy(psbt + len, key->hash160, 20); len += 20;
+    // bip32 derivation: pubkey, root fingerprint and path
+    psbt[len++] = 0x22;
+    psbt[len++] = 0x06;
+    memcpy(psbt + len, key->pub_key, 33); len += 33;
+    psbt[len++] = 4 + 4 * 5;
+    memcpy(psbt + len, root->hash160, 4); len += 4;
+    for (size_t ii = 0; ii < 5; ++ii)
+        for (size_t jj = 0; jj < 4; ++jj)
+            psbt[len++] = path[ii] >> (8 * jj);
+    psbt[len++] = 0x00;		// end of input 1
+    psbt[len++] = 0x00;		// outputs
+    psbt[len++] = 0x00;
+    serial_assert(len <= sizeof(psbt));
+
+    PsbtTestSig sig;
+    memset(&sig, 0, sizeof(sig));
+    PsbtCallbacks cb = { psbt_test_confirm, psbt_test_confirm_fee, psbt_test_signature, &sig };
+    PsbtSignStats stats;
+
+    // Declining the fee drops the signature.
+    PsbtBufferSource declined_src(psbt, len);
+    if (psbt_sign(declined_src, ctx, MAINNET, cb, stats) || !sig.fee_asked || sig.count != 0)
+        return test_failed("test_psbt failed: fee declined\n");
+
+    // The outputs are shown by address.
+    if (sig.tx.outputs[0].amount != 112340000 ||
+        psbt_output_address(sig.tx.outputs[0], MAINNET) != "1Cu32FVupVCgHkMMRJdYJugxwo2Aprgk7H")
+        return test_failed("test_psbt failed: p2pkh output\n");
+    PsbtOutput p2wpkh = { 0 };
+    p2wpkh.script[0] = 0x00;
+    p2wpkh.script[1] = 0x14;
+    memcpy(p2wpkh.script + 2, pkh1, sizeof(pkh1));
+    p2wpkh.script_len = 2 + sizeof(pkh1);
+    if (psbt_output_address(p2wpkh, MAINNET) != "bc1qr583w2swedy2acd7rung055k8t3n7udp7vyzyg")
+        return test_failed("test_psbt failed: p2wpkh output\n");
+
+    sig.send = true;
+    PsbtBufferSource src(psbt, len);
+    if (!psbt_sign(src, ctx, MAINNET, cb, stats) ||
+        stats.ninputs != 2 || stats.nsigned != 1 || sig.count != 1 || sig.input != 1)
+        return test_failed("test_psbt failed: signing\n");
+
+    uint8_t compact[EC_SIGNATURE_LEN];
+    hasher.sighash_p2wpkh(outpoint1, key->hash160, 600000000, 0xffffffff, 1, hash);
+    if (sig.sig[sig.sig_len - 1] != 1 ||
+        wally_ec_sig_from_der(sig.sig, sig.sig_len - 1, compact, sizeof(compact)) != WALLY_OK ||
+        wally_ec_sig_verify(key->pub_key, 33, hash, sizeof(hash), EC_FLAG_ECDSA,
+                            compact, sizeof(compact)) != WALLY_OK)
+        return test_failed("test_psbt failed: signature\n");
+
+    // A truncated PSBT is an error.
+    PsbtBufferSource short_src(psbt, len - 2);
+    if (psbt_sign(short_src, ctx, MAINNET, cb, stats))
+        return test_failed("test_psbt failed: truncated\n");
+
+    // Streamed in as sign_psbt does, the confirmations waiting for keys
+    // before the input maps are read.
+    PsbtTestStream stream(psbt, len);
+    PsbtStreamSource stream_src(stream);
+    PsbtCallbacks key_cb = { psbt_test_confirm_key, psbt_test_confirm_fee_key,
+                             psbt_test_signature, &sig };
+    sig.count = 0;
+    {
+        SerialCmdHold hold;
+        hw_key_flush();
+        if (!psbt_sign(stream_src, ctx, MAINNET, key_cb, stats) || sig.count != 1 ||
+            stream.available() != 0)
+            return test_failed("test_psbt failed: streamed\n");
+    }
+
+    LOG_DEBUG("test_psbt finished\n");
+    return true;
+}
+
+// Collects what a serial command writes.
+class CapturePrint : public Print {
+  public:
+    CapturePrint() : len(0) {}
+    size_t write(uint8_t b) {
+        if (len < sizeof(data))
+            data[len++] = b;
+        return 1;
+    }
+    using Print::write;
+
+    uint8_t data[1024];
+    size_t len;
+};
+
+// Feeds a request frame, preceded by debug output to skip.
+void serialcmd_test_send(CapturePrint & out, uint8_t cmd, uint8_t seq,
+                         uint8_t const * payload, size_t len, bool bad_crc = false) {
+    uint8_t frame[6 + 128 + 4];
+    serial_assert(len <= 128);
+    frame[0] = SERIALCMD_SOF0;
+    frame[1] = SERIALCMD_SOF1;
+    frame[2] = cmd;
+    frame[3] = seq;
+    frame[4] = len;
+    frame[5] = len >> 8;
+    memcpy(frame + 6, payload, len);
+    uint32_t crc = crc32(frame + 2, 4 + len) ^ (bad_crc ? 1 : 0);
+    for (size_t ii = 0; ii < 4; ++ii)
+        frame[6 + len + ii] = crc >> (8 * ii);
+
+    out.len = 0;
+    char const * noise = "seedy_menu saw A\r\n";
+    for (size_t ii = 0; ii < strlen(noise); ++ii)
+        serial_assert(!serialcmd_feed(noise[ii], out));
+    for (size_t ii = 0; ii < 6 + len + 4; ++ii)
+        serial_assert(serialcmd_feed(frame[ii], out) == (ii == 6 + len + 3));
+}
+
+// Checks response frame ndx and returns its payload and length.
+uint8_t const * serialcmd_test_response(CapturePrint const & out, size_t ndx, uint8_t cmd,
+                                        uint8_t seq, uint8_t status, size_t & o_len) {
+    size_t pos = 0;
+    for (size_t ii = 0; ; ++ii) {
+        serial_assert(pos + 11 <= out.len);
+        uint8_t const * frame = out.data + pos;
+        size_t len = frame[5] | (frame[6] << 8);
+        serial_assert(pos + 11 + len <= out.len);
+        if (ii == ndx) {
+            uint32_t crc = 0;
+            for (size_t jj = 4; jj-- > 0; )
+                crc = (crc << 8) | frame[7 + len + jj];
+            serial_assert(frame[0] == SERIALCMD_SOF0 && frame[1] == SERIALCMD_SOF1);
+            serial_assert(frame[2] == (cmd | 0x80) && frame[3] == seq && frame[4] == status);
+            serial_assert(crc32(frame + 2, 5 + len) == crc);
+            o_len = len;
+            return frame + 7;
+        }
+        pos += 11 + len;
+    }
+}
+
+bool test_serialcmd(void) {
+    LOG_DEBUG("test_serialcmd starting\n");
+    // Leaves the host's session alone when run from a SELFTEST command.
+    SerialCmdScope scope;
+    CapturePrint out;
+    size_t len;
+
+    serialcmd_test_send(out, SERIALCMD_PING, 1, NULL, 0);
+    uint8_t const * payload = serialcmd_test_response(out, 0, SERIALCMD_PING, 1, SERIALCMD_OK, len);
+    if (len != strlen(GIT_DESCRIBE) || memcmp(payload, GIT_DESCRIBE, len) != 0)
+        return test_failed("test_serialcmd failed: ping\n");
+
+    serialcmd_test_send(out, SERIALCMD_PING, 2, NULL, 0, true);
+    serialcmd_test_response(out, 0, SERIALCMD_PING, 2, SERIALCMD_BAD_CRC, len);
+
+    serialcmd_test_send(out, 0x7f, 3, NULL, 0);
+    serialcmd_test_response(out, 0, 0x7f, 3, SERIALCMD_BAD_CMD, len);
+
+    // Not dice rolls
+    uint8_t ceremony[] = { MAINNET, 2, 3, '1', '2', '7' };
+    serialcmd_test_send(out, SERIALCMD_CEREMONY, 3, ceremony, sizeof(ceremony));
+    serialcmd_test_response(out, 0, SERIALCMD_CEREMONY, 3, SERIALCMD_BAD_ARGS, len);
+
+    // BIP84 test vector
+    if (SEED_BYTES == 16) {
+        char const * words =
+            "abandon abandon abandon abandon abandon abandon "
+            "abandon abandon abandon abandon abandon about";
+        serialcmd_test_send(out, SERIALCMD_LOAD_WORDS, 4, (uint8_t const *) words, strlen(words));
+        payload = serialcmd_test_response(out, 0, SERIALCMD_LOAD_WORDS, 4, SERIALCMD_OK, len);
+        if (len != 4 || !compare_bytes_with_hex((uint8_t *) payload, 4, "73c5da0a"))
+            return test_failed("test_serialcmd failed: fingerprint\n");
+
+        // mainnet, keys 0 and 1 of m/84h/0h/0h/0
+        uint8_t derive[7 + 13] = { MAINNET, 0, 0, 0, 0, 2, 0 };
+        memcpy(derive + 7, "m/84h/0h/0h/0", 13);
+        serialcmd_test_send(out, SERIALCMD_DERIVE, 5, derive, sizeof(derive));
+        payload = serialcmd_test_response(out, 0, SERIALCMD_DERIVE, 5, SERIALCMD_MORE, len);
+        char const * addr0 = "bc1qcr8te4kr609gcawutmrza0j4xv80jy8z306fyu";
+        if (len != 37 + strlen(addr0) || payload[0] != 0 ||
+            memcmp(payload + 37, addr0, strlen(addr0)) != 0)
+            return test_failed("test_serialcmd failed: address\n");
+        payload = serialcmd_test_response(out, 1, SERIALCMD_DERIVE, 5, SERIALCMD_MORE, len);
+        if (payload[0] != 1)
+            return test_failed("test_serialcmd failed: index\n");
+        payload = serialcmd_test_response(out, 2, SERIALCMD_DERIVE, 5, SERIALCMD_OK, len);
+        if (len != 2 || payload[0] != 2 || payload[1] != 0)
+            return test_failed("test_serialcmd failed: count\n");
+    }
+
+    LOG_DEBUG("test_serialcmd finished\n");
+    return true;
+}
+
+// The pipeline is deterministic and leaves the UI's keystore alone.
+bool test_ceremony(void) {
+    LOG_DEBUG("test_ceremony starting\n");
+    uint32_t fingerprint = keystore.fingerprint;
+    String line, line2;
+    if (!ceremony_run("123456", MAINNET, 2, 3, line) ||
+        !ceremony_run("123456", MAINNET, 2, 3, line2) || line != line2)
+        return test_failed("test_ceremony failed: not deterministic\n");
+    if (SEED_BYTES == 16 &&
+        line.indexOf("\"bip39\":\"mirror reject rookie talk pudding throw "
+                     "happy era myth already payment owner\"") < 0)
+        return test_failed("test_ceremony failed: mnemonic\n");
+    if (line.indexOf("\"path\":\"m/84h/0h/0h\"") < 0 ||
+        line.indexOf("ur:crypto-sskr/") < 0)
+        return test_failed("test_ceremony failed: fields\n");
+    if (ceremony_run("1237", MAINNET, 2, 3, line) ||
+        ceremony_run("123456", MAINNET, 3, 2, line))
+        return test_failed("test_ceremony failed: bad arguments\n");
+    if (keystore.fingerprint != fingerprint)
+        return test_failed("test_ceremony failed: keystore changed\n");
+    LOG_DEBUG("test_ceremony finished\n");
+    return true;
+}
+
 struct selftest_t {
     char const * testname;
     bool (*testfun)();
+    SelftestTier tier;
 };
 
 selftest_t g_selftests[] =
 {
  // Max test name display length is ~16 chars.
  // |--------------|
- { "SHA256", test_sha256 },
- { "seed generate", test_seed_generate },
- { "BIP39 mnemonics", test_bip39_mnemonics },
- { "BIP39 generate", test_bip39_generate },
- { "BIP39 restore", test_bip39_restore },
- { "BIP39 chksum", test_bip39_bad_checksum },
- { "BIP32", test_bip32 },
- { "UR", test_ur },
- { "SSKR", test_sskr},
- { "BC-UR", test_bc_ur},
+ // Fast tier, known answers which run at every boot.
+ { "SHA256", test_sha256, SELFTEST_FAST },
+ { "HMAC/PBKDF2", test_kdf, SELFTEST_FAST },
+ { "seed generate", test_seed_generate, SELFTEST_FAST },
+ { "BIP39 mnemonics", test_bip39_mnemonics, SELFTEST_FAST },
+ { "BIP39 last word", test_bip39_last_words, SELFTEST_FAST },
+ { "Wordlists", test_wordlist, SELFTEST_FAST },
+ { "Entropy", test_entropy, SELFTEST_FAST },
+ { "Scheduler", test_scheduler, SELFTEST_FAST },
+ // Full tier, the BIP39 seed tests each take seconds of PBKDF2.
+ { "BIP39 generate", test_bip39_generate, SELFTEST_FULL },
+ { "BIP39 restore", test_bip39_restore, SELFTEST_FULL },
+ { "BIP39 chksum", test_bip39_bad_checksum, SELFTEST_FULL },
+ { "BIP32", test_bip32, SELFTEST_FULL },
+ { "Seed context", test_seed_context, SELFTEST_FULL },
+ { "PSBT", test_psbt, SELFTEST_FULL },
+ { "Serial commands", test_serialcmd, SELFTEST_FULL },
+ { "UR", test_ur, SELFTEST_FULL },
+ { "SSKR", test_sskr, SELFTEST_FULL },
+ { "SSKR outliers", test_sskr_outliers, SELFTEST_FULL },
+ { "SSKR 16 of 16", test_sskr_16, SELFTEST_FULL },
+ { "256 bit seeds", test_seed256, SELFTEST_FULL },
+ { "Random corpora", test_random, SELFTEST_FULL },
+ { "Ceremony", test_ceremony, SELFTEST_FULL },
+ { "BC-UR", test_bc_ur, SELFTEST_FULL },
+#ifndef SEEDTOOL_HOST
+ { "Glyphs", test_glyph, SELFTEST_FULL },
+#endif
  // |--------------|
 };
 
 size_t const g_numtests = sizeof(g_selftests) / sizeof(*g_selftests);
 
+uint32_t g_durations[g_numtests];	// ms, of the last run
+
 } // namespace selftest_internal
 
+// The dummy data is only there for 128 bit seeds.
 const uint16_t * selftest_dummy_bip39() {
     using namespace selftest_internal;
+    if (SEED_BYTES != 16)
+        return NULL;
     return ref_bip39_words_correct;
 }
 
 const uint8_t * selftest_dummy_sskr(size_t ndx) {
     using namespace selftest_internal;
+    if (SEED_BYTES != 16)
+        return NULL;
     if (ndx > selftest_sskr_nshares - 1)
         ndx = selftest_sskr_nshares - 1;
     return selftest_sskr_indx[ndx];
@@ -364,8 +1464,25 @@ String selftest_testname(size_t ndx) {
     return g_selftests[ndx].testname;
 }
 
+SelftestTier selftest_testtier(size_t ndx) {
+    using namespace selftest_internal;
+    serial_assert(ndx < g_numtests);
+    return g_selftests[ndx].tier;
+}
+
 bool selftest_testrun(size_t ndx) {
     using namespace selftest_internal;
     serial_assert(ndx < g_numtests);
-    return g_selftests[ndx].testfun();
+    uint32_t start = millis();
+    bool passed = g_selftests[ndx].testfun();
+    g_durations[ndx] = millis() - start;
+    LOG_INFO("selftest %s: %s, %u ms\n", g_selftests[ndx].testname,
+             passed ? "passed" : "FAILED", (unsigned) g_durations[ndx]);
+    return passed;
+}
+
+uint32_t selftest_duration(size_t ndx) {
+    using namespace selftest_internal;
+    serial_assert(ndx < g_numtests);
+    return g_durations[ndx];
 }
@@ -0,0 +1,91 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#ifndef SERIALCMD_H
+#define SERIALCMD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Framed binary commands on the USB serial port, for scripted use of
+ * the device without the keypad or the display.  Commands work on a
+ * seed of their own, the seed shown by the user interface is never
+ * touched.  See doc/serial_protocol.md for the frames and commands.
+ *
+ * Frames are found by their start bytes and checked by their CRC, so
+ * the debug output sharing the port is skipped by the host.
+ */
+
+uint8_t const SERIALCMD_SOF0 = 0xa5;
+uint8_t const SERIALCMD_SOF1 = 0x5a;
+size_t const SERIALCMD_MAX_PAYLOAD = 512;
+
+enum SerialCmd {
+    SERIALCMD_PING = 0x01,		// -> GIT_DESCRIBE
+    SERIALCMD_SELFTEST = 0x02,		// tier -> one frame per test
+    SERIALCMD_LOAD_WORDS = 0x03,	// BIP39 words -> fingerprint
+    SERIALCMD_DERIVE = 0x04,		// network, first, count, path -> one frame per key
+    SERIALCMD_UR = 0x05,		// kind, network, path -> UR
+    SERIALCMD_SSKR = 0x06,		// threshold, shares -> one frame per share
+    SERIALCMD_COUNTERS = 0x07,		// -> performance counters
+    SERIALCMD_CEREMONY = 0x08,		// network, threshold, shares, rolls -> NDJSON
+};
+
+enum SerialCmdStatus {
+    SERIALCMD_OK = 0,			// last frame of a response
+    SERIALCMD_MORE = 1,			// more frames follow
+    SERIALCMD_BAD_CRC = 2,
+    SERIALCMD_BAD_CMD = 3,
+    SERIALCMD_BAD_ARGS = 4,
+    SERIALCMD_NO_SEED = 5,
+    SERIALCMD_FAILED = 6,
+    SERIALCMD_TOO_LONG = 7,
+};
+
+/**
+ * Feeds one received byte, a complete frame is handled right away and
+ * its response frames are written to out.  Returns true if a frame was
+ * handled.
+ */
+bool serialcmd_feed(uint8_t byte, Print & out);
+
+// Handles what Serial has received, without blocking for more.
+// Returns true if a frame was handled.
+bool serialcmd_poll();
+
+/**
+ * While one is in scope serialcmd_poll leaves Serial alone, for a
+ * screen reading Serial itself while it waits for keys, e.g. a PSBT
+ * streamed in.  Its bytes would be skipped as not being frames.
+ */
+class SerialCmdHold {
+  public:
+    SerialCmdHold();
+    ~SerialCmdHold();
+
+  private:
+    SerialCmdHold(SerialCmdHold const &);
+    SerialCmdHold & operator=(SerialCmdHold const &);
+};
+
+struct SerialCmdState;
+
+/**
+ * Sets aside the frame being received, the counters and the command
+ * seed, and puts them back when it goes out of scope.  Commands fed in
+ * between start on an empty parser with no seed, what they load is
+ * dropped.  The self test uses it, it may run from a SELFTEST command.
+ */
+class SerialCmdScope {
+  public:
+    SerialCmdScope();
+    ~SerialCmdScope();
+
+  private:
+    SerialCmdScope(SerialCmdScope const &);
+    SerialCmdScope & operator=(SerialCmdScope const &);
+
+    SerialCmdState * saved_;
+};
+
+#endif // SERIALCMD_H
@@ -0,0 +1,489 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#include <bc-crypto-base.h>
+
+#include "serialcmd.h"
+#include "ceremony.h"
+#include "entropy.h"
+#include "gitrevision.h"
+#include "keystore.h"
+#include "seed.h"
+#include "selftest.h"
+#include "ur.h"
+#include "util.h"
+#include "wally_address.h"
+#include "wally_bip32.h"
+#include "wordlist.h"
+
+namespace serialcmd_internal {
+
+// start bytes, cmd, seq, length (LE), payload, CRC32 (LE)
+size_t const HEADER_LEN = 6;
+size_t const CRC_LEN = 4;
+// A frame not completed within this is dropped.
+uint32_t const FRAME_TIMEOUT_MS = 1000;
+
+uint8_t g_rx[HEADER_LEN + SERIALCMD_MAX_PAYLOAD + CRC_LEN];
+size_t g_rxlen = 0;
+uint32_t g_rx_start;
+// SerialCmdHolds in scope
+uint32_t g_holds = 0;
+
+struct Counters {
+    uint32_t frames_rx;
+    uint32_t frames_tx;
+    uint32_t bad_crc;
+    uint32_t dropped;		// timed out or too long
+    uint32_t last_cmd_ms;	// time taken by the last command
+} g_counters;
+
+// The commands' own seed, apart from the user interface's.
+struct Session {
+    Seed * seed;
+    BIP39Seq * bip39;
+    SeedContext * context;
+} g_session;
+
+void put_le16(uint16_t val, uint8_t * o_p) {
+    o_p[0] = val;
+    o_p[1] = val >> 8;
+}
+
+void put_le32(uint32_t val, uint8_t * o_p) {
+    for (size_t ii = 0; ii < 4; ++ii)
+        o_p[ii] = val >> (8 * ii);
+}
+
+uint32_t get_le32(uint8_t const * p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+// The response frame has the start bytes, cmd | 0x80, seq, status,
+// length, payload and CRC32 over everything after the start bytes.
+void send(Print & out, uint8_t cmd, uint8_t seq, SerialCmdStatus status,
+          uint8_t const * payload, size_t len) {
+    uint8_t frame[HEADER_LEN + 1 + SERIALCMD_MAX_PAYLOAD + CRC_LEN];
+    if (len > SERIALCMD_MAX_PAYLOAD) {
+        len = 0;
+        status = SERIALCMD_FAILED;
+    }
+    frame[0] = SERIALCMD_SOF0;
+    frame[1] = SERIALCMD_SOF1;
+    frame[2] = cmd | 0x80;
+    frame[3] = seq;
+    frame[4] = status;
+    put_le16(len, frame + 5);
+    memcpy(frame + 7, payload, len);
+    put_le32(crc32(frame + 2, 5 + len), frame + 7 + len);
+    out.write(frame, 7 + len + CRC_LEN);
+    g_counters.frames_tx++;
+}
+
+void send_string(Print & out, uint8_t cmd, uint8_t seq, SerialCmdStatus status,
+                 String const & str) {
+    send(out, cmd, seq, status, (uint8_t const *) str.c_str(), str.length());
+}
+
+void session_clear() {
+    delete g_session.context;
+    delete g_session.bip39;
+    delete g_session.seed;
+    g_session.context = NULL;
+    g_session.bip39 = NULL;
+    g_session.seed = NULL;
+}
+
+bool valid_network(uint8_t network) {
+    return network == REGTEST || network == TESTNET || network == MAINNET;
+}
+
+// The path is the rest of the payload, e.g. "m/84h/0h/0h".
+bool parse_path(uint8_t const * payload, size_t len, uint32_t * o_path, uint32_t & o_len) {
+    char path[64];
+    if (len == 0 || len >= sizeof(path))
+        return false;
+    memcpy(path, payload, len);
+    path[len] = '\0';
+    Keystore ks;
+    return ks.calc_derivation_path(path, o_path, o_len);
+}
+
+void cmd_selftest(Print & out, uint8_t cmd, uint8_t seq, uint8_t const * payload, size_t len) {
+    if (len != 1 || payload[0] > SELFTEST_FULL) {
+        send(out, cmd, seq, SERIALCMD_BAD_ARGS, NULL, 0);
+        return;
+    }
+    // payload is in the receive buffer, a test may feed frames.
+    uint8_t const tier = payload[0];
+
+    // ndx, passed, duration (ms), name
+    uint8_t npassed = 0;
+    uint8_t nrun = 0;
+    for (size_t ndx = 0; ndx < selftest_numtests(); ++ndx) {
+        if (selftest_testtier(ndx) > tier)
+            continue;
+        bool passed = selftest_testrun(ndx);
+        String name = selftest_testname(ndx);
+        uint8_t result[6 + 32];
+        size_t nn = name.length() < 32 ? name.length() : 32;
+        result[0] = ndx;
+        result[1] = passed;
+        put_le32(selftest_duration(ndx), result + 2);
+        memcpy(result + 6, name.c_str(), nn);
+        send(out, cmd, seq, SERIALCMD_MORE, result, 6 + nn);
+        npassed += passed;
+        nrun++;
+    }
+    uint8_t summary[] = { npassed, nrun };
+    send(out, cmd, seq, SERIALCMD_OK, summary, sizeof(summary));
+}
+
+// Space separated BIP39 words, BIP39Seq::WORD_COUNT of them.
+void cmd_load_words(Print & out, uint8_t cmd, uint8_t seq, uint8_t const * payload, size_t len) {
+    uint16_t words[BIP39Seq::WORD_COUNT];
+    size_t nwords = 0;
+    size_t pos = 0;
+    while (pos < len) {
+        size_t end = pos;
+        while (end < len && payload[end] != ' ')
+            end++;
+        if (end > pos) {
+            uint16_t lo, hi;
+            char const * word = (char const *) payload + pos;
+            wordlist_prefix_range(WORDLIST_BIP39, word, end - pos, lo, hi);
+            if (nwords == BIP39Seq::WORD_COUNT || lo == hi ||
+                strlen(wordlist_word(WORDLIST_BIP39, lo)) != end - pos) {
+                send(out, cmd, seq, SERIALCMD_BAD_ARGS, NULL, 0);
+                return;
+            }
+            words[nwords++] = lo;
+        }
+        pos = end + 1;
+    }
+    if (nwords != BIP39Seq::WORD_COUNT) {
+        send(out, cmd, seq, SERIALCMD_BAD_ARGS, NULL, 0);
+        return;
+    }
+
+    session_clear();
+    BIP39Seq * bip39 = BIP39Seq::from_words(words);	// a couple of seconds
+    Seed * seed = bip39->restore_seed();
+    if (seed == NULL) {
+        delete bip39;
+        send(out, cmd, seq, SERIALCMD_BAD_ARGS, NULL, 0);
+        return;
+    }
+    g_session.seed = seed;
+    g_session.bip39 = bip39;
+    g_session.context = new SeedContext(bip39->mnemonic_seed);
+
+    ext_key const * root = g_session.context->root(MAINNET);
+    if (root == NULL) {
+        send(out, cmd, seq, SERIALCMD_FAILED, NULL, 0);
+        return;
+    }
+    send(out, cmd, seq, SERIALCMD_OK, root->hash160, 4);
+}
+
+// network, first index (LE32), count (LE16), parent path.  One frame per
+// key with its index, public key and P2WPKH address.
+void cmd_derive(Print & out, uint8_t cmd, uint8_t seq, uint8_t const * payload, size_t len) {
+    uint32_t path[MAX_DERIVATION_PATH_LEN];
+    uint32_t path_len;
+    if (len < 7 || !valid_network(payload[0]) ||
+        !parse_path(payload + 7, len - 7, path, path_len)) {
+        send(out, cmd, seq, SERIALCMD_BAD_ARGS, NULL, 0);
+        return;
+    }
+    if (g_session.context == NULL) {
+        send(out, cmd, seq, SERIALCMD_NO_SEED, NULL, 0);
+        return;
+    }
+
+    NetwtorkType network = (NetwtorkType) payload[0];
+    uint32_t first = get_le32(payload + 1);
+    uint16_t count = payload[5] | (payload[6] << 8);
+    char const * family = network == MAINNET ? "bc" : network == TESTNET ? "tb" : "bcrt";
+
+    // The parent is derived once, each key is one child step below it.
+    ext_key const * parent = g_session.context->derive(network, path, path_len);
+    if (parent == NULL) {
+        send(out, cmd, seq, SERIALCMD_FAILED, NULL, 0);
+        return;
+    }
+    ext_key account = *parent;
+    for (uint32_t ii = 0; ii < count; ++ii) {
+        ext_key key;
+        char * addr = NULL;
+        if (bip32_key_from_parent(&account, first + ii, BIP32_FLAG_KEY_PUBLIC, &key) != WALLY_OK ||
+            wally_bip32_key_to_addr_segwit(&key, family, 0, &addr) != WALLY_OK) {
+            memzero(&account, sizeof(account));
+            send(out, cmd, seq, SERIALCMD_FAILED, NULL, 0);
+            return;
+        }
+        uint8_t result[4 + 33 + 90];
+        size_t addr_len = strlen(addr) < 90 ? strlen(addr) : 90;
+        put_le32(first + ii, result);
+        memcpy(result + 4, key.pub_key, 33);
+        memcpy(result + 37, addr, addr_len);
+        wally_free_string(addr);
+        send(out, cmd, seq, SERIALCMD_MORE, result, 37 + addr_len);
+    }
+    memzero(&account, sizeof(account));
+
+    uint8_t summary[2];
+    put_le16(count, summary);
+    send(out, cmd, seq, SERIALCMD_OK, summary, sizeof(summary));
+}
+
+// kind 0: crypto-seed, kind 1: crypto-hdkey xpub at path.
+void cmd_ur(Print & out, uint8_t cmd, uint8_t seq, uint8_t const * payload, size_t len) {
+    if (len < 2 || payload[0] > 1 || !valid_network(payload[1])) {
+        send(out, cmd, seq, SERIALCMD_BAD_ARGS, NULL, 0);
+        return;
+    }
+    if (g_session.seed == NULL) {
+        send(out, cmd, seq, SERIALCMD_NO_SEED, NULL, 0);
+        return;
+    }
+
+    String ur;
+    bool ok;
+    if (payload[0] == 0) {
+        ok = ur_encode_crypto_seed(g_session.seed->data, sizeof(g_session.seed->data), ur);
+    }
+    else {
+        Keystore ks((NetwtorkType) payload[1]);
+        uint32_t path[MAX_DERIVATION_PATH_LEN];
+        uint32_t path_len;
+        if (!parse_path(payload + 2, len - 2, path, path_len)) {
+            send(out, cmd, seq, SERIALCMD_BAD_ARGS, NULL, 0);
+            return;
+        }
+        ok = g_session.context->select(ks) &&
+            ur_encode_hd_pubkey_xpub(ks, ur, path, path_len);
+    }
+    if (ok)
+        send_string(out, cmd, seq, SERIALCMD_OK, ur);
+    else
+        send(out, cmd, seq, SERIALCMD_FAILED, NULL, 0);
+}
+
+// threshold, number of shares.  One frame per share UR.
+void cmd_sskr(Print & out, uint8_t cmd, uint8_t seq, uint8_t const * payload, size_t len) {
+    if (len != 2 || payload[0] < 1 || payload[0] > payload[1] ||
+        payload[1] > SSKRShareSeq::MAX_SHARES) {
+        send(out, cmd, seq, SERIALCMD_BAD_ARGS, NULL, 0);
+        return;
+    }
+    if (g_session.seed == NULL) {
+        send(out, cmd, seq, SERIALCMD_NO_SEED, NULL, 0);
+        return;
+    }
+
+    SSKRShareSeq * sskr = SSKRShareSeq::from_seed(g_session.seed, payload[0], payload[1],
+                                                  random_buffer);
+    if (sskr == NULL) {
+        send(out, cmd, seq, SERIALCMD_FAILED, NULL, 0);
+        return;
+    }
+    for (size_t ii = 0; ii < sskr->numshares(); ++ii)
+        send_string(out, cmd, seq, SERIALCMD_MORE, sskr->get_share_ur(ii));
+    delete sskr;
+    send(out, cmd, seq, SERIALCMD_OK, NULL, 0);
+}
+
+// network, threshold, number of shares, dice rolls.  Runs a ceremony on
+// its own seed, the session's is left alone.  The NDJSON line comes in
+// MORE frames of at most SERIALCMD_MAX_PAYLOAD bytes.
+void cmd_ceremony(Print & out, uint8_t cmd, uint8_t seq, uint8_t const * payload, size_t len) {
+    String rolls;
+    if (len > 3) {
+        rolls.reserve(len - 3);
+        for (size_t ii = 3; ii < len; ++ii)
+            rolls += (char) payload[ii];
+    }
+    if (len <= 3 || !valid_network(payload[0]) ||
+        !ceremony_valid_args(rolls, payload[1], payload[2])) {
+        wipe_string(rolls);
+        send(out, cmd, seq, SERIALCMD_BAD_ARGS, NULL, 0);
+        return;
+    }
+
+    String line;
+    bool ok = ceremony_run(rolls, (NetwtorkType) payload[0], payload[1], payload[2], line);
+    wipe_string(rolls);
+    if (!ok) {
+        send(out, cmd, seq, SERIALCMD_FAILED, NULL, 0);
+        return;
+    }
+    uint8_t const * text = (uint8_t const *) line.c_str();
+    for (size_t pos = 0; pos < line.length(); pos += SERIALCMD_MAX_PAYLOAD) {
+        size_t nn = line.length() - pos;
+        send(out, cmd, seq, SERIALCMD_MORE, text + pos,
+             nn < SERIALCMD_MAX_PAYLOAD ? nn : SERIALCMD_MAX_PAYLOAD);
+    }
+    wipe_string(line);
+    send(out, cmd, seq, SERIALCMD_OK, NULL, 0);
+}
+
+// uptime, frame counters and the last command's time (LE32 each), then
+// the number of self tests and each one's last duration (LE32).
+void cmd_counters(Print & out, uint8_t cmd, uint8_t seq) {
+    uint8_t result[4 * 6 + 1 + 4 * 64];
+    size_t nn = 0;
+    put_le32(millis(), result + nn); nn += 4;
+    put_le32(g_counters.frames_rx, result + nn); nn += 4;
+    put_le32(g_counters.frames_tx, result + nn); nn += 4;
+    put_le32(g_counters.bad_crc, result + nn); nn += 4;
+    put_le32(g_counters.dropped, result + nn); nn += 4;
+    put_le32(g_counters.last_cmd_ms, result + nn); nn += 4;
+    size_t ntests = selftest_numtests() < 64 ? selftest_numtests() : 64;
+    result[nn++] = ntests;
+    for (size_t ndx = 0; ndx < ntests; ++ndx) {
+        put_le32(selftest_duration(ndx), result + nn);
+        nn += 4;
+    }
+    send(out, cmd, seq, SERIALCMD_OK, result, nn);
+}
+
+void handle(Print & out, uint8_t const * frame, size_t len) {
+    uint8_t cmd = frame[2];
+    uint8_t seq = frame[3];
+    uint8_t const * payload = frame + HEADER_LEN;
+    size_t payload_len = len - HEADER_LEN - CRC_LEN;
+
+    g_counters.frames_rx++;
+    if (crc32(frame + 2, len - 2 - CRC_LEN) != get_le32(frame + len - CRC_LEN)) {
+        g_counters.bad_crc++;
+        send(out, cmd, seq, SERIALCMD_BAD_CRC, NULL, 0);
+        return;
+    }
+
+    uint32_t t0 = millis();
+    switch (cmd) {
+    case SERIALCMD_PING:
+        send_string(out, cmd, seq, SERIALCMD_OK, GIT_DESCRIBE);
+        break;
+    case SERIALCMD_SELFTEST:
+        cmd_selftest(out, cmd, seq, payload, payload_len);
+        break;
+    case SERIALCMD_LOAD_WORDS:
+        cmd_load_words(out, cmd, seq, payload, payload_len);
+        break;
+    case SERIALCMD_DERIVE:
+        cmd_derive(out, cmd, seq, payload, payload_len);
+        break;
+    case SERIALCMD_UR:
+        cmd_ur(out, cmd, seq, payload, payload_len);
+        break;
+    case SERIALCMD_SSKR:
+        cmd_sskr(out, cmd, seq, payload, payload_len);
+        break;
+    case SERIALCMD_COUNTERS:
+        cmd_counters(out, cmd, seq);
+        break;
+    case SERIALCMD_CEREMONY:
+        cmd_ceremony(out, cmd, seq, payload, payload_len);
+        break;
+    default:
+        send(out, cmd, seq, SERIALCMD_BAD_CMD, NULL, 0);
+        break;
+    }
+    g_counters.last_cmd_ms = millis() - t0;
+}
+
+} // namespace serialcmd_internal
+
+SerialCmdHold::SerialCmdHold() {
+    serialcmd_internal::g_holds++;
+}
+
+SerialCmdHold::~SerialCmdHold() {
+    serialcmd_internal::g_holds--;
+}
+
+struct SerialCmdState {
+    uint8_t rx[sizeof(serialcmd_internal::g_rx)];
+    size_t rxlen;
+    uint32_t rx_start;
+    serialcmd_internal::Counters counters;
+    serialcmd_internal::Session session;
+};
+
+SerialCmdScope::SerialCmdScope() : saved_(new SerialCmdState) {
+    using namespace serialcmd_internal;
+
+    memcpy(saved_->rx, g_rx, g_rxlen);
+    saved_->rxlen = g_rxlen;
+    saved_->rx_start = g_rx_start;
+    saved_->counters = g_counters;
+    saved_->session = g_session;
+    g_rxlen = 0;
+    memset(&g_session, 0, sizeof(g_session));
+}
+
+SerialCmdScope::~SerialCmdScope() {
+    using namespace serialcmd_internal;
+
+    session_clear();
+    g_session = saved_->session;
+    g_counters = saved_->counters;
+    memcpy(g_rx, saved_->rx, saved_->rxlen);
+    g_rxlen = saved_->rxlen;
+    g_rx_start = saved_->rx_start;
+    memzero(saved_, sizeof(*saved_));
+    delete saved_;
+}
+
+bool serialcmd_feed(uint8_t byte, Print & out) {
+    using namespace serialcmd_internal;
+
+    if (g_rxlen > 0 && millis() - g_rx_start > FRAME_TIMEOUT_MS) {
+        g_counters.dropped++;
+        g_rxlen = 0;
+    }
+
+    // Bytes outside of frames are skipped.
+    if (g_rxlen == 0) {
+        if (byte == SERIALCMD_SOF0) {
+            g_rx[g_rxlen++] = byte;
+            g_rx_start = millis();
+        }
+        return false;
+    }
+    if (g_rxlen == 1 && byte != SERIALCMD_SOF1) {
+        g_rxlen = byte == SERIALCMD_SOF0 ? 1 : 0;
+        return false;
+    }
+
+    g_rx[g_rxlen++] = byte;
+    if (g_rxlen < HEADER_LEN)
+        return false;
+
+    size_t payload_len = g_rx[4] | (g_rx[5] << 8);
+    if (payload_len > SERIALCMD_MAX_PAYLOAD) {
+        g_counters.dropped++;
+        send(out, g_rx[2], g_rx[3], SERIALCMD_TOO_LONG, NULL, 0);
+        g_rxlen = 0;
+        return true;
+    }
+    if (g_rxlen < HEADER_LEN + payload_len + CRC_LEN)
+        return false;
+
+    size_t len = g_rxlen;
+    g_rxlen = 0;
+    handle(out, g_rx, len);
+    return true;
+}
+
+bool serialcmd_poll() {
+    using namespace serialcmd_internal;
+
+    if (g_holds > 0)
+        return false;
+    bool handled = false;
+    while (!handled && Serial.available() > 0)
+        handled = serialcmd_feed(Serial.read(), Serial);
+    return handled;
+}
@@ -3,6 +3,8 @@
 #ifndef _UR_H
 #define _UR_H
 
+#include "keystore.h"
+
 /**
  * @brief       encode as single part ur text
  * @param[in]   ur_type: UR type
@@ -12,10 +14,22 @@
  * @return      true on success
  */
 bool ur_encode(String ur_type, uint8_t *cbor, uint32_t cbor_size, String &ur_string);
-bool ur_encode_hd_pubkey_xpub(String &xpub_bytewords);
+// The keys, fingerprint and network come from the keystore context ks.
+bool ur_encode_hd_pubkey_xpub(Keystore &ks, String &xpub_bytewords, uint32_t *derivation, uint32_t derivation_len);
+bool ur_encode_hd_pubkey_xpriv(Keystore &ks, String &xpriv_bytewords, uint32_t *derivation, uint32_t derivation_len);
 bool ur_encode_crypto_seed(uint8_t *seed, size_t seed_len, String &seed_bytewords, uint32_t *unix_timestamp=NULL);
 bool ur_encode_sskr_share(SSKRShareSeq *sskr_generate, size_t share_wndx, String &ur);
-bool ur_encode_address(uint8_t *address, size_t address_len, String &address_ur);
+bool ur_encode_address(Keystore &ks, uint8_t *address, size_t address_len, String &address_ur);
+bool ur_encode_output_descriptor(Keystore &ks, String &ur, uint32_t *derivation, uint32_t derivation_len, uint32_t parent_fingerprint);
+
+/**
+ * @brief       crypto-account: the root fingerprint of ks and one output
+ *              descriptor per account key
+ * param[out]   buff_out: cbor, to be freed by the caller
+ * @return      size of cbor in bytes, 0 on failure
+ */
+size_t cbor_encode_crypto_account(Keystore &ks, AccountKey const *accounts, size_t n, uint8_t **buff_out);
+bool ur_encode_crypto_account(Keystore &ks, AccountKey const *accounts, size_t n, String &ur);
 
 bool test_ur(void);
 
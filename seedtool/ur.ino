@@ -1,6 +1,7 @@
 // Copyright © 2020 Blockchain Commons, LLC
 
 #include "ur.h"
+#include "log.h"
 #include "util.h"
 #include "bc-crypto-base.h"
 #include "bc-bytewords.h"
@@ -21,9 +22,10 @@ bool crypto_coin_info(class CborWriter &writer, NetwtorkType network) {
     writer.writeMap(1);
     writer.writeInt(2);
     writer.writeInt(network == MAINNET ? 0 : 1);
+    return true;
 }
 
-bool crypto_keypath(class CborWriter &writer, uint32_t *derivation, uint32_t derivation_len, uint32_t fingerprint) {
+bool crypto_keypath(class CborWriter &writer, Keystore &ks, uint32_t *derivation, uint32_t derivation_len, uint32_t fingerprint) {
     // crypto-keypath:
     writer.writeTag(304);
     writer.writeMap(3);
@@ -33,7 +35,7 @@ bool crypto_keypath(class CborWriter &writer, uint32_t *derivation, uint32_t der
       for (size_t i=0; i<derivation_len; i++) {
         indx = derivation[i] & ~BIP32_INITIAL_HARDENED_CHILD;
         writer.writeInt(indx);
-        if (keystore.is_bip32_indx_hardened(derivation[i])) {
+        if (ks.is_bip32_indx_hardened(derivation[i])) {
           uint32_t cbor_true = 21;
           writer.writeSpecial(cbor_true);
         }
@@ -47,14 +49,15 @@ bool crypto_keypath(class CborWriter &writer, uint32_t *derivation, uint32_t der
 
       writer.writeInt(3);
       writer.writeInt(derivation_len);
+      return true;
 }
 
-size_t cbor_encode_output_descriptor(struct ext_key *key, uint8_t **buff_out, uint32_t parent_fingerprint, uint32_t *derivation, uint32_t derivation_len) {
+size_t cbor_encode_output_descriptor(Keystore &ks, struct ext_key *key, uint8_t **buff_out, uint32_t parent_fingerprint, uint32_t *derivation, uint32_t derivation_len) {
 
     // ATM lethekit only supports single native segwit output descriptor (wpkh)
     stdDerivation path;
-    if (keystore.is_standard_derivation_path(&path) != true && path != SINGLE_NATIVE_SEGWIT) {
-        Serial.println("error: only single native segwit supported atm!");
+    if (ks.is_standard_derivation_path(&path) != true && path != SINGLE_NATIVE_SEGWIT) {
+        LOG_ERROR("error: only single native segwit supported atm!\n");
         return 0;
     }
 
@@ -81,7 +84,7 @@ size_t cbor_encode_output_descriptor(struct ext_key *key, uint8_t **buff_out, ui
       for (size_t i=0; i< derivation_len; i++) {
         indx = derivation[i] & ~BIP32_INITIAL_HARDENED_CHILD;
         writer.writeInt(indx);
-        if (keystore.is_bip32_indx_hardened(derivation[i])) {
+        if (ks.is_bip32_indx_hardened(derivation[i])) {
           uint32_t cbor_true = 21;
           writer.writeSpecial(cbor_true);
         }
@@ -91,7 +94,7 @@ size_t cbor_encode_output_descriptor(struct ext_key *key, uint8_t **buff_out, ui
         }
       }
       writer.writeInt(2);
-      writer.writeInt(keystore.fingerprint);
+      writer.writeInt(ks.fingerprint);
 
     // children: crypto-keypath
     writer.writeInt(7);
@@ -119,12 +122,12 @@ size_t cbor_encode_output_descriptor(struct ext_key *key, uint8_t **buff_out, ui
     return output.getSize();
 }
 
-size_t cbor_encode_hdkey_xpub(struct ext_key *key, uint8_t **buff_out, uint32_t parent_fingerprint, uint32_t *derivation, uint32_t derivation_len) {
+size_t cbor_encode_hdkey_xpub(Keystore &ks, struct ext_key *key, uint8_t **buff_out, uint32_t parent_fingerprint, uint32_t *derivation, uint32_t derivation_len) {
 
     CborDynamicOutput output;
     CborWriter writer(output);
 
-    if (network.get_network() == MAINNET)
+    if (ks.network.get_network() == MAINNET)
         writer.writeMap(4);
     else
         writer.writeMap(5);
@@ -133,7 +136,7 @@ size_t cbor_encode_hdkey_xpub(struct ext_key *key, uint8_t **buff_out, uint32_t
     writer.writeInt(4);
     writer.writeBytes(key->chain_code, sizeof(key->chain_code));
     // crypto-coininfo
-    if (network.get_network() != MAINNET) {
+    if (ks.network.get_network() != MAINNET) {
         writer.writeInt(5);
         writer.writeTag(305);
           writer.writeMap(1);
@@ -141,7 +144,7 @@ size_t cbor_encode_hdkey_xpub(struct ext_key *key, uint8_t **buff_out, uint32_t
           writer.writeInt(1);
     }
     writer.writeInt(6);
-    crypto_keypath(writer, derivation, derivation_len, keystore.fingerprint);
+    crypto_keypath(writer, ks, derivation, derivation_len, ks.fingerprint);
 
     writer.writeInt(8);
     writer.writeInt(parent_fingerprint);
@@ -152,12 +155,12 @@ size_t cbor_encode_hdkey_xpub(struct ext_key *key, uint8_t **buff_out, uint32_t
     return output.getSize();
 }
 
-size_t cbor_encode_hdkey_xpriv(struct ext_key *key, uint8_t **buff_out, uint32_t parent_fingerprint, uint32_t *derivation, uint32_t derivation_len) {
+size_t cbor_encode_hdkey_xpriv(Keystore &ks, struct ext_key *key, uint8_t **buff_out, uint32_t parent_fingerprint, uint32_t *derivation, uint32_t derivation_len) {
 
     CborDynamicOutput output;
     CborWriter writer(output);
 
-    if (network.get_network() == MAINNET)
+    if (ks.network.get_network() == MAINNET)
         writer.writeMap(5);
     else
         writer.writeMap(6);
@@ -172,7 +175,7 @@ size_t cbor_encode_hdkey_xpriv(struct ext_key *key, uint8_t **buff_out, uint32_t
     writer.writeInt(4);
     writer.writeBytes(key->chain_code, sizeof(key->chain_code));
     // crypto-coininfo
-    if (network.get_network() != MAINNET) {
+    if (ks.network.get_network() != MAINNET) {
         writer.writeInt(5);
         writer.writeTag(305);
           writer.writeMap(1);
@@ -180,7 +183,7 @@ size_t cbor_encode_hdkey_xpriv(struct ext_key *key, uint8_t **buff_out, uint32_t
           writer.writeInt(1);
     }
     writer.writeInt(6);
-    crypto_keypath(writer, derivation, derivation_len, keystore.fingerprint);
+    crypto_keypath(writer, ks, derivation, derivation_len, ks.fingerprint);
 
     writer.writeInt(8);
     writer.writeInt(parent_fingerprint);
@@ -261,7 +264,7 @@ bool ur_encode(String ur_type, uint8_t *cbor, uint32_t cbor_size, String &ur_str
     // Encode cbor payload as bytewords
     char *payload_bytewords = bytewords_encode(bw_minimal, cbor, cbor_size);
     if(payload_bytewords == NULL) {
-      Serial.println("ur_encode bytewords failed");
+      LOG_ERROR("ur_encode bytewords failed\n");
       return false;
     }
 
@@ -272,12 +275,12 @@ bool ur_encode(String ur_type, uint8_t *cbor, uint32_t cbor_size, String &ur_str
     return true;
 }
 
-bool ur_encode_hd_pubkey_xpub(String &xpub_bytewords, uint32_t *derivation, uint32_t derivation_len) {
+bool ur_encode_hd_pubkey_xpub(Keystore &ks, String &xpub_bytewords, uint32_t *derivation, uint32_t derivation_len) {
     bool retval;
     ext_key xpub;
     uint8_t *cbor_xpub = NULL;
 
-    (void)bip32_key_from_parent_path(&keystore.root, derivation, derivation_len, BIP32_FLAG_KEY_PRIVATE, &xpub);
+    (void)bip32_key_from_parent_path(&ks.root, derivation, derivation_len, BIP32_FLAG_KEY_PRIVATE, &xpub);
 
     uint32_t parent_fingerprint;
     ((uint8_t *)&parent_fingerprint)[0] = xpub.parent160[3];
@@ -285,7 +288,7 @@ bool ur_encode_hd_pubkey_xpub(String &xpub_bytewords, uint32_t *derivation, uint
     ((uint8_t *)&parent_fingerprint)[2] = xpub.parent160[1];
     ((uint8_t *)&parent_fingerprint)[3] = xpub.parent160[0];
 
-    size_t cbor_xpub_size = cbor_encode_hdkey_xpub(&xpub, &cbor_xpub, parent_fingerprint, derivation, derivation_len);
+    size_t cbor_xpub_size = cbor_encode_hdkey_xpub(ks, &xpub, &cbor_xpub, parent_fingerprint, derivation, derivation_len);
     if (cbor_xpub_size == 0) {
         return false;
     }
@@ -301,12 +304,12 @@ bool ur_encode_hd_pubkey_xpub(String &xpub_bytewords, uint32_t *derivation, uint
     return true;
 }
 
-bool ur_encode_hd_pubkey_xpriv(String &xpriv_bytewords, uint32_t *derivation, uint32_t derivation_len) {
+bool ur_encode_hd_pubkey_xpriv(Keystore &ks, String &xpriv_bytewords, uint32_t *derivation, uint32_t derivation_len) {
     bool retval;
     ext_key xpriv;
     uint8_t *cbor_xpriv = NULL;
 
-    (void)bip32_key_from_parent_path(&keystore.root, derivation, derivation_len, BIP32_FLAG_KEY_PRIVATE, &xpriv);
+    (void)bip32_key_from_parent_path(&ks.root, derivation, derivation_len, BIP32_FLAG_KEY_PRIVATE, &xpriv);
 
     uint32_t parent_fingerprint;
     ((uint8_t *)&parent_fingerprint)[0] = xpriv.parent160[3];
@@ -314,13 +317,13 @@ bool ur_encode_hd_pubkey_xpriv(String &xpriv_bytewords, uint32_t *derivation, ui
     ((uint8_t *)&parent_fingerprint)[2] = xpriv.parent160[1];
     ((uint8_t *)&parent_fingerprint)[3] = xpriv.parent160[0];
 
-    size_t cbor_xpriv_size = cbor_encode_hdkey_xpriv(&xpriv, &cbor_xpriv, parent_fingerprint, derivation, derivation_len);
+    size_t cbor_xpriv_size = cbor_encode_hdkey_xpriv(ks, &xpriv, &cbor_xpriv, parent_fingerprint, derivation, derivation_len);
     if (cbor_xpriv_size == 0) {
         return false;
     }
 
-    //Serial.println("cbor xpriv:");
-    //print_hex(cbor_xpriv, cbor_xpriv_size);
+    LOG_TRACE("cbor xpriv:\n");
+    LOG_HEX(LOG_LEVEL_TRACE, cbor_xpriv, cbor_xpriv_size);
 
     retval = ur_encode("crypto-hdkey", cbor_xpriv, cbor_xpriv_size, xpriv_bytewords);
     if (retval == false) {
@@ -342,7 +345,8 @@ bool ur_encode_crypto_seed(uint8_t *seed, size_t seed_len, String &seed_ur, uint
         return false;
     }
 
-    //print_hex(cbor_seed, cbor_seed_size);
+    LOG_TRACE("cbor seed:\n");
+    LOG_HEX(LOG_LEVEL_TRACE, cbor_seed, cbor_seed_size);
 
     retval = ur_encode("crypto-seed", cbor_seed, cbor_seed_size, seed_ur);
     if (retval == false) {
@@ -355,11 +359,11 @@ bool ur_encode_crypto_seed(uint8_t *seed, size_t seed_len, String &seed_ur, uint
     return true;
 }
 
-bool ur_encode_address(uint8_t *address, size_t address_len, String &address_ur) {
+bool ur_encode_address(Keystore &ks, uint8_t *address, size_t address_len, String &address_ur) {
     bool retval;
     uint8_t *cbor = NULL;
 
-    size_t cbor_size = cbor_encode_address(address, address_len, &cbor, network.get_network());
+    size_t cbor_size = cbor_encode_address(address, address_len, &cbor, ks.network.get_network());
     if (cbor_size == 0) {
         return false;
     }
@@ -369,7 +373,7 @@ bool ur_encode_address(uint8_t *address, size_t address_len, String &address_ur)
         return false;
     }
 
-    print_hex(cbor, cbor_size);
+    LOG_HEX(LOG_LEVEL_DEBUG, cbor, cbor_size);
 
     // @FIXME: free also on premature exit
     free(cbor);
@@ -377,7 +381,7 @@ bool ur_encode_address(uint8_t *address, size_t address_len, String &address_ur)
     return true;
 }
 
-bool ur_encode_output_descriptor(String &ur, uint32_t *derivation, uint32_t derivation_len, uint32_t parent_fingerprint) {
+bool ur_encode_output_descriptor(Keystore &ks, String &ur, uint32_t *derivation, uint32_t derivation_len, uint32_t parent_fingerprint) {
     bool retval;
     uint8_t *cbor = NULL;
     size_t cbor_size;
@@ -389,17 +393,17 @@ bool ur_encode_output_descriptor(String &ur, uint32_t *derivation, uint32_t deri
 
     writer.writeTag(404); // @FIXME currently fixed ton only wpkh (404)
 
-    (void)bip32_key_from_parent_path(&keystore.root, derivation, derivation_len, 0, &child_key);
-    cbor_size = cbor_encode_output_descriptor(&child_key, &buff_out, parent_fingerprint, derivation, derivation_len);
+    (void)bip32_key_from_parent_path(&ks.root, derivation, derivation_len, 0, &child_key);
+    cbor_size = cbor_encode_output_descriptor(ks, &child_key, &buff_out, parent_fingerprint, derivation, derivation_len);
 
-    Serial.println("cbor output descriptor:");
-    print_hex(buff_out, cbor_size);
+    LOG_DEBUG("cbor output descriptor:\n");
+    LOG_HEX(LOG_LEVEL_DEBUG, buff_out, cbor_size);
 
     uint8_t *cbor_all = (uint8_t *)malloc(cbor_size + output.getSize());
     memcpy(cbor_all, output.getData(), output.getSize());
     memcpy(cbor_all + output.getSize(), buff_out, cbor_size);
 
-    print_hex(cbor_all, cbor_size + output.getSize());
+    LOG_HEX(LOG_LEVEL_DEBUG, cbor_all, cbor_size + output.getSize());
 
     retval = ur_encode("crypto-output", cbor_all, cbor_size + output.getSize(), ur);
     if (retval == false) {
@@ -413,6 +417,76 @@ bool ur_encode_output_descriptor(String &ur, uint32_t *derivation, uint32_t deri
     return true;
 }
 
+size_t cbor_encode_crypto_account(Keystore &ks, AccountKey const *accounts, size_t n, uint8_t **buff_out) {
+
+    CborDynamicOutput output;
+    CborWriter writer(output);
+
+    writer.writeMap(2);
+    writer.writeInt(1);
+    writer.writeInt(ks.fingerprint);
+    writer.writeInt(2);
+    writer.writeArray(n);
+
+    for (size_t i=0; i<n; i++) {
+        AccountKey const &account = accounts[i];
+        ext_key const *key = &account.key;
+
+        writer.writeTag(308); // crypto-output
+        switch (account.script) {
+            case SINGLE_NATIVE_SEGWIT:
+                writer.writeTag(404); // witness-public-key-hash
+                break;
+            case SINGLE_NESTED_SEGWIT:
+                writer.writeTag(400); // script-hash
+                writer.writeTag(404); // witness-public-key-hash
+                break;
+            case MULTISIG_NATIVE_SEGWIT:
+                writer.writeTag(401); // witness-script-hash, cosigner key
+                break;
+        }
+        writer.writeTag(303); // crypto-hdkey
+
+        bool const mainnet = ks.network.get_network() == MAINNET;
+        writer.writeMap(mainnet ? 4 : 5);
+        writer.writeInt(3);
+        writer.writeBytes(key->pub_key, sizeof(key->pub_key));
+        writer.writeInt(4);
+        writer.writeBytes(key->chain_code, sizeof(key->chain_code));
+        if (!mainnet)
+            crypto_coin_info(writer, ks.network.get_network());
+        writer.writeInt(6);
+        crypto_keypath(writer, ks, (uint32_t *)account.path, account.path_len, ks.fingerprint);
+
+        uint32_t parent_fingerprint;
+        ((uint8_t *)&parent_fingerprint)[0] = key->parent160[3];
+        ((uint8_t *)&parent_fingerprint)[1] = key->parent160[2];
+        ((uint8_t *)&parent_fingerprint)[2] = key->parent160[1];
+        ((uint8_t *)&parent_fingerprint)[3] = key->parent160[0];
+        writer.writeInt(8);
+        writer.writeInt(parent_fingerprint);
+    }
+
+    *buff_out = (uint8_t *)malloc(output.getSize());
+    memcpy(*buff_out, output.getData(), output.getSize());
+
+    return output.getSize();
+}
+
+bool ur_encode_crypto_account(Keystore &ks, AccountKey const *accounts, size_t n, String &ur) {
+    uint8_t *cbor = NULL;
+
+    size_t cbor_size = cbor_encode_crypto_account(ks, accounts, n, &cbor);
+    if (cbor_size == 0) {
+        return false;
+    }
+
+    bool retval = ur_encode("crypto-account", cbor, cbor_size, ur);
+    free(cbor);
+
+    return retval;
+}
+
 bool test_ur(void) {
 
     int ret;
@@ -425,7 +499,7 @@ bool test_ur(void) {
         char *seed_bytewords = bytewords_encode(bw_minimal, seeds, sizeof(seeds));
 
         if (strcmp(seed_bytewords_expected.c_str(), seed_bytewords) != 0) {
-            Serial.println("bytewords failed.");
+            LOG_ERROR("bytewords failed.\n");
             return false;
         }
 
@@ -440,12 +514,12 @@ bool test_ur(void) {
 
         bool rval = ur_encode_crypto_seed(payload, sizeof(payload), seed_ur, &birthday);
         if (rval == false) {
-          Serial.println(F("ur_encode_crypto_seed fails"));
+          LOG_ERROR("ur_encode_crypto_seed fails\n");
           return false;
         }
 
         if (seed_ur != ur_expected) {
-          Serial.println(F("ur_encode_crypto_seed wrong"));
+          LOG_ERROR("ur_encode_crypto_seed wrong\n");
           return false;
         }
     }
@@ -34,13 +34,23 @@ enum UIState {
     SET_ADDRESS_FORMAT,
     EXPORT_WALLET,
     SET_EXPORT_WALLET_FORMAT,
-    UR_DEMO
+    UR_DEMO,
+    SEED_SLOTS,
+    EXPORT_MULTISIG,
+    EXPORT_ACCOUNTS,
+    SIGN_PSBT
 };
 
+extern void ui_setup();
+
 extern void ui_reset_into_state(UIState state);
 
 extern void ui_dispatch();
 
+// Waits for a key press, running serial commands and scheduled tasks
+// meanwhile.
+extern char wait_for_key();
+
 struct pg_show_address_t {
     uint32_t addr_indx;
     format addr_format;
@@ -97,4 +107,13 @@ struct pg_seedless_menu_t {
     bool allow_invalid_mnemonic;
 };
 
+struct pg_export_multisig_t {
+    uint8_t threshold;
+    format multisig_format;
+};
+
+struct pg_export_accounts_t {
+    uint32_t naccounts;
+};
+
 #endif // USERINTERFACE_H
@@ -6,46 +6,137 @@
 #include <Fonts/FreeMono9pt7b.h>
 #include <Fonts/FreeMonoBold9pt7b.h>
 #include <Fonts/FreeMonoBold12pt7b.h>
+#include <bc-crypto-base.h>
 
 #include "hardware.h"
+#include "entropy.h"
 #include "seed.h"
 #include "userinterface.h"
 #include "selftest.h"	// Used to fetch dummy data for UI testing.
 #include "util.h"
+#include "log.h"
 #include "qrcode.h"
 #include "ur.h"
 #include "keystore.h"
 #include "wally_address.h"
 #include "test_bc_ur.hpp"
+#include "scheduler.h"
+#include "wordlist.h"
+#include "psbt.h"
+#include "serialcmd.h"
 
 /** This caps entropy obtained from dice rolling to
- *  MAX_DICE_ENTROPY + 2.6. 128 bits of trng entropy
+ *  MAX_DICE_ENTROPY + 2.6. Seed::SIZE bytes of trng entropy
  *  can be mixed in. So the total entropy may yield
- *  in maximum MAX_DICE_ENTROPY + 2.6 + 128 bits
+ *  in maximum MAX_DICE_ENTROPY + 2.6 + 8 * Seed::SIZE bits
  */
 #define MAX_DICE_ENTROPY 256 // [bits]
 
 namespace userinterface_internal {
 
 UIState g_uistate;
-String g_rolls;
+UIState g_dispatched_state;	// state of the last ui_dispatch
+SeedBuilder g_seed_builder;
 bool g_submitted;
 String g_error_string;
 
 /**
- *  A structure holding 128 bits of TRNG entropy which can be
+ *  A structure holding a seed's worth of TRNG entropy which can be
  *  used as an additional source of entropy when dicing
  */
 struct {
   bool rdy;  /* true: entropy is available for mixing */
-  uint8_t buff[16];
-}g_trng128;
+  uint8_t buff[Seed::SIZE];
+}g_trng_entropy;
 
 Seed * g_master_seed = NULL;
 BIP39Seq * g_bip39 = NULL;
 SSKRShareSeq * g_sskr_generate = NULL;
 SSKRShareSeq * g_sskr_restore = NULL;
 
+// Keys derived from g_bip39, dropped with it.
+SeedContext * g_seed_context = NULL;
+
+SeedContext * seed_context() {
+    if (!g_seed_context)
+        g_seed_context = new SeedContext(g_bip39->mnemonic_seed);
+    return g_seed_context;
+}
+
+// Key at path below the root of the current network, without deriving
+// again when the same key was asked for recently.
+bool seed_context_derive(uint32_t const *path, uint32_t path_len, ext_key *o_key) {
+    ext_key const *key = NULL;
+    if (seed_context()->select(keystore))
+        key = seed_context()->derive(keystore.network.get_network(), path, path_len);
+    if (key == NULL)
+        return false;
+    *o_key = *key;
+    return true;
+}
+
+/**
+ * Seeds kept in RAM for multisig ceremonies.  The current seed lives in
+ * g_master_seed, g_bip39 and g_seed_context and its slot is empty, the
+ * others are parked in their slots with the keys already derived.
+ */
+struct SeedSlot {
+    Seed * seed;
+    BIP39Seq * bip39;
+    SeedContext * context;
+};
+
+size_t const MAX_SEED_SLOTS = 5;
+SeedSlot g_slots[MAX_SEED_SLOTS];
+size_t g_slot = 0;	// slot of the current seed
+
+size_t slots_count() {
+    size_t count = g_master_seed ? 1 : 0;
+    for (size_t ii = 0; ii < MAX_SEED_SLOTS; ++ii)
+        if (g_slots[ii].seed)
+            count++;
+    return count;
+}
+
+// Park the current seed in its slot and make ndx current.
+void slots_switch(size_t ndx) {
+    serial_assert(ndx < MAX_SEED_SLOTS);
+    if (g_master_seed) {
+        seed_context();
+        g_slots[g_slot] = { g_master_seed, g_bip39, g_seed_context };
+        g_master_seed = NULL;
+        g_bip39 = NULL;
+        g_seed_context = NULL;
+    }
+    if (g_sskr_generate) {
+        delete g_sskr_generate;
+        g_sskr_generate = NULL;
+    }
+
+    g_slot = ndx;
+    g_master_seed = g_slots[ndx].seed;
+    g_bip39 = g_slots[ndx].bip39;
+    g_seed_context = g_slots[ndx].context;
+    g_slots[ndx] = { NULL, NULL, NULL };
+
+    // The keystore's root key follows the current seed, the parked
+    // seed's private root must not stay behind in it.
+    if (g_master_seed)
+        seed_context()->select(keystore);
+    else
+        keystore.clear_root_key();
+}
+
+// Forget every parked seed, the current one is left alone.
+void slots_wipe_all() {
+    for (size_t ii = 0; ii < MAX_SEED_SLOTS; ++ii) {
+        delete g_slots[ii].context;
+        delete g_slots[ii].bip39;
+        delete g_slots[ii].seed;
+        g_slots[ii] = { NULL, NULL, NULL };
+    }
+}
+
 int g_ndx = 0;		// index of "selected" word
 int g_pos = 0;		// char position of cursor
 int g_scroll = 0;	// index of scrolled window
@@ -71,8 +162,6 @@ int const W_FMB12 = 14;	// width
 int const H_FMB12 = 21;	// height
 int const YM_FMB12 = 4;	// y-margin
 
-bool clear_full_window = true;
-
 // Pages
 struct pg_show_address_t pg_show_address{0, qr_ur};
 struct pg_export_wallet_t pg_export_wallet{qr_ur};
@@ -83,11 +172,79 @@ struct pg_set_xpub_options_t pg_set_xpub_options = {false, false, 0};
 struct pg_set_seed_format_t pg_set_seed_format = {qr_ur};
 struct pg_set_sskr_format_t pg_set_sskr_format = {ur};
 struct pg_seedless_menu_t pg_seedless_menu = {false};
+struct pg_export_multisig_t pg_export_multisig = {0, text};
+struct pg_export_accounts_t pg_export_accounts = {1};
+
+/**
+ * Titles and footer options ("# Done", "Back *", "<-4/6->", ...) are
+ * measured on every redraw.  Adafruit_GFX walks the glyph metrics for
+ * each measurement, so the bounds are cached keyed by (font, string).
+ * The string is identified by its FNV-1a hash and length.
+ */
+struct TextBounds {
+    const GFXfont *font;
+    uint32_t hash;
+    uint16_t len;
+    int16_t tbx, tby;
+    uint16_t tbw, tbh;
+};
+
+// FNV-1a hash of txt, also returns its length.
+uint32_t fnv1a(const char *txt, uint16_t & len) {
+    uint32_t hash = 2166136261u;
+    const char *pp = txt;
+    for (; *pp; ++pp) {
+        hash ^= (uint8_t) *pp;
+        hash *= 16777619u;
+    }
+    len = pp - txt;
+    return hash;
+}
+
+struct TextLayoutCache {
+    static int const NENTRIES = 16;
+
+    TextBounds entries[NENTRIES];
+    int next;			// round-robin victim
+
+    TextBounds const & lookup(const GFXfont *font, const char *txt) {
+        uint16_t len;
+        uint32_t hash = fnv1a(txt, len);
+        for (int ii = 0; ii < NENTRIES; ++ii) {
+            TextBounds const & ee = entries[ii];
+            if (ee.font == font && ee.hash == hash && ee.len == len)
+                return ee;
+        }
+        TextBounds & ee = entries[next];
+        next = (next + 1) % NENTRIES;
+        g_display->getTextBounds(txt, 0, 0, &ee.tbx, &ee.tby, &ee.tbw, &ee.tbh);
+        ee.font = font;
+        ee.hash = hash;
+        ee.len = len;
+        return ee;
+    }
+};
+
+TextLayoutCache g_text_layout;
+
+// The font currently selected in g_display, Adafruit_GFX doesn't
+// expose it.
+const GFXfont *g_font = NULL;
+
+// Use instead of g_display->setFont so the layout cache knows the font.
+void set_font(const GFXfont *font) {
+    g_font = font;
+    g_display->setFont(font);
+}
+
+TextBounds const & text_bounds(const char *txt) {
+    return g_text_layout.lookup(g_font, txt);
+}
 
 Point text_center(const char * txt) {
-    int16_t tbx, tby; uint16_t tbw, tbh;
+    TextBounds const & tb = text_bounds(txt);
+    int16_t tbx = tb.tbx, tby = tb.tby; uint16_t tbw = tb.tbw, tbh = tb.tbh;
     Point p;
-    g_display->getTextBounds(txt, 0, 0, &tbx, &tby, &tbw, &tbh);
     // center bounding box by transposition of origin:
     p.x = ((g_display->width() - tbw) / 2) - tbx;
     p.y = ((g_display->height() - tbh) / 2) - tby;
@@ -112,16 +269,33 @@ void highlight(int yy, int xx_start=0, int xx_end=0) {
  *                 0  highlight will fit the width of the screen
  */
 void display_text(const char *txt, int x, int y, bool _highlight, int xx_end=-1) {
-    int16_t tbx, tby; uint16_t tbw, tbh;
-    g_display->getTextBounds(txt, 0, 0, &tbx, &tby, &tbw, &tbh);
-
     if (_highlight)
-        highlight(y, x, xx_end < 0 ? tbw + 3 : (W_FMB12 * (16 + 3) + 3));
+        highlight(y, x, xx_end < 0 ? text_bounds(txt).tbw + 3 : (W_FMB12 * (16 + 3) + 3));
     g_display->setCursor(x, y);
     g_display->println(txt);
     g_display->setTextColor(GxEPD_BLACK);
 }
 
+/**
+ * @brief displays rows of a long text broken every len characters,
+ *        starting at row first.  The rows are written straight from
+ *        the text, no substrings are built, so scrolling through an
+ *        xpub, descriptor or UR only re-renders.
+ * @pre   text style: a monospace font
+ * @return y of the row following the last one displayed
+ */
+int display_text_rows(int xx, int yy, const char *txt, size_t txtlen,
+                      size_t first, size_t nrows, size_t len, int row_h) {
+    for (size_t row = first; row < first + nrows; ++row) {
+        size_t off = row * len;
+        g_display->setCursor(xx, yy);
+        if (off < txtlen)
+            g_display->write(txt + off, min(len, txtlen - off));
+        yy += row_h;
+    }
+    return yy;
+}
+
 /**
  * @brief displays long text by breaking it with a small margin at the left side of the screen.
  *        This is because some plastic cases may cover the left margin of the screen a bit.
@@ -129,21 +303,80 @@ void display_text(const char *txt, int x, int y, bool _highlight, int xx_end=-1)
  * @len   string lenght, must be less than screen width
  * @todo  make independent from text style
  */
-void display_long_text(int yy, String txt, int len=17)  {
-    g_display->setCursor(6, yy);
-    for (int i=0; i<txt.length(); i+=len) {
-        g_display->println(txt.substring(i, i+len));
-        yy+=H_FSB9+2;
-        g_display->setCursor(6, yy );
-    }
+void display_long_text(int yy, const char *txt, int len=17)  {
+    size_t txtlen = strlen(txt);
+    display_text_rows(6, yy, txt, txtlen, 0, (txtlen + len - 1) / len, len, H_FSB9+2);
+}
+
+void display_long_text(int yy, String const & txt, int len=17)  {
+    display_text_rows(6, yy, txt.c_str(), txt.length(), 0, (txt.length() + len - 1) / len, len, H_FSB9+2);
 }
 
 int text_right(const char * txt) {
-    int16_t tbx, tby; uint16_t tbw, tbh;
-    g_display->getTextBounds(txt, 0, 0, &tbx, &tby, &tbw, &tbh);
-    return ((g_display->width() - tbw) - tbx);
+    TextBounds const & tb = text_bounds(txt);
+    return ((g_display->width() - tb.tbw) - tb.tbx);
 }
 
+/**
+ * Partial refreshes are fast but leave ghosting behind, a full refresh
+ * cleans the panel but flashes for a couple of seconds.  The refresh
+ * scheduler counts partial refreshes and only asks for a full refresh
+ * when the count exceeds the ghosting budget of the connected
+ * controller, or when the user has left a dirty panel alone for a
+ * while.  Every screen redraws the whole panel, so the count is kept
+ * for the panel as a whole.
+ */
+struct RefreshBudget {
+    uint16_t max_partials;	// partial refreshes between full ones
+    uint32_t idle_ms;		// idle time before a cleanup refresh
+};
+
+// GxEPD2_154 (GDEP015OC1) ghosts after a handful of partial updates.
+RefreshBudget const REFRESH_BUDGET_LEGACY = { 8, 20000 };
+
+// GxEPD2_154_D67 (SSD1681) has a much cleaner partial waveform.
+RefreshBudget const REFRESH_BUDGET_MODERN = { 24, 45000 };
+
+struct RefreshScheduler {
+    RefreshBudget budget;
+    uint16_t partials;		// partial refreshes since the last full one
+    uint32_t last_refresh;		// millis() of the last refresh
+    bool dirty;			// any partial refresh since the last full one
+
+    void init(DisplayVariant variant) {
+        budget = variant == DISPLAY_LEGACY
+            ? REFRESH_BUDGET_LEGACY
+            : REFRESH_BUDGET_MODERN;
+        // The panel content is unknown at power on, start over budget
+        // so the first screen is drawn on a clean panel.
+        partials = budget.max_partials;
+        last_refresh = millis();
+        dirty = true;
+    }
+
+    void reset() {
+        partials = 0;
+        last_refresh = millis();
+        dirty = false;
+    }
+
+    void note_partial() {
+        partials += 1;
+        last_refresh = millis();
+        dirty = true;
+    }
+
+    bool over_budget() const {
+        return partials >= budget.max_partials;
+    }
+
+    bool idle_expired() const {
+        return dirty && millis() - last_refresh > budget.idle_ms;
+    }
+};
+
+RefreshScheduler g_refresh;
+
 void full_window_clear() {
     g_display->firstPage();
     do
@@ -152,6 +385,52 @@ void full_window_clear() {
         g_display->fillScreen(GxEPD_WHITE);
     }
     while (g_display->nextPage());
+    g_refresh.reset();
+}
+
+// Use instead of g_display->setPartialWindow so the refresh scheduler
+// can account for the ghosting. With the full height page buffer the
+// page loop runs once, so this is called once per refresh.
+void set_partial_window(int x, int y, int w, int h) {
+    g_display->setPartialWindow(x, y, w, h);
+    g_refresh.note_partial();
+}
+
+// Called between screens, clean the panel only when it is needed.
+void refresh_transition() {
+    if (g_refresh.over_budget())
+        full_window_clear();
+}
+
+// Called while waiting for the user, redraw the current screen with a
+// full refresh to remove the accumulated ghosting.
+void refresh_idle() {
+    if (!g_refresh.idle_expired())
+        return;
+    // The buffer holds the whole screen, no need to redraw it.
+    g_display->display(false);
+    g_refresh.reset();
+}
+
+// Background tasks run while we wait for the user.
+char wait_for_key() {
+    char key;
+    do {
+        key = hw_getkey();
+        // Serial commands first, a host is waiting for them.
+        if (key == NO_KEY && !serialcmd_poll() && !sched_run_one())
+            refresh_idle();
+    } while (key == NO_KEY);
+    return key;
+}
+
+// For screens animating while they wait: a queued key, or NO_KEY once
+// the serial commands or one scheduled task had their turn.
+char poll_key() {
+    char key = hw_getkey();
+    if (key == NO_KEY && !serialcmd_poll())
+        sched_run_one();
+    return key;
 }
 
 void display_printf(const char *format, ...) {
@@ -173,7 +452,7 @@ void interstitial_error(String const lines[], size_t nlines) {
     g_display->firstPage();
     do
     {
-        g_display->setPartialWindow(0, 0, 200, 200);
+        set_partial_window(0, 0, 200, 200);
         // g_display->fillScreen(GxEPD_WHITE);
         g_display->setTextColor(GxEPD_BLACK);
 
@@ -182,25 +461,22 @@ void interstitial_error(String const lines[], size_t nlines) {
 
         for (size_t ii = 0; ii < nlines; ++ii) {
             yy += H_FSB9 + YM_FSB9;
-            g_display->setFont(&FreeSansBold9pt7b);
+            set_font(&FreeSansBold9pt7b);
             g_display->setCursor(xx, yy);
-            serial_printf("%s", lines[ii].c_str());
+            LOG_DEBUG("%s", lines[ii].c_str());
             display_printf("%s", lines[ii].c_str());
         }
 
         yy = 190; // Absolute, stuck to bottom
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         g_display->setCursor(xx, yy);
         display_printf("%", GIT_DESCRIBE);
     }
     while (g_display->nextPage());
 
     while (true) {
-        char key;
-        do {
-            key = g_keypad.getKey();
-        } while (key == NO_KEY);
-        Serial.println("interstitial_error saw " + String(key));
+        char key = wait_for_key();
+        LOG_DEBUG("interstitial_error saw %c\n", key);
         switch (key) {
         case '#':
             return;
@@ -218,47 +494,99 @@ void interstitial_error(String const lines[], size_t nlines) {
  *   @param[in]   text: text to be qr encoded
  *   @param[in]   _scale: if negative apply default scale
  */
-bool displayQR(char * text, int _scale = -1) {
-    // source: https://github.com/arcbtc/koopa/blob/master/main.ino
-
-    // auto detect best qr code size
-    int qrSize = 10;
-    int ec_lvl = 0;
-    int const sizes[18][4] = {
-                        /* https://github.com/ricmoo/QRCode */
-                        /* 1 */ { 17, 14, 11, 7 },
-                        /* 2 */ { 32, 26, 20, 14 },
-                        /* 3 */ { 53, 42, 32, 24 },
-                        /* 4 */ { 78, 62, 46, 34 },
-                        /* 5 */ { 106, 84, 60, 44 },
-                        /* 6 */ { 134, 106, 74, 58 },
-                        /* 7 */ { 154, 122, 86, 64 },
-                        /* 8 */ { 192, 152, 108, 84 },
-                        /* 9 */ { 230, 180, 130, 98 },      // OPN:0 LND:0 good
-                        /* 10 */ { 271, 213, 151, 119 },    // BTP:0 OPN:1 good
-                        /* 11 */ { 321, 251, 177, 137 },
-                        /* 12 */ { 367, 287, 203, 155 },    // BTP:1 bad
-                        /* 13 */ { 425, 331, 241, 177 },    // BTP:2 meh
-                        /* 14 */ { 458, 362, 258, 194 },
-                        /* 15 */ { 520, 412, 292, 220 },
-                        /* 16 */ { 586, 450, 322, 250 },
-                        /* 17 */ { 644, 504, 364, 280 },
-    };
-    int len = strlen(text);
-    for(int ii=0; ii<17; ii++){
-        qrSize = ii+1;
-        if(sizes[ii][ec_lvl] > len){
-            break;
+int const QR_MAX_VERSION = 17;
+int const QR_MAX_SIZE = 17 + 4 * QR_MAX_VERSION;
+int const QR_MAX_BUFFER = (QR_MAX_SIZE * QR_MAX_SIZE + 7) / 8;
+
+/**
+ * Encoded QR codes are cached keyed by the text's SHA256 digest, so a
+ * redraw doesn't encode again and QR codes can be precomputed in the
+ * background (see qr_precompute).  The texts include shares and
+ * seeds, the cache is wiped with the seed (wipe).
+ */
+struct QRCacheEntry {
+    uint8_t digest[SHA256_DIGEST_LENGTH];	// of the text
+    uint16_t len;
+    uint32_t used;			// LRU stamp, 0 if unused
+    QRCode qrcode;
+    uint8_t modules[QR_MAX_BUFFER];
+};
+
+struct QRCache {
+    static int const NENTRIES = 3;	// shown, next and previous
+
+    QRCacheEntry entries[NENTRIES];
+    uint32_t clock;
+
+    QRCode const * encode(const char * text) {
+        uint16_t len = strlen(text);
+        uint8_t digest[SHA256_DIGEST_LENGTH];
+        sha256_Raw((uint8_t const *) text, len, digest);
+        QRCacheEntry * victim = &entries[0];
+        for (int ii = 0; ii < NENTRIES; ++ii) {
+            QRCacheEntry & ee = entries[ii];
+            if (ee.used && ee.len == len &&
+                memcmp(ee.digest, digest, sizeof(digest)) == 0) {
+                ee.used = ++clock;
+                return &ee.qrcode;
+            }
+            if (ee.used < victim->used)
+                victim = &ee;
+        }
+
+        // source: https://github.com/arcbtc/koopa/blob/master/main.ino
+
+        // auto detect best qr code size
+        int qrSize = 10;
+        int ec_lvl = 0;
+        int const sizes[18][4] = {
+                            /* https://github.com/ricmoo/QRCode */
+                            /* 1 */ { 17, 14, 11, 7 },
+                            /* 2 */ { 32, 26, 20, 14 },
+                            /* 3 */ { 53, 42, 32, 24 },
+                            /* 4 */ { 78, 62, 46, 34 },
+                            /* 5 */ { 106, 84, 60, 44 },
+                            /* 6 */ { 134, 106, 74, 58 },
+                            /* 7 */ { 154, 122, 86, 64 },
+                            /* 8 */ { 192, 152, 108, 84 },
+                            /* 9 */ { 230, 180, 130, 98 },      // OPN:0 LND:0 good
+                            /* 10 */ { 271, 213, 151, 119 },    // BTP:0 OPN:1 good
+                            /* 11 */ { 321, 251, 177, 137 },
+                            /* 12 */ { 367, 287, 203, 155 },    // BTP:1 bad
+                            /* 13 */ { 425, 331, 241, 177 },    // BTP:2 meh
+                            /* 14 */ { 458, 362, 258, 194 },
+                            /* 15 */ { 520, 412, 292, 220 },
+                            /* 16 */ { 586, 450, 322, 250 },
+                            /* 17 */ { 644, 504, 364, 280 },
+        };
+        for(int ii=0; ii<QR_MAX_VERSION; ii++){
+            qrSize = ii+1;
+            if(sizes[ii][ec_lvl] > len){
+                break;
+            }
         }
+
+        // Create the QR code
+        qrcode_initText(&victim->qrcode, victim->modules, qrSize, ec_lvl,
+                        text);
+        memcpy(victim->digest, digest, sizeof(digest));
+        victim->len = len;
+        victim->used = ++clock;
+        return &victim->qrcode;
     }
 
-    // Create the QR code
-    QRCode qrcode;
-    uint8_t qrcodeData[qrcode_getBufferSize(qrSize)];
-    qrcode_initText(&qrcode, qrcodeData, qrSize, ec_lvl,
-                    text);
+    void wipe() {
+        memzero(entries, sizeof(entries));
+        clock = 0;
+    }
+};
+
+QRCache g_qr_cache;
+
+bool displayQR(char * text, int _scale = -1) {
+    QRCode const * qrcode = g_qr_cache.encode(text);
 
-    int width = 17 + 4*qrSize;
+    int width = qrcode->size;
 
     int scale;
     if (_scale <= 0)
@@ -269,9 +597,9 @@ bool displayQR(char * text, int _scale = -1) {
     int padding = (200 - width*scale)/2;
 
     // for every pixel in QR code we draw a rectangle with size `scale`
-    for (uint8_t y = 0; y < qrcode.size; y++) {
-        for (uint8_t x = 0; x < qrcode.size; x++) {
-            if(qrcode_getModule(&qrcode, x, y)){
+    for (uint8_t y = 0; y < qrcode->size; y++) {
+        for (uint8_t x = 0; x < qrcode->size; x++) {
+            if(qrcode_getModule((QRCode *)qrcode, x, y)){
                 g_display->fillRect(padding+scale*x,
                                    padding+scale*y,
                                    scale, scale, GxEPD_BLACK);
@@ -282,89 +610,133 @@ bool displayQR(char * text, int _scale = -1) {
     return true;
 }
 
-void self_test() {
+// Encodes text into the QR cache while the user looks at the current
+// screen, e.g. the QR code of the next share.
+String g_qr_precompute_text;
+int g_qr_precompute_task = -1;
+
+bool qr_precompute_step(void *ctx) {
+    g_qr_cache.encode(((String *) ctx)->c_str());
+    return true;
+}
+
+void qr_precompute(String const & text) {
+    sched_cancel(g_qr_precompute_task);
+    wipe_string(g_qr_precompute_text);
+    g_qr_precompute_text = text;
+    g_qr_precompute_task = sched_add(qr_precompute_step, &g_qr_precompute_text, SCHED_PRIO_IDLE);
+}
+
+// The last self test tier to run, the boot runs only the fast one.
+SelftestTier g_selftest_tier = SELFTEST_FAST;
+
+void self_test_display(char const * title, String const lines[], size_t nlines) {
     int xoff = 8;
     int yoff = 6;
 
-    size_t const NLINES = 8;
-    String lines[NLINES];
+    g_display->firstPage();
+    do
+    {
+        set_partial_window(0, 0, 200, 200);
+        // g_display->fillScreen(GxEPD_WHITE);
+        g_display->setTextColor(GxEPD_BLACK);
 
-    // Turn the green LED on for the duration of the tests.
-    hw_green_led(HIGH);
+        int xx = xoff;
+        int yy = yoff;
 
-    bool last_test_passed = true;
-    size_t numtests = selftest_numtests();
-    // Loop, once for each test.  Need an extra trip at the end in
-    // case we failed the last test.
-    for (size_t ndx = 0; ndx < numtests+1; ++ndx) {
+        yy += 1*(H_FSB9 + YM_FSB9);
+        set_font(&FreeSansBold9pt7b);
+        g_display->setCursor(xx, yy);
+        g_display->println(title);
 
-        // If any key is pressed, skip remaining self test.
-        if (g_keypad.getKey() != NO_KEY)
-            break;
+        yy += 10;
 
-        // Append each test name to the bottom of the displayed list.
-        size_t row = ndx;
-        if (row > NLINES - 1) {
-            // slide all the lines up one
-            for (size_t ii = 0; ii < NLINES - 1; ++ii)
-                lines[ii] = lines[ii+1];
-            row = NLINES - 1;
+        for (size_t ii = 0; ii < nlines; ++ii) {
+            yy += 1*(H_FMB9 + YM_FMB9);
+            set_font(&FreeMonoBold9pt7b);
+            g_display->setCursor(xx, yy);
+            display_printf("%s", lines[ii].c_str());
         }
 
-        if (!last_test_passed) {
-            lines[row] = "TEST FAILED";
-        } else if (ndx < numtests) {
-            lines[row] = selftest_testname(ndx).c_str();
-        } else {
-            // ran last test and it passed
-            lines[row] = "TESTS PASSED";
-        }
+        yy = 190; // Absolute, stuck to bottom
+        set_font(&FreeSansBold9pt7b);
+        g_display->setCursor(xx, yy);
+        display_printf("%", GIT_DESCRIBE);
+    }
+    while (g_display->nextPage());
+}
 
-        // Display the current list.
-        g_display->firstPage();
-        do
-        {
-            g_display->setPartialWindow(0, 0, 200, 200);
-            // g_display->fillScreen(GxEPD_WHITE);
-            g_display->setTextColor(GxEPD_BLACK);
+void self_test() {
+    size_t const NLINES = 8;
+    String lines[NLINES];
 
-            int xx = xoff;
-            int yy = yoff;
+    // Turn the green LED on for the duration of the tests.
+    hw_green_led(HIGH);
 
-            yy += 1*(H_FSB9 + YM_FSB9);
-            g_display->setFont(&FreeSansBold9pt7b);
-            g_display->setCursor(xx, yy);
-            g_display->println("Running self tests:");
+    size_t numtests = selftest_numtests();
+    bool skipped = false;
+    for (int tier = SELFTEST_FAST; tier <= g_selftest_tier && !skipped; ++tier) {
+        // The display is only redrawn when the tier is done, it shows
+        // the last tests run with their durations.
+        size_t nlines = 0;
+        uint32_t start = millis();
+        bool passed = true;
+        for (size_t ndx = 0; ndx < numtests && passed; ++ndx) {
+            if (selftest_testtier(ndx) != tier)
+                continue;
+
+            // If any key is pressed, skip remaining self test.
+            if (hw_getkey() != NO_KEY) {
+                skipped = true;
+                break;
+            }
 
-            yy += 10;
+            passed = selftest_testrun(ndx);
 
-            for (size_t ii = 0; ii < NLINES; ++ii) {
-                yy += 1*(H_FMB9 + YM_FMB9);
-                g_display->setFont(&FreeMonoBold9pt7b);
-                g_display->setCursor(xx, yy);
-                display_printf("%s", lines[ii].c_str());
+            if (nlines == NLINES - 1) {
+                // slide all the lines up one
+                for (size_t ii = 0; ii < NLINES - 2; ++ii)
+                    lines[ii] = lines[ii+1];
+                --nlines;
             }
-
-            yy = 190; // Absolute, stuck to bottom
-            g_display->setFont(&FreeSansBold9pt7b);
-            g_display->setCursor(xx, yy);
-            display_printf("%", GIT_DESCRIBE);
+            char line[32];
+            snprintf(line, sizeof(line), "%-11.11s%5lu",
+                     selftest_testname(ndx).c_str(),
+                     (unsigned long) selftest_duration(ndx));
+            lines[nlines++] = line;
         }
-        while (g_display->nextPage());
+        LOG_INFO("self_test: tier %d %lu ms\n",
+                 tier, (unsigned long) (millis() - start));
+        if (skipped)
+            break;
+
+        if (!passed)
+            lines[nlines++] = "TEST FAILED";
+        else if (tier < g_selftest_tier)
+            lines[nlines++] = "Running full ...";
+        else
+            lines[nlines++] = "TESTS PASSED";
+        self_test_display(tier == SELFTEST_FAST
+                          ? "Fast self tests:" : "Full self tests:",
+                          lines, nlines);
 
         // If the test failed, abort (leaving status on screen).
-        if (!last_test_passed) {
+        if (!passed) {
             hw_green_led(LOW);
             abort();
         }
-
-        // If this isn't the last pass run the next test.
-        if (ndx < numtests)
-            last_test_passed = selftest_testrun(ndx);
     }
     delay(500);		// short pause ..
-    hw_green_led(LOW);	// Green LED back off until there is a seed.
-    g_uistate = INTRO_SCREEN;
+
+    if (g_selftest_tier == SELFTEST_FAST) {
+        hw_green_led(LOW);	// Green LED back off until there is a seed.
+        g_uistate = INTRO_SCREEN;
+    } else {
+        // Run on demand, back to the menu.
+        hw_green_led(g_master_seed ? HIGH : LOW);
+        g_selftest_tier = SELFTEST_FAST;
+        g_uistate = g_master_seed ? SEEDY_MENU : SEEDLESS_MENU;
+    }
 }
 
 void intro_screen() {
@@ -374,13 +746,13 @@ void intro_screen() {
     g_display->firstPage();
     do
     {
-        g_display->setPartialWindow(0, 0, 200, 200);
+        set_partial_window(0, 0, 200, 200);
         // g_display->fillScreen(GxEPD_WHITE);
         g_display->setTextColor(GxEPD_BLACK);
 
         int xx = xoff + 14;
         int yy = yoff + (H_FSB12 + YM_FSB12);
-        g_display->setFont(&FreeSansBold12pt7b);
+        set_font(&FreeSansBold12pt7b);
         g_display->setCursor(xx, yy);
         g_display->println("LetheKit v0");
 
@@ -393,13 +765,13 @@ void intro_screen() {
 
         xx = xoff + 50;
         yy += H_FSB9;
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         g_display->setCursor(xx, yy);
         display_printf("%s", GIT_LATEST_TAG);
 
         xx = xoff + 28;
         yy += 1*(H_FSB9 + 2*YM_FSB9);
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         g_display->setCursor(xx, yy);
         g_display->println("Blockchain");
 
@@ -421,11 +793,8 @@ void intro_screen() {
     while (g_display->nextPage());
 
     while (true) {
-        char key;
-        do {
-            key = g_keypad.getKey();
-        } while (key == NO_KEY);
-        Serial.println("intro_screen saw " + String(key));
+        char key = wait_for_key();
+        LOG_DEBUG("intro_screen saw %c\n", key);
         g_uistate = SEEDLESS_MENU;
         return;
     }
@@ -438,18 +807,18 @@ void seedless_menu() {
     g_display->firstPage();
     do
     {
-        g_display->setPartialWindow(0, 0, 200, 200);
+        set_partial_window(0, 0, 200, 200);
         // g_display->fillScreen(GxEPD_WHITE);
         g_display->setTextColor(GxEPD_BLACK);
 
         int xx = xoff;
         int yy = (H_FSB12 + YM_FSB12);
-        g_display->setFont(&FreeSansBold12pt7b);
+        set_font(&FreeSansBold12pt7b);
         g_display->setCursor(xx, yy);
         g_display->println("No Seed");
 
         yy = 3*(H_FSB9 + YM_FSB9);
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         g_display->setCursor(xx, yy);
         g_display->println("A - Generate Seed");
         yy += H_FSB9 + 2*YM_FSB9;
@@ -467,18 +836,24 @@ void seedless_menu() {
         g_display->println("0 - UR Demo");
 
         yy = 190; // Absolute, stuck to bottom
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         g_display->setCursor(xx, yy);
         display_printf("%", GIT_DESCRIBE);
+
+        // Other seeds are parked, allow going back to them.
+        if (slots_count() > 0) {
+            set_font(&FreeMono9pt7b);
+            String right_option = "2Slots";
+            int x_r = text_right(right_option.c_str());
+            g_display->setCursor(x_r, yy+5);
+            g_display->println(right_option);
+        }
     }
     while (g_display->nextPage());
 
     while (true) {
-        char key;
-        do {
-            key = g_keypad.getKey();
-        } while (key == NO_KEY);
-        Serial.println("seedless_menu saw " + String(key));
+        char key = wait_for_key();
+        LOG_DEBUG("seedless_menu saw %c\n", key);
         switch (key) {
         case 'A':
             g_uistate = GENERATE_SEED;
@@ -495,6 +870,17 @@ void seedless_menu() {
         case '0':
             g_uistate = UR_DEMO;
             return;
+        case '8':
+            // Hidden, run the full self test suite.
+            g_selftest_tier = SELFTEST_FULL;
+            g_uistate = SELF_TEST;
+            return;
+        case '2':
+            if (slots_count() > 0) {
+                g_uistate = SEED_SLOTS;
+                return;
+            }
+            break;
         case 'D':
             // allow inputting invalid mnemonic
             pg_seedless_menu.allow_invalid_mnemonic = true;
@@ -522,89 +908,91 @@ void generate_seed() {
         int yoff = 8;
         bool ret;
 
-        g_display->firstPage();
-        do
-        {
-            g_display->setPartialWindow(0, 0, 200, 200);
-            // g_display->fillScreen(GxEPD_WHITE);
-            g_display->setTextColor(GxEPD_BLACK);
+        // Keys queued while the panel was refreshing are applied
+        // first, so a burst of key presses costs a single redraw.
+        if (!hw_key_pending()) {
+            g_display->firstPage();
+            do
+            {
+                set_partial_window(0, 0, 200, 200);
+                // g_display->fillScreen(GxEPD_WHITE);
+                g_display->setTextColor(GxEPD_BLACK);
 
-            int xx = xoff;
-            int yy = yoff + (H_FSB12 + YM_FSB12) - 4;
-            g_display->setFont(&FreeSansBold12pt7b);
-            g_display->setCursor(xx, yy);
-            g_display->println("Generate Seed");
+                int xx = xoff;
+                int yy = yoff + (H_FSB12 + YM_FSB12) - 4;
+                set_font(&FreeSansBold12pt7b);
+                g_display->setCursor(xx, yy);
+                g_display->println("Generate Seed");
 
-            yy += 10;
+                yy += 10;
 
-            yy += H_FSB9 + YM_FSB9;
-            g_display->setFont(&FreeSansBold9pt7b);
-            g_display->setCursor(xx, yy);
-            if (g_rolls.length() * 2.5850 >= MAX_DICE_ENTROPY) {
-                g_display->println("Max rolls reached!");
-            }
-            else {
-                g_display->println("Enter Dice Rolls");
-            }
+                yy += H_FSB9 + YM_FSB9;
+                set_font(&FreeSansBold9pt7b);
+                g_display->setCursor(xx, yy);
+                if (g_seed_builder.numrolls() * 2.5850 >= MAX_DICE_ENTROPY) {
+                    g_display->println("Max rolls reached!");
+                }
+                else {
+                    g_display->println("Enter Dice Rolls");
+                }
 
-            yy += 10;
+                yy += 10;
 
-            yy += H_FMB12 + YM_FMB12;
-            g_display->setFont(&FreeMonoBold12pt7b);
-            g_display->setCursor(xx, yy);
-            display_printf("Rolls: %d\n", g_rolls.length());
-            yy += H_FMB12 + YM_FMB12;
-            g_display->setCursor(xx, yy);
-            if (g_trng128.rdy) {
-                display_printf(" Bits: %0.1f\n       +128\n", g_rolls.length() * 2.5850);
-            }
-            else {
-                display_printf(" Bits: %0.1f\n", g_rolls.length() * 2.5850);
-            }
+                yy += H_FMB12 + YM_FMB12;
+                set_font(&FreeMonoBold12pt7b);
+                g_display->setCursor(xx, yy);
+                display_printf("Rolls: %d\n", g_seed_builder.numrolls());
+                yy += H_FMB12 + YM_FMB12;
+                g_display->setCursor(xx, yy);
+                if (g_trng_entropy.rdy) {
+                    display_printf(" Bits: %0.1f\n       +%u\n", g_seed_builder.numrolls() * 2.5850,
+                                   (unsigned) (Seed::SIZE * 8));
+                }
+                else {
+                    display_printf(" Bits: %0.1f\n", g_seed_builder.numrolls() * 2.5850);
+                }
 
-            // bottom-relative position
-            xx = xoff;
-            yy = Y_MAX - 2*(H_FSB9 + YM_FSB9) + 15;
-            g_display->setFont(&FreeSansBold9pt7b);
-            g_display->setCursor(xx, yy);
-            if (g_trng128.rdy) {
-                g_display->println("");
-            }
-            else {
-                g_display->println("Add 128b TRNG:   C");
+                // bottom-relative position
+                xx = xoff;
+                yy = Y_MAX - 2*(H_FSB9 + YM_FSB9) + 15;
+                set_font(&FreeSansBold9pt7b);
+                g_display->setCursor(xx, yy);
+                if (g_trng_entropy.rdy) {
+                    g_display->println("");
+                }
+                else {
+                    display_printf("Add %ub TRNG:   C\n", (unsigned) (Seed::SIZE * 8));
+                }
+                yy += H_FSB9 + YM_FSB9;
+                g_display->setCursor(xx, yy);
+                g_display->println("Clear: *      Submit: #");
             }
-            yy += H_FSB9 + YM_FSB9;
-            g_display->setCursor(xx, yy);
-            g_display->println("Clear: *      Submit: #");
+            while (g_display->nextPage());
         }
-        while (g_display->nextPage());
 
-        char key;
-        do {
-            key = g_keypad.getKey();
-        } while (key == NO_KEY);
-        Serial.println("generate_seed saw " + String(key));
+        char key = wait_for_key();
+        LOG_DEBUG("generate_seed saw %c\n", key);
         switch (key) {
         case '1': case '2': case '3':
         case '4': case '5': case '6':
-            if (g_rolls.length() * 2.5850 < MAX_DICE_ENTROPY) {
-                g_rolls += key;
+            if (g_seed_builder.numrolls() * 2.5850 < MAX_DICE_ENTROPY) {
+                g_seed_builder.add_roll(key);
             }
             break;
         case '*':
-            g_rolls = "";
-            g_trng128.rdy = false;
+            g_seed_builder.reset();
+            g_trng_entropy.rdy = false;
             break;
         case '#': {
             g_submitted = true;
             serial_assert(!g_master_seed);
             if (g_master_seed)
                 delete g_master_seed;
-            if (g_trng128.rdy) {
-                g_master_seed = Seed::from_rolls(g_rolls, g_trng128.buff, sizeof(g_trng128.buff));
+            if (g_trng_entropy.rdy) {
+                g_master_seed = g_seed_builder.finalize(g_trng_entropy.buff, sizeof(g_trng_entropy.buff));
             }
             else {
-                g_master_seed = Seed::from_rolls(g_rolls);
+                g_master_seed = g_seed_builder.finalize();
             }
             g_master_seed->log();
 
@@ -616,8 +1004,12 @@ void generate_seed() {
             if (g_bip39)
                 delete g_bip39;
             g_bip39 = new BIP39Seq(g_master_seed);
+            if (g_seed_context) {
+                delete g_seed_context;
+                g_seed_context = NULL;
+            }
 
-            ret = keystore.update_root_key(g_bip39->mnemonic_seed, BIP39_SEED_LEN_512);
+            ret = seed_context()->select(keystore);
             if (ret == false) {
                 g_uistate = ERROR_SCREEN;
                 return;
@@ -627,9 +1019,9 @@ void generate_seed() {
         }
             return;
         case 'C':
-            /* Allow mixing 128 bits of trng entropy regardless of the size of dice entropy */
-            hw_random_buffer(g_trng128.buff, sizeof(g_trng128.buff));
-            g_trng128.rdy = true;
+            /* Allow mixing a seed's worth of trng entropy regardless of the size of dice entropy */
+            random_buffer(g_trng_entropy.buff, sizeof(g_trng_entropy.buff));
+            g_trng_entropy.rdy = true;
             break;
         default:
             break;
@@ -641,17 +1033,17 @@ void set_network() {
     int xoff = 10, yoff = 5;
     String title = "Set network";
     bool ret;
-    NetwtorkType net = network.get_network();
+    NetwtorkType net = keystore.network.get_network();
     g_display->firstPage();
     do
     {
-        g_display->setPartialWindow(0, 0, 200, 200);
+        set_partial_window(0, 0, 200, 200);
         // g_display->fillScreen(GxEPD_WHITE);
         g_display->setTextColor(GxEPD_BLACK);
 
         int xx = xoff;
         int yy = yoff + (H_FSB9 + YM_FSB9);
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         Point p = text_center(title.c_str());
         g_display->setCursor(p.x, yy);
         g_display->println(title);
@@ -668,48 +1060,44 @@ void set_network() {
         // bottom-relative position
         xx = xoff + 2;
         yy = Y_MAX - (H_FSB9) + 2;
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         g_display->setCursor(xx, yy);
         g_display->println("*-Cancel");
     }
     while (g_display->nextPage());
 
-    char key;
-    do {
-        key = g_keypad.getKey();
-    } while (key == NO_KEY);
+    char key = wait_for_key();
     g_uistate = SEEDY_MENU;
-    clear_full_window = false;
     switch (key) {
     case 'A':
-        network.set_network(REGTEST);
-        ret = keystore.update_root_key(g_bip39->mnemonic_seed, BIP39_SEED_LEN_512, network.get_network());
+        keystore.network.set_network(REGTEST);
+        ret = seed_context()->select(keystore);
         if (ret == false) {
             g_uistate = ERROR_SCREEN;
             return;
         }
         if (keystore.is_standard_derivation_path())
-            keystore.save_standard_derivation_path(NULL, network.get_network());
+            keystore.save_standard_derivation_path(NULL, keystore.network.get_network());
         return;
     case 'B':
-        network.set_network(TESTNET);
-        ret = keystore.update_root_key(g_bip39->mnemonic_seed, BIP39_SEED_LEN_512, network.get_network());
+        keystore.network.set_network(TESTNET);
+        ret = seed_context()->select(keystore);
         if (ret == false) {
             g_uistate = ERROR_SCREEN;
             return;
         }
         if (keystore.is_standard_derivation_path())
-            keystore.save_standard_derivation_path(NULL, network.get_network());
+            keystore.save_standard_derivation_path(NULL, keystore.network.get_network());
         return;
     case 'C':
-        network.set_network(MAINNET);
-        ret = keystore.update_root_key(g_bip39->mnemonic_seed, BIP39_SEED_LEN_512, network.get_network());
+        keystore.network.set_network(MAINNET);
+        ret = seed_context()->select(keystore);
         if (ret == false) {
             g_uistate = ERROR_SCREEN;
             return;
         }
         if (keystore.is_standard_derivation_path())
-            keystore.save_standard_derivation_path(NULL, network.get_network());
+            keystore.save_standard_derivation_path(NULL, keystore.network.get_network());
         return;
     case '*':
         return;
@@ -726,18 +1114,18 @@ void seedy_menu() {
     g_display->firstPage();
     do
     {
-        g_display->setPartialWindow(0, 0, 200, 200);
+        set_partial_window(0, 0, 200, 200);
         // g_display->fillScreen(GxEPD_WHITE);
         g_display->setTextColor(GxEPD_BLACK);
 
         int xx = xoff;
         int yy = H_FSB12 + YM_FSB12;
-        g_display->setFont(&FreeSansBold12pt7b);
+        set_font(&FreeSansBold12pt7b);
         g_display->setCursor(xx, yy);
         g_display->println("Seed Present");
 
         yy = yoff + 2*(H_FSB9 + YM_FSB9) + 15;
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         g_display->setCursor(xx, yy);
         g_display->println("A - Display BIP39");
         yy += H_FSB9 + 2*YM_FSB9;
@@ -754,25 +1142,27 @@ void seedy_menu() {
         g_display->println("0 - Open Wallet");
 
         yy = 190; // Absolute, stuck to bottom
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         g_display->setCursor(xx, yy);
         display_printf("%", GIT_DESCRIBE);
 
-        g_display->setFont(&FreeMono9pt7b);
+        set_font(&FreeMono9pt7b);
         String right_option = "1Netw.";
         int x_r = text_right(right_option.c_str());
         g_display->setCursor(x_r, yy+5);
         g_display->println(right_option);
 
+        right_option = "2Slots";
+        x_r = text_right(right_option.c_str());
+        g_display->setCursor(x_r, yy-15);
+        g_display->println(right_option);
+
     }
     while (g_display->nextPage());
 
     while (true) {
-        char key;
-        do {
-            key = g_keypad.getKey();
-        } while (key == NO_KEY);
-        Serial.println("seedy_menu saw " + String(key));
+        char key = wait_for_key();
+        LOG_DEBUG("seedy_menu saw %c\n", key);
         switch (key) {
         case 'A':
             g_uistate = DISPLAY_BIP39;
@@ -781,22 +1171,26 @@ void seedy_menu() {
             g_uistate = CONFIG_SSKR;
             return;
         case 'C':
-            clear_full_window = false;
             g_uistate = DISPLAY_KEYS;
             return;
         case '0':
-            clear_full_window = false;
             g_uistate = OPEN_WALLET;
             return;
         case '1':
             // TODO: this option is currently hidden from UI
-            clear_full_window = false;
             g_uistate = SET_NETWORK;
             return;
+        case '2':
+            g_uistate = SEED_SLOTS;
+            return;
         case 'D':
-            clear_full_window = false;
             g_uistate = DISPLAY_SEED;
             return;
+        case '8':
+            // Hidden, run the full self test suite.
+            g_selftest_tier = SELFTEST_FULL;
+            g_uistate = SELF_TEST;
+            return;
         case '*':
            ui_reset_into_state(SEEDLESS_MENU);
            g_uistate = SEEDLESS_MENU;
@@ -819,20 +1213,20 @@ void display_bip39() {
         g_display->firstPage();
         do
         {
-            g_display->setPartialWindow(0, 0, 200, 200);
+            set_partial_window(0, 0, 200, 200);
             // g_display->fillScreen(GxEPD_WHITE);
             g_display->setTextColor(GxEPD_BLACK);
 
             int xx = xoff;
             int yy = yoff + (H_FSB9 + YM_FSB9);
-            g_display->setFont(&FreeSansBold9pt7b);
+            set_font(&FreeSansBold9pt7b);
             g_display->setCursor(xx, yy);
             g_display->println("BIP39 Mnemonic");
             yy += H_FSB9 + YM_FSB9;
 
             yy += 6;
 
-            g_display->setFont(&FreeMonoBold12pt7b);
+            set_font(&FreeMonoBold12pt7b);
             for (int rr = 0; rr < nrows; ++rr) {
                 int wndx = scroll + rr;
                 g_display->setCursor(xx, yy);
@@ -843,17 +1237,14 @@ void display_bip39() {
             // bottom-relative position
             xx = xoff + 2;
             yy = Y_MAX - (H_FSB9) + 2;
-            g_display->setFont(&FreeSansBold9pt7b);
+            set_font(&FreeSansBold9pt7b);
             g_display->setCursor(xx, yy);
             g_display->println("1,7-Up,Down #-Done");
         }
         while (g_display->nextPage());
 
-        char key;
-        do {
-            key = g_keypad.getKey();
-        } while (key == NO_KEY);
-        Serial.println("display_bip39 saw " + String(key));
+        char key = wait_for_key();
+        LOG_DEBUG("display_bip39 saw %c\n", key);
         switch (key) {
         case '1':
             if (scroll > 0)
@@ -902,20 +1293,20 @@ void config_sskr() {
         g_display->firstPage();
         do
         {
-            g_display->setPartialWindow(0, 0, 200, 200);
+            set_partial_window(0, 0, 200, 200);
             // g_display->fillScreen(GxEPD_WHITE);
             g_display->setTextColor(GxEPD_BLACK);
 
             int xx = xoff;
             int yy = yoff + (H_FSB9 + YM_FSB9);
-            g_display->setFont(&FreeSansBold9pt7b);
+            set_font(&FreeSansBold9pt7b);
             g_display->setCursor(xx, yy);
             g_display->println("Configure SSKR");
 
             yy += 10;
 
             yy += H_FMB12 + 2*YM_FMB12;
-            g_display->setFont(&FreeMonoBold12pt7b);
+            set_font(&FreeMonoBold12pt7b);
             g_display->setCursor(xx, yy);
             display_printf(" Thresh: %s", threshstr.c_str());
 
@@ -954,7 +1345,7 @@ void config_sskr() {
             // bottom-relative position
             xx = xoff + 2;
             yy = Y_MAX - (H_FSB9) + 2;
-            g_display->setFont(&FreeSansBold9pt7b);
+            set_font(&FreeSansBold9pt7b);
             g_display->setCursor(xx, yy);
 
             if (!thresh_done) {
@@ -969,11 +1360,8 @@ void config_sskr() {
         }
         while (g_display->nextPage());
 
-        char key;
-        do {
-            key = g_keypad.getKey();
-        } while (key == NO_KEY);
-        Serial.println("config_sskr saw " + String(key));
+        char key = wait_for_key();
+        LOG_DEBUG("config_sskr saw %c\n", key);
         switch (key) {
         case '0': case '1': case '2': case '3': case '4':
         case '5': case '6': case '7': case '8': case '9':
@@ -1034,13 +1422,13 @@ void set_sskr_format() {
     g_display->firstPage();
     do
     {
-        g_display->setPartialWindow(0, 0, 200, 200);
+        set_partial_window(0, 0, 200, 200);
         // g_display->fillScreen(GxEPD_WHITE);
         g_display->setTextColor(GxEPD_BLACK);
 
         int xx = xoff;
         int yy = yoff + (H_FSB9 + YM_FSB9);
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         Point p = text_center(title.c_str());
         g_display->setCursor(p.x, yy);
         g_display->println(title);
@@ -1057,18 +1445,14 @@ void set_sskr_format() {
         // bottom-relative position
         xx = xoff + 2;
         yy = Y_MAX - (H_FSB9) + 2;
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         g_display->setCursor(xx, yy);
         g_display->println("*-Cancel");
     }
     while (g_display->nextPage());
 
-    char key;
-    do {
-        key = g_keypad.getKey();
-    } while (key == NO_KEY);
+    char key = wait_for_key();
     g_uistate = DISPLAY_SSKR;
-    clear_full_window = false;
     switch (key) {
     case 'A':
         pg_set_sskr_format.sskr_format = text;
@@ -1102,12 +1486,12 @@ void display_sskr() {
         g_display->firstPage();
         do
         {
-            g_display->setPartialWindow(0, 0, 200, 200);
+            set_partial_window(0, 0, 200, 200);
             g_display->setTextColor(GxEPD_BLACK);
 
             int xx = xoff;
             int yy = yoff + (H_FSB9 + YM_FSB9);
-            g_display->setFont(&FreeSansBold9pt7b);
+            set_font(&FreeSansBold9pt7b);
             g_display->setCursor(xx, yy);
             display_printf("         SSKR %d/%d",
                            sharendx+1, g_sskr_generate->shares_len);
@@ -1115,7 +1499,7 @@ void display_sskr() {
 
             yy += 8;
 
-            g_display->setFont(&FreeMonoBold12pt7b);
+            set_font(&FreeMonoBold12pt7b);
 
             if (pg_set_sskr_format.sskr_format == text) {
                 for (int rr = 0; rr < nrows; ++rr) {
@@ -1128,21 +1512,22 @@ void display_sskr() {
                 }
             }
             else if (pg_set_sskr_format.sskr_format == qr_ur) {
-                String ur = g_sskr_generate->shares_ur[sharendx];
+                String ur = g_sskr_generate->get_share_ur(sharendx);
                 ur.toUpperCase();
                 displayQR((char *)ur.c_str());
+                wipe_string(ur);
             }
             else {
                 int xx = 0;
                 yy = 65;
-                g_display->setFont(&FreeMonoBold9pt7b);
+                set_font(&FreeMonoBold9pt7b);
                 g_display->setCursor(5, yy);
-                display_long_text(yy, g_sskr_generate->shares_ur[sharendx]);
-                Serial.println(g_sskr_generate->shares_ur[sharendx].c_str());
+                display_long_text(yy, g_sskr_generate->get_share_ur(sharendx));
+                LOG_TRACE("%s\n", g_sskr_generate->get_share_ur(sharendx).c_str());
             }
 
             yy = 195; // Absolute, stuck to bottom
-            g_display->setFont(&FreeMono9pt7b);
+            set_font(&FreeMono9pt7b);
 
             String right_option = "# Done";
             if (sharendx < (int)(g_sskr_generate->shares_len-1))
@@ -1169,15 +1554,20 @@ void display_sskr() {
         }
         while (g_display->nextPage());
 
-        char key;
-        do {
-            key = g_keypad.getKey();
-        } while (key == NO_KEY);
-        Serial.println("display_sskr saw " + String(key));
+        // The next share is the likely next screen.
+        if (pg_set_sskr_format.sskr_format == qr_ur &&
+            sharendx < (int)(g_sskr_generate->shares_len-1)) {
+            String next_ur = g_sskr_generate->get_share_ur(sharendx+1);
+            next_ur.toUpperCase();
+            qr_precompute(next_ur);
+            wipe_string(next_ur);
+        }
+
+        char key = wait_for_key();
+        LOG_DEBUG("display_sskr saw %c\n", key);
         switch (key) {
         case 'A':
             g_uistate = SET_SSKR_FORMAT;
-            clear_full_window = false;
             scroll = 0;
             return;
         case '1':
@@ -1220,6 +1610,7 @@ void display_sskr() {
 
 struct WordListState {
     int nwords;				// number of words in the mnemonic
+    WordListId wordlist;		// the reference word list
     int nrefwords;			// number of words in the total word list
 
     int* wordndx;			// ref index for each word in list
@@ -1229,9 +1620,10 @@ struct WordListState {
     int pos;				// char index of cursor
     int scroll;				// index of first visible word
 
-    WordListState(int i_nwords, int i_nrefwords)
+    WordListState(int i_nwords, WordListId i_wordlist)
         : nwords(i_nwords)
-        , nrefwords(i_nrefwords)
+        , wordlist(i_wordlist)
+        , nrefwords(wordlist_size(i_wordlist))
         , nrows(5)
         , selected(0)
         , pos(0)
@@ -1244,7 +1636,9 @@ struct WordListState {
         free(wordndx);
     }
 
-    virtual String refword(int ndx) = 0;
+    const char * refword(int ndx) const {
+        return wordlist_word(wordlist, ndx);
+    }
 
     void set_words(uint16_t const * wordlist) {
 
@@ -1256,7 +1650,7 @@ struct WordListState {
     void set_words(uint8_t const * wordlist) {
         for (int ii = 0; ii < nwords; ++ii) {
             wordndx[ii] = wordlist ? wordlist[ii] : 0;
-            Serial.println(String(wordndx[ii]) );
+            LOG_TRACE("%d\n", wordndx[ii]);
         }
     }
 
@@ -1269,7 +1663,7 @@ struct WordListState {
     // for sskr
     void get_words(String & o_wordlist) {
         for (int ii = 0; ii < nwords; ++ii) {
-            o_wordlist += String(refword(wordndx[ii]));
+            o_wordlist += refword(wordndx[ii]);
             if (ii < nwords-1)
                 o_wordlist += " ";
         }
@@ -1306,83 +1700,35 @@ struct WordListState {
     }
 
     void cursor_right() {
-        if (pos < (int)refword(wordndx[selected]).length() - 1)
+        if (pos < (int)strlen(refword(wordndx[selected])) - 1)
             ++pos;
     }
 
     void word_down() {
         // Find the previous word that differs in the cursor position.
-        int wordndx0 = wordndx[selected];	// remember starting wordndx
-        String prefix0 = prefix(wordndx[selected]);
-        char curr0 = current(wordndx[selected]);
-        do {
-            if (wordndx[selected] == 0)
-                wordndx[selected] = nrefwords - 1;
-            else
-                --wordndx[selected];
-            // If we've returned to the original there are no choices.
-            if (wordndx[selected] == wordndx0)
-                break;
-        } while (prefix(wordndx[selected]) != prefix0 ||
-                 current(wordndx[selected]) == curr0);
+        wordndx[selected] = wordlist_prev_distinct(wordlist, wordndx[selected], pos);
     }
 
     void word_up() {
         // Find the next word that differs in the cursor position.
-        int wordndx0 = wordndx[selected];	// remember starting wordndx
-        String prefix0 = prefix(wordndx[selected]);
-        char curr0 = current(wordndx[selected]);
-        do {
-            if (wordndx[selected] == (nrefwords - 1))
-                wordndx[selected] = 0;
-            else
-                ++wordndx[selected];
-            // If we've returned to the original there are no choices.
-            if (wordndx[selected] == wordndx0)
-                break;
-        } while (prefix(wordndx[selected]) != prefix0 ||
-                 current(wordndx[selected]) == curr0);
-    }
-
-    String prefix(int word) {
-        return refword(word).substring(0, pos);
-    }
-
-    char current(int word) {
-        return refword(word)[pos];
+        wordndx[selected] = wordlist_next_distinct(wordlist, wordndx[selected], pos);
     }
 
     bool unique_match() {
-        // Does the previous word also match?
-        if (wordndx[selected] > 0)
-            if (prefix(wordndx[selected] - 1) == prefix(wordndx[selected]))
-                return false;
-        // Does the next word also match?
-        if (wordndx[selected] < (nrefwords - 1))
-            if (prefix(wordndx[selected] + 1) == prefix(wordndx[selected]))
-                return false;
-        return true;
+        return wordlist_unique_prefix(wordlist, wordndx[selected], pos);
     }
 };
 
 struct SSKRWordlistState : WordListState {
-    SSKRWordlistState(int i_nwords) : WordListState(i_nwords, 1024) {}
-    virtual String refword(int ndx) {
-        char wrd[5];
-        bytewords_get_word(ndx, wrd);
-        return String(wrd);
-    }
+    SSKRWordlistState(int i_nwords) : WordListState(i_nwords, WORDLIST_BYTEWORDS) {}
 };
 
 struct BIP39WordlistState : WordListState {
     BIP39Seq * bip39;
     BIP39WordlistState(BIP39Seq * i_bip39, int i_nwords)
-        : WordListState(i_nwords, 2048)
+        : WordListState(i_nwords, WORDLIST_BIP39)
         , bip39(i_bip39)
     {}
-    virtual String refword(int ndx) {
-        return BIP39Seq::get_dict_string(ndx);
-    }
 };
 
 
@@ -1395,23 +1741,23 @@ bool complete_bip39_checksum(void) {
     g_display->firstPage();
     do
     {
-        g_display->setPartialWindow(0, 0, 200, 200);
+        set_partial_window(0, 0, 200, 200);
         // g_display->fillScreen(GxEPD_WHITE);
         g_display->setTextColor(GxEPD_BLACK);
 
         int xx = xoff;
         int yy = yoff + (H_FSB9 + YM_FSB9);
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         g_display->setCursor(xx, yy);
         display_printf("    Complete BIP39 \n          sentence?");
         yy += H_FSB9 + YM_FSB9+20;
 
-        g_display->setFont(&FreeMono9pt7b);
+        set_font(&FreeMono9pt7b);
         g_display->setCursor(xx, yy);
         display_long_text(yy, "Confirm only if  your words were  generated by a   random procedure,i.e. tossing coi-ns.");
 
         yy = 195; // Absolute, stuck to bottom
-        g_display->setFont(&FreeMono9pt7b);
+        set_font(&FreeMono9pt7b);
         String right_option = "Ok #";
         int x_r = text_right(right_option.c_str());
         g_display->setCursor(x_r, yy);
@@ -1424,10 +1770,7 @@ bool complete_bip39_checksum(void) {
     while (g_display->nextPage());
 
     while (true) {
-        char key;
-        do {
-            key = g_keypad.getKey();
-        } while (key == NO_KEY);
+        char key = wait_for_key();
         switch (key) {
         case '*':
             return false;
@@ -1447,24 +1790,24 @@ bool warning_bip39_checksum(void) {
     g_display->firstPage();
     do
     {
-        g_display->setPartialWindow(0, 0, 200, 200);
+        set_partial_window(0, 0, 200, 200);
         // g_display->fillScreen(GxEPD_WHITE);
         g_display->setTextColor(GxEPD_BLACK);
 
         int xx = xoff;
         int yy = yoff + (H_FSB9 + YM_FSB9);
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         Point p = text_center("Warning");
         g_display->setCursor(p.x, yy);
         display_printf("Warning");
         yy += H_FSB9 + YM_FSB9+20;
 
-        g_display->setFont(&FreeMono9pt7b);
+        set_font(&FreeMono9pt7b);
         g_display->setCursor(xx, yy);
         display_long_text(yy, "Have you updated the last word on your sheet to ma-tch the one gene-rated by Lethe-\n Kit?");
 
         yy = 195; // Absolute, stuck to bottom
-        g_display->setFont(&FreeMono9pt7b);
+        set_font(&FreeMono9pt7b);
         String right_option = "Yes #";
         int x_r = text_right(right_option.c_str());
         g_display->setCursor(x_r, yy);
@@ -1476,11 +1819,10 @@ bool warning_bip39_checksum(void) {
     }
     while (g_display->nextPage());
 
+    // Only a key pressed after reading the question answers it.
+    hw_key_flush();
     while (true) {
-        char key;
-        do {
-            key = g_keypad.getKey();
-        } while (key == NO_KEY);
+        char key = wait_for_key();
         switch (key) {
         case '*':
             return false;
@@ -1492,98 +1834,216 @@ bool warning_bip39_checksum(void) {
     }
 }
 
-void restore_bip39() {
-    BIP39WordlistState state(g_bip39, BIP39Seq::WORD_COUNT);
-    state.set_words((uint16_t *)NULL);
+/**
+ * Lets the user pick the last BIP39 word among the words giving a
+ * valid checksum with the other words.  Returns false if cancelled.
+ */
+bool pick_last_bip39_word(uint16_t const * words, uint16_t & io_word) {
+    uint16_t choices[BIP39Seq::LAST_WORD_CHOICES];
+    int const nchoices = BIP39Seq::LAST_WORD_CHOICES;
+    BIP39Seq::valid_last_words(words, choices);
+
+    // Start on the current word if it's valid, otherwise on the first
+    // valid word following it.
+    int selected = 0;
+    while (selected < nchoices - 1 && choices[selected] < io_word)
+        ++selected;
 
     while (true) {
         int const xoff = 12;
         int const yoff = 0;
+        int const nrows = 5;
 
-        state.compute_scroll();
-
-        g_display->firstPage();
-        do
-        {
-            g_display->setPartialWindow(0, 0, 200, 200);
-            // g_display->fillScreen(GxEPD_WHITE);
-            g_display->setTextColor(GxEPD_BLACK);
+        int scroll;
+        if (selected < 3)
+            scroll = 0;
+        else if (selected > nchoices - 3)
+            scroll = nchoices - nrows;
+        else
+            scroll = selected - 2;
 
-            int xx = xoff;
-            int yy = yoff + (H_FSB9 + YM_FSB9);
-            g_display->setFont(&FreeSansBold9pt7b);
-            g_display->setCursor(xx, yy);
-            display_printf("BIP39 Mnemonic");
-            yy += H_FSB9 + YM_FSB9;
+        if (!hw_key_pending()) {
+            g_display->firstPage();
+            do
+            {
+                set_partial_window(0, 0, 200, 200);
+                g_display->fillScreen(GxEPD_WHITE);
+                g_display->setTextColor(GxEPD_BLACK);
 
-            g_display->setFont(&FreeMonoBold12pt7b);
-            yy += 2;
+                int xx = xoff;
+                int yy = yoff + (H_FSB9 + YM_FSB9);
+                set_font(&FreeSansBold9pt7b);
+                g_display->setCursor(xx, yy);
+                display_printf("Last Word %d/%d", selected+1, nchoices);
+                yy += H_FSB9 + YM_FSB9;
 
-            for (int rr = 0; rr < state.nrows; ++rr) {
-                int wndx = state.scroll + rr;
-                String word = state.refword(state.wordndx[wndx]);
-                Serial.println(String(wndx) + " " + word);
+                set_font(&FreeMonoBold12pt7b);
+                yy += 2;
 
-                if (wndx != state.selected) {
-                    // Regular entry, not being edited
+                for (int rr = 0; rr < nrows; ++rr) {
+                    int cndx = scroll + rr;
+                    const char * word = wordlist_word(WORDLIST_BIP39, choices[cndx]);
                     g_display->setTextColor(GxEPD_BLACK);
-                    g_display->setCursor(xx, yy);
-                    display_printf("%2d %s\n", wndx+1, word.c_str());
-                } else {
-                    // Edited entry
-                    if (state.unique_match()) {
-                        // Unique, highlight entire word.
+                    if (cndx == selected) {
                         g_display->fillRect(xx - 1,
                                            yy - H_FMB12 + YM_FMB12,
-                                           W_FMB12 * (word.length() + 3) + 3,
+                                           W_FMB12 * (strlen(word) + 3) + 3,
                                            H_FMB12 + YM_FMB12,
                                            GxEPD_BLACK);
-
                         g_display->setTextColor(GxEPD_WHITE);
-                        g_display->setCursor(xx, yy);
+                    }
+                    g_display->setCursor(xx, yy);
+                    display_printf("%2d %s\n", (int)BIP39Seq::WORD_COUNT, word);
+                    yy += H_FMB12 + YM_FMB12;
+                }
 
-                        display_printf("%2d %s\n", wndx+1, word.c_str());
+                // bottom-relative position
+                xx = xoff;
+                yy = Y_MAX - 2*(H_FSB9) + 2;
+                set_font(&FreeSansBold9pt7b);
+                g_display->setTextColor(GxEPD_BLACK);
+                g_display->setCursor(xx, yy);
+                g_display->println("1,7-Up,Down 4,6-Letter");
+                yy += H_FSB9 + 2;
+                g_display->setCursor(xx, yy);
+                g_display->println("*-Cancel #-Select");
+            }
+            while (g_display->nextPage());
+        }
 
-                    } else {
-                        // Not unique, highlight cursor.
-                        g_display->setTextColor(GxEPD_BLACK);
-                        g_display->setCursor(xx, yy);
+        char key = wait_for_key();
+        LOG_DEBUG("pick_last_bip39_word saw %c\n", key);
+        char letter = wordlist_word(WORDLIST_BIP39, choices[selected])[0];
+        switch (key) {
+        case '1':
+            selected = selected == 0 ? nchoices - 1 : selected - 1;
+            break;
+        case '7':
+            selected = selected == nchoices - 1 ? 0 : selected + 1;
+            break;
+        case '4':
+            // First word of the previous letter.
+            while (selected > 0 &&
+                   wordlist_word(WORDLIST_BIP39, choices[selected])[0] == letter)
+                --selected;
+            letter = wordlist_word(WORDLIST_BIP39, choices[selected])[0];
+            while (selected > 0 &&
+                   wordlist_word(WORDLIST_BIP39, choices[selected - 1])[0] == letter)
+                --selected;
+            break;
+        case '6':
+            // First word of the next letter.
+            while (selected < nchoices - 1 &&
+                   wordlist_word(WORDLIST_BIP39, choices[selected])[0] == letter)
+                ++selected;
+            break;
+        case '*':
+            return false;
+        case '#':
+            io_word = choices[selected];
+            return true;
+        default:
+            break;
+        }
+    }
+}
 
-                        display_printf("%2d %s\n", wndx+1, word.c_str());
+void restore_bip39() {
+    BIP39WordlistState state(g_bip39, BIP39Seq::WORD_COUNT);
+    state.set_words((uint16_t *)NULL);
 
-                        g_display->fillRect(xx + (state.pos+3)*W_FMB12,
-                                           yy - H_FMB12 + YM_FMB12,
-                                           W_FMB12,
-                                           H_FMB12 + YM_FMB12,
-                                           GxEPD_BLACK);
+    while (true) {
+        int const xoff = 12;
+        int const yoff = 0;
 
-                        g_display->setTextColor(GxEPD_WHITE);
-                        g_display->setCursor(xx + (state.pos+3)*W_FMB12, yy);
-                        display_printf("%c", word.c_str()[state.pos]);
+        state.compute_scroll();
+
+        // Keys queued while the panel was refreshing are applied
+        // first, so a burst of key presses costs a single redraw.
+        if (!hw_key_pending()) {
+            g_display->firstPage();
+            do
+            {
+                set_partial_window(0, 0, 200, 200);
+                // g_display->fillScreen(GxEPD_WHITE);
+                g_display->setTextColor(GxEPD_BLACK);
+
+                int xx = xoff;
+                int yy = yoff + (H_FSB9 + YM_FSB9);
+                set_font(&FreeSansBold9pt7b);
+                g_display->setCursor(xx, yy);
+                display_printf("BIP39 Mnemonic");
+                yy += H_FSB9 + YM_FSB9;
+
+                set_font(&FreeMonoBold12pt7b);
+                yy += 2;
+
+                for (int rr = 0; rr < state.nrows; ++rr) {
+                    int wndx = state.scroll + rr;
+                    const char * word = state.refword(state.wordndx[wndx]);
+                    LOG_TRACE("%d %s\n", wndx, word);
+
+                    if (wndx != state.selected) {
+                        // Regular entry, not being edited
+                        g_display->setTextColor(GxEPD_BLACK);
+                        g_display->setCursor(xx, yy);
+                        display_printf("%2d %s\n", wndx+1, word);
+                    } else {
+                        // Edited entry
+                        if (state.unique_match()) {
+                            // Unique, highlight entire word.
+                            g_display->fillRect(xx - 1,
+                                               yy - H_FMB12 + YM_FMB12,
+                                               W_FMB12 * (strlen(word) + 3) + 3,
+                                               H_FMB12 + YM_FMB12,
+                                               GxEPD_BLACK);
+
+                            g_display->setTextColor(GxEPD_WHITE);
+                            g_display->setCursor(xx, yy);
+
+                            display_printf("%2d %s\n", wndx+1, word);
+
+                        } else {
+                            // Not unique, highlight cursor.
+                            g_display->setTextColor(GxEPD_BLACK);
+                            g_display->setCursor(xx, yy);
+
+                            display_printf("%2d %s\n", wndx+1, word);
+
+                            g_display->fillRect(xx + (state.pos+3)*W_FMB12,
+                                               yy - H_FMB12 + YM_FMB12,
+                                               W_FMB12,
+                                               H_FMB12 + YM_FMB12,
+                                               GxEPD_BLACK);
+
+                            g_display->setTextColor(GxEPD_WHITE);
+                            g_display->setCursor(xx + (state.pos+3)*W_FMB12, yy);
+                            display_printf("%c", word[state.pos]);
+                        }
                     }
+
+                    yy += H_FMB12 + YM_FMB12;
                 }
 
-                yy += H_FMB12 + YM_FMB12;
+                // bottom-relative position
+                xx = xoff;
+                yy = Y_MAX - 2*(H_FSB9) + 2;
+                set_font(&FreeSansBold9pt7b);
+                g_display->setTextColor(GxEPD_BLACK);
+                g_display->setCursor(xx, yy);
+                g_display->println("4,6-L,R 2,8-chr-,chr+");
+                yy += H_FSB9 + 2;
+                g_display->setCursor(xx, yy);
+                if (state.selected == state.nwords - 1)
+                    g_display->println("1,7-U,D C-Valid #-Done");
+                else
+                    g_display->println("1,7-Up,Down #-Done");
             }
-
-            // bottom-relative position
-            xx = xoff;
-            yy = Y_MAX - 2*(H_FSB9) + 2;
-            g_display->setFont(&FreeSansBold9pt7b);
-            g_display->setTextColor(GxEPD_BLACK);
-            g_display->setCursor(xx, yy);
-            g_display->println("4,6-L,R 2,8-chr-,chr+");
-            yy += H_FSB9 + 2;
-            g_display->setCursor(xx, yy);
-            g_display->println("1,7-Up,Down #-Done");
+            while (g_display->nextPage());
         }
-        while (g_display->nextPage());
 
-        char key;
-        do {
-            key = g_keypad.getKey();
-        } while (key == NO_KEY);
-        Serial.println("restore bip39 saw " + String(key));
+        char key = wait_for_key();
+        LOG_DEBUG("restore bip39 saw %c\n", key);
         switch (key) {
         case '1':
             state.select_prev();
@@ -1603,16 +2063,26 @@ void restore_bip39() {
         case '8':
             state.word_up();
             break;
+        case 'C':
+            // Pick the last word among the ones with a valid checksum.
+            if (state.selected == state.nwords - 1) {
+                uint16_t words[BIP39Seq::WORD_COUNT];
+                state.get_words(words);
+                if (pick_last_bip39_word(words, words[state.selected])) {
+                    state.wordndx[state.selected] = words[state.selected];
+                    state.pos = 0;
+                }
+            }
+            break;
         case 'D':
             // If 'D' and then '0' are typed, fill dummy data.
-            do {
-                key = g_keypad.getKey();
-            } while (key == NO_KEY);
-            Serial.println("restore bip39_D saw " + String(key));
+            key = wait_for_key();
+            LOG_DEBUG("restore bip39_D saw %c\n", key);
             switch (key) {
             case '0':
-                Serial.println("Loading dummy bip39 data");
-                state.set_words(selftest_dummy_bip39());
+                LOG_DEBUG("Loading dummy bip39 data\n");
+                if (selftest_dummy_bip39())
+                    state.set_words(selftest_dummy_bip39());
                 break;
             default:
                 break;
@@ -1692,18 +2162,18 @@ void restore_sskr() {
             scroll = g_sskr_restore->numshares() + 2 - disprows;
         else
             scroll = selected - 2;
-        serial_printf("scroll = %d\n", scroll);
+        LOG_DEBUG("scroll = %d\n", scroll);
 
         g_display->firstPage();
         do
         {
-            g_display->setPartialWindow(0, 0, 200, 200);
+            set_partial_window(0, 0, 200, 200);
             // g_display->fillScreen(GxEPD_WHITE);
             g_display->setTextColor(GxEPD_BLACK);
 
             int xx = xoff;
             int yy = yoff + (H_FSB9 + YM_FSB9);
-            g_display->setFont(&FreeSansBold9pt7b);
+            set_font(&FreeSansBold9pt7b);
             g_display->setCursor(xx, yy);
             g_display->println("Enter SSKR Shares");
             yy += H_FSB9 + YM_FSB9;
@@ -1711,7 +2181,7 @@ void restore_sskr() {
             xx = xoff + 20;
             yy += 16;
 
-            g_display->setFont(&FreeMonoBold12pt7b);
+            set_font(&FreeMonoBold12pt7b);
             for (int rr = 0; rr < disprows; ++rr) {
                 int sharendx = scroll + rr;
                 char buffer[32];
@@ -1743,17 +2213,14 @@ void restore_sskr() {
             // bottom-relative position
             xx = xoff + 2;
             yy = Y_MAX - (H_FSB9) + 2;
-            g_display->setFont(&FreeSansBold9pt7b);
+            set_font(&FreeSansBold9pt7b);
             g_display->setCursor(xx, yy);
             g_display->println("1,7-Up,Down #-Do");
         }
         while (g_display->nextPage());
 
-        char key;
-        do {
-            key = g_keypad.getKey();
-        } while (key == NO_KEY);
-        Serial.println("restore_sskr saw " + String(key));
+        char key = wait_for_key();
+        LOG_DEBUG("restore_sskr saw %c\n", key);
         switch (key) {
         case '1':
             if (selected > 0)
@@ -1789,9 +2256,33 @@ void restore_sskr() {
                 for (size_t ii = 0; ii < g_sskr_restore->numshares(); ++ii) {
                     String strings =
                         g_sskr_restore->get_share_strings(ii);
-                    serial_printf("%d %s\n", ii+1, strings.c_str());
+                    LOG_TRACE("%d %s\n", (int) ii+1, strings.c_str());
                 }
                 Seed * seed = g_sskr_restore->restore_seed();
+                if (!seed) {
+                    // A bad share among more than threshold shares
+                    // can be found by recombining subsets.
+                    size_t outliers[SSKRShareSeq::MAX_SHARES];
+                    size_t noutliers;
+                    seed = g_sskr_restore->restore_seed_majority(outliers, noutliers);
+                    if (seed && noutliers > 0) {
+                        String bad;
+                        for (size_t ii = 0; ii < noutliers; ++ii) {
+                            if (ii > 0)
+                                bad += ",";
+                            bad += String(outliers[ii] + 1);
+                        }
+                        String lines[7];
+                        size_t nlines = 0;
+                        lines[nlines++] = "SSKR Restored";
+                        lines[nlines++] = "";
+                        lines[nlines++] = "These shares are";
+                        lines[nlines++] = "bad: " + bad;
+                        lines[nlines++] = "";
+                        lines[nlines++] = "Press # to continue";
+                        interstitial_error(lines, nlines);
+                    }
+                }
                 if (!seed) {
                     int err = g_sskr_restore->last_restore_error();
                     String lines[7];
@@ -1823,113 +2314,277 @@ void restore_sskr() {
 }
 
 
-void enter_share() {
-    SSKRWordlistState state(SSKRShareSeq::WORDS_PER_SHARE);
-    state.set_words(g_sskr_restore->get_share(g_restore_sskr_selected));
-
-    // We currently support only 16 byte seed so the first 4 words are always the same.
-    state.wordndx[0] = 0xd8 + 1;  // 'tuna'
-    state.wordndx[1] = 0x00 + 1;  // 'acid'
-    state.wordndx[2] = 0x30 + 5;  // 'epic'
-    state.wordndx[3] = 0x50 + 5;  // 'gyro'
+// Letters on the keys, phone style.
+const char * const T9_LETTERS[10] = {
+    "", "", "abc", "def", "ghi", "jkl", "mno", "pqrs", "tuv", "wxyz"
+};
 
-    if (g_restore_sskr_selected > 0) {
-        // words 4-7 are the same acrross all shares
-        const uint8_t * share_ = g_sskr_restore->get_share(0);
-        state.wordndx[4] = share_[4];
-        state.wordndx[5] = share_[5];
-        state.wordndx[6] = share_[6];
-        state.wordndx[7] = share_[7];
+// At most 9 bytewords share the keys of their first and last letters.
+size_t const MAX_T9_BYTEWORDS = 9;
+
+// Finds the bytewords with the first letter on first_key and the last
+// letter on last_key, in alphabetical order of first letter.
+size_t t9_bytewords(char first_key, char last_key, uint16_t * o_words) {
+    size_t count = 0;
+    for (const char * ff = T9_LETTERS[first_key - '0']; *ff; ++ff) {
+        for (const char * ll = T9_LETTERS[last_key - '0']; *ll; ++ll) {
+            int ndx = wordlist_byteword_from_letters(*ff, *ll);
+            if (ndx >= 0) {
+                serial_assert(count < MAX_T9_BYTEWORDS);
+                o_words[count++] = ndx;
+            }
+        }
     }
+    return count;
+}
+
+/**
+ * Fast share entry: a byteword is entered by the keys of its first and
+ * last letters, plus a digit to pick among the few bytewords sharing
+ * these keys.  Moves on to the next word after each word, returns
+ * after the last word or when the user leaves.
+ */
+void enter_share_fast(SSKRWordlistState & state) {
+    enum { FIRST_LETTER, LAST_LETTER, PICK_WORD } stage = FIRST_LETTER;
+    char first_key = 0;
+    uint16_t candidates[MAX_T9_BYTEWORDS];
+    size_t ncandidates = 0;
 
     while (true) {
         int const xoff = 12;
         int const yoff = 0;
 
-        state.compute_scroll();
+        if (!hw_key_pending()) {
+            g_display->firstPage();
+            do
+            {
+                set_partial_window(0, 0, 200, 200);
+                g_display->fillScreen(GxEPD_WHITE);
+                g_display->setTextColor(GxEPD_BLACK);
 
-        g_display->firstPage();
-        do
-        {
-            g_display->setPartialWindow(0, 0, 200, 200);
-            // g_display->fillScreen(GxEPD_WHITE);
-            g_display->setTextColor(GxEPD_BLACK);
+                int xx = xoff;
+                int yy = yoff + (H_FSB9 + YM_FSB9);
+                set_font(&FreeSansBold9pt7b);
+                g_display->setCursor(xx, yy);
+                display_printf("SSKR Share %d", g_restore_sskr_selected+1);
+                yy += H_FSB9 + YM_FSB9;
 
-            int xx = xoff;
-            int yy = yoff + (H_FSB9 + YM_FSB9);
-            g_display->setFont(&FreeSansBold9pt7b);
-            g_display->setCursor(xx, yy);
-            display_printf("SSKR Share %d", g_restore_sskr_selected+1);
-            yy += H_FSB9 + YM_FSB9;
+                set_font(&FreeMonoBold12pt7b);
+                yy += 2;
+                g_display->setCursor(xx, yy);
+                display_printf("%2d %s", state.selected+1,
+                               state.refword(state.wordndx[state.selected]));
+                yy += H_FMB12 + YM_FMB12;
+
+                set_font(&FreeMonoBold9pt7b);
+                g_display->setCursor(xx, yy);
+                switch (stage) {
+                case FIRST_LETTER:
+                    display_printf("First letter?");
+                    break;
+                case LAST_LETTER:
+                    display_printf("First %s, last?", T9_LETTERS[first_key - '0']);
+                    break;
+                case PICK_WORD:
+                    display_printf("Pick word:");
+                    break;
+                }
+                yy += H_FMB9 + YM_FMB9 + 4;
+
+                if (stage == PICK_WORD) {
+                    // Two columns of candidates.
+                    for (size_t ii = 0; ii < ncandidates; ++ii) {
+                        g_display->setCursor(xx + (ii % 2) * 90,
+                                             yy + (ii / 2) * (H_FMB9 + YM_FMB9));
+                        display_printf("%d %s", (int)ii+1,
+                                       wordlist_word(WORDLIST_BYTEWORDS, candidates[ii]));
+                    }
+                } else {
+                    g_display->setCursor(xx, yy);
+                    display_printf("2abc 3def 4ghi");
+                    yy += H_FMB9 + YM_FMB9;
+                    g_display->setCursor(xx, yy);
+                    display_printf("5jkl 6mno 7pqrs");
+                    yy += H_FMB9 + YM_FMB9;
+                    g_display->setCursor(xx, yy);
+                    display_printf("8tuv 9wxyz");
+                }
+
+                // bottom-relative position
+                xx = xoff;
+                yy = Y_MAX - 2*(H_FSB9) + 2;
+                set_font(&FreeSansBold9pt7b);
+                g_display->setTextColor(GxEPD_BLACK);
+                g_display->setCursor(xx, yy);
+                g_display->println("A,B-Prev,Next word");
+                yy += H_FSB9 + 2;
+                g_display->setCursor(xx, yy);
+                g_display->println("*-Back to list");
+            }
+            while (g_display->nextPage());
+        }
 
-            g_display->setFont(&FreeMonoBold12pt7b);
-            yy += 2;
+        char key = wait_for_key();
+        LOG_DEBUG("enter_share_fast saw %c\n", key);
+        switch (key) {
+        case 'A':
+            state.select_prev();
+            stage = FIRST_LETTER;
+            break;
+        case 'B':
+            state.select_next();
+            stage = FIRST_LETTER;
+            break;
+        case '*':
+            return;
+        case '1': case '2': case '3':
+        case '4': case '5': case '6':
+        case '7': case '8': case '9':
+            if (stage == FIRST_LETTER) {
+                if (key != '1') {
+                    first_key = key;
+                    stage = LAST_LETTER;
+                }
+                break;
+            }
+            if (stage == LAST_LETTER) {
+                if (key == '1')
+                    break;
+                ncandidates = t9_bytewords(first_key, key, candidates);
+                if (ncandidates == 0) {
+                    stage = FIRST_LETTER;	// no such word, start over
+                    break;
+                }
+                stage = PICK_WORD;
+                if (ncandidates > 1)
+                    break;
+                key = '1';	// only one word, nothing to pick
+            }
+            if ((size_t) (key - '1') >= ncandidates)
+                break;
+            state.wordndx[state.selected] = candidates[key - '1'];
+            stage = FIRST_LETTER;
+            if (state.selected == state.nwords - 1)
+                return;
+            state.select_next();
+            break;
+        default:
+            break;
+        }
+    }
+}
 
-            for (int rr = 0; rr < state.nrows; ++rr) {
-                int wndx = state.scroll + rr;
-                String word = state.refword(state.wordndx[wndx]);
-                Serial.println(String(wndx) + " " + word);
+void enter_share() {
+    SSKRWordlistState state(SSKRShareSeq::WORDS_PER_SHARE);
 
-                if (wndx != state.selected) {
-                    // Regular entry, not being edited
-                    g_display->setTextColor(GxEPD_BLACK);
-                    g_display->setCursor(xx, yy);
-                    display_printf("%2d %s\n", wndx+1, word.c_str());
-                } else {
-                    // Edited entry
-                    if (state.unique_match()) {
-                        // Unique, highlight entire word.
-                        g_display->fillRect(xx - 1,
-                                           yy - H_FMB12 + YM_FMB12,
-                                           W_FMB12 * (word.length() + 3) + 3,
-                                           H_FMB12 + YM_FMB12,
-                                           GxEPD_BLACK);
+    // Start from the words of the share, a new share is all zeros so
+    // this also fills in the header words, which depend only on the
+    // seed size.
+    uint8_t words[SSKRShareSeq::WORDS_PER_SHARE];
+    g_sskr_restore->get_share_words(g_restore_sskr_selected, words);
+
+    uint8_t const empty_share[SSKRShareSeq::BYTES_PER_SHARE] = {0};
+    if (g_restore_sskr_selected > 0 &&
+        memcmp(g_sskr_restore->get_share(g_restore_sskr_selected),
+               empty_share, sizeof(empty_share)) == 0) {
+        // The identifier and threshold words following the header are
+        // the same across all shares.
+        uint8_t first[SSKRShareSeq::WORDS_PER_SHARE];
+        g_sskr_restore->get_share_words(0, first);
+        memcpy(words + SSKRShareSeq::HEADER_WORDS,
+               first + SSKRShareSeq::HEADER_WORDS, 4);
+    }
+    state.set_words(words);
 
-                        g_display->setTextColor(GxEPD_WHITE);
-                        g_display->setCursor(xx, yy);
+    while (true) {
+        int const xoff = 12;
+        int const yoff = 0;
 
-                        display_printf("%2d %s\n", wndx+1, word.c_str());
+        state.compute_scroll();
 
-                    } else {
-                        // Not unique, highlight cursor.
-                        g_display->setTextColor(GxEPD_BLACK);
-                        g_display->setCursor(xx, yy);
+        // Keys queued while the panel was refreshing are applied
+        // first, so a burst of key presses costs a single redraw.
+        if (!hw_key_pending()) {
+            g_display->firstPage();
+            do
+            {
+                set_partial_window(0, 0, 200, 200);
+                // g_display->fillScreen(GxEPD_WHITE);
+                g_display->setTextColor(GxEPD_BLACK);
 
-                        display_printf("%2d %s\n", wndx+1, word.c_str());
+                int xx = xoff;
+                int yy = yoff + (H_FSB9 + YM_FSB9);
+                set_font(&FreeSansBold9pt7b);
+                g_display->setCursor(xx, yy);
+                display_printf("SSKR Share %d", g_restore_sskr_selected+1);
+                yy += H_FSB9 + YM_FSB9;
 
-                        g_display->fillRect(xx + (state.pos+3)*W_FMB12,
-                                           yy - H_FMB12 + YM_FMB12,
-                                           W_FMB12,
-                                           H_FMB12 + YM_FMB12,
-                                           GxEPD_BLACK);
+                set_font(&FreeMonoBold12pt7b);
+                yy += 2;
 
-                        g_display->setTextColor(GxEPD_WHITE);
-                        g_display->setCursor(xx + (state.pos+3)*W_FMB12, yy);
-                        display_printf("%c", word.c_str()[state.pos]);
+                for (int rr = 0; rr < state.nrows; ++rr) {
+                    int wndx = state.scroll + rr;
+                    const char * word = state.refword(state.wordndx[wndx]);
+                    LOG_TRACE("%d %s\n", wndx, word);
+
+                    if (wndx != state.selected) {
+                        // Regular entry, not being edited
+                        g_display->setTextColor(GxEPD_BLACK);
+                        g_display->setCursor(xx, yy);
+                        display_printf("%2d %s\n", wndx+1, word);
+                    } else {
+                        // Edited entry
+                        if (state.unique_match()) {
+                            // Unique, highlight entire word.
+                            g_display->fillRect(xx - 1,
+                                               yy - H_FMB12 + YM_FMB12,
+                                               W_FMB12 * (strlen(word) + 3) + 3,
+                                               H_FMB12 + YM_FMB12,
+                                               GxEPD_BLACK);
+
+                            g_display->setTextColor(GxEPD_WHITE);
+                            g_display->setCursor(xx, yy);
+
+                            display_printf("%2d %s\n", wndx+1, word);
+
+                        } else {
+                            // Not unique, highlight cursor.
+                            g_display->setTextColor(GxEPD_BLACK);
+                            g_display->setCursor(xx, yy);
+
+                            display_printf("%2d %s\n", wndx+1, word);
+
+                            g_display->fillRect(xx + (state.pos+3)*W_FMB12,
+                                               yy - H_FMB12 + YM_FMB12,
+                                               W_FMB12,
+                                               H_FMB12 + YM_FMB12,
+                                               GxEPD_BLACK);
+
+                            g_display->setTextColor(GxEPD_WHITE);
+                            g_display->setCursor(xx + (state.pos+3)*W_FMB12, yy);
+                            display_printf("%c", word[state.pos]);
+                        }
                     }
+
+                    yy += H_FMB12 + YM_FMB12;
                 }
 
-                yy += H_FMB12 + YM_FMB12;
+                // bottom-relative position
+                xx = xoff;
+                yy = Y_MAX - 2*(H_FSB9) + 2;
+                set_font(&FreeSansBold9pt7b);
+                g_display->setTextColor(GxEPD_BLACK);
+                g_display->setCursor(xx, yy);
+                g_display->println("4,6-L,R 2,8-chr-,chr+");
+                yy += H_FSB9 + 2;
+                g_display->setCursor(xx, yy);
+                g_display->println("1,7-Up,Down C-Fast #-Done");
             }
-
-            // bottom-relative position
-            xx = xoff;
-            yy = Y_MAX - 2*(H_FSB9) + 2;
-            g_display->setFont(&FreeSansBold9pt7b);
-            g_display->setTextColor(GxEPD_BLACK);
-            g_display->setCursor(xx, yy);
-            g_display->println("4,6-L,R 2,8-chr-,chr+");
-            yy += H_FSB9 + 2;
-            g_display->setCursor(xx, yy);
-            g_display->println("1,7-Up,Down #-Done");
+            while (g_display->nextPage());
         }
-        while (g_display->nextPage());
 
-        char key;
-        do {
-            key = g_keypad.getKey();
-        } while (key == NO_KEY);
-        Serial.println("enter_share saw " + String(key));
+        char key = wait_for_key();
+        LOG_DEBUG("enter_share saw %c\n", key);
         switch (key) {
         case '1':
             state.select_prev();
@@ -1949,16 +2604,22 @@ void enter_share() {
         case '8':
             state.word_up();
             break;
+        case 'C':
+            enter_share_fast(state);
+            break;
         case 'D':   // TESTING
-            do {
-                key = g_keypad.getKey();
-            } while (key == NO_KEY);
-            Serial.println("enter_share_D saw " + String(key));
+            key = wait_for_key();
+            LOG_DEBUG("enter_share_D saw %c\n", key);
             switch (key) {
             case '0':
                 // If 'D' and then '0' are typed, fill with valid dummy data.
-                Serial.println("Loading dummy sskr data");
-                state.set_words(selftest_dummy_sskr((size_t)g_restore_sskr_selected));
+                LOG_DEBUG("Loading dummy sskr data\n");
+                {
+                    uint8_t const * dummy =
+                        selftest_dummy_sskr((size_t)g_restore_sskr_selected);
+                    if (dummy)
+                        state.set_words(dummy);
+                }
                 break;
             default:
                 break;
@@ -1990,11 +2651,46 @@ void enter_share() {
                     lines[nlines++] = "";
                     lines[nlines++] = "Press # to revisit";
                     interstitial_error(lines, nlines);
-                } else {
-                    serial_assert(g_sskr_restore);
-                    g_uistate = RESTORE_SSKR;
-                    return;
+                    break;
+                }
+
+                // Catch a share that can't go with the others now,
+                // rather than when restoring.
+                SSKRShareCheck check =
+                    g_sskr_restore->check_share(g_restore_sskr_selected);
+                if (check != SSKR_SHARE_OK) {
+                    String lines[7];
+                    size_t nlines = 0;
+                    lines[nlines++] = "SSKR Share";
+                    switch (check) {
+                    case SSKR_SHARE_MISMATCH:
+                        lines[nlines++] = "From Other Seed";
+                        lines[nlines++] = "";
+                        lines[nlines++] = "ID or threshold";
+                        lines[nlines++] = "doesn't match";
+                        break;
+                    case SSKR_SHARE_DUPLICATE:
+                        lines[nlines++] = "Duplicate Share";
+                        lines[nlines++] = "";
+                        lines[nlines++] = "Share was already";
+                        lines[nlines++] = "entered";
+                        break;
+                    default:
+                        lines[nlines++] = "Unsupported";
+                        lines[nlines++] = "";
+                        lines[nlines++] = "Single group";
+                        lines[nlines++] = "shares only";
+                        break;
+                    }
+                    lines[nlines++] = "";
+                    lines[nlines++] = "Press # to revisit";
+                    interstitial_error(lines, nlines);
+                    break;
                 }
+
+                serial_assert(g_sskr_restore);
+                g_uistate = RESTORE_SSKR;
+                return;
             }
         default:
             break;
@@ -2011,14 +2707,14 @@ void derivation_path(void) {
       g_display->firstPage();
       do
       {
-          g_display->setPartialWindow(0, 0, 200, 200);
+          set_partial_window(0, 0, 200, 200);
           g_display->fillScreen(GxEPD_WHITE);
           g_display->setTextColor(GxEPD_BLACK);
 
           const char * title = "Set derivation path";
           int yy = 30;
 
-          g_display->setFont(&FreeSansBold9pt7b);
+          set_font(&FreeSansBold9pt7b);
           Point p = text_center(title);
           g_display->setCursor(p.x, yy);
           g_display->println(title);
@@ -2033,7 +2729,7 @@ void derivation_path(void) {
           display_text("D: custom", x_off, yy += 30, pg_derivation_path.is_standard_derivation == false, 0);
 
           yy = 195; // Absolute, stuck to bottom
-          g_display->setFont(&FreeMono9pt7b);
+          set_font(&FreeMono9pt7b);
           String right_option = "Ok #";
           int x_r = text_right(right_option.c_str());
           g_display->setCursor(x_r, yy);
@@ -2045,10 +2741,7 @@ void derivation_path(void) {
       }
       while (g_display->nextPage());
 
-      char key;
-      do {
-          key = g_keypad.getKey();
-      } while (key == NO_KEY);
+      char key = wait_for_key();
 
       switch (key) {
         case '#':
@@ -2060,7 +2753,7 @@ void derivation_path(void) {
         case 'A': {
             pg_derivation_path.std_derivation = SINGLE_NATIVE_SEGWIT;
             pg_derivation_path.is_standard_derivation = true;
-            ret = keystore.save_standard_derivation_path(&pg_derivation_path.std_derivation, network.get_network());
+            ret = keystore.save_standard_derivation_path(&pg_derivation_path.std_derivation, keystore.network.get_network());
             if (ret == false) {
                 g_uistate = ERROR_SCREEN;
                 return;
@@ -2071,7 +2764,7 @@ void derivation_path(void) {
         case 'B': {
             pg_derivation_path.std_derivation = SINGLE_NESTED_SEGWIT;
             pg_derivation_path.is_standard_derivation = true;
-            ret = keystore.save_standard_derivation_path(&pg_derivation_path.std_derivation, network.get_network());
+            ret = keystore.save_standard_derivation_path(&pg_derivation_path.std_derivation, keystore.network.get_network());
             if (ret == false) {
                 g_uistate = ERROR_SCREEN;
                 return;
@@ -2082,7 +2775,7 @@ void derivation_path(void) {
         case 'C': {
             pg_derivation_path.std_derivation = MULTISIG_NATIVE_SEGWIT;
             pg_derivation_path.is_standard_derivation = true;
-            ret = keystore.save_standard_derivation_path(&pg_derivation_path.std_derivation, network.get_network());
+            ret = keystore.save_standard_derivation_path(&pg_derivation_path.std_derivation, keystore.network.get_network());
             if (ret == false) {
                 g_uistate = ERROR_SCREEN;
                 return;
@@ -2114,19 +2807,19 @@ void custom_derivation_path(void) {
       g_display->firstPage();
       do
       {
-          g_display->setPartialWindow(0, 0, 200, 200);
+          set_partial_window(0, 0, 200, 200);
           g_display->fillScreen(GxEPD_WHITE);
           g_display->setTextColor(GxEPD_BLACK);
 
           const char * title = "Enter derivation path";
           int yy = 20;
 
-          g_display->setFont(&FreeSansBold9pt7b);
+          set_font(&FreeSansBold9pt7b);
           Point p = text_center(title);
           g_display->setCursor(p.x, yy);
           g_display->println(title);
 
-          g_display->setFont(&FreeMonoBold12pt7b);
+          set_font(&FreeMonoBold12pt7b);
           g_display->setCursor(x_off, yy + 50);
           g_display->println(path_start + path_entered);
 
@@ -2139,7 +2832,7 @@ void custom_derivation_path(void) {
           g_display->println(is_valid_tip);
 
           yy = 195; // Absolute, stuck to bottom
-          g_display->setFont(&FreeMono9pt7b);
+          set_font(&FreeMono9pt7b);
           String right_option = "Ok #";
           int x_r = text_right(right_option.c_str());
           g_display->setCursor(x_r, yy);
@@ -2161,10 +2854,7 @@ void custom_derivation_path(void) {
       }
       while (g_display->nextPage());
 
-      char key;
-      do {
-          key = g_keypad.getKey();
-      } while (key == NO_KEY);
+      char key = wait_for_key();
 
       switch (key) {
         case '#':
@@ -2214,13 +2904,13 @@ void set_xpub_format() {
     g_display->firstPage();
     do
     {
-        g_display->setPartialWindow(0, 0, 200, 200);
+        set_partial_window(0, 0, 200, 200);
         // g_display->fillScreen(GxEPD_WHITE);
         g_display->setTextColor(GxEPD_BLACK);
 
         int xx = xoff;
         int yy = yoff + (H_FSB9 + YM_FSB9);
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         Point p = text_center(title.c_str());
         g_display->setCursor(p.x, yy);
         g_display->println(title);
@@ -2240,18 +2930,14 @@ void set_xpub_format() {
         // bottom-relative position
         xx = xoff + 2;
         yy = Y_MAX - (H_FSB9) + 2;
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         g_display->setCursor(xx, yy);
         g_display->println("*-Cancel");
     }
     while (g_display->nextPage());
 
-    char key;
-    do {
-        key = g_keypad.getKey();
-    } while (key == NO_KEY);
+    char key = wait_for_key();
     g_uistate = DISPLAY_KEYS;
-    clear_full_window = false;
     switch (key) {
     case 'A':
         pg_set_xpub_format.current = qr_text;
@@ -2278,13 +2964,13 @@ void set_xpub_options() {
     g_display->firstPage();
     do
     {
-        g_display->setPartialWindow(0, 0, 200, 200);
+        set_partial_window(0, 0, 200, 200);
         // g_display->fillScreen(GxEPD_WHITE);
         g_display->setTextColor(GxEPD_BLACK);
 
         int xx = xoff;
         int yy = yoff + (H_FSB9 + YM_FSB9);
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         String title = "Options";
         Point p = text_center(title.c_str());
         g_display->setCursor(p.x, yy);
@@ -2317,7 +3003,7 @@ void set_xpub_options() {
 
 
         yy = 195; // Absolute, stuck to bottom
-        g_display->setFont(&FreeMono9pt7b);
+        set_font(&FreeMono9pt7b);
         String right_option = "# Done";
         int x_r = text_right(right_option.c_str());
         g_display->setCursor(x_r, yy);
@@ -2329,12 +3015,8 @@ void set_xpub_options() {
     }
     while (g_display->nextPage());
 
-    char key;
-    do {
-        key = g_keypad.getKey();
-    } while (key == NO_KEY);
+    char key = wait_for_key();
     g_uistate = DISPLAY_KEYS;
-    clear_full_window = false;
     switch (key) {
     case 'A':
         if (pg_set_xpub_options.current == 0)
@@ -2362,126 +3044,80 @@ void set_xpub_options() {
 }
 
 void display_keys(void) {
-    ext_key key;
-    String ur_string;
-    String ur_xpriv_string;
-    String ur_xpub_string;
     String encoding_type;
     const int nrows = 5;
     int scroll = 0;
     String derivation_path = keystore.get_derivation_path();
     int scroll_strlen = 17;
-    bool ret;
 
-    ret = keystore.update_root_key(g_bip39->mnemonic_seed, BIP39_SEED_LEN_512);
-    if (ret == false) {
+    // Only derives and encodes when the seed, network, path or format
+    // changed since the last visit.
+    SeedContext::Account const *account = NULL;
+    if (seed_context()->select(keystore))
+        account = seed_context()->account(keystore, pg_set_xpub_options.slip132);
+    if (account == NULL) {
         g_uistate = ERROR_SCREEN;
         return;
     }
 
-    ret = keystore.get_xpriv(&key);
-    if (ret == false) {
-        g_uistate = ERROR_SCREEN;
-        return;
-    }
+    while (true) {
 
-    char *hdkey = NULL;
-    char *xpub = NULL;
-    ret = keystore.xpub_to_base58(&key, &xpub, pg_set_xpub_options.slip132);
-    if (ret == false) {
-        g_uistate = ERROR_SCREEN;
-        return;
-    }
-
-    char *xpriv = NULL;
-    ret = keystore.xpriv_to_base58(&key, &xpriv, pg_set_xpub_options.slip132);
-    if (ret == false) {
-        g_uistate = ERROR_SCREEN;
-        return;
-    }
-
-    ret = ur_encode_hd_pubkey_xpub(ur_xpub_string, keystore.derivation, keystore.derivationLen);
-    if (ret == false) {
-        g_uistate = ERROR_SCREEN;
-        return;
-    }
-
-    ret = ur_encode_hd_pubkey_xpriv(ur_xpriv_string, keystore.derivation, keystore.derivationLen);
-    if (ret == false) {
-        g_uistate = ERROR_SCREEN;
-        return;
-    }
-
-    while (true) {
-
-     if (pg_set_xpub_options.show_private_key) {
-         ur_string = ur_xpriv_string;
-         hdkey = xpriv;
-     }
-     else {
-         ur_string = ur_xpub_string;
-         hdkey = xpub;
+     // The copies may hold the xpriv, they are wiped once the screen
+     // is drawn.  Reserved so they are never reallocated on the way.
+     String const & hdkey = pg_set_xpub_options.show_private_key ?
+         account->xpriv : account->xpub;
+     String ur_string = pg_set_xpub_options.show_private_key ?
+         account->ur_xpriv : account->ur_xpub;
+
+     String hdkey_txt;
+     hdkey_txt.reserve(hdkey.length() + derivation_path.length() + 10);
+     if (pg_set_xpub_options.show_derivation_path) {
+         char fingerprint[9] = {0};
+         sprintf(fingerprint, "%08x", (unsigned int)keystore.fingerprint);
+         hdkey_txt += "[";
+         hdkey_txt += fingerprint;
+         hdkey_txt += derivation_path.substring(1);
+         hdkey_txt += "]";
      }
+     hdkey_txt += hdkey;
 
       g_display->firstPage();
       do
       {
-          g_display->setPartialWindow(0, 0, 200, 200);
+          set_partial_window(0, 0, 200, 200);
           g_display->fillScreen(GxEPD_WHITE);
           g_display->setTextColor(GxEPD_BLACK);
 
           const char * title = pg_set_xpub_options.show_private_key ? "Xpriv": "Xpub";
 
           int yy = 18;
-          g_display->setFont(&FreeSansBold9pt7b);
+          set_font(&FreeSansBold9pt7b);
           Point p = text_center(title);
           g_display->setCursor(p.x, yy);
           g_display->println(title);
 
           switch(pg_set_xpub_format.current) {
             case text:
-                g_display->setFont(&FreeMonoBold9pt7b);
+                set_font(&FreeMonoBold9pt7b);
                 yy += 30;
                 if (pg_set_xpub_options.show_derivation_path) {
-                    char fingerprint[9] = {0};
-                    sprintf(fingerprint, "%08x", (unsigned int)keystore.fingerprint);
-                    String txt = "[" + String(fingerprint) + keystore.get_derivation_path().substring(1) + "]" + String(hdkey);
-                    for (int k = 0; k < nrows; ++k) {
-                        g_display->setCursor(5, yy);
-                        display_printf("%s", txt.substring((k + scroll)*scroll_strlen, (1+k + scroll)*scroll_strlen).c_str());
-                        yy += H_FMB12 + YM_FMB12;
-                    }
+                    display_text_rows(5, yy, hdkey_txt.c_str(), hdkey_txt.length(),
+                                      scroll, nrows, scroll_strlen, H_FMB12 + YM_FMB12);
                 }
                 else {
-                    display_long_text(yy, hdkey);
+                    display_long_text(yy, hdkey_txt);
                 }
                 break;
             case qr_text:
-                if (pg_set_xpub_options.show_derivation_path) {
-                    char fingerprint[9] = {0};
-                    sprintf(fingerprint, "%08x", (unsigned int)keystore.fingerprint);
-                    String fing = "[" + String(fingerprint) + keystore.get_derivation_path().substring(1) + "]" + String(hdkey);
-                    displayQR((char *)fing.c_str());
-                }
-                else {
-                    displayQR(hdkey);
-                }
+                displayQR((char *)hdkey_txt.c_str());
                 break;
             case ur: {
                 int xx = 5;
                 yy = 50;
-                g_display->setFont(&FreeMonoBold9pt7b);
+                set_font(&FreeMonoBold9pt7b);
                 g_display->setCursor(0, yy);
-                int16_t tbx, tby; uint16_t tbw, tbh;
-                size_t i = 0;
-
-                scroll_strlen = 17;
-
-                for (int k = 0; k < nrows; ++k) {
-                    g_display->setCursor(xx, yy);
-                    display_printf("%s", ur_string.substring((k + scroll)*scroll_strlen, (1+k + scroll)*scroll_strlen).c_str());
-                    yy += H_FMB12 + YM_FMB12;
-                }
+                display_text_rows(xx, yy, ur_string.c_str(), ur_string.length(),
+                                  scroll, nrows, scroll_strlen, H_FMB12 + YM_FMB12);
                 }
                 break;
             case qr_ur:
@@ -2493,7 +3129,7 @@ void display_keys(void) {
           }
 
           yy = 195; // Absolute, stuck to bottom
-          g_display->setFont(&FreeMono9pt7b);
+          set_font(&FreeMono9pt7b);
           String right_option = "# Done";
           int x_r = text_right(right_option.c_str());
           g_display->setCursor(x_r, yy);
@@ -2522,23 +3158,16 @@ void display_keys(void) {
       }
       while (g_display->nextPage());
 
-      char key;
-      do {
-          key = g_keypad.getKey();
-      } while (key == NO_KEY);
+      char key = wait_for_key();
+      wipe_string(ur_string);
+      wipe_string(hdkey_txt);
 
       switch (key) {
         case '#':
             g_uistate = SEEDY_MENU;
-            if (xpub != NULL) {
-              wally_free_string(xpub);
-            }
             return;
         case '*':
             g_uistate = SEEDY_MENU;
-            if (xpub != NULL) {
-              wally_free_string(xpub);
-            }
             return;
         case '1':
             if (scroll > 0)
@@ -2571,26 +3200,26 @@ void display_seed(void) {
         return;
     }
 
-    Serial.println(ur_string);
+    LOG_TRACE("%s\n", ur_string.c_str());
 
     while (true) {
       g_display->firstPage();
       do
       {
-          g_display->setPartialWindow(0, 0, 200, 200);
+          set_partial_window(0, 0, 200, 200);
           g_display->fillScreen(GxEPD_WHITE);
           g_display->setTextColor(GxEPD_BLACK);
 
           const char * title = "Seed";
           int yy = 25;
-          g_display->setFont(&FreeSansBold9pt7b);
+          set_font(&FreeSansBold9pt7b);
           Point p = text_center(title);
           g_display->setCursor(p.x, yy);
           g_display->println(title);
 
           switch(pg_set_seed_format.seed_format) {
             case ur:
-                g_display->setFont(&FreeMonoBold9pt7b);
+                set_font(&FreeMonoBold9pt7b);
                 yy+=40;
                 display_long_text(yy, ur_string);
                 break;
@@ -2603,7 +3232,7 @@ void display_seed(void) {
           }
 
           yy = 195; // Absolute, stuck to bottom
-          g_display->setFont(&FreeMono9pt7b);
+          set_font(&FreeMono9pt7b);
           String right_option = "# Done";
           int x_r = text_right(right_option.c_str());
           g_display->setCursor(x_r, yy);
@@ -2620,10 +3249,7 @@ void display_seed(void) {
       }
       while (g_display->nextPage());
 
-      char key;
-      do {
-          key = g_keypad.getKey();
-      } while (key == NO_KEY);
+      char key = wait_for_key();
 
       switch (key) {
         case '#':
@@ -2647,13 +3273,13 @@ void set_seed_format() {
     g_display->firstPage();
     do
     {
-        g_display->setPartialWindow(0, 0, 200, 200);
+        set_partial_window(0, 0, 200, 200);
         // g_display->fillScreen(GxEPD_WHITE);
         g_display->setTextColor(GxEPD_BLACK);
 
         int xx = xoff;
         int yy = yoff + (H_FSB9 + YM_FSB9);
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         Point p = text_center(title.c_str());
         g_display->setCursor(p.x, yy);
         g_display->println(title);
@@ -2667,18 +3293,14 @@ void set_seed_format() {
         // bottom-relative position
         xx = xoff + 2;
         yy = Y_MAX - (H_FSB9) + 2;
-        g_display->setFont(&FreeSansBold9pt7b);
+        set_font(&FreeSansBold9pt7b);
         g_display->setCursor(xx, yy);
         g_display->println("*-Cancel");
     }
     while (g_display->nextPage());
 
-    char key;
-    do {
-        key = g_keypad.getKey();
-    } while (key == NO_KEY);
+    char key = wait_for_key();
     g_uistate = DISPLAY_SEED;
-    clear_full_window = false;
     switch (key) {
     case 'A':
         pg_set_seed_format.seed_format = ur;
@@ -2699,25 +3321,25 @@ void error_screen(void) {
       g_display->firstPage();
       do
       {
-          g_display->setPartialWindow(0, 0, 200, 200);
+          set_partial_window(0, 0, 200, 200);
           g_display->fillScreen(GxEPD_WHITE);
           g_display->setTextColor(GxEPD_BLACK);
 
           const char * title = "Error!";
           int yy = 30;
-          g_display->setFont(&FreeSansBold12pt7b);
+          set_font(&FreeSansBold12pt7b);
           Point p = text_center(title);
           g_display->setCursor(p.x, yy);
           g_display->println(title);
 
           if (g_error_string.length() > 0) {
-              g_display->setFont(&FreeMonoBold9pt7b);
+              set_font(&FreeMonoBold9pt7b);
               g_display->setCursor(0, yy + 40);
               g_display->println(g_error_string);
           }
 
           yy = 195; // Absolute, stuck to bottom
-          g_display->setFont(&FreeMono9pt7b);
+          set_font(&FreeMono9pt7b);
           String right_option = "# Done";
           int x_r = text_right(right_option.c_str());
           g_display->setCursor(x_r, yy);
@@ -2725,10 +3347,7 @@ void error_screen(void) {
       }
       while (g_display->nextPage());
 
-      char key;
-      do {
-          key = g_keypad.getKey();
-      } while (key == NO_KEY);
+      char key = wait_for_key();
 
       switch (key) {
         case '#':
@@ -2748,14 +3367,14 @@ void open_wallet(void) {
       g_display->firstPage();
       do
       {
-          g_display->setPartialWindow(0, 0, 200, 200);
+          set_partial_window(0, 0, 200, 200);
           g_display->fillScreen(GxEPD_WHITE);
           g_display->setTextColor(GxEPD_BLACK);
 
           const char * title = "Wallet: P2WPKH";
           int yy = 25;
 
-          g_display->setFont(&FreeSansBold9pt7b);
+          set_font(&FreeSansBold9pt7b);
           Point p = text_center(title);
           g_display->setCursor(p.x, yy);
           g_display->println(title);
@@ -2768,8 +3387,16 @@ void open_wallet(void) {
           g_display->setCursor(xx, yy);
           g_display->println("B: export");
 
+          yy += 30;
+          g_display->setCursor(xx, yy);
+          g_display->println("C: export all");
+
+          yy += 30;
+          g_display->setCursor(xx, yy);
+          g_display->println("D: sign PSBT");
+
           yy = 195; // Absolute, stuck to bottom
-          g_display->setFont(&FreeMono9pt7b);
+          set_font(&FreeMono9pt7b);
           String right_option = "Ok #";
           int x_r = text_right(right_option.c_str());
           g_display->setCursor(x_r, yy);
@@ -2781,12 +3408,8 @@ void open_wallet(void) {
       }
       while (g_display->nextPage());
 
-      char key;
-      do {
-          key = g_keypad.getKey();
-      } while (key == NO_KEY);
+      char key = wait_for_key();
 
-      clear_full_window = false;
       switch (key) {
         case '#':
             g_uistate = SEEDY_MENU;
@@ -2800,76 +3423,149 @@ void open_wallet(void) {
         case 'B':
             g_uistate = EXPORT_WALLET;
             return;
+        case 'C':
+            g_uistate = EXPORT_ACCOUNTS;
+            return;
+        case 'D':
+            g_uistate = SIGN_PSBT;
+            return;
         default:
             break;
       }
     }
 }
 
+// Derives the receive address indx of the account, as text and ur.
+void derive_address(ext_key const * account, const char * family, uint32_t indx,
+                    String & addr, String & address_ur) {
+    struct ext_key child_key2;
+    char *addr_segwit = NULL;
+    (void)bip32_key_from_parent(account, indx, BIP32_FLAG_KEY_PUBLIC, &child_key2);
+    (void)wally_bip32_key_to_addr_segwit(&child_key2, family, 0, &addr_segwit);
+    addr = addr_segwit;
+
+    // prepare cbor/ur format
+    uint8_t data[100];
+    size_t data_written;
+    address_ur = "";
+    (void)wally_addr_segwit_to_bytes(addr_segwit, family, 0, data, sizeof(data), &data_written);
+    (void)ur_encode_address(keystore, data, data_written, address_ur);
+    wally_free_string(addr_segwit);
+}
+
+/**
+ * While an address is shown the next one is derived in the background,
+ * first the address itself and then its QR code if a QR format is
+ * selected, so paging through addresses doesn't wait on derivation.
+ */
+struct AddressPrecompute {
+    ext_key account;		// public key only
+    String family;
+    uint32_t indx;
+    int stage;
+    bool valid;			// addr and address_ur hold address indx
+    String addr;
+    String address_ur;
+};
+
+AddressPrecompute g_next_address;
+int g_next_address_task = -1;
+
+bool address_precompute_step(void *ctx) {
+    AddressPrecompute * pre = (AddressPrecompute *) ctx;
+    switch (pre->stage++) {
+    case 0:
+        derive_address(&pre->account, pre->family.c_str(), pre->indx,
+                       pre->addr, pre->address_ur);
+        pre->valid = true;
+        return false;
+    case 1:
+        if (pg_show_address.addr_format == qr_text) {
+            g_qr_cache.encode(pre->addr.c_str());
+        }
+        else if (pg_show_address.addr_format == qr_ur) {
+            String upper = pre->address_ur;
+            upper.toUpperCase();
+            g_qr_cache.encode(upper.c_str());
+        }
+        return true;
+    default:
+        return true;
+    }
+}
+
 void show_address(void) {
 
     String title = "Address " + String(pg_show_address.addr_indx);
     struct ext_key child_key;
-    struct ext_key child_key2;
-    char *addr_segwit = NULL; // @TODO free
+    String addr_segwit;
     // @TODO only single native segwit for now
-    String child_path_str = network.get_network() == MAINNET ? "m/84h/0h/0h/0" : "m/84h/1h/0h/0";
+    String child_path_str = keystore.network.get_network() == MAINNET ? "m/84h/0h/0h/0" : "m/84h/1h/0h/0";
     uint32_t child_path[10];
     uint32_t child_path_len;
     String address_family;
+    String address_ur;
 
 
     keystore.calc_derivation_path(child_path_str.c_str(), child_path, child_path_len);
+    if (!seed_context_derive(child_path, child_path_len, &child_key)) {
+        g_uistate = ERROR_SCREEN;
+        return;
+    }
 
-    while (true) {
+    switch(keystore.network.get_network())
+    {
+      case MAINNET:
+          address_family = "bc";
+          break;
+      case TESTNET:
+          address_family = "tb";
+          break;
+      default:
+          address_family = "bcrt";
+          break;
+    }
 
-      (void)bip32_key_from_parent_path(&keystore.root, child_path, child_path_len, BIP32_FLAG_KEY_PRIVATE, &child_key);
-      (void)bip32_key_from_parent(&child_key, pg_show_address.addr_indx, BIP32_FLAG_KEY_PUBLIC, &child_key2);
+    // Whatever was precomputed may be for another seed or network.
+    sched_cancel(g_next_address_task);
+    g_next_address.valid = false;
+    g_next_address.account = child_key;
+    bip32_key_strip_private_key(&g_next_address.account);
+    g_next_address.family = address_family;
 
-      switch(network.get_network())
-      {
-        case MAINNET:
-            address_family = "bc";
-            break;
-        case TESTNET:
-            address_family = "tb";
-            break;
-        default:
-            address_family = "bcrt";
-            break;
-      }
-
-      (void)wally_bip32_key_to_addr_segwit(&child_key2, address_family.c_str(), 0, &addr_segwit);
+    while (true) {
 
-      // prepare cbor/ur format
-      uint8_t data[100];
-      size_t data_written;
-      String address_ur;
-      (void)wally_addr_segwit_to_bytes(addr_segwit, address_family.c_str(), 0, data, sizeof(data), &data_written);
-      (void)ur_encode_address(data, data_written, address_ur);
+      if (g_next_address.valid && g_next_address.indx == pg_show_address.addr_indx) {
+          addr_segwit = g_next_address.addr;
+          address_ur = g_next_address.address_ur;
+      }
+      else {
+          derive_address(&child_key, address_family.c_str(), pg_show_address.addr_indx,
+                         addr_segwit, address_ur);
+      }
 
       g_display->firstPage();
       do
       {
-          g_display->setPartialWindow(0, 0, 200, 200);
+          set_partial_window(0, 0, 200, 200);
           g_display->fillScreen(GxEPD_WHITE);
           g_display->setTextColor(GxEPD_BLACK);
 
           int yy = 25;
-          g_display->setFont(&FreeSansBold9pt7b);
+          set_font(&FreeSansBold9pt7b);
           Point p = text_center(title.c_str());
           g_display->setCursor(p.x, yy);
           g_display->println(title);
 
-          g_display->setFont(&FreeSansBold9pt7b);
+          set_font(&FreeSansBold9pt7b);
           g_display->setCursor(0, yy + 40);
           switch(pg_show_address.addr_format) {
             case text:
-                g_display->setFont(&FreeMonoBold9pt7b);
+                set_font(&FreeMonoBold9pt7b);
                 display_long_text(yy+40, addr_segwit);
                 break;
             case qr_text:
-                displayQR(addr_segwit);
+                displayQR((char *)addr_segwit.c_str());
                 break;
             case qr_ur:
             {
@@ -2878,16 +3574,16 @@ void show_address(void) {
                 break;
             }
             case ur:
-                g_display->setFont(&FreeMonoBold9pt7b);
+                set_font(&FreeMonoBold9pt7b);
                 display_long_text(yy+40, address_ur);
-                Serial.println(address_ur.c_str());
+                Serial.println(address_ur);
                 break;
             default:
                 break;
           }
 
           yy = 195; // Absolute, stuck to bottom
-          g_display->setFont(&FreeMono9pt7b);
+          set_font(&FreeMono9pt7b);
           String right_option = "# Done";
           int x_r = text_right(right_option.c_str());
           g_display->setCursor(x_r, yy);
@@ -2909,10 +3605,14 @@ void show_address(void) {
       }
       while (g_display->nextPage());
 
-      char key;
-      do {
-          key = g_keypad.getKey();
-      } while (key == NO_KEY);
+      // Paging forward is the likely next step.
+      sched_cancel(g_next_address_task);
+      g_next_address.valid = false;
+      g_next_address.indx = pg_show_address.addr_indx + 1;
+      g_next_address.stage = 0;
+      g_next_address_task = sched_add(address_precompute_step, &g_next_address, SCHED_PRIO_IDLE);
+
+      char key = wait_for_key();
 
       switch (key) {
         case '#':
@@ -2948,12 +3648,12 @@ void set_address_format(void) {
       g_display->firstPage();
       do
       {
-          g_display->setPartialWindow(0, 0, 200, 200);
+          set_partial_window(0, 0, 200, 200);
           g_display->fillScreen(GxEPD_WHITE);
           g_display->setTextColor(GxEPD_BLACK);
 
           int yy = 25;
-          g_display->setFont(&FreeSansBold9pt7b);
+          set_font(&FreeSansBold9pt7b);
           Point p = text_center(title.c_str());
           g_display->setCursor(p.x, yy);
           g_display->println(title);
@@ -2971,7 +3671,7 @@ void set_address_format(void) {
           display_text("D: qr-ur", xx, yy, pg_show_address.addr_format == qr_ur, 0);
 
           yy = 195; // Absolute, stuck to bottom
-          g_display->setFont(&FreeMono9pt7b);
+          set_font(&FreeMono9pt7b);
           String right_option = "# Done";
           int x_r = text_right(right_option.c_str());
           g_display->setCursor(x_r, yy);
@@ -2983,10 +3683,7 @@ void set_address_format(void) {
       }
       while (g_display->nextPage());
 
-      char key;
-      do {
-          key = g_keypad.getKey();
-      } while (key == NO_KEY);
+      char key = wait_for_key();
 
       g_uistate = SHOW_ADDRESS;
       switch (key) {
@@ -3018,7 +3715,7 @@ void export_wallet(void) {
     String title = "Wallet";
     struct ext_key child_key;
     // TODO: currently only single native segwit wallet supported
-    String child_path_str = network.get_network() == MAINNET ? "m/84h/0h/0h" : "m/84h/1h/0h";
+    String child_path_str = keystore.network.get_network() == MAINNET ? "m/84h/0h/0h" : "m/84h/1h/0h";
     uint32_t child_path[10];
     uint32_t child_path_len;
     String address_family;
@@ -3032,11 +3729,15 @@ void export_wallet(void) {
     String wallet_text;
     String wallet_ur;
 
-    while (true) {
-
+    // The descriptor doesn't change while this page is shown, derive it
+    // once so scrolling only re-renders.
+    {
       // @todo check return values
       keystore.calc_derivation_path(child_path_str.c_str(), child_path, child_path_len);
-      (void)bip32_key_from_parent_path(&keystore.root, child_path, child_path_len, BIP32_FLAG_KEY_PRIVATE, &child_key);
+      if (!seed_context_derive(child_path, child_path_len, &child_key)) {
+          g_uistate = ERROR_SCREEN;
+          return;
+      }
 
       sprintf(derivation_path_with_fingerprint, "[%02x%02x%02x%02x%s]", ((uint8_t *)&keystore.fingerprint)[3], ((uint8_t *)&keystore.fingerprint)[2],
                                                 ((uint8_t *)&keystore.fingerprint)[1], ((uint8_t *)&keystore.fingerprint)[0], child_path_str.substring(1).c_str());
@@ -3050,36 +3751,36 @@ void export_wallet(void) {
       ((uint8_t *)&fingerprint)[1] = child_key.parent160[2];
       ((uint8_t *)&fingerprint)[2] = child_key.parent160[1];
       ((uint8_t *)&fingerprint)[3] = child_key.parent160[0];
-      (void)ur_encode_output_descriptor(wallet_ur, child_path, child_path_len, fingerprint); // TODO this is parent fingerprint unlike above which is root fingerprint
+      (void)ur_encode_output_descriptor(keystore, wallet_ur, child_path, child_path_len, fingerprint); // TODO this is parent fingerprint unlike above which is root fingerprint
+    }
+
+    while (true) {
 
       g_display->firstPage();
       do
       {
-          g_display->setPartialWindow(0, 0, 200, 200);
+          set_partial_window(0, 0, 200, 200);
           g_display->fillScreen(GxEPD_WHITE);
           g_display->setTextColor(GxEPD_BLACK);
 
           int yy = 25; int xx = 5;
-          g_display->setFont(&FreeSansBold9pt7b);
+          set_font(&FreeSansBold9pt7b);
           Point p = text_center(title.c_str());
           g_display->setCursor(p.x, yy);
           g_display->println(title);
           yy += H_FMB12 + YM_FMB12 + 15;
 
-          g_display->setFont(&FreeMonoBold9pt7b);
+          set_font(&FreeMonoBold9pt7b);
           g_display->setCursor(xx, yy + 40);
 
           switch(pg_export_wallet.wallet_format) {
             case text:
             {
                 Serial.println(wallet_text);
-                Serial.println(scroll);
+                LOG_DEBUG("scroll = %u\n", (unsigned) scroll);
                 int scroll_strlen = 17;
-                for (int k = 0; k < nrows; ++k) {
-                    g_display->setCursor(xx, yy);
-                    display_printf("%s", wallet_text.substring((k + scroll)*scroll_strlen, (1+k + scroll)*scroll_strlen).c_str());
-                    yy += H_FMB12 + YM_FMB12;
-                }
+                display_text_rows(xx, yy, wallet_text.c_str(), wallet_text.length(),
+                                  scroll, nrows, scroll_strlen, H_FMB12 + YM_FMB12);
                 break;
             }
             case qr_text:
@@ -3095,11 +3796,8 @@ void export_wallet(void) {
             {
                 Serial.println(wallet_ur);
                 int scroll_strlen = 17;
-                for (int k = 0; k < nrows; ++k) {
-                    g_display->setCursor(xx, yy);
-                    display_printf("%s", wallet_ur.substring((k + scroll)*scroll_strlen, (1+k + scroll)*scroll_strlen).c_str());
-                    yy += H_FMB12 + YM_FMB12;
-                }
+                display_text_rows(xx, yy, wallet_ur.c_str(), wallet_ur.length(),
+                                  scroll, nrows, scroll_strlen, H_FMB12 + YM_FMB12);
                 break;
             }
             default:
@@ -3107,7 +3805,7 @@ void export_wallet(void) {
           }
 
           yy = 195; // Absolute, stuck to bottom
-          g_display->setFont(&FreeMono9pt7b);
+          set_font(&FreeMono9pt7b);
           String right_option = "# Done";
           int x_r = text_right(right_option.c_str());
           g_display->setCursor(x_r, yy);
@@ -3129,10 +3827,7 @@ void export_wallet(void) {
       }
       while (g_display->nextPage());
 
-      char key;
-      do {
-          key = g_keypad.getKey();
-      } while (key == NO_KEY);
+      char key = wait_for_key();
 
       switch (key) {
         case '#':
@@ -3167,12 +3862,12 @@ void set_export_wallet_format(void) {
       g_display->firstPage();
       do
       {
-          g_display->setPartialWindow(0, 0, 200, 200);
+          set_partial_window(0, 0, 200, 200);
           g_display->fillScreen(GxEPD_WHITE);
           g_display->setTextColor(GxEPD_BLACK);
 
           int yy = 25;
-          g_display->setFont(&FreeSansBold9pt7b);
+          set_font(&FreeSansBold9pt7b);
           Point p = text_center(title.c_str());
           g_display->setCursor(p.x, yy);
           g_display->println(title);
@@ -3190,7 +3885,7 @@ void set_export_wallet_format(void) {
           display_text("D: qr-ur", xx, yy, pg_export_wallet.wallet_format == qr_ur, 0);
 
           yy = 195; // Absolute, stuck to bottom
-          g_display->setFont(&FreeMono9pt7b);
+          set_font(&FreeMono9pt7b);
           String right_option = "# Done";
           int x_r = text_right(right_option.c_str());
           g_display->setCursor(x_r, yy);
@@ -3202,10 +3897,7 @@ void set_export_wallet_format(void) {
       }
       while (g_display->nextPage());
 
-      char key;
-      do {
-          key = g_keypad.getKey();
-      } while (key == NO_KEY);
+      char key = wait_for_key();
 
       g_uistate = EXPORT_WALLET;
       switch (key) {
@@ -3232,6 +3924,493 @@ void set_export_wallet_format(void) {
     }
 }
 
+void seed_slots(void) {
+    int xx = 10;
+
+    while (true) {
+      g_display->firstPage();
+      do
+      {
+          set_partial_window(0, 0, 200, 200);
+          g_display->fillScreen(GxEPD_WHITE);
+          g_display->setTextColor(GxEPD_BLACK);
+
+          const char * title = "Seed slots";
+          int yy = 20;
+          set_font(&FreeSansBold9pt7b);
+          Point p = text_center(title);
+          g_display->setCursor(p.x, yy);
+          g_display->println(title);
+
+          // Slots by their root fingerprint on the current network.
+          set_font(&FreeMonoBold9pt7b);
+          NetwtorkType network = keystore.network.get_network();
+          for (size_t ii = 0; ii < MAX_SEED_SLOTS; ++ii) {
+              SeedContext * context = ii == g_slot ?
+                  (g_master_seed ? seed_context() : NULL) : g_slots[ii].context;
+              char line[20];
+              ext_key const * root = context ? context->root(network) : NULL;
+              if (root)
+                  snprintf(line, sizeof(line), "%c%u %02x%02x%02x%02x", ii == g_slot ? '>' : ' ',
+                           (unsigned int)(ii + 1), root->hash160[0], root->hash160[1],
+                           root->hash160[2], root->hash160[3]);
+              else
+                  snprintf(line, sizeof(line), "%c%u -", ii == g_slot ? '>' : ' ',
+                           (unsigned int)(ii + 1));
+              yy += H_FMB12 + 4;
+              g_display->setCursor(xx, yy);
+              g_display->println(line);
+          }
+
+          yy = 195; // Absolute, stuck to bottom
+          set_font(&FreeMono9pt7b);
+          String right_option = "Multisig A";
+          int x_r = text_right(right_option.c_str());
+          g_display->setCursor(x_r, yy);
+          g_display->println(right_option);
+
+          right_option = "Wipe all D";
+          x_r = text_right(right_option.c_str());
+          g_display->setCursor(x_r, yy - 20);
+          g_display->println(right_option);
+
+          String left_option = "Back *";
+          g_display->setCursor(0, yy);
+          g_display->println(left_option);
+      }
+      while (g_display->nextPage());
+
+      char key = wait_for_key();
+
+      switch (key) {
+        case '*':
+            g_uistate = g_master_seed ? SEEDY_MENU : SEEDLESS_MENU;
+            return;
+        case 'A':
+            if (slots_count() > 0) {
+                if (!g_master_seed) {
+                    // Export from a parked seed.
+                    for (size_t ii = 0; ii < MAX_SEED_SLOTS; ++ii)
+                        if (g_slots[ii].seed) {
+                            slots_switch(ii);
+                            break;
+                        }
+                }
+                g_uistate = EXPORT_MULTISIG;
+                return;
+            }
+            break;
+        case 'D':
+            // The current seed and every parked one.
+            ui_reset_into_state(SEEDLESS_MENU);
+            return;
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+            // An empty slot starts a new seed, the current one is kept.
+            slots_switch(key - '1');
+            g_uistate = g_master_seed ? SEEDY_MENU : SEEDLESS_MENU;
+            hw_green_led(g_master_seed ? HIGH : LOW);
+            return;
+        default:
+            break;
+      }
+    }
+}
+
+void export_multisig(void) {
+    String title = "Multisig";
+    size_t nrows = 4;
+    size_t scroll = 0;
+
+    // Every seed's keys are already in its context.
+    SeedContext * contexts[MAX_SEED_SLOTS];
+    size_t n = 0;
+    for (size_t ii = 0; ii < MAX_SEED_SLOTS; ++ii) {
+        if (ii == g_slot && g_master_seed)
+            contexts[n++] = seed_context();
+        else if (g_slots[ii].context)
+            contexts[n++] = g_slots[ii].context;
+    }
+    if (pg_export_multisig.threshold < 1 || pg_export_multisig.threshold > n)
+        pg_export_multisig.threshold = n / 2 + 1;
+
+    String descriptor;
+    bool stale = true;	// threshold changed
+
+    while (true) {
+      if (stale) {
+          if (!multisig_descriptor(contexts, n, keystore.network.get_network(),
+                                   pg_export_multisig.threshold, descriptor)) {
+              g_uistate = ERROR_SCREEN;
+              return;
+          }
+          Serial.println(descriptor);
+          stale = false;
+      }
+
+      g_display->firstPage();
+      do
+      {
+          set_partial_window(0, 0, 200, 200);
+          g_display->fillScreen(GxEPD_WHITE);
+          g_display->setTextColor(GxEPD_BLACK);
+
+          int yy = 25; int xx = 5;
+          set_font(&FreeSansBold9pt7b);
+          String heading = title + " " + String(pg_export_multisig.threshold) + "/" + String(n);
+          Point p = text_center(heading.c_str());
+          g_display->setCursor(p.x, yy);
+          g_display->println(heading);
+          yy += H_FMB12 + YM_FMB12 + 15;
+
+          set_font(&FreeMonoBold9pt7b);
+          switch(pg_export_multisig.multisig_format) {
+            case qr_text:
+                displayQR((char *)descriptor.c_str());
+                break;
+            default:
+            {
+                int scroll_strlen = 17;
+                display_text_rows(xx, yy, descriptor.c_str(), descriptor.length(),
+                                  scroll, nrows, scroll_strlen, H_FMB12 + YM_FMB12);
+                break;
+            }
+          }
+
+          yy = 195; // Absolute, stuck to bottom
+          set_font(&FreeMono9pt7b);
+          String right_option = "# Done";
+          int x_r = text_right(right_option.c_str());
+          g_display->setCursor(x_r, yy);
+          g_display->println(right_option);
+
+          String left_option = "Back *";
+          g_display->setCursor(0, yy);
+          g_display->println(left_option);
+
+          yy -= 15;
+          right_option = "<-4/6->";
+          x_r = text_right(right_option.c_str());
+          g_display->setCursor(x_r, yy);
+          g_display->println(right_option);
+
+          left_option = "A k B QR";
+          g_display->setCursor(0, yy);
+          g_display->println(left_option);
+      }
+      while (g_display->nextPage());
+
+      char key = wait_for_key();
+
+      switch (key) {
+        case '#':
+            g_uistate = SEEDY_MENU;
+            return;
+        case '*':
+            g_uistate = SEED_SLOTS;
+            return;
+        case '6':
+            scroll++;
+            break;
+        case '4':
+            if (scroll > 0)
+                scroll--;
+            break;
+        case 'A':
+            // Cycle the threshold through 1..n.
+            pg_export_multisig.threshold = pg_export_multisig.threshold % n + 1;
+            stale = true;
+            break;
+        case 'B':
+            pg_export_multisig.multisig_format =
+                pg_export_multisig.multisig_format == text ? qr_text : text;
+            scroll = 0;
+            break;
+        default:
+            break;
+      }
+    }
+}
+
+// The key expression of an account, e.g. "[d34db33f/84h/0h/0h]xpub...".
+String account_key_expression(AccountKey const & account) {
+    char origin[48];
+    int len = snprintf(origin, sizeof(origin), "[%08x", (unsigned int)keystore.fingerprint);
+    for (size_t ii = 0; ii < account.path_len; ++ii)
+        len += snprintf(origin + len, sizeof(origin) - len, "/%luh",
+                        (unsigned long)(account.path[ii] & ~BIP32_INITIAL_HARDENED_CHILD));
+    char * xpub = NULL;
+    (void)bip32_key_to_base58(&account.key, BIP32_FLAG_KEY_PUBLIC, &xpub);
+    String expr = String(origin) + "]" + xpub;
+    wally_free_string(xpub);
+    return expr;
+}
+
+/**
+ * Accounts 0..naccounts-1 of every standard script type as one animated
+ * crypto-account UR, so a coordinator is set up with a single scan.  The
+ * same accounts are dumped to serial.
+ */
+void export_accounts(void) {
+    uint32_t const MAX_ACCOUNTS = 5;
+    size_t const CHUNK_SIZE = 100; // bytes
+    uint32_t const naccounts = pg_export_accounts.naccounts;
+    size_t const nkeys = NUM_STD_DERIVATIONS * naccounts;
+
+    AccountKey * accounts = new AccountKey[nkeys];
+    bool ok = seed_context()->select(keystore) &&
+        derive_account_keys(*seed_context(), keystore.network.get_network(), naccounts, accounts);
+
+    // Encoded once, for the serial UR and the animated QR.
+    uint8_t * cbor = NULL;
+    size_t cbor_size = 0;
+    if (ok) {
+        cbor_size = cbor_encode_crypto_account(keystore, accounts, nkeys, &cbor);
+        ok = cbor_size > 0;
+    }
+    String account_ur;
+    if (ok)
+        ok = ur_encode("crypto-account", cbor, cbor_size, account_ur);
+    if (ok) {
+        for (size_t ii = 0; ii < nkeys; ++ii) {
+            String expr = account_key_expression(accounts[ii]);
+            switch (accounts[ii].script) {
+                case SINGLE_NATIVE_SEGWIT:
+                    Serial.println("wpkh(" + expr + ")");
+                    break;
+                case SINGLE_NESTED_SEGWIT:
+                    Serial.println("sh(wpkh(" + expr + "))");
+                    break;
+                case MULTISIG_NATIVE_SEGWIT:
+                    Serial.println("cosigner " + expr);
+                    break;
+            }
+        }
+        Serial.println(account_ur);
+    }
+    memzero(accounts, nkeys * sizeof(AccountKey));
+    delete[] accounts;
+
+    if (!ok) {
+        free(cbor);
+        g_uistate = ERROR_SCREEN;
+        return;
+    }
+
+    auto encoder = UREncoder(UR("crypto-account", ByteVector(cbor, cbor + cbor_size)), CHUNK_SIZE);
+    free(cbor);
+
+    while (true) {
+      String part = encoder.next_part().c_str();
+      part.toUpperCase();
+
+      g_display->firstPage();
+      do
+      {
+          set_partial_window(0, 0, 200, 200);
+          g_display->fillScreen(GxEPD_WHITE);
+          g_display->setTextColor(GxEPD_BLACK);
+          displayQR((char *)part.c_str(), 200);
+      }
+      while (g_display->nextPage());
+
+      // Keep animating until a key is pressed.
+      char key = poll_key();
+
+      switch (key) {
+        case NO_KEY:
+            break;
+        case 'A':
+            // Cycle the number of accounts through 1..MAX_ACCOUNTS.
+            pg_export_accounts.naccounts = naccounts % MAX_ACCOUNTS + 1;
+            return;
+        case '#':
+        case '*':
+            g_uistate = OPEN_WALLET;
+            return;
+        default:
+            break;
+      }
+    }
+}
+
+// Shows a title and a few lines of text, with optional footer options.
+void sign_psbt_display(const char * title, String const * lines, size_t nlines,
+                       const char * left_option, const char * right_option) {
+    g_display->firstPage();
+    do
+    {
+        set_partial_window(0, 0, 200, 200);
+        g_display->fillScreen(GxEPD_WHITE);
+        g_display->setTextColor(GxEPD_BLACK);
+
+        int yy = 25;
+        set_font(&FreeSansBold9pt7b);
+        Point p = text_center(title);
+        g_display->setCursor(p.x, yy);
+        g_display->println(title);
+
+        yy += 15;
+        set_font(&FreeMonoBold9pt7b);
+        for (size_t ii = 0; ii < nlines; ++ii) {
+            yy += H_FMB12;
+            g_display->setCursor(5, yy);
+            g_display->println(lines[ii]);
+        }
+
+        yy = 195; // Absolute, stuck to bottom
+        set_font(&FreeMono9pt7b);
+        if (right_option) {
+            int x_r = text_right(right_option);
+            g_display->setCursor(x_r, yy);
+            g_display->println(right_option);
+        }
+        if (left_option) {
+            g_display->setCursor(0, yy);
+            g_display->println(left_option);
+        }
+    }
+    while (g_display->nextPage());
+}
+
+// e.g. "0.00150000 BTC", amounts are at most 21e14 satoshis.
+String sign_psbt_btc(uint64_t sats) {
+    char btc[24];
+    snprintf(btc, sizeof(btc), "%lu.%08lu BTC", (unsigned long)(sats / 100000000),
+             (unsigned long)(sats % 100000000));
+    return btc;
+}
+
+// Only a key pressed after the question is shown answers it.
+bool sign_psbt_yes_no() {
+    hw_key_flush();
+    while (true) {
+        char key = wait_for_key();
+        if (key == '#')
+            return true;
+        if (key == '*')
+            return false;
+    }
+}
+
+// Before any input is signed the user steps through where the
+// transaction pays, an output per screen, and then its total.
+bool sign_psbt_confirm(PsbtTxSummary const & tx, void * arg) {
+    NetwtorkType network = *(NetwtorkType const *) arg;
+    size_t const line_len = 16;
+    size_t const max_addr_lines = 5;
+
+    for (size_t ii = 0; ii < tx.nshown; ++ii) {
+        String addr = psbt_output_address(tx.outputs[ii], network);
+        String lines[max_addr_lines + 1];
+        size_t nlines = 0;
+        for (size_t pos = 0; pos < addr.length() && nlines < max_addr_lines; pos += line_len)
+            lines[nlines++] = addr.substring(pos, pos + line_len);
+        if (addr.length() > line_len * max_addr_lines)
+            lines[nlines - 1] += "..";
+        lines[nlines++] = sign_psbt_btc(tx.outputs[ii].amount);
+
+        char title[32];
+        snprintf(title, sizeof(title), "Output %u of %lu", (unsigned) ii + 1,
+                 (unsigned long) tx.noutputs);
+        sign_psbt_display(title, lines, nlines, "No *", "Next #");
+        if (!sign_psbt_yes_no())
+            return false;
+    }
+
+    String lines[5] = {
+        String(tx.ninputs) + " inputs", String(tx.noutputs) + " outputs",
+        "paying", sign_psbt_btc(tx.out_total),
+    };
+    size_t nlines = 4;
+    if (tx.noutputs > tx.nshown)
+        lines[nlines++] = String(tx.noutputs - tx.nshown) + " not shown";
+    sign_psbt_display("Sign PSBT?", lines, nlines, "No *", "Yes #");
+    return sign_psbt_yes_no();
+}
+
+// Every input was read, the signatures only go out once the user
+// agrees to the fee.
+bool sign_psbt_confirm_fee(uint32_t nsigned, uint32_t ninputs, bool fee_known,
+                           uint64_t fee, void * arg) {
+    (void) arg;
+    String lines[] = {
+        "Signed " + String(nsigned) + " of", String(ninputs) + " inputs",
+        "fee", fee_known ? sign_psbt_btc(fee) : String("unknown"),
+    };
+    sign_psbt_display("Send signatures?", lines, 4, "No *", "Yes #");
+    return sign_psbt_yes_no();
+}
+
+void sign_psbt_print_hex(uint8_t const * data, size_t len) {
+    char hex[3];
+    for (size_t ii = 0; ii < len; ++ii) {
+        snprintf(hex, sizeof(hex), "%02x", data[ii]);
+        Serial.print(hex);
+    }
+}
+
+// One line per signature: "sig <input> <pubkey> <signature>", in hex.
+// It's the result for the host, written whatever the log level.
+void sign_psbt_signature(uint32_t input, uint8_t const * pubkey,
+                         uint8_t const * sig, size_t sig_len, void * arg) {
+    (void) arg;
+    Serial.print("sig ");
+    Serial.print((unsigned long) input);
+    Serial.print(" ");
+    sign_psbt_print_hex(pubkey, 33);
+    Serial.print(" ");
+    sign_psbt_print_hex(sig, sig_len);
+    Serial.println();
+}
+
+/**
+ * Signs a PSBT sent over USB serial, as base64 text on one line or as
+ * raw bytes.  Signatures go back over serial as they are made.
+ */
+void sign_psbt(void) {
+    String lines[] = { "Send PSBT over", "USB serial,", "base64 or raw" };
+    sign_psbt_display("Sign PSBT", lines, 3, "Cancel *", NULL);
+
+    while (!Serial.available()) {
+        if (hw_getkey() == '*') {
+            g_uistate = OPEN_WALLET;
+            return;
+        }
+    }
+
+    // The confirm screens wait for keys with the PSBT still coming in.
+    SerialCmdHold hold;
+    PsbtStreamSource src(Serial);
+    NetwtorkType network = keystore.network.get_network();
+    PsbtCallbacks cb = { sign_psbt_confirm, sign_psbt_confirm_fee, sign_psbt_signature, &network };
+    PsbtSignStats stats;
+    bool ok = seed_context()->select(keystore) &&
+        psbt_sign(src, *seed_context(), network, cb, stats);
+    src.finish();
+
+    // Signing throughput, inputs per second over the input maps.
+    uint32_t rate = stats.sign_ms ? stats.ninputs * 1000UL / stats.sign_ms : stats.ninputs;
+    serial_printf("psbt %s: signed %lu of %lu inputs in %lu ms, %lu inputs/s\n",
+                  ok ? "done" : "failed", (unsigned long) stats.nsigned,
+                  (unsigned long) stats.ninputs, (unsigned long) stats.sign_ms,
+                  (unsigned long) rate);
+
+    String result[] = {
+        ok ? "Signed" : "Failed",
+        String(stats.nsigned) + " of " + String(stats.ninputs),
+        String(stats.sign_ms) + " ms",
+        String(rate) + " inputs/s",
+    };
+    sign_psbt_display("Sign PSBT", result, 4, NULL, "Done #");
+    while (wait_for_key() != '#')
+        ;
+    g_uistate = OPEN_WALLET;
+}
+
 void ur_demo(void) {
 
     uint32_t dt;
@@ -3241,12 +4420,12 @@ void ur_demo(void) {
     dt = millis();
     auto ur = make_message_ur(1000);
     dt = millis() - dt;
-    Serial.println("Make mesage: " + String(dt));
+    LOG_DEBUG("Make mesage: %lu\n", (unsigned long) dt);
 
     dt = millis();
     auto encoder = UREncoder(ur, CHUNK_SIZE);
     dt = millis() - dt;
-    Serial.println("UREncoder: " + String(dt));
+    LOG_DEBUG("UREncoder: %lu\n", (unsigned long) dt);
 
     while (true) {
 
@@ -3256,7 +4435,7 @@ void ur_demo(void) {
       dt = millis();
       string _part = encoder.next_part();
       dt = millis() - dt;
-      Serial.println("Encoder.next_part: " + String(dt));
+      LOG_DEBUG("Encoder.next_part: %lu\n", (unsigned long) dt);
 
       const char * part_tmp = _part.c_str();
       String part_Str = part_tmp;
@@ -3265,7 +4444,7 @@ void ur_demo(void) {
       g_display->firstPage();
       do
       {
-          g_display->setPartialWindow(0, 0, 200, 200);
+          set_partial_window(0, 0, 200, 200);
           g_display->fillScreen(GxEPD_WHITE);
           g_display->setTextColor(GxEPD_BLACK);
 
@@ -3274,16 +4453,16 @@ void ur_demo(void) {
           displayQR((char *)part_Str.c_str(), 200);
           // Delta time
           dt = millis() - dt;
-          Serial.println("QR Code generated: " + String(dt));
+          LOG_DEBUG("QR Code generated: %lu\n", (unsigned long) dt);
       }
       while (g_display->nextPage());
 
       // Delta time
       dt0 = millis() - dt0;
-      Serial.println("QR updated: " + String(dt0));
+      LOG_DEBUG("QR updated: %lu\n", (unsigned long) dt0);
 
       char key;
-      key = g_keypad.getKey();
+      key = hw_getkey();
 
       switch (key) {
         case NO_KEY:
@@ -3298,6 +4477,12 @@ void ur_demo(void) {
 
 } // namespace userinterface_internal
 
+void ui_setup() {
+    using namespace userinterface_internal;
+
+    g_refresh.init(hw_display_variant());
+}
+
 void ui_reset_into_state(UIState state) {
     using namespace userinterface_internal;
 
@@ -3311,6 +4496,11 @@ void ui_reset_into_state(UIState state) {
         g_bip39 = NULL;
     }
 
+    if (g_seed_context) {
+        delete g_seed_context;
+        g_seed_context = NULL;
+    }
+
     if (g_sskr_generate) {
         delete g_sskr_generate;
         g_sskr_generate = NULL;
@@ -3321,7 +4511,22 @@ void ui_reset_into_state(UIState state) {
         g_sskr_restore = NULL;
     }
 
-    g_rolls = "";
+    // Forgetting the seed forgets the parked ones too.
+    slots_wipe_all();
+    g_slot = 0;
+    keystore.clear_root_key();
+
+    // Background work belongs to the previous session, and nothing it
+    // left behind may outlive the seed.
+    sched_cancel_all();
+    memzero(&g_next_address.account, sizeof(g_next_address.account));
+    g_next_address.valid = false;
+    wipe_string(g_next_address.addr);
+    wipe_string(g_next_address.address_ur);
+    wipe_string(g_qr_precompute_text);
+    g_qr_cache.wipe();
+
+    g_seed_builder.reset();
     g_submitted = false;
     g_uistate = state;
 
@@ -3331,9 +4536,13 @@ void ui_reset_into_state(UIState state) {
 void ui_dispatch() {
     using namespace userinterface_internal;
 
-    if (clear_full_window) {
-        full_window_clear();
-        clear_full_window = true;
+    refresh_transition();
+
+    // Type-ahead is kept within a screen, e.g. while entering words,
+    // keys queued on one screen must not act on the next.
+    if (g_uistate != g_dispatched_state) {
+        hw_key_flush();
+        g_dispatched_state = g_uistate;
     }
 
     switch (g_uistate) {
@@ -3418,8 +4627,20 @@ void ui_dispatch() {
     case UR_DEMO:
        ur_demo();
        break;
+    case SEED_SLOTS:
+       seed_slots();
+       break;
+    case EXPORT_MULTISIG:
+       export_multisig();
+       break;
+    case EXPORT_ACCOUNTS:
+       export_accounts();
+       break;
+    case SIGN_PSBT:
+       sign_psbt();
+       break;
     default:
-        Serial.println("loop: unknown g_uistate " + String(g_uistate));
+        LOG_ERROR("loop: unknown g_uistate %d\n", (int) g_uistate);
         break;
     }
 }
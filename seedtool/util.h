@@ -9,7 +9,7 @@ extern "C" {
 
 #define ARRAY_SIZE(x) sizeof(x)/sizeof(x[0])
 
-void serial_printf(const char *format, ...);
+void serial_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
 
 #ifdef __cplusplus
 }
@@ -27,6 +27,9 @@ void serial_printf(const char *format, ...);
 void print_hex(uint8_t *data, size_t len);
 bool compare_bytes_with_hex(uint8_t *data, size_t len, const char * hex);
 String get_word_from_sentence(String data, char separator, int index);
+// Overwrites the characters of str and empties it, String frees its
+// buffer without wiping it.
+void wipe_string(String & str);
 
 struct Point {
   int x;
@@ -1,5 +1,7 @@
 // Copyright © 2020 Blockchain Commons, LLC
 
+#include <bc-crypto-base.h>
+
 #include "util.h"
 
 void serial_printf(const char *format, ...) {
@@ -54,3 +56,9 @@ String get_word_from_sentence(String data, char separator, int index)
     }
     return found > index ? data.substring(strIndex[0], strIndex[1]) : "";
 }
+
+void wipe_string(String & str) {
+    if (str.length() > 0)
+        memzero((void *) str.c_str(), str.length());
+    str = "";
+}
@@ -0,0 +1,48 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#ifndef WORDLIST_H
+#define WORDLIST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Zero allocation access to the sorted BIP39 and Bytewords wordlists,
+ * with the prefix queries used by word entry.  Words sharing a prefix
+ * are a contiguous range of a sorted list, a first letter table and a
+ * binary search find the range in O(log n).  The Bytewords are those
+ * of the bc-ur library, there is no second copy to drift apart.
+ */
+enum WordListId {
+    WORDLIST_BIP39,		// 2048 words
+    WORDLIST_BYTEWORDS,		// 256 words
+};
+
+uint16_t wordlist_size(WordListId wl);
+
+// Returns the NUL terminated word, valid for the lifetime of the program.
+const char * wordlist_word(WordListId wl, uint16_t ndx);
+
+// Words [lo, hi) start with the first len characters of prefix.
+void wordlist_prefix_range(WordListId wl, const char * prefix, size_t len,
+                           uint16_t & lo, uint16_t & hi);
+
+// The first word after ndx (wrapping around) that shares the first pos
+// characters with word ndx but differs at pos.  Returns ndx if there
+// is none.
+uint16_t wordlist_next_distinct(WordListId wl, uint16_t ndx, size_t pos);
+
+// The last word before ndx (wrapping around) that shares the first pos
+// characters with word ndx but differs at pos.  Returns ndx if there
+// is none.
+uint16_t wordlist_prev_distinct(WordListId wl, uint16_t ndx, size_t pos);
+
+// Is word ndx the only word starting with its first pos characters?
+bool wordlist_unique_prefix(WordListId wl, uint16_t ndx, size_t pos);
+
+// The byteword with the given first and last letters, or -1.  The
+// first and last letters identify a byteword uniquely, the lookup
+// uses the table of the bc-ur Bytewords decoder.
+int wordlist_byteword_from_letters(char first, char last);
+
+#endif // WORDLIST_H
@@ -0,0 +1,126 @@
+// Copyright © 2020 Blockchain Commons, LLC
+
+#include "wordlist.h"
+#include "bip39words.h"
+#include "util.h"
+#include "bytewords.hpp"
+
+namespace wordlist_internal {
+
+uint16_t const BIP39_NWORDS = 2048;
+
+// Index of the first word starting with each letter, and the list size.
+uint16_t g_first[2][27];
+bool g_first_ready[2] = { false, false };
+
+uint16_t const * first_letters(WordListId wl) {
+    uint16_t * first = g_first[wl];
+    if (!g_first_ready[wl]) {
+        uint16_t nwords = wordlist_size(wl);
+        uint16_t ndx = 0;
+        for (int ll = 0; ll < 26; ++ll) {
+            while (ndx < nwords && wordlist_word(wl, ndx)[0] < 'a' + ll)
+                ++ndx;
+            first[ll] = ndx;
+        }
+        first[26] = nwords;
+        g_first_ready[wl] = true;
+    }
+    return first;
+}
+
+// First word in [lo, hi) not less than prefix (upper == false) or
+// greater than prefix (upper == true), comparing len characters.
+uint16_t bound(WordListId wl, const char * prefix, size_t len,
+               uint16_t lo, uint16_t hi, bool upper) {
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+        int cmp = strncmp(wordlist_word(wl, mid), prefix, len);
+        if (cmp < 0 || (upper && cmp == 0))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+} // namespace wordlist_internal
+
+uint16_t wordlist_size(WordListId wl) {
+    using namespace wordlist_internal;
+    return wl == WORDLIST_BIP39 ? BIP39_NWORDS : 256;
+}
+
+const char * wordlist_word(WordListId wl, uint16_t ndx) {
+    using namespace wordlist_internal;
+    serial_assert(ndx < wordlist_size(wl));
+    if (wl == WORDLIST_BYTEWORDS)
+        return ur_arduino::Bytewords::word(ndx);
+    return bip39_words + bip39_word_offset[ndx];
+}
+
+void wordlist_prefix_range(WordListId wl, const char * prefix, size_t len,
+                           uint16_t & lo, uint16_t & hi) {
+    using namespace wordlist_internal;
+    uint16_t const * first = first_letters(wl);
+    if (len == 0) {
+        lo = 0;
+        hi = wordlist_size(wl);
+        return;
+    }
+    if (prefix[0] < 'a' || prefix[0] > 'z') {
+        lo = hi = 0;
+        return;
+    }
+    int ll = prefix[0] - 'a';
+    lo = bound(wl, prefix, len, first[ll], first[ll + 1], false);
+    hi = bound(wl, prefix, len, lo, first[ll + 1], true);
+}
+
+uint16_t wordlist_next_distinct(WordListId wl, uint16_t ndx, size_t pos) {
+    using namespace wordlist_internal;
+    const char * word = wordlist_word(wl, ndx);
+    uint16_t lo, hi;
+    wordlist_prefix_range(wl, word, pos, lo, hi);
+    // Skip the words having the same character at pos.
+    uint16_t next = wordlist_internal::bound(wl, word, pos + 1, ndx, hi, true);
+    if (next < hi)
+        return next;
+    // Wrap around to the start of the prefix range.
+    if (wordlist_word(wl, lo)[pos] != word[pos])
+        return lo;
+    return ndx;
+}
+
+uint16_t wordlist_prev_distinct(WordListId wl, uint16_t ndx, size_t pos) {
+    using namespace wordlist_internal;
+    const char * word = wordlist_word(wl, ndx);
+    uint16_t lo, hi;
+    wordlist_prefix_range(wl, word, pos, lo, hi);
+    // Skip the words having the same character at pos.
+    uint16_t start = wordlist_internal::bound(wl, word, pos + 1, lo, ndx, false);
+    if (start > lo)
+        return start - 1;
+    // Wrap around to the end of the prefix range.
+    if (wordlist_word(wl, hi - 1)[pos] != word[pos])
+        return hi - 1;
+    return ndx;
+}
+
+bool wordlist_unique_prefix(WordListId wl, uint16_t ndx, size_t pos) {
+    // The list is sorted, only the neighbours can share the prefix.
+    const char * word = wordlist_word(wl, ndx);
+    if (ndx > 0 && strncmp(wordlist_word(wl, ndx - 1), word, pos) == 0)
+        return false;
+    if (ndx < wordlist_size(wl) - 1 &&
+        strncmp(wordlist_word(wl, ndx + 1), word, pos) == 0)
+        return false;
+    return true;
+}
+
+int wordlist_byteword_from_letters(char first, char last) {
+    if (first < 'a' || first > 'z' || last < 'a' || last > 'z')
+        return -1;
+    // The bc-ur decoder already keeps this table, share it.
+    return ur_arduino::Bytewords::from_letters(first, last);
+}